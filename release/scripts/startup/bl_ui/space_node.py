@@ -656,6 +656,10 @@ class NODE_PT_quality(bpy.types.Panel):
         snode = context.space_data
         tree = snode.node_tree
 
+        col = layout.column()
+        col.prop(tree, "execution_mode")
+        col.prop(tree, "use_half_buffers")
+
         col = layout.column()
         col.prop(tree, "render_quality", text="Render")
         col.prop(tree, "edit_quality", text="Edit")
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <mutex>
 
 #include "FN_cpp_type.hh"
@@ -25,6 +26,10 @@
 
 #include "BLI_color.hh"
 #include "BLI_float3.hh"
+#include "BLI_map.hh"
+
+struct CustomData;
+struct CustomDataLayer;
 
 namespace blender::bke {
 
@@ -100,11 +105,40 @@ class ReadAttribute {
   /* Get a span that contains all attribute values. */
   fn::GSpan get_span() const;
 
+  /* Get the values in the given range. When the attribute is stored in a contiguous array, a slice
+   * of that array is returned. Otherwise the values are copied into the uninitialized buffer,
+   * which must have the size of the range. Contrary to #get_span, this never allocates an array
+   * for the entire attribute, so that chunks can be processed while they are in the CPU cache.
+   * It can be called from multiple threads at the same time. */
+  fn::GSpan get_chunk(const IndexRange range, void *r_buffer) const;
+
+  /* Get the contiguous array of all values when the attribute is stored like that, or an empty
+   * span otherwise. Contrary to #get_span, this never allocates. */
+  fn::GSpan get_array() const
+  {
+    return this->get_array_internal();
+  }
+
+  /* True when all elements have the same value. Node implementations can use this to compute
+   * the result only once and fill it in, instead of evaluating it for every element. */
+  bool is_single() const
+  {
+    return this->is_single_internal();
+  }
+
  protected:
   /* r_value is expected to be uninitialized. */
   virtual void get_internal(const int64_t index, void *r_value) const = 0;
 
+  virtual bool is_single_internal() const;
+
   virtual void initialize_span() const;
+
+  /* Return the contiguous array of all values if the attribute is stored like that, or an empty
+   * span otherwise. */
+  virtual fn::GSpan get_array_internal() const;
+  /* r_buffer is expected to be uninitialized. */
+  virtual void get_range_internal(const IndexRange range, void *r_buffer) const;
 };
 
 /**
@@ -216,6 +250,27 @@ template<typename T> class TypedReadAttribute {
   {
     return attribute_->get_span().template typed<T>();
   }
+
+  /* Get the values in a range, using the buffer if they are not stored contiguously.
+   * See #ReadAttribute::get_chunk. */
+  Span<T> get_chunk(const IndexRange range, MutableSpan<T> buffer) const
+  {
+    static_assert(std::is_trivially_destructible_v<T>);
+    BLI_assert(buffer.size() >= range.size());
+    return attribute_->get_chunk(range, buffer.data()).template typed<T>();
+  }
+
+  /* See #ReadAttribute::get_array. */
+  Span<T> get_array() const
+  {
+    return attribute_->get_array().template typed<T>();
+  }
+
+  /* See #ReadAttribute::is_single. */
+  bool is_single() const
+  {
+    return attribute_->is_single();
+  }
 };
 
 /* This provides type safe access to an attribute. */
@@ -275,4 +330,31 @@ using Float3WriteAttribute = TypedWriteAttribute<float3>;
 using Int32WriteAttribute = TypedWriteAttribute<int>;
 using Color4fWriteAttribute = TypedWriteAttribute<Color4f>;
 
+/**
+ * Remembers the indices of the generic attribute layers of one #CustomData by name, so that
+ * looking up an attribute does not have to compare the names of all layers. The cache is built by
+ * the first lookup and only read afterwards, so lookups can run on multiple threads at the same
+ * time. The owner of the custom data has to call #tag_dirty when layers may have been added,
+ * removed or renamed. That must not happen while other threads look up layers.
+ */
+class CustomDataLayerIndexCache {
+ private:
+  enum State {
+    Dirty,
+    Building,
+    Built,
+  };
+  std::atomic<int> state_ = Dirty;
+  /* The layers the cache was built for, used to detect changes the owner didn't tag. */
+  const CustomDataLayer *layers_ = nullptr;
+  int totlayer_ = 0;
+  Map<std::string, int> index_by_name_;
+
+ public:
+  /* Return the index of the generic attribute layer with the given name, or -1 when it does not
+   * exist. Layers with other types are skipped, even when they have the same name. */
+  int find(const CustomData &custom_data, StringRef name);
+
+  void tag_dirty();
+};
 }  // namespace blender::bke
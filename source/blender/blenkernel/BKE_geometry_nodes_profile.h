@@ -0,0 +1,62 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#pragma once
+
+/** \file
+ * \ingroup bke
+ *
+ * Per-node execution statistics of geometry node trees. Events are only recorded while
+ * #G_DEBUG_GEOMETRY_NODES_PROFILE is set, e.g. with `--debug-geometry-nodes-profile` or
+ * `bpy.app.debug_geometry_nodes_profile`.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct SessionUUID;
+
+bool BKE_geometry_nodes_profile_is_enabled(void);
+
+/**
+ * Remove the recorded events of the modifier with the given session UUID, or all events when it
+ * is null.
+ */
+void BKE_geometry_nodes_profile_clear(const struct SessionUUID *modifier_uuid);
+
+/**
+ * Write the recorded events in the Chrome trace event format, which can be loaded in
+ * `chrome://tracing` and other trace viewers. Only events of the given modifier are written,
+ * unless it is null. Returns false when the file cannot be written.
+ */
+bool BKE_geometry_nodes_profile_write_chrome_trace(const char *filepath,
+                                                   const struct SessionUUID *modifier_uuid);
+
+/**
+ * Accumulated statistics of all executions of the named node in the given modifier:
+ * wall time and thread time in seconds, the number of elements and the output size in bytes.
+ */
+void BKE_geometry_nodes_profile_node_stats(const struct SessionUUID *modifier_uuid,
+                                           const char *node_name,
+                                           float r_stats[4]);
+
+/** Enable recording and write all events to the given file when Blender exits. */
+void BKE_geometry_nodes_profile_write_on_exit(const char *filepath);
+
+#ifdef __cplusplus
+}
+#endif
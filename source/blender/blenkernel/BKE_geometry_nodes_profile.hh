@@ -0,0 +1,59 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#pragma once
+
+/** \file
+ * \ingroup bke
+ */
+
+#include <string>
+
+#include "BKE_geometry_nodes_profile.h"
+
+#include "DNA_session_uuid_types.h"
+
+namespace blender::bke {
+
+/** Statistics of a single execution of a node. */
+struct GeometryNodesProfileEvent {
+  SessionUUID modifier_uuid;
+  std::string object_name;
+  std::string modifier_name;
+  std::string node_name;
+  /** Start time, see #geometry_nodes_profile_time_ns. */
+  int64_t start_ns;
+  int64_t duration_ns;
+  /**
+   * CPU time spent by the thread executing the node. Work done by other threads for the node
+   * (e.g. in a parallel loop) is not included, so this is lower than the wall time then.
+   */
+  int64_t thread_duration_ns;
+  /** Number of points, vertices and instances in the geometry outputs. */
+  int64_t elements;
+  /** Size of the output values, including the attribute arrays of geometries. */
+  int64_t bytes;
+};
+
+/** Monotonic time in nanoseconds. */
+int64_t geometry_nodes_profile_time_ns();
+/** CPU time consumed by the calling thread in nanoseconds. */
+int64_t geometry_nodes_profile_thread_time_ns();
+
+/** Record an event executed by the calling thread. This can be called from any thread. */
+void geometry_nodes_profile_add_event(GeometryNodesProfileEvent event);
+
+}  // namespace blender::bke
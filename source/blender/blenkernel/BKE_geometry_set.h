@@ -46,9 +46,7 @@ typedef struct InstancedData {
 } InstancedData;
 
 int BKE_geometry_set_instances(const struct GeometrySet *geometry_set,
-                               float (**r_positions)[3],
-                               float (**r_rotations)[3],
-                               float (**r_scales)[3],
+                               float (**r_transforms)[4][4],
                                struct InstancedData **r_instanced_data);
 
 #ifdef __cplusplus
@@ -24,6 +24,7 @@
 #include <iostream>
 
 #include "BLI_float3.hh"
+#include "BLI_float4x4.hh"
 #include "BLI_hash.hh"
 #include "BLI_map.hh"
 #include "BLI_set.hh"
@@ -75,6 +76,11 @@ class GeometryComponent {
   mutable std::atomic<int> users_ = 1;
   GeometryComponentType type_;
 
+ protected:
+  /* Speeds up repeated lookups of the same attributes, one for the custom data of every domain.
+   * Components have to call #tag_attribute_layers_changed when layers may have changed. */
+  mutable blender::bke::CustomDataLayerIndexCache layer_index_caches_[ATTR_DOMAIN_NUM];
+
  public:
   GeometryComponent(GeometryComponentType type);
   virtual ~GeometryComponent();
@@ -136,6 +142,45 @@ class GeometryComponent {
       const AttributeDomain domain,
       const CustomDataType data_type) const;
 
+  /* Get the array of a generic attribute that is stored with the given type on the given domain,
+   * without creating an attribute accessor. Returns null when there is no such array, e.g. for
+   * attributes that are stored differently, like vertex positions or vertex groups of meshes. */
+  const void *attribute_try_get_array(const blender::StringRef attribute_name,
+                                      const AttributeDomain domain,
+                                      const CustomDataType data_type) const;
+  /* Same as above, but the array can be modified. Shared arrays are copied first. */
+  void *attribute_try_get_array_for_write(const blender::StringRef attribute_name,
+                                          const AttributeDomain domain,
+                                          const CustomDataType data_type);
+
+  /* Typed version of #attribute_try_get_array. Returns an empty span when there is no array. */
+  template<typename T>
+  blender::Span<T> attribute_try_get_span(const blender::StringRef attribute_name,
+                                          const AttributeDomain domain) const
+  {
+    const CustomDataType data_type = blender::bke::cpp_type_to_custom_data_type(
+        blender::fn::CPPType::get<T>());
+    const void *data = this->attribute_try_get_array(attribute_name, domain, data_type);
+    if (data == nullptr) {
+      return {};
+    }
+    return {static_cast<const T *>(data), this->attribute_domain_size(domain)};
+  }
+
+  /* Typed version of #attribute_try_get_array_for_write. */
+  template<typename T>
+  blender::MutableSpan<T> attribute_try_get_span_for_write(const blender::StringRef attribute_name,
+                                                           const AttributeDomain domain)
+  {
+    const CustomDataType data_type = blender::bke::cpp_type_to_custom_data_type(
+        blender::fn::CPPType::get<T>());
+    void *data = this->attribute_try_get_array_for_write(attribute_name, domain, data_type);
+    if (data == nullptr) {
+      return {};
+    }
+    return {static_cast<T *>(data), this->attribute_domain_size(domain)};
+  }
+
   /* Get a read-only attribute interpolated to the input domain, leaving the data type unchanged.
    * Returns null when the attribute does not exist. */
   blender::bke::ReadAttributePtr attribute_try_get_for_read(
@@ -193,6 +238,16 @@ class GeometryComponent {
       const blender::StringRef attribute_name,
       const AttributeDomain domain,
       const CustomDataType data_type);
+
+ protected:
+  /* The custom data storing the generic attributes of the domain, or null. */
+  virtual const CustomData *attribute_custom_data(const AttributeDomain domain) const;
+  /* Same as above, but the geometry is made mutable first. */
+  virtual CustomData *attribute_custom_data_for_write(const AttributeDomain domain);
+  /* Called when layers of the custom data have been reallocated. */
+  virtual void attribute_custom_data_changed();
+  /* Called when layers of the custom data may have been added, removed or renamed. */
+  void tag_attribute_layers_changed();
 };
 
 template<typename T>
@@ -278,6 +333,10 @@ class MeshComponent : public GeometryComponent {
    * group names are stored on an object. Since we don't have an object here, we copy over the
    * names into this map. */
   blender::Map<std::string, int> vertex_group_names_;
+  /* When the mesh has been copied from a shared component, its custom data layers reference the
+   * arrays of that component (see #CD_FLAG_NOFREE). That component is kept alive until this
+   * component does not reference its data anymore, so that only modified layers are copied. */
+  blender::UserCounter<const GeometryComponent> referenced_layers_owner_;
 
  public:
   MeshComponent();
@@ -290,10 +349,16 @@ class MeshComponent : public GeometryComponent {
   Mesh *release();
 
   void copy_vertex_group_names_from_object(const struct Object &object);
+  const blender::Map<std::string, int> &vertex_group_names() const;
 
   const Mesh *get_for_read() const;
   Mesh *get_for_write();
 
+ private:
+  Mesh *get_for_attribute_write();
+  void ensure_owned_layers();
+
+ public:
   bool attribute_domain_supported(const AttributeDomain domain) const final;
   bool attribute_domain_with_type_supported(const AttributeDomain domain,
                                             const CustomDataType data_type) const final;
@@ -314,6 +379,11 @@ class MeshComponent : public GeometryComponent {
   bool is_empty() const final;
 
   static constexpr inline GeometryComponentType static_type = GeometryComponentType::Mesh;
+
+ protected:
+  const CustomData *attribute_custom_data(const AttributeDomain domain) const final;
+  CustomData *attribute_custom_data_for_write(const AttributeDomain domain) final;
+  void attribute_custom_data_changed() final;
 };
 
 /** A geometry component that stores a point cloud. */
@@ -321,6 +391,8 @@ class PointCloudComponent : public GeometryComponent {
  private:
   PointCloud *pointcloud_ = nullptr;
   GeometryOwnershipType ownership_ = GeometryOwnershipType::Owned;
+  /* See #MeshComponent::referenced_layers_owner_. */
+  blender::UserCounter<const GeometryComponent> referenced_layers_owner_;
 
  public:
   PointCloudComponent();
@@ -336,6 +408,12 @@ class PointCloudComponent : public GeometryComponent {
   const PointCloud *get_for_read() const;
   PointCloud *get_for_write();
 
+ private:
+  PointCloud *get_for_attribute_write();
+  void ensure_owned_layers();
+
+ public:
+
   bool attribute_domain_supported(const AttributeDomain domain) const final;
   bool attribute_domain_with_type_supported(const AttributeDomain domain,
                                             const CustomDataType data_type) const final;
@@ -356,14 +434,19 @@ class PointCloudComponent : public GeometryComponent {
   bool is_empty() const final;
 
   static constexpr inline GeometryComponentType static_type = GeometryComponentType::PointCloud;
+
+ protected:
+  const CustomData *attribute_custom_data(const AttributeDomain domain) const final;
+  CustomData *attribute_custom_data_for_write(const AttributeDomain domain) final;
+  void attribute_custom_data_changed() final;
 };
 
 /** A geometry component that stores instances. */
 class InstancesComponent : public GeometryComponent {
  private:
-  blender::Vector<blender::float3> positions_;
-  blender::Vector<blender::float3> rotations_;
-  blender::Vector<blender::float3> scales_;
+  /* Only the transforms and references to the instanced data are stored per instance. The
+   * instanced geometry itself is shared and only realized when the instances are drawn. */
+  blender::Vector<blender::float4x4> transforms_;
   blender::Vector<InstancedData> instanced_data_;
 
  public:
@@ -372,24 +455,16 @@ class InstancesComponent : public GeometryComponent {
   GeometryComponent *copy() const override;
 
   void clear();
-  void add_instance(Object *object,
-                    blender::float3 position,
-                    blender::float3 rotation = {0, 0, 0},
-                    blender::float3 scale = {1, 1, 1});
-  void add_instance(Collection *collection,
-                    blender::float3 position,
-                    blender::float3 rotation = {0, 0, 0},
-                    blender::float3 scale = {1, 1, 1});
-  void add_instance(InstancedData data,
-                    blender::float3 position,
-                    blender::float3 rotation,
-                    blender::float3 scale);
+  void reserve(const int amount);
+  void add_instance(Object *object, const blender::float4x4 &transform);
+  void add_instance(Collection *collection, const blender::float4x4 &transform);
+  void add_instance(const InstancedData &data, const blender::float4x4 &transform);
+  void add_instances(blender::Span<InstancedData> instanced_data,
+                     blender::Span<blender::float4x4> transforms);
 
   blender::Span<InstancedData> instanced_data() const;
-  blender::Span<blender::float3> positions() const;
-  blender::Span<blender::float3> rotations() const;
-  blender::Span<blender::float3> scales() const;
-  blender::MutableSpan<blender::float3> positions();
+  blender::Span<blender::float4x4> transforms() const;
+  blender::MutableSpan<blender::float4x4> transforms();
   int instances_amount() const;
 
   bool is_empty() const final;
@@ -156,6 +156,8 @@ enum {
   G_DEBUG_XR_TIME = (1 << 22),               /* XR/OpenXR timing messages */
 
   G_DEBUG_GHOST = (1 << 23), /* Debug GHOST module. */
+
+  G_DEBUG_GEOMETRY_NODES_PROFILE = (1 << 24), /* Record per-node geometry nodes timings. */
 };
 
 #define G_DEBUG_ALL \
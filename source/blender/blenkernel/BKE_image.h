@@ -234,6 +234,10 @@ void BKE_image_ensure_viewer_views(const struct RenderData *rd,
 void BKE_image_user_frame_calc(struct Image *ima, struct ImageUser *iuser, int cfra);
 int BKE_image_user_frame_get(const struct ImageUser *iuser, int cfra, bool *r_is_in_range);
 void BKE_image_user_file_path(struct ImageUser *iuser, struct Image *ima, char *path);
+
+/* load image sequence files of upcoming frames in the background */
+void BKE_image_prefetch_frame(struct Image *ima, struct ImageUser *iuser, int cfra);
+void BKE_image_prefetch_discard(int cfra);
 void BKE_image_editors_update_frame(const struct Main *bmain, int cfra);
 
 /* dependency graph update for image user users */
@@ -41,6 +41,17 @@ struct Mesh;
 struct Object;
 struct Scene;
 
+/**
+ * Kind of change made to a mesh, used to only free the runtime caches depending on it.
+ * See #BKE_mesh_runtime_tag_dirty.
+ */
+typedef enum eMeshRuntimeDirtyFlag {
+  /** Vertex coordinates changed (deformation), the topology is the same. */
+  ME_RUNTIME_DIRTY_POSITIONS = (1 << 0),
+  /** Number, order or connectivity of vertices, edges, loops or polygons changed. */
+  ME_RUNTIME_DIRTY_TOPOLOGY = (1 << 1),
+} eMeshRuntimeDirtyFlag;
+
 void BKE_mesh_runtime_reset(struct Mesh *mesh);
 void BKE_mesh_runtime_reset_on_copy(struct Mesh *mesh, const int flag);
 int BKE_mesh_runtime_looptri_len(const struct Mesh *mesh);
@@ -49,6 +60,7 @@ const struct MLoopTri *BKE_mesh_runtime_looptri_ensure(struct Mesh *mesh);
 bool BKE_mesh_runtime_ensure_edit_data(struct Mesh *mesh);
 bool BKE_mesh_runtime_clear_edit_data(struct Mesh *mesh);
 bool BKE_mesh_runtime_reset_edit_data(struct Mesh *mesh);
+void BKE_mesh_runtime_tag_dirty(struct Mesh *mesh, const int dirty_flag);
 void BKE_mesh_runtime_clear_geometry(struct Mesh *mesh);
 void BKE_mesh_runtime_clear_cache(struct Mesh *mesh);
 
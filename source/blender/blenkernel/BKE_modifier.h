@@ -290,6 +290,22 @@ typedef struct ModifierTypeInfo {
                            struct ModifierData *md,
                            struct CustomData_MeshMasks *r_cddata_masks);
 
+  /**
+   * Should add to passed \a r_cddata_masks the CustomData types written by the modifier.
+   * Only meaningful for #eModifierTypeType_NonGeometrical modifiers, which leave every
+   * other data of the mesh untouched.
+   *
+   * Adjacent modifiers which do not read or write the data written by each other can be
+   * evaluated concurrently, their results are then merged back into one mesh.
+   *
+   * If this function is not present, the modifier is always evaluated on its own.
+   *
+   * This function is optional.
+   */
+  void (*writtenDataMask)(struct Object *ob,
+                          struct ModifierData *md,
+                          struct CustomData_MeshMasks *r_cddata_masks);
+
   /**
    * Free internal modifier data variables, this function should
    * not free the md variable itself.
@@ -36,12 +36,15 @@
 #include "DNA_scene_types.h"
 
 #include "BLI_array.h"
+#include "BLI_array.hh"
 #include "BLI_bitmap.h"
 #include "BLI_blenlib.h"
 #include "BLI_float2.hh"
 #include "BLI_linklist.h"
 #include "BLI_math.h"
+#include "BLI_span.hh"
 #include "BLI_task.h"
+#include "BLI_task.hh"
 #include "BLI_utildefines.h"
 #include "BLI_vector.hh"
 
@@ -932,6 +935,223 @@ static Mesh *modifier_modify_mesh_and_geometry_set(ModifierData *md,
   return mesh_output;
 }
 
+static bool mesh_masks_overlap(const CustomData_MeshMasks *a, const CustomData_MeshMasks *b)
+{
+  return (a->vmask & b->vmask) || (a->emask & b->emask) || (a->fmask & b->fmask) ||
+         (a->pmask & b->pmask) || (a->lmask & b->lmask);
+}
+
+static void modifier_uses_texture_cb(void *userData,
+                                     Object *UNUSED(ob),
+                                     ID **idpoin,
+                                     int UNUSED(cb_flag))
+{
+  if (*idpoin && GS((*idpoin)->name) == ID_TE) {
+    *(bool *)userData = true;
+  }
+}
+
+static bool modifier_uses_texture(ModifierData *md, Object *ob)
+{
+  const ModifierTypeInfo *mti = BKE_modifier_get_info((ModifierType)md->type);
+  bool uses_texture = false;
+  if (mti->foreachIDLink) {
+    mti->foreachIDLink(md, ob, modifier_uses_texture_cb, &uses_texture);
+  }
+  return uses_texture;
+}
+
+/**
+ * Collect the modifiers, starting at \a md, that can be evaluated concurrently. These are adjacent
+ * non-geometrical modifiers declaring the data they write, where none of them reads or writes
+ * data written by another one of the group. Geometry is implicitly read by all modifiers.
+ *
+ * \param r_written_mask: The data written by any modifier of the group.
+ */
+static blender::Vector<ModifierData *> mesh_calc_modifiers_independent_group(
+    Scene *scene,
+    Object *ob,
+    ModifierData *md,
+    CDMaskLink *md_datamask,
+    const CustomData_MeshMasks *final_datamask,
+    const int required_mode,
+    const int useDeform,
+    const bool need_mapping,
+    CustomData_MeshMasks *r_written_mask)
+{
+  blender::Vector<ModifierData *> group;
+  CustomData_MeshMasks group_read_mask = {0};
+  CustomData_MeshMasks group_written_mask = {0};
+
+  for (; md; md = md->next, md_datamask = md_datamask->next) {
+    const ModifierTypeInfo *mti = BKE_modifier_get_info((ModifierType)md->type);
+
+    if (!BKE_modifier_is_enabled(scene, md, required_mode)) {
+      break;
+    }
+    if (mti->type != eModifierTypeType_NonGeometrical || mti->writtenDataMask == nullptr ||
+        mti->modifyMesh == nullptr || mti->modifyGeometrySet != nullptr) {
+      break;
+    }
+    /* Normals would be computed concurrently into the shared vertex array. */
+    if (mti->dependsOnNormals && mti->dependsOnNormals(md)) {
+      break;
+    }
+    if (need_mapping && !BKE_modifier_supports_mapping(md)) {
+      break;
+    }
+    if (useDeform < 0 && mti->dependsOnTime && mti->dependsOnTime(md)) {
+      break;
+    }
+    /* Evaluating a texture updates its image user, which may be shared with other modifiers. */
+    if (modifier_uses_texture(md, ob)) {
+      break;
+    }
+    /* Orco meshes and original space layers are evaluated along with each modifier, also when
+     * only the following modifiers need them. */
+    const CustomData_MeshMasks *next_mask = md_datamask->next ? &md_datamask->next->mask :
+                                                                final_datamask;
+    if (((md_datamask->mask.vmask | next_mask->vmask) & (CD_MASK_ORCO | CD_MASK_CLOTH_ORCO)) ||
+        (md_datamask->mask.lmask & CD_MASK_ORIGSPACE_MLOOP)) {
+      break;
+    }
+
+    CustomData_MeshMasks read_mask = CD_MASK_BAREMESH;
+    CustomData_MeshMasks written_mask = {0};
+    if (mti->requiredDataMask) {
+      mti->requiredDataMask(ob, md, &read_mask);
+    }
+    mti->writtenDataMask(ob, md, &written_mask);
+    CustomData_MeshMasks_update(&read_mask, &written_mask);
+
+    if (mesh_masks_overlap(&written_mask, &group_read_mask) ||
+        mesh_masks_overlap(&read_mask, &group_written_mask)) {
+      break;
+    }
+
+    group.append(md);
+    CustomData_MeshMasks_update(&group_read_mask, &read_mask);
+    CustomData_MeshMasks_update(&group_written_mask, &written_mask);
+  }
+
+  *r_written_mask = group_written_mask;
+  return group;
+}
+
+/**
+ * Replace the layers of the types in \a mask in \a data_dst by the ones of \a data_src.
+ * Ownership of the layer data is moved, \a data_src only keeps references to it.
+ */
+static void mesh_customdata_move_layers(CustomData *data_src,
+                                        CustomData *data_dst,
+                                        const CustomDataMask mask,
+                                        const int totelem)
+{
+  if (mask == 0) {
+    return;
+  }
+
+  /* Layers not written by the modifier still reference the data of the destination. */
+  for (int i = 0; i < data_src->totlayer; i++) {
+    CustomDataLayer *layer = &data_src->layers[i];
+    if (mask & CD_TYPE_AS_MASK(layer->type)) {
+      const int n = i - CustomData_get_layer_index(data_src, layer->type);
+      CustomData_duplicate_referenced_layer_n(data_src, layer->type, n, totelem);
+    }
+  }
+
+  for (int type = 0; type < CD_NUMTYPES; type++) {
+    if (mask & CD_TYPE_AS_MASK(type)) {
+      CustomData_free_layers(data_dst, type, totelem);
+    }
+  }
+
+  CustomData_merge(data_src, data_dst, mask, CD_ASSIGN, totelem);
+
+  for (int i = 0; i < data_src->totlayer; i++) {
+    CustomDataLayer *layer = &data_src->layers[i];
+    if (mask & CD_TYPE_AS_MASK(layer->type)) {
+      layer->flag |= CD_FLAG_NOFREE;
+    }
+  }
+}
+
+/**
+ * Evaluate a group built by #mesh_calc_modifiers_independent_group concurrently. Every modifier
+ * is given its own copy of \a mesh referencing all of its data, afterwards the data written by
+ * each modifier is moved back into \a mesh.
+ */
+static void mesh_calc_modifiers_independent(blender::Span<ModifierData *> mds,
+                                            const ModifierEvalContext &mectx,
+                                            Object *ob,
+                                            Mesh *mesh)
+{
+  BKE_mesh_wrapper_ensure_mdata(mesh);
+
+  blender::Array<Mesh *> results(mds.size());
+  blender::parallel_for(mds.index_range(), 1, [&](blender::IndexRange range) {
+    for (const int i : range) {
+      Mesh *mesh_copy = BKE_mesh_copy_for_eval(mesh, true);
+      Mesh *result = BKE_modifier_modify_mesh(mds[i], &mectx, mesh_copy);
+      if (result != mesh_copy) {
+        BKE_id_free(nullptr, mesh_copy);
+      }
+      results[i] = result;
+    }
+  });
+
+  for (const int i : mds.index_range()) {
+    Mesh *result = results[i];
+    if (result == nullptr) {
+      continue;
+    }
+    BLI_assert(result->totvert == mesh->totvert && result->totedge == mesh->totedge &&
+               result->totpoly == mesh->totpoly && result->totloop == mesh->totloop);
+
+    const ModifierTypeInfo *mti = BKE_modifier_get_info((ModifierType)mds[i]->type);
+    CustomData_MeshMasks written_mask = {0};
+    mti->writtenDataMask(ob, mds[i], &written_mask);
+
+    mesh_customdata_move_layers(&result->vdata, &mesh->vdata, written_mask.vmask, mesh->totvert);
+    mesh_customdata_move_layers(&result->edata, &mesh->edata, written_mask.emask, mesh->totedge);
+    mesh_customdata_move_layers(&result->ldata, &mesh->ldata, written_mask.lmask, mesh->totloop);
+    mesh_customdata_move_layers(&result->pdata, &mesh->pdata, written_mask.pmask, mesh->totpoly);
+    BKE_id_free(nullptr, result);
+  }
+
+  BKE_mesh_update_customdata_pointers(mesh, false);
+}
+
+/**
+ * Check whether the leading deform-only modifiers of the stack can all be passed the same
+ * evaluated mesh instead of null. Without a mesh, every deform modifier that needs topology or
+ * attributes creates its own copy of the input mesh (see #MOD_deform_mesh_eval_get), while a
+ * single copy that references the input topology can be shared by the whole run of deformers.
+ *
+ * Physics modifiers take a snapshot of the mesh they are given and behave differently when there
+ * is none, so stacks containing them keep passing null.
+ */
+static bool mesh_calc_modifiers_use_shared_deform_mesh(Scene *scene,
+                                                       ModifierData *md,
+                                                       const int required_mode)
+{
+  for (; md; md = md->next) {
+    if (!BKE_modifier_is_enabled(scene, md, required_mode)) {
+      continue;
+    }
+    const ModifierTypeInfo *mti = BKE_modifier_get_info((ModifierType)md->type);
+    if (mti->type != eModifierTypeType_OnlyDeform) {
+      /* Deform modifiers after a constructive one are passed the evaluated mesh anyway. */
+      return true;
+    }
+    if (mti->flags & (eModifierTypeFlag_UsesPointCache | eModifierTypeFlag_Single |
+                      eModifierTypeFlag_NoUserAdd)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 static void mesh_calc_modifiers(struct Depsgraph *depsgraph,
                                 Scene *scene,
                                 Object *ob,
@@ -1024,6 +1244,13 @@ static void mesh_calc_modifiers(struct Depsgraph *depsgraph,
 
   /* Apply all leading deform modifiers. */
   if (useDeform) {
+    /* Pass one mesh sharing the input topology through the whole run of deform modifiers. Its
+     * coordinates are only updated from `deformed_verts` when a modifier needs normals, the
+     * final normals are computed once all modifiers are evaluated. */
+    const bool use_shared_deform_mesh = !sculpt_dyntopo &&
+                                        mesh_calc_modifiers_use_shared_deform_mesh(
+                                            scene, md, required_mode);
+
     for (; md; md = md->next, md_datamask = md_datamask->next) {
       const ModifierTypeInfo *mti = BKE_modifier_get_info((ModifierType)md->type);
 
@@ -1036,14 +1263,21 @@ static void mesh_calc_modifiers(struct Depsgraph *depsgraph,
       }
 
       if (mti->type == eModifierTypeType_OnlyDeform && !sculpt_dyntopo) {
+        const bool depends_on_normals = mti->dependsOnNormals && mti->dependsOnNormals(md);
         if (!deformed_verts) {
           deformed_verts = BKE_mesh_vert_coords_alloc(mesh_input, &num_deformed_verts);
-        }
-        else if (isPrevDeform && mti->dependsOnNormals && mti->dependsOnNormals(md)) {
-          if (mesh_final == nullptr) {
+          if (use_shared_deform_mesh) {
             mesh_final = BKE_mesh_copy_for_eval(mesh_input, true);
             ASSERT_IS_VALID_MESH(mesh_final);
           }
+        }
+        else if (isPrevDeform && depends_on_normals && mesh_final == nullptr) {
+          mesh_final = BKE_mesh_copy_for_eval(mesh_input, true);
+          ASSERT_IS_VALID_MESH(mesh_final);
+        }
+        if (mesh_final && depends_on_normals) {
+          /* Also makes sure the vertex layer is not shared with the input mesh anymore,
+           * normals are written to it. */
           BKE_mesh_vert_coords_apply(mesh_final, deformed_verts);
         }
 
@@ -1225,6 +1459,21 @@ static void mesh_calc_modifiers(struct Depsgraph *depsgraph,
         }
       }
 
+      /* Independent modifiers following this one are evaluated concurrently with it. */
+      blender::Vector<ModifierData *> independent_mds;
+      CustomData_MeshMasks independent_written_mask = {0};
+      if (index == -1 && !sculpt_mode) {
+        independent_mds = mesh_calc_modifiers_independent_group(scene,
+                                                                ob,
+                                                                md,
+                                                                md_datamask,
+                                                                &final_datamask,
+                                                                required_mode,
+                                                                useDeform,
+                                                                need_mapping,
+                                                                &independent_written_mask);
+      }
+
       /* set the Mesh to only copy needed data */
       CustomData_MeshMasks mask = md_datamask->mask;
       /* needMapping check here fixes bug T28112, otherwise it's
@@ -1235,6 +1484,10 @@ static void mesh_calc_modifiers(struct Depsgraph *depsgraph,
         mask.emask |= CD_MASK_ORIGINDEX;
         mask.pmask |= CD_MASK_ORIGINDEX;
       }
+      if (independent_mds.size() > 1) {
+        /* Keep the data written by all modifiers of the group, not only by the first one. */
+        CustomData_MeshMasks_update(&mask, &independent_written_mask);
+      }
       mesh_set_only_copy(mesh_final, &mask);
 
       /* add cloth rest shape key if needed */
@@ -1251,8 +1504,23 @@ static void mesh_calc_modifiers(struct Depsgraph *depsgraph,
         }
       }
 
-      Mesh *mesh_next = modifier_modify_mesh_and_geometry_set(
-          md, mectx, ob, mesh_final, geometry_set_final);
+      Mesh *mesh_next;
+      if (independent_mds.size() > 1) {
+        mesh_calc_modifiers_independent(independent_mds, mectx, ob, mesh_final);
+        mesh_next = mesh_final;
+        while (md != independent_mds.last()) {
+          md = md->next;
+          md_datamask = md_datamask->next;
+        }
+        /* Continue with the last modifier of the group, none of the orco meshes are needed. */
+        mti = BKE_modifier_get_info((ModifierType)md->type);
+        nextmask = md_datamask->next ? md_datamask->next->mask : final_datamask;
+        BLI_assert((nextmask.vmask & (CD_MASK_ORCO | CD_MASK_CLOTH_ORCO)) == 0);
+      }
+      else {
+        mesh_next = modifier_modify_mesh_and_geometry_set(
+            md, mectx, ob, mesh_final, geometry_set_final);
+      }
       ASSERT_IS_VALID_MESH(mesh_next);
 
       if (mesh_next) {
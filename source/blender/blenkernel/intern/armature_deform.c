@@ -55,6 +55,10 @@
 
 #include "CLG_log.h"
 
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
 static CLG_LogRef LOG = {"bke.armature_deform"};
 
 /* -------------------------------------------------------------------- */
@@ -229,6 +233,63 @@ static void pchan_bone_deform(bPoseChannel *pchan,
   (*contrib) += weight;
 }
 
+#ifdef __SSE2__
+/**
+ * SSE2 version of the linear blending of #pchan_deform_accumulate. The offset is accumulated in
+ * \a vec_accum, so it can stay in a register for all the bones of a vertex.
+ */
+BLI_INLINE __m128 deform_mat_accumulate_sse2(const float deform_mat[4][4],
+                                             const __m128 co,
+                                             float weight,
+                                             __m128 vec_accum)
+{
+  const __m128 co_x = _mm_shuffle_ps(co, co, _MM_SHUFFLE(0, 0, 0, 0));
+  const __m128 co_y = _mm_shuffle_ps(co, co, _MM_SHUFFLE(1, 1, 1, 1));
+  const __m128 co_z = _mm_shuffle_ps(co, co, _MM_SHUFFLE(2, 2, 2, 2));
+  __m128 tmp = _mm_mul_ps(_mm_loadu_ps(deform_mat[0]), co_x);
+  tmp = _mm_add_ps(tmp, _mm_mul_ps(_mm_loadu_ps(deform_mat[1]), co_y));
+  tmp = _mm_add_ps(tmp, _mm_mul_ps(_mm_loadu_ps(deform_mat[2]), co_z));
+  tmp = _mm_add_ps(tmp, _mm_loadu_ps(deform_mat[3]));
+  tmp = _mm_sub_ps(tmp, co);
+  return _mm_add_ps(vec_accum, _mm_mul_ps(tmp, _mm_set1_ps(weight)));
+}
+
+/** SSE2 version of #add_weighted_dq_dq. */
+BLI_INLINE void add_weighted_dq_dq_sse2(DualQuat *dq_sum, const DualQuat *dq, float weight)
+{
+  const __m128 quat = _mm_loadu_ps(dq->quat);
+  const __m128 quat_sum = _mm_loadu_ps(dq_sum->quat);
+
+  /* Make sure we interpolate quats in the right direction. This is a branch rather than a select,
+   * so blending the next bone doesn't wait for the dot product. */
+  __m128 dot = _mm_mul_ps(quat, quat_sum);
+  dot = _mm_add_ps(dot, _mm_shuffle_ps(dot, dot, _MM_SHUFFLE(1, 0, 3, 2)));
+  dot = _mm_add_ss(dot, _mm_shuffle_ps(dot, dot, _MM_SHUFFLE(0, 0, 0, 1)));
+  float weight_rot = weight;
+  if (UNLIKELY(_mm_cvtss_f32(dot) < 0.0f)) {
+    weight_rot = -weight;
+  }
+  const __m128 weight_rot_vec = _mm_set1_ps(weight_rot);
+
+  /* Interpolate rotation and translation. */
+  _mm_storeu_ps(dq_sum->quat, _mm_add_ps(quat_sum, _mm_mul_ps(quat, weight_rot_vec)));
+  _mm_storeu_ps(dq_sum->trans,
+                _mm_add_ps(_mm_loadu_ps(dq_sum->trans),
+                           _mm_mul_ps(_mm_loadu_ps(dq->trans), weight_rot_vec)));
+
+  /* Interpolate scale with the weight which is never negative, only if there is scale present. */
+  if (dq->scale_weight) {
+    const __m128 weight_scale = _mm_set1_ps(weight);
+    for (int i = 0; i < 4; i++) {
+      _mm_storeu_ps(dq_sum->scale[i],
+                    _mm_add_ps(_mm_loadu_ps(dq_sum->scale[i]),
+                               _mm_mul_ps(_mm_loadu_ps(dq->scale[i]), weight_scale)));
+    }
+    dq_sum->scale_weight += weight;
+  }
+}
+#endif
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
@@ -237,6 +298,23 @@ static void pchan_bone_deform(bPoseChannel *pchan,
  * #BKE_armature_deform_coords and related functions.
  * \{ */
 
+/**
+ * Deform data of the bone of a vertex group, copied from its pose channel into an array indexed by
+ * the vertex group, so the weights of a vertex are blended from compact memory.
+ */
+typedef struct ArmatureDeformBone {
+  /** Null for vertex groups without a deforming bone. */
+  bPoseChannel *pchan;
+  /** Copy of #bPoseChannel.chan_mat. */
+  float mat[4][4];
+  /** Copy of #bPoseChannel_Runtime.deform_dual_quat. */
+  DualQuat dq;
+  /** The B-Bone segments affecting a vertex are looked up in the pose channel. */
+  bool use_bbone;
+  /** Weights are multiplied with the envelope of the bone, see #BONE_MULT_VG_ENV. */
+  bool use_envelope_multiply;
+} ArmatureDeformBone;
+
 typedef struct ArmatureUserdata {
   const Object *ob_arm;
   const Object *ob_target;
@@ -255,7 +333,7 @@ typedef struct ArmatureUserdata {
   const MDeformVert *dverts;
   int dverts_len;
 
-  bPoseChannel **pchan_from_defbase;
+  const ArmatureDeformBone *bone_from_defbase;
   int defbase_len;
 
   float premat[4][4];
@@ -331,22 +409,60 @@ static void armature_vert_task_with_dvert(const ArmatureUserdata *data,
     const MDeformWeight *dw = dvert->dw;
     int deformed = 0;
     unsigned int j;
+#ifdef __SSE2__
+    const __m128 co_sse = _mm_setr_ps(co[0], co[1], co[2], 0.0f);
+    __m128 vec_sse = _mm_setzero_ps();
+#endif
     for (j = dvert->totweight; j != 0; j--, dw++) {
       const uint index = dw->def_nr;
-      if (index < data->defbase_len && (pchan = data->pchan_from_defbase[index])) {
-        float weight = dw->weight;
-        Bone *bone = pchan->bone;
+      if (index >= data->defbase_len || data->bone_from_defbase[index].pchan == NULL) {
+        continue;
+      }
+      const ArmatureDeformBone *deform_bone = &data->bone_from_defbase[index];
+      float weight = dw->weight;
 
-        deformed = 1;
+      deformed = 1;
 
-        if (bone && bone->flag & BONE_MULT_VG_ENV) {
-          weight *= distfactor_to_bone(
-              co, bone->arm_head, bone->arm_tail, bone->rad_head, bone->rad_tail, bone->dist);
-        }
+      if (deform_bone->use_envelope_multiply) {
+        const Bone *bone = deform_bone->pchan->bone;
+        weight *= distfactor_to_bone(
+            co, bone->arm_head, bone->arm_tail, bone->rad_head, bone->rad_tail, bone->dist);
+      }
 
-        pchan_bone_deform(pchan, weight, vec, dq, smat, co, &contrib);
+      if (weight == 0.0f) {
+        continue;
       }
+
+      if (deform_bone->use_bbone) {
+        b_bone_deform(deform_bone->pchan, co, weight, vec, dq, smat);
+      }
+      else {
+#ifdef __SSE2__
+        if (dq) {
+          add_weighted_dq_dq_sse2(dq, &deform_bone->dq, weight);
+        }
+        else {
+          vec_sse = deform_mat_accumulate_sse2(deform_bone->mat, co_sse, weight, vec_sse);
+          if (smat) {
+            float tmpmat[3][3];
+            copy_m3_m4(tmpmat, deform_bone->mat);
+            madd_m3_m3m3fl(smat, smat, tmpmat, weight);
+          }
+        }
+#else
+        pchan_deform_accumulate(&deform_bone->dq, deform_bone->mat, co, weight, vec, dq, smat);
+#endif
+      }
+
+      contrib += weight;
+    }
+#ifdef __SSE2__
+    if (vec) {
+      float vec_sum[4];
+      _mm_storeu_ps(vec_sum, vec_sse);
+      add_v3_v3(vec, vec_sum);
     }
+#endif
     /* If there are vertex-groups but not groups with bones (like for soft-body groups). */
     if (deformed == 0 && use_envelope) {
       for (pchan = data->ob_arm->pose->chanbase.first; pchan; pchan = pchan->next) {
@@ -472,7 +588,7 @@ static void armature_deform_coords_impl(const Object *ob_arm,
                                         bGPDstroke *gps_target)
 {
   bArmature *arm = ob_arm->data;
-  bPoseChannel **pchan_from_defbase = NULL;
+  ArmatureDeformBone *bone_from_defbase = NULL;
   const MDeformVert *dverts = NULL;
   bDeformGroup *dg;
   const bool use_envelope = (deformflag & ARM_DEF_ENVELOPE) != 0;
@@ -542,19 +658,25 @@ static void armature_deform_coords_impl(const Object *ob_arm,
       }
 
       if (use_dverts) {
-        pchan_from_defbase = MEM_callocN(sizeof(*pchan_from_defbase) * defbase_len, "defnrToBone");
+        bone_from_defbase = MEM_callocN(sizeof(*bone_from_defbase) * defbase_len, "defnrToBone");
         /* TODO(sergey): Some considerations here:
          *
          * - Check whether keeping this consistent across frames gives speedup.
          */
         for (i = 0, dg = ob_target->defbase.first; dg; i++, dg = dg->next) {
-          pchan_from_defbase[i] = BKE_pose_channel_find_name(ob_arm->pose, dg->name);
+          bPoseChannel *pchan = BKE_pose_channel_find_name(ob_arm->pose, dg->name);
           /* exclude non-deforming bones */
-          if (pchan_from_defbase[i]) {
-            if (pchan_from_defbase[i]->bone->flag & BONE_NO_DEFORM) {
-              pchan_from_defbase[i] = NULL;
-            }
+          if (pchan == NULL || (pchan->bone->flag & BONE_NO_DEFORM)) {
+            continue;
           }
+          const Bone *bone = pchan->bone;
+          ArmatureDeformBone *deform_bone = &bone_from_defbase[i];
+          deform_bone->pchan = pchan;
+          copy_m4_m4(deform_bone->mat, pchan->chan_mat);
+          deform_bone->dq = pchan->runtime.deform_dual_quat;
+          deform_bone->use_bbone = (bone->segments > 1 &&
+                                    pchan->runtime.bbone_segments == bone->segments);
+          deform_bone->use_envelope_multiply = (bone->flag & BONE_MULT_VG_ENV) != 0;
         }
       }
     }
@@ -574,7 +696,7 @@ static void armature_deform_coords_impl(const Object *ob_arm,
       .armature_def_nr = armature_def_nr,
       .dverts = dverts,
       .dverts_len = dverts_len,
-      .pchan_from_defbase = pchan_from_defbase,
+      .bone_from_defbase = bone_from_defbase,
       .defbase_len = defbase_len,
       .bmesh =
           {
@@ -604,12 +726,14 @@ static void armature_deform_coords_impl(const Object *ob_arm,
   else {
     TaskParallelSettings settings;
     BLI_parallel_range_settings_defaults(&settings);
-    settings.min_iter_per_thread = 32;
+    /* Blocks large enough for the coordinates and weights of a task to stay in cache,
+     * while leaving enough tasks for all threads on dense meshes. */
+    settings.min_iter_per_thread = 1024;
     BLI_task_parallel_range(0, vert_coords_len, &data, armature_vert_task, &settings);
   }
 
-  if (pchan_from_defbase) {
-    MEM_freeN(pchan_from_defbase);
+  if (bone_from_defbase) {
+    MEM_freeN(bone_from_defbase);
   }
 }
 
@@ -40,6 +40,7 @@ static CLG_LogRef LOG = {"bke.attribute_access"};
 using blender::float3;
 using blender::Set;
 using blender::StringRef;
+using blender::bke::CustomDataLayerIndexCache;
 using blender::bke::ReadAttributePtr;
 using blender::bke::WriteAttributePtr;
 
@@ -84,6 +85,36 @@ void ReadAttribute::initialize_span() const
   }
 }
 
+fn::GSpan ReadAttribute::get_chunk(const IndexRange range, void *r_buffer) const
+{
+  BLI_assert(range.one_after_last() <= size_);
+  const fn::GSpan array = this->get_array_internal();
+  if (!array.is_empty()) {
+    return fn::GSpan(
+        cpp_type_, POINTER_OFFSET(array.data(), range.start() * cpp_type_.size()), range.size());
+  }
+  this->get_range_internal(range, r_buffer);
+  return fn::GSpan(cpp_type_, r_buffer, range.size());
+}
+
+bool ReadAttribute::is_single_internal() const
+{
+  return false;
+}
+
+fn::GSpan ReadAttribute::get_array_internal() const
+{
+  return fn::GSpan(cpp_type_);
+}
+
+void ReadAttribute::get_range_internal(const IndexRange range, void *r_buffer) const
+{
+  const int element_size = cpp_type_.size();
+  for (const int i : IndexRange(range.size())) {
+    this->get_internal(range[i], POINTER_OFFSET(r_buffer, i * element_size));
+  }
+}
+
 WriteAttribute::~WriteAttribute()
 {
   if (array_should_be_applied_) {
@@ -252,6 +283,11 @@ template<typename T> class ArrayReadAttribute final : public ReadAttribute {
     array_buffer_ = const_cast<T *>(data_.data());
     array_is_temporary_ = false;
   }
+
+  fn::GSpan get_array_internal() const override
+  {
+    return data_;
+  }
 };
 
 template<typename StructT, typename ElemT, typename GetFuncT, typename SetFuncT>
@@ -308,6 +344,13 @@ class DerivedArrayReadAttribute final : public ReadAttribute {
     const ElemT value = get_function_(struct_value);
     new (r_value) ElemT(value);
   }
+  void get_range_internal(const IndexRange range, void *r_buffer) const override
+  {
+    ElemT *r_values = static_cast<ElemT *>(r_buffer);
+    for (const int i : IndexRange(range.size())) {
+      new (r_values + i) ElemT(get_function_(data_[range[i]]));
+    }
+  }
 };
 
 class ConstantReadAttribute final : public ReadAttribute {
@@ -336,6 +379,11 @@ class ConstantReadAttribute final : public ReadAttribute {
     this->cpp_type_.copy_to_uninitialized(value_, r_value);
   }
 
+  bool is_single_internal() const override
+  {
+    return true;
+  }
+
   void initialize_span() const override
   {
     const int element_size = cpp_type_.size();
@@ -343,6 +391,11 @@ class ConstantReadAttribute final : public ReadAttribute {
     array_is_temporary_ = true;
     cpp_type_.fill_uninitialized(value_, array_buffer_, size_);
   }
+
+  void get_range_internal(const IndexRange range, void *r_buffer) const override
+  {
+    cpp_type_.fill_uninitialized(value_, r_buffer, range.size());
+  }
 };
 
 class ConvertedReadAttribute final : public ReadAttribute {
@@ -354,6 +407,8 @@ class ConvertedReadAttribute final : public ReadAttribute {
 
   static constexpr int MaxValueSize = 64;
   static constexpr int MaxValueAlignment = 64;
+  /* Number of values converted with one call of the conversion function in range reads. */
+  static constexpr int64_t RangeBlockSize = 64;
 
  public:
   ConvertedReadAttribute(ReadAttributePtr base_attribute, const CPPType &to_type)
@@ -375,6 +430,38 @@ class ConvertedReadAttribute final : public ReadAttribute {
     base_attribute_->get(index, buffer.ptr());
     conversions_.convert(from_type_, to_type_, buffer.ptr(), r_value);
   }
+
+  bool is_single_internal() const override
+  {
+    return base_attribute_->is_single();
+  }
+
+  void get_range_internal(const IndexRange range, void *r_buffer) const override
+  {
+    const fn::MultiFunction *fn = conversions_.get_conversion(
+        fn::MFDataType::ForSingle(from_type_), fn::MFDataType::ForSingle(to_type_));
+    BLI_assert(fn != nullptr);
+
+    /* Read the base values in blocks that fit in a stack buffer, and convert each block with
+     * a single call of the conversion function. */
+    AlignedBuffer<MaxValueSize * RangeBlockSize, MaxValueAlignment> buffer;
+    for (int64_t start = 0; start < range.size(); start += RangeBlockSize) {
+      const IndexRange block(range.start() + start,
+                             std::min(RangeBlockSize, range.size() - start));
+      const fn::GSpan from_values = base_attribute_->get_chunk(block, buffer.ptr());
+
+      fn::MFContextBuilder context;
+      fn::MFParamsBuilder params{*fn, block.size()};
+      params.add_readonly_single_input(from_values);
+      params.add_uninitialized_single_output(fn::GMutableSpan(
+          to_type_, POINTER_OFFSET(r_buffer, start * to_type_.size()), block.size()));
+      fn->call(IndexRange(block.size()), params, context);
+
+      if (from_values.data() == buffer.ptr()) {
+        from_type_.destruct_n(buffer.ptr(), block.size());
+      }
+    }
+  }
 };
 
 /** \} */
@@ -423,6 +510,53 @@ CustomDataType cpp_type_to_custom_data_type(const blender::fn::CPPType &type)
   return static_cast<CustomDataType>(-1);
 }
 
+static bool custom_data_layer_is_generic(const CustomDataLayer &layer)
+{
+  return custom_data_type_to_cpp_type(static_cast<CustomDataType>(layer.type)) != nullptr;
+}
+
+static int find_generic_custom_data_layer(const CustomData &custom_data, const StringRef name)
+{
+  for (const int index : IndexRange(custom_data.totlayer)) {
+    const CustomDataLayer &layer = custom_data.layers[index];
+    if (layer.name == name && custom_data_layer_is_generic(layer)) {
+      return index;
+    }
+  }
+  return -1;
+}
+
+int CustomDataLayerIndexCache::find(const CustomData &custom_data, const StringRef name)
+{
+  int state = state_.load(std::memory_order_acquire);
+  if (state == Dirty && state_.compare_exchange_strong(state, Building)) {
+    index_by_name_.clear();
+    for (const int index : IndexRange(custom_data.totlayer)) {
+      const CustomDataLayer &layer = custom_data.layers[index];
+      if (custom_data_layer_is_generic(layer)) {
+        index_by_name_.add(layer.name, index);
+      }
+    }
+    layers_ = custom_data.layers;
+    totlayer_ = custom_data.totlayer;
+    state = Built;
+    state_.store(Built, std::memory_order_release);
+  }
+  if (state == Built && layers_ == custom_data.layers && totlayer_ == custom_data.totlayer) {
+    const int index = index_by_name_.lookup_default_as(name, -1);
+    if (index == -1 || custom_data.layers[index].name == name) {
+      return index;
+    }
+  }
+  /* The cache is being built by another thread or is outdated. */
+  return find_generic_custom_data_layer(custom_data, name);
+}
+
+void CustomDataLayerIndexCache::tag_dirty()
+{
+  state_.store(Dirty, std::memory_order_release);
+}
+
 }  // namespace blender::bke
 
 /* -------------------------------------------------------------------- */
@@ -432,33 +566,35 @@ CustomDataType cpp_type_to_custom_data_type(const blender::fn::CPPType &type)
 static ReadAttributePtr read_attribute_from_custom_data(const CustomData &custom_data,
                                                         const int size,
                                                         const StringRef attribute_name,
-                                                        const AttributeDomain domain)
+                                                        const AttributeDomain domain,
+                                                        CustomDataLayerIndexCache &cache)
 {
   using namespace blender;
   using namespace blender::bke;
-  for (const CustomDataLayer &layer : Span(custom_data.layers, custom_data.totlayer)) {
-    if (layer.name != nullptr && layer.name == attribute_name) {
-      switch (layer.type) {
-        case CD_PROP_FLOAT:
-          return std::make_unique<ArrayReadAttribute<float>>(
-              domain, Span(static_cast<float *>(layer.data), size));
-        case CD_PROP_FLOAT2:
-          return std::make_unique<ArrayReadAttribute<float2>>(
-              domain, Span(static_cast<float2 *>(layer.data), size));
-        case CD_PROP_FLOAT3:
-          return std::make_unique<ArrayReadAttribute<float3>>(
-              domain, Span(static_cast<float3 *>(layer.data), size));
-        case CD_PROP_INT32:
-          return std::make_unique<ArrayReadAttribute<int>>(
-              domain, Span(static_cast<int *>(layer.data), size));
-        case CD_PROP_COLOR:
-          return std::make_unique<ArrayReadAttribute<Color4f>>(
-              domain, Span(static_cast<Color4f *>(layer.data), size));
-        case CD_PROP_BOOL:
-          return std::make_unique<ArrayReadAttribute<bool>>(
-              domain, Span(static_cast<bool *>(layer.data), size));
-      }
-    }
+  const int layer_index = cache.find(custom_data, attribute_name);
+  if (layer_index == -1) {
+    return {};
+  }
+  const CustomDataLayer &layer = custom_data.layers[layer_index];
+  switch (layer.type) {
+    case CD_PROP_FLOAT:
+      return std::make_unique<ArrayReadAttribute<float>>(
+          domain, Span(static_cast<float *>(layer.data), size));
+    case CD_PROP_FLOAT2:
+      return std::make_unique<ArrayReadAttribute<float2>>(
+          domain, Span(static_cast<float2 *>(layer.data), size));
+    case CD_PROP_FLOAT3:
+      return std::make_unique<ArrayReadAttribute<float3>>(
+          domain, Span(static_cast<float3 *>(layer.data), size));
+    case CD_PROP_INT32:
+      return std::make_unique<ArrayReadAttribute<int>>(
+          domain, Span(static_cast<int *>(layer.data), size));
+    case CD_PROP_COLOR:
+      return std::make_unique<ArrayReadAttribute<Color4f>>(
+          domain, Span(static_cast<Color4f *>(layer.data), size));
+    case CD_PROP_BOOL:
+      return std::make_unique<ArrayReadAttribute<bool>>(
+          domain, Span(static_cast<bool *>(layer.data), size));
   }
   return {};
 }
@@ -468,41 +604,43 @@ static WriteAttributePtr write_attribute_from_custom_data(
     const int size,
     const StringRef attribute_name,
     const AttributeDomain domain,
-    const std::function<void()> &update_customdata_pointers)
+    const std::function<void()> &update_customdata_pointers,
+    CustomDataLayerIndexCache &cache)
 {
 
   using namespace blender;
   using namespace blender::bke;
-  for (const CustomDataLayer &layer : Span(custom_data.layers, custom_data.totlayer)) {
-    if (layer.name != nullptr && layer.name == attribute_name) {
-      const void *data_before = layer.data;
-      /* The data layer might be shared with someone else. Since the caller wants to modify it, we
-       * copy it first. */
-      CustomData_duplicate_referenced_layer_named(&custom_data, layer.type, layer.name, size);
-      if (data_before != layer.data) {
-        update_customdata_pointers();
-      }
-      switch (layer.type) {
-        case CD_PROP_FLOAT:
-          return std::make_unique<ArrayWriteAttribute<float>>(
-              domain, MutableSpan(static_cast<float *>(layer.data), size));
-        case CD_PROP_FLOAT2:
-          return std::make_unique<ArrayWriteAttribute<float2>>(
-              domain, MutableSpan(static_cast<float2 *>(layer.data), size));
-        case CD_PROP_FLOAT3:
-          return std::make_unique<ArrayWriteAttribute<float3>>(
-              domain, MutableSpan(static_cast<float3 *>(layer.data), size));
-        case CD_PROP_INT32:
-          return std::make_unique<ArrayWriteAttribute<int>>(
-              domain, MutableSpan(static_cast<int *>(layer.data), size));
-        case CD_PROP_COLOR:
-          return std::make_unique<ArrayWriteAttribute<Color4f>>(
-              domain, MutableSpan(static_cast<Color4f *>(layer.data), size));
-        case CD_PROP_BOOL:
-          return std::make_unique<ArrayWriteAttribute<bool>>(
-              domain, MutableSpan(static_cast<bool *>(layer.data), size));
-      }
-    }
+  const int layer_index = cache.find(custom_data, attribute_name);
+  if (layer_index == -1) {
+    return {};
+  }
+  const CustomDataLayer &layer = custom_data.layers[layer_index];
+  const void *data_before = layer.data;
+  /* The data layer might be shared with someone else. Since the caller wants to modify it, we
+   * copy it first. */
+  CustomData_duplicate_referenced_layer_named(&custom_data, layer.type, layer.name, size);
+  if (data_before != layer.data) {
+    update_customdata_pointers();
+  }
+  switch (layer.type) {
+    case CD_PROP_FLOAT:
+      return std::make_unique<ArrayWriteAttribute<float>>(
+          domain, MutableSpan(static_cast<float *>(layer.data), size));
+    case CD_PROP_FLOAT2:
+      return std::make_unique<ArrayWriteAttribute<float2>>(
+          domain, MutableSpan(static_cast<float2 *>(layer.data), size));
+    case CD_PROP_FLOAT3:
+      return std::make_unique<ArrayWriteAttribute<float3>>(
+          domain, MutableSpan(static_cast<float3 *>(layer.data), size));
+    case CD_PROP_INT32:
+      return std::make_unique<ArrayWriteAttribute<int>>(
+          domain, MutableSpan(static_cast<int *>(layer.data), size));
+    case CD_PROP_COLOR:
+      return std::make_unique<ArrayWriteAttribute<Color4f>>(
+          domain, MutableSpan(static_cast<Color4f *>(layer.data), size));
+    case CD_PROP_BOOL:
+      return std::make_unique<ArrayWriteAttribute<bool>>(
+          domain, MutableSpan(static_cast<bool *>(layer.data), size));
   }
   return {};
 }
@@ -769,6 +907,66 @@ WriteAttributePtr GeometryComponent::attribute_try_ensure_for_write(const String
   return this->attribute_try_get_for_write(attribute_name);
 }
 
+const void *GeometryComponent::attribute_try_get_array(const StringRef attribute_name,
+                                                       const AttributeDomain domain,
+                                                       const CustomDataType data_type) const
+{
+  const CustomData *custom_data = this->attribute_custom_data(domain);
+  if (custom_data == nullptr) {
+    return nullptr;
+  }
+  const int layer_index = layer_index_caches_[domain].find(*custom_data, attribute_name);
+  if (layer_index == -1 || custom_data->layers[layer_index].type != data_type) {
+    return nullptr;
+  }
+  return custom_data->layers[layer_index].data;
+}
+
+void *GeometryComponent::attribute_try_get_array_for_write(const StringRef attribute_name,
+                                                           const AttributeDomain domain,
+                                                           const CustomDataType data_type)
+{
+  CustomData *custom_data = this->attribute_custom_data_for_write(domain);
+  if (custom_data == nullptr) {
+    return nullptr;
+  }
+  const int layer_index = layer_index_caches_[domain].find(*custom_data, attribute_name);
+  if (layer_index == -1 || custom_data->layers[layer_index].type != data_type) {
+    return nullptr;
+  }
+  CustomDataLayer &layer = custom_data->layers[layer_index];
+  if (layer.flag & CD_FLAG_NOFREE) {
+    /* The array is shared with another geometry, copy it before it is modified. */
+    CustomData_duplicate_referenced_layer_named(
+        custom_data, layer.type, layer.name, this->attribute_domain_size(domain));
+    this->attribute_custom_data_changed();
+  }
+  return layer.data;
+}
+
+const CustomData *GeometryComponent::attribute_custom_data(
+    const AttributeDomain UNUSED(domain)) const
+{
+  return nullptr;
+}
+
+CustomData *GeometryComponent::attribute_custom_data_for_write(
+    const AttributeDomain UNUSED(domain))
+{
+  return nullptr;
+}
+
+void GeometryComponent::attribute_custom_data_changed()
+{
+}
+
+void GeometryComponent::tag_attribute_layers_changed()
+{
+  for (blender::bke::CustomDataLayerIndexCache &cache : layer_index_caches_) {
+    cache.tag_dirty();
+  }
+}
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
@@ -814,21 +1012,27 @@ ReadAttributePtr PointCloudComponent::attribute_try_get_for_read(
     return {};
   }
 
-  return read_attribute_from_custom_data(
-      pointcloud_->pdata, pointcloud_->totpoint, attribute_name, ATTR_DOMAIN_POINT);
+  return read_attribute_from_custom_data(pointcloud_->pdata,
+                                         pointcloud_->totpoint,
+                                         attribute_name,
+                                         ATTR_DOMAIN_POINT,
+                                         layer_index_caches_[ATTR_DOMAIN_POINT]);
 }
 
 WriteAttributePtr PointCloudComponent::attribute_try_get_for_write(const StringRef attribute_name)
 {
-  PointCloud *pointcloud = this->get_for_write();
+  PointCloud *pointcloud = this->get_for_attribute_write();
   if (pointcloud == nullptr) {
     return {};
   }
 
   return write_attribute_from_custom_data(
-      pointcloud->pdata, pointcloud->totpoint, attribute_name, ATTR_DOMAIN_POINT, [&]() {
-        BKE_pointcloud_update_customdata_pointers(pointcloud);
-      });
+      pointcloud->pdata,
+      pointcloud->totpoint,
+      attribute_name,
+      ATTR_DOMAIN_POINT,
+      [&]() { BKE_pointcloud_update_customdata_pointers(pointcloud); },
+      layer_index_caches_[ATTR_DOMAIN_POINT]);
 }
 
 bool PointCloudComponent::attribute_try_delete(const StringRef attribute_name)
@@ -836,11 +1040,12 @@ bool PointCloudComponent::attribute_try_delete(const StringRef attribute_name)
   if (this->attribute_is_builtin(attribute_name)) {
     return false;
   }
-  PointCloud *pointcloud = this->get_for_write();
+  PointCloud *pointcloud = this->get_for_attribute_write();
   if (pointcloud == nullptr) {
     return false;
   }
   delete_named_custom_data_layer(pointcloud->pdata, attribute_name, pointcloud->totpoint);
+  this->tag_attribute_layers_changed();
   return true;
 }
 
@@ -864,7 +1069,7 @@ bool PointCloudComponent::attribute_try_create(const StringRef attribute_name,
   if (!this->attribute_domain_with_type_supported(domain, data_type)) {
     return false;
   }
-  PointCloud *pointcloud = this->get_for_write();
+  PointCloud *pointcloud = this->get_for_attribute_write();
   if (pointcloud == nullptr) {
     return false;
   }
@@ -876,9 +1081,35 @@ bool PointCloudComponent::attribute_try_create(const StringRef attribute_name,
   attribute_name.copy(attribute_name_c);
   CustomData_add_layer_named(
       &pointcloud->pdata, data_type, CD_DEFAULT, nullptr, pointcloud_->totpoint, attribute_name_c);
+  this->tag_attribute_layers_changed();
   return true;
 }
 
+const CustomData *PointCloudComponent::attribute_custom_data(const AttributeDomain domain) const
+{
+  if (pointcloud_ == nullptr || domain != ATTR_DOMAIN_POINT) {
+    return nullptr;
+  }
+  return &pointcloud_->pdata;
+}
+
+CustomData *PointCloudComponent::attribute_custom_data_for_write(const AttributeDomain domain)
+{
+  if (domain != ATTR_DOMAIN_POINT) {
+    return nullptr;
+  }
+  PointCloud *pointcloud = this->get_for_attribute_write();
+  if (pointcloud == nullptr) {
+    return nullptr;
+  }
+  return &pointcloud->pdata;
+}
+
+void PointCloudComponent::attribute_custom_data_changed()
+{
+  BKE_pointcloud_update_customdata_pointers(pointcloud_);
+}
+
 Set<std::string> PointCloudComponent::attribute_names() const
 {
   if (pointcloud_ == nullptr) {
@@ -958,7 +1189,11 @@ ReadAttributePtr MeshComponent::attribute_try_get_for_read(const StringRef attri
   }
 
   ReadAttributePtr corner_attribute = read_attribute_from_custom_data(
-      mesh_->ldata, mesh_->totloop, attribute_name, ATTR_DOMAIN_CORNER);
+      mesh_->ldata,
+      mesh_->totloop,
+      attribute_name,
+      ATTR_DOMAIN_CORNER,
+      layer_index_caches_[ATTR_DOMAIN_CORNER]);
   if (corner_attribute) {
     return corner_attribute;
   }
@@ -970,19 +1205,31 @@ ReadAttributePtr MeshComponent::attribute_try_get_for_read(const StringRef attri
   }
 
   ReadAttributePtr vertex_attribute = read_attribute_from_custom_data(
-      mesh_->vdata, mesh_->totvert, attribute_name, ATTR_DOMAIN_POINT);
+      mesh_->vdata,
+      mesh_->totvert,
+      attribute_name,
+      ATTR_DOMAIN_POINT,
+      layer_index_caches_[ATTR_DOMAIN_POINT]);
   if (vertex_attribute) {
     return vertex_attribute;
   }
 
   ReadAttributePtr edge_attribute = read_attribute_from_custom_data(
-      mesh_->edata, mesh_->totedge, attribute_name, ATTR_DOMAIN_EDGE);
+      mesh_->edata,
+      mesh_->totedge,
+      attribute_name,
+      ATTR_DOMAIN_EDGE,
+      layer_index_caches_[ATTR_DOMAIN_EDGE]);
   if (edge_attribute) {
     return edge_attribute;
   }
 
   ReadAttributePtr polygon_attribute = read_attribute_from_custom_data(
-      mesh_->pdata, mesh_->totpoly, attribute_name, ATTR_DOMAIN_POLYGON);
+      mesh_->pdata,
+      mesh_->totpoly,
+      attribute_name,
+      ATTR_DOMAIN_POLYGON,
+      layer_index_caches_[ATTR_DOMAIN_POLYGON]);
   if (polygon_attribute) {
     return polygon_attribute;
   }
@@ -992,7 +1239,7 @@ ReadAttributePtr MeshComponent::attribute_try_get_for_read(const StringRef attri
 
 WriteAttributePtr MeshComponent::attribute_try_get_for_write(const StringRef attribute_name)
 {
-  Mesh *mesh = this->get_for_write();
+  Mesh *mesh = this->get_for_attribute_write();
   if (mesh == nullptr) {
     return {};
   }
@@ -1019,7 +1266,12 @@ WriteAttributePtr MeshComponent::attribute_try_get_for_write(const StringRef att
   }
 
   WriteAttributePtr corner_attribute = write_attribute_from_custom_data(
-      mesh_->ldata, mesh_->totloop, attribute_name, ATTR_DOMAIN_CORNER, update_mesh_pointers);
+      mesh_->ldata,
+      mesh_->totloop,
+      attribute_name,
+      ATTR_DOMAIN_CORNER,
+      update_mesh_pointers,
+      layer_index_caches_[ATTR_DOMAIN_CORNER]);
   if (corner_attribute) {
     return corner_attribute;
   }
@@ -1029,24 +1281,43 @@ WriteAttributePtr MeshComponent::attribute_try_get_for_write(const StringRef att
     if (mesh_->dvert == nullptr) {
       BKE_object_defgroup_data_create(&mesh_->id);
     }
+    else {
+      CustomData_duplicate_referenced_layer(&mesh_->vdata, CD_MDEFORMVERT, mesh_->totvert);
+      update_mesh_pointers();
+    }
     return std::make_unique<blender::bke::VertexWeightWriteAttribute>(
         mesh_->dvert, mesh_->totvert, vertex_group_index);
   }
 
   WriteAttributePtr vertex_attribute = write_attribute_from_custom_data(
-      mesh_->vdata, mesh_->totvert, attribute_name, ATTR_DOMAIN_POINT, update_mesh_pointers);
+      mesh_->vdata,
+      mesh_->totvert,
+      attribute_name,
+      ATTR_DOMAIN_POINT,
+      update_mesh_pointers,
+      layer_index_caches_[ATTR_DOMAIN_POINT]);
   if (vertex_attribute) {
     return vertex_attribute;
   }
 
   WriteAttributePtr edge_attribute = write_attribute_from_custom_data(
-      mesh_->edata, mesh_->totedge, attribute_name, ATTR_DOMAIN_EDGE, update_mesh_pointers);
+      mesh_->edata,
+      mesh_->totedge,
+      attribute_name,
+      ATTR_DOMAIN_EDGE,
+      update_mesh_pointers,
+      layer_index_caches_[ATTR_DOMAIN_EDGE]);
   if (edge_attribute) {
     return edge_attribute;
   }
 
   WriteAttributePtr polygon_attribute = write_attribute_from_custom_data(
-      mesh_->pdata, mesh_->totpoly, attribute_name, ATTR_DOMAIN_POLYGON, update_mesh_pointers);
+      mesh_->pdata,
+      mesh_->totpoly,
+      attribute_name,
+      ATTR_DOMAIN_POLYGON,
+      update_mesh_pointers,
+      layer_index_caches_[ATTR_DOMAIN_POLYGON]);
   if (polygon_attribute) {
     return polygon_attribute;
   }
@@ -1059,7 +1330,7 @@ bool MeshComponent::attribute_try_delete(const StringRef attribute_name)
   if (this->attribute_is_builtin(attribute_name)) {
     return false;
   }
-  Mesh *mesh = this->get_for_write();
+  Mesh *mesh = this->get_for_attribute_write();
   if (mesh == nullptr) {
     return false;
   }
@@ -1068,9 +1339,12 @@ bool MeshComponent::attribute_try_delete(const StringRef attribute_name)
   delete_named_custom_data_layer(mesh_->vdata, attribute_name, mesh_->totvert);
   delete_named_custom_data_layer(mesh_->edata, attribute_name, mesh_->totedge);
   delete_named_custom_data_layer(mesh_->pdata, attribute_name, mesh_->totpoly);
+  this->tag_attribute_layers_changed();
 
   const int vertex_group_index = vertex_group_names_.lookup_default_as(attribute_name, -1);
   if (vertex_group_index != -1) {
+    CustomData_duplicate_referenced_layer(&mesh_->vdata, CD_MDEFORMVERT, mesh_->totvert);
+    BKE_mesh_update_customdata_pointers(mesh_, false);
     for (MDeformVert &dvert : blender::MutableSpan(mesh_->dvert, mesh_->totvert)) {
       MDeformWeight *weight = BKE_defvert_find_index(&dvert, vertex_group_index);
       BKE_defvert_remove_group(&dvert, weight);
@@ -1091,13 +1365,14 @@ bool MeshComponent::attribute_try_create(const StringRef attribute_name,
   if (!this->attribute_domain_with_type_supported(domain, data_type)) {
     return false;
   }
-  Mesh *mesh = this->get_for_write();
+  Mesh *mesh = this->get_for_attribute_write();
   if (mesh == nullptr) {
     return false;
   }
 
   char attribute_name_c[MAX_NAME];
   attribute_name.copy(attribute_name_c);
+  this->tag_attribute_layers_changed();
 
   switch (domain) {
     case ATTR_DOMAIN_CORNER: {
@@ -1140,6 +1415,44 @@ bool MeshComponent::attribute_try_create(const StringRef attribute_name,
   }
 }
 
+static CustomData *mesh_custom_data_for_domain(Mesh &mesh, const AttributeDomain domain)
+{
+  switch (domain) {
+    case ATTR_DOMAIN_CORNER:
+      return &mesh.ldata;
+    case ATTR_DOMAIN_POINT:
+      return &mesh.vdata;
+    case ATTR_DOMAIN_EDGE:
+      return &mesh.edata;
+    case ATTR_DOMAIN_POLYGON:
+      return &mesh.pdata;
+    default:
+      return nullptr;
+  }
+}
+
+const CustomData *MeshComponent::attribute_custom_data(const AttributeDomain domain) const
+{
+  if (mesh_ == nullptr) {
+    return nullptr;
+  }
+  return mesh_custom_data_for_domain(*mesh_, domain);
+}
+
+CustomData *MeshComponent::attribute_custom_data_for_write(const AttributeDomain domain)
+{
+  Mesh *mesh = this->get_for_attribute_write();
+  if (mesh == nullptr) {
+    return nullptr;
+  }
+  return mesh_custom_data_for_domain(*mesh, domain);
+}
+
+void MeshComponent::attribute_custom_data_changed()
+{
+  BKE_mesh_update_customdata_pointers(mesh_, false);
+}
+
 Set<std::string> MeshComponent::attribute_names() const
 {
   if (mesh_ == nullptr) {
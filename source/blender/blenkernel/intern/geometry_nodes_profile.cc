@@ -0,0 +1,249 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/** \file
+ * \ingroup bke
+ */
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <mutex>
+#include <sstream>
+
+#ifdef WIN32
+#  include <windows.h>
+#else
+#  include <time.h>
+#endif
+
+#include "BLI_fileops.h"
+#include "BLI_map.hh"
+#include "BLI_session_uuid.h"
+#include "BLI_vector.hh"
+
+#include "BKE_blender.h"
+#include "BKE_geometry_nodes_profile.hh"
+#include "BKE_global.h"
+
+#include "MEM_guardedalloc.h"
+
+using blender::Map;
+using blender::Vector;
+using blender::bke::GeometryNodesProfileEvent;
+
+struct GeometryNodesProfile {
+  std::mutex mutex;
+  Vector<GeometryNodesProfileEvent> events;
+  /** Small indices of the threads that executed the events, used as thread ids in the trace. */
+  Vector<int> event_thread_indices;
+  int threads_num = 0;
+  /** Events are written to this file on exit, when it is not empty. */
+  std::string exit_filepath;
+};
+
+static GeometryNodesProfile &get_profile()
+{
+  static GeometryNodesProfile profile;
+  return profile;
+}
+
+static bool event_matches(const GeometryNodesProfileEvent &event, const SessionUUID *modifier_uuid)
+{
+  return modifier_uuid == nullptr ||
+         BLI_session_uuid_is_equal(&event.modifier_uuid, modifier_uuid);
+}
+
+namespace blender::bke {
+
+int64_t geometry_nodes_profile_time_ns()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+int64_t geometry_nodes_profile_thread_time_ns()
+{
+#ifdef WIN32
+  FILETIME creation_time, exit_time, kernel_time, user_time;
+  if (!GetThreadTimes(GetCurrentThread(), &creation_time, &exit_time, &kernel_time, &user_time)) {
+    return 0;
+  }
+  const uint64_t kernel = ((uint64_t)kernel_time.dwHighDateTime << 32) | kernel_time.dwLowDateTime;
+  const uint64_t user = ((uint64_t)user_time.dwHighDateTime << 32) | user_time.dwLowDateTime;
+  /* The times are in units of 100 nanoseconds. */
+  return (int64_t)(kernel + user) * 100;
+#else
+  struct timespec time;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) != 0) {
+    return 0;
+  }
+  return (int64_t)time.tv_sec * 1000000000 + time.tv_nsec;
+#endif
+}
+
+void geometry_nodes_profile_add_event(GeometryNodesProfileEvent event)
+{
+  GeometryNodesProfile &profile = get_profile();
+  static thread_local int thread_index = -1;
+  std::lock_guard lock{profile.mutex};
+  if (thread_index == -1) {
+    thread_index = profile.threads_num++;
+  }
+  profile.events.append(std::move(event));
+  profile.event_thread_indices.append(thread_index);
+}
+
+}  // namespace blender::bke
+
+bool BKE_geometry_nodes_profile_is_enabled(void)
+{
+  return (G.debug & G_DEBUG_GEOMETRY_NODES_PROFILE) != 0;
+}
+
+void BKE_geometry_nodes_profile_clear(const SessionUUID *modifier_uuid)
+{
+  GeometryNodesProfile &profile = get_profile();
+  std::lock_guard lock{profile.mutex};
+  Vector<GeometryNodesProfileEvent> events;
+  Vector<int> event_thread_indices;
+  for (const int i : profile.events.index_range()) {
+    if (!event_matches(profile.events[i], modifier_uuid)) {
+      events.append(std::move(profile.events[i]));
+      event_thread_indices.append(profile.event_thread_indices[i]);
+    }
+  }
+  profile.events = std::move(events);
+  profile.event_thread_indices = std::move(event_thread_indices);
+}
+
+static void write_json_string(std::stringstream &ss, const std::string &str)
+{
+  ss << '"';
+  for (const char c : str) {
+    if (c == '"' || c == '\\') {
+      ss << '\\' << c;
+    }
+    else if ((unsigned char)c < 0x20) {
+      char buffer[8];
+      snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+      ss << buffer;
+    }
+    else {
+      ss << c;
+    }
+  }
+  ss << '"';
+}
+
+bool BKE_geometry_nodes_profile_write_chrome_trace(const char *filepath,
+                                                   const SessionUUID *modifier_uuid)
+{
+  GeometryNodesProfile &profile = get_profile();
+  std::stringstream ss;
+  {
+    std::lock_guard lock{profile.mutex};
+    int64_t first_start_ns = INT64_MAX;
+    for (const GeometryNodesProfileEvent &event : profile.events) {
+      first_start_ns = std::min(first_start_ns, event.start_ns);
+    }
+
+    /* Complete events ("ph": "X") with times in microseconds. Every modifier is shown as a
+     * separate process, so that the nodes of different modifiers are not mixed up. */
+    Map<std::string, int> process_ids;
+    ss << "{\"traceEvents\": [";
+    for (const int i : profile.events.index_range()) {
+      const GeometryNodesProfileEvent &event = profile.events[i];
+      if (!event_matches(event, modifier_uuid)) {
+        continue;
+      }
+      const std::string process_name = event.object_name + " / " + event.modifier_name;
+      const int process_id = process_ids.lookup_or_add_cb(process_name, [&]() {
+        const int id = (int)process_ids.size();
+        /* The first process is always written before any other event. */
+        ss << (id == 0 ? "\n" : ",\n");
+        ss << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": " << id;
+        ss << ", \"args\": {\"name\": ";
+        write_json_string(ss, process_name);
+        ss << "}}";
+        return id;
+      });
+      ss << ",\n{\"name\": ";
+      write_json_string(ss, event.node_name);
+      ss << ", \"cat\": \"geometry_nodes\", \"ph\": \"X\"";
+      ss << ", \"ts\": " << (event.start_ns - first_start_ns) / 1000.0;
+      ss << ", \"dur\": " << event.duration_ns / 1000.0;
+      ss << ", \"pid\": " << process_id;
+      ss << ", \"tid\": " << profile.event_thread_indices[i];
+      ss << ", \"args\": {\"thread_time_us\": " << event.thread_duration_ns / 1000.0;
+      ss << ", \"elements\": " << event.elements;
+      ss << ", \"bytes\": " << event.bytes << "}}";
+    }
+    ss << "\n]}\n";
+  }
+
+  FILE *file = BLI_fopen(filepath, "w");
+  if (file == nullptr) {
+    return false;
+  }
+  const std::string str = ss.str();
+  const bool success = fwrite(str.data(), 1, str.size(), file) == str.size();
+  fclose(file);
+  return success;
+}
+
+void BKE_geometry_nodes_profile_node_stats(const SessionUUID *modifier_uuid,
+                                           const char *node_name,
+                                           float r_stats[4])
+{
+  GeometryNodesProfile &profile = get_profile();
+  std::lock_guard lock{profile.mutex};
+  int64_t duration_ns = 0;
+  int64_t thread_duration_ns = 0;
+  int64_t elements = 0;
+  int64_t bytes = 0;
+  for (const GeometryNodesProfileEvent &event : profile.events) {
+    if (event_matches(event, modifier_uuid) && event.node_name == node_name) {
+      duration_ns += event.duration_ns;
+      thread_duration_ns += event.thread_duration_ns;
+      elements += event.elements;
+      bytes += event.bytes;
+    }
+  }
+  r_stats[0] = (float)(duration_ns * 1e-9);
+  r_stats[1] = (float)(thread_duration_ns * 1e-9);
+  r_stats[2] = (float)elements;
+  r_stats[3] = (float)bytes;
+}
+
+static void geometry_nodes_profile_write_atexit(void *UNUSED(user_data))
+{
+  GeometryNodesProfile &profile = get_profile();
+  if (!BKE_geometry_nodes_profile_write_chrome_trace(profile.exit_filepath.c_str(), nullptr)) {
+    printf("Error: cannot write geometry nodes profile to '%s'\n", profile.exit_filepath.c_str());
+  }
+}
+
+void BKE_geometry_nodes_profile_write_on_exit(const char *filepath)
+{
+  GeometryNodesProfile &profile = get_profile();
+  if (profile.exit_filepath.empty()) {
+    BKE_blender_atexit_register(geometry_nodes_profile_write_atexit, nullptr);
+  }
+  profile.exit_filepath = filepath;
+  G.debug |= G_DEBUG_GEOMETRY_NODES_PROFILE;
+}
@@ -14,17 +14,21 @@
  * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
  */
 
+#include "BKE_customdata.h"
 #include "BKE_geometry_set.hh"
 #include "BKE_lib_id.h"
 #include "BKE_mesh.h"
 #include "BKE_mesh_wrapper.h"
 #include "BKE_pointcloud.h"
 
+#include "DNA_mesh_types.h"
 #include "DNA_object_types.h"
+#include "DNA_pointcloud_types.h"
 
 #include "MEM_guardedalloc.h"
 
 using blender::float3;
+using blender::float4x4;
 using blender::MutableSpan;
 using blender::Span;
 using blender::StringRef;
@@ -281,8 +285,16 @@ GeometryComponent *MeshComponent::copy() const
 {
   MeshComponent *new_component = new MeshComponent();
   if (mesh_ != nullptr) {
-    new_component->mesh_ = BKE_mesh_copy_for_eval(mesh_, false);
+    /* The data layers are only referenced when this component owns the mesh, because it is
+     * unknown how long meshes owned by someone else stay valid. Referenced layers are copied
+     * once they are modified. */
+    const bool reference_layers = ownership_ == GeometryOwnershipType::Owned;
+    new_component->mesh_ = BKE_mesh_copy_for_eval(mesh_, reference_layers);
     new_component->ownership_ = GeometryOwnershipType::Owned;
+    if (reference_layers) {
+      this->user_add();
+      new_component->referenced_layers_owner_ = this;
+    }
   }
   return new_component;
 }
@@ -296,7 +308,10 @@ void MeshComponent::clear()
     }
     mesh_ = nullptr;
   }
+  /* Only release the referenced data after the mesh using it has been freed. */
+  referenced_layers_owner_.reset();
   vertex_group_names_.clear();
+  this->tag_attribute_layers_changed();
 }
 
 bool MeshComponent::has_mesh() const
@@ -318,8 +333,13 @@ void MeshComponent::replace(Mesh *mesh, GeometryOwnershipType ownership)
 Mesh *MeshComponent::release()
 {
   BLI_assert(this->is_mutable());
+  if (mesh_ != nullptr) {
+    /* The mesh may outlive the component that owns the referenced data. */
+    this->ensure_owned_layers();
+  }
   Mesh *mesh = mesh_;
   mesh_ = nullptr;
+  this->tag_attribute_layers_changed();
   return mesh;
 }
 
@@ -334,6 +354,11 @@ void MeshComponent::copy_vertex_group_names_from_object(const Object &object)
   }
 }
 
+const blender::Map<std::string, int> &MeshComponent::vertex_group_names() const
+{
+  return vertex_group_names_;
+}
+
 /* Get the mesh from this component. This method can be used by multiple threads at the same
  * time. Therefore, the returned mesh should not be modified. No ownership is transferred. */
 const Mesh *MeshComponent::get_for_read() const
@@ -344,6 +369,19 @@ const Mesh *MeshComponent::get_for_read() const
 /* Get the mesh from this component. This method can only be used when the component is mutable,
  * i.e. it is not shared. The returned mesh can be modified. No ownership is transferred. */
 Mesh *MeshComponent::get_for_write()
+{
+  Mesh *mesh = this->get_for_attribute_write();
+  if (mesh != nullptr) {
+    this->ensure_owned_layers();
+    /* The caller may add or remove layers. */
+    this->tag_attribute_layers_changed();
+  }
+  return mesh;
+}
+
+/* Like #get_for_write, but the custom data layers of the returned mesh may still be shared with
+ * another component. Referenced layers have to be duplicated before they are modified. */
+Mesh *MeshComponent::get_for_attribute_write()
 {
   BLI_assert(this->is_mutable());
   if (ownership_ == GeometryOwnershipType::ReadOnly) {
@@ -353,6 +391,21 @@ Mesh *MeshComponent::get_for_write()
   return mesh_;
 }
 
+/* Copy all data layers that are still shared with another component. */
+void MeshComponent::ensure_owned_layers()
+{
+  if (!referenced_layers_owner_) {
+    return;
+  }
+  CustomData_duplicate_referenced_layers(&mesh_->vdata, mesh_->totvert);
+  CustomData_duplicate_referenced_layers(&mesh_->edata, mesh_->totedge);
+  CustomData_duplicate_referenced_layers(&mesh_->fdata, mesh_->totface);
+  CustomData_duplicate_referenced_layers(&mesh_->ldata, mesh_->totloop);
+  CustomData_duplicate_referenced_layers(&mesh_->pdata, mesh_->totpoly);
+  BKE_mesh_update_customdata_pointers(mesh_, false);
+  referenced_layers_owner_.reset();
+}
+
 bool MeshComponent::is_empty() const
 {
   return mesh_ == nullptr;
@@ -377,8 +430,14 @@ GeometryComponent *PointCloudComponent::copy() const
 {
   PointCloudComponent *new_component = new PointCloudComponent();
   if (pointcloud_ != nullptr) {
-    new_component->pointcloud_ = BKE_pointcloud_copy_for_eval(pointcloud_, false);
+    /* See #MeshComponent::copy. */
+    const bool reference_layers = ownership_ == GeometryOwnershipType::Owned;
+    new_component->pointcloud_ = BKE_pointcloud_copy_for_eval(pointcloud_, reference_layers);
     new_component->ownership_ = GeometryOwnershipType::Owned;
+    if (reference_layers) {
+      this->user_add();
+      new_component->referenced_layers_owner_ = this;
+    }
   }
   return new_component;
 }
@@ -392,6 +451,8 @@ void PointCloudComponent::clear()
     }
     pointcloud_ = nullptr;
   }
+  referenced_layers_owner_.reset();
+  this->tag_attribute_layers_changed();
 }
 
 bool PointCloudComponent::has_pointcloud() const
@@ -413,8 +474,12 @@ void PointCloudComponent::replace(PointCloud *pointcloud, GeometryOwnershipType
 PointCloud *PointCloudComponent::release()
 {
   BLI_assert(this->is_mutable());
+  if (pointcloud_ != nullptr) {
+    this->ensure_owned_layers();
+  }
   PointCloud *pointcloud = pointcloud_;
   pointcloud_ = nullptr;
+  this->tag_attribute_layers_changed();
   return pointcloud;
 }
 
@@ -430,6 +495,18 @@ const PointCloud *PointCloudComponent::get_for_read() const
  * mutable, i.e. it is not shared. The returned point cloud can be modified. No ownership is
  * transferred. */
 PointCloud *PointCloudComponent::get_for_write()
+{
+  PointCloud *pointcloud = this->get_for_attribute_write();
+  if (pointcloud != nullptr) {
+    this->ensure_owned_layers();
+    /* The caller may add or remove layers. */
+    this->tag_attribute_layers_changed();
+  }
+  return pointcloud;
+}
+
+/* See #MeshComponent::get_for_attribute_write. */
+PointCloud *PointCloudComponent::get_for_attribute_write()
 {
   BLI_assert(this->is_mutable());
   if (ownership_ == GeometryOwnershipType::ReadOnly) {
@@ -439,6 +516,16 @@ PointCloud *PointCloudComponent::get_for_write()
   return pointcloud_;
 }
 
+void PointCloudComponent::ensure_owned_layers()
+{
+  if (!referenced_layers_owner_) {
+    return;
+  }
+  CustomData_duplicate_referenced_layers(&pointcloud_->pdata, pointcloud_->totpoint);
+  BKE_pointcloud_update_customdata_pointers(pointcloud_);
+  referenced_layers_owner_.reset();
+}
+
 bool PointCloudComponent::is_empty() const
 {
   return pointcloud_ == nullptr;
@@ -457,9 +544,7 @@ InstancesComponent::InstancesComponent() : GeometryComponent(GeometryComponentTy
 GeometryComponent *InstancesComponent::copy() const
 {
   InstancesComponent *new_component = new InstancesComponent();
-  new_component->positions_ = positions_;
-  new_component->rotations_ = rotations_;
-  new_component->scales_ = scales_;
+  new_component->transforms_ = transforms_;
   new_component->instanced_data_ = instanced_data_;
   return new_component;
 }
@@ -467,81 +552,70 @@ GeometryComponent *InstancesComponent::copy() const
 void InstancesComponent::clear()
 {
   instanced_data_.clear();
-  positions_.clear();
-  rotations_.clear();
-  scales_.clear();
+  transforms_.clear();
 }
 
-void InstancesComponent::add_instance(Object *object,
-                                      blender::float3 position,
-                                      blender::float3 rotation,
-                                      blender::float3 scale)
+void InstancesComponent::reserve(const int amount)
+{
+  instanced_data_.reserve(amount);
+  transforms_.reserve(amount);
+}
+
+void InstancesComponent::add_instance(Object *object, const float4x4 &transform)
 {
   InstancedData data;
   data.type = INSTANCE_DATA_TYPE_OBJECT;
   data.data.object = object;
-  this->add_instance(data, position, rotation, scale);
+  this->add_instance(data, transform);
 }
 
-void InstancesComponent::add_instance(Collection *collection,
-                                      blender::float3 position,
-                                      blender::float3 rotation,
-                                      blender::float3 scale)
+void InstancesComponent::add_instance(Collection *collection, const float4x4 &transform)
 {
   InstancedData data;
   data.type = INSTANCE_DATA_TYPE_COLLECTION;
   data.data.collection = collection;
-  this->add_instance(data, position, rotation, scale);
+  this->add_instance(data, transform);
 }
 
-void InstancesComponent::add_instance(InstancedData data,
-                                      blender::float3 position,
-                                      blender::float3 rotation,
-                                      blender::float3 scale)
+void InstancesComponent::add_instance(const InstancedData &data, const float4x4 &transform)
 {
   instanced_data_.append(data);
-  positions_.append(position);
-  rotations_.append(rotation);
-  scales_.append(scale);
+  transforms_.append(transform);
 }
 
-Span<InstancedData> InstancesComponent::instanced_data() const
+void InstancesComponent::add_instances(Span<InstancedData> instanced_data,
+                                       Span<float4x4> transforms)
 {
-  return instanced_data_;
+  BLI_assert(instanced_data.size() == transforms.size());
+  instanced_data_.extend(instanced_data);
+  transforms_.extend(transforms);
 }
 
-Span<float3> InstancesComponent::positions() const
-{
-  return positions_;
-}
-
-blender::Span<blender::float3> InstancesComponent::rotations() const
+Span<InstancedData> InstancesComponent::instanced_data() const
 {
-  return rotations_;
+  return instanced_data_;
 }
 
-blender::Span<blender::float3> InstancesComponent::scales() const
+Span<float4x4> InstancesComponent::transforms() const
 {
-  return scales_;
+  return transforms_;
 }
 
-MutableSpan<float3> InstancesComponent::positions()
+MutableSpan<float4x4> InstancesComponent::transforms()
 {
-  return positions_;
+  return transforms_;
 }
 
 int InstancesComponent::instances_amount() const
 {
   const int size = instanced_data_.size();
-  BLI_assert(positions_.size() == size);
-  BLI_assert(rotations_.size() == size);
-  BLI_assert(scales_.size() == size);
+  BLI_assert(transforms_.size() == size);
   return size;
 }
 
 bool InstancesComponent::is_empty() const
 {
-  return positions_.size() == 0;
+  return transforms_.size() == 0;
 }
 
 /** \} */
@@ -561,18 +635,14 @@ bool BKE_geometry_set_has_instances(const GeometrySet *geometry_set)
 }
 
 int BKE_geometry_set_instances(const GeometrySet *geometry_set,
-                               float (**r_positions)[3],
-                               float (**r_rotations)[3],
-                               float (**r_scales)[3],
+                               float (**r_transforms)[4][4],
                                InstancedData **r_instanced_data)
 {
   const InstancesComponent *component = geometry_set->get_component_for_read<InstancesComponent>();
   if (component == nullptr) {
     return 0;
   }
-  *r_positions = (float(*)[3])component->positions().data();
-  *r_rotations = (float(*)[3])component->rotations().data();
-  *r_scales = (float(*)[3])component->scales().data();
+  *r_transforms = (float(*)[4][4])component->transforms().data();
   *r_instanced_data = (InstancedData *)component->instanced_data().data();
   return component->instances_amount();
 }
@@ -37,6 +37,8 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "atomic_ops.h"
+
 #include "IMB_colormanagement.h"
 #include "IMB_imbuf.h"
 #include "IMB_imbuf_types.h"
@@ -68,6 +70,7 @@
 #include "BLI_math_vector.h"
 #include "BLI_mempool.h"
 #include "BLI_system.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 #include "BLI_timecode.h" /* For stamp time-code format. */
 #include "BLI_utildefines.h"
@@ -113,6 +116,33 @@
 static CLG_LogRef LOG = {"bke.image"};
 static ThreadMutex *image_mutex;
 
+/* Source of #Image_Runtime.changed_timestamp, unique for all images of the session so undo
+ * can't bring back an image with the time-stamp of different pixels. */
+static int32_t image_changed_timestamp = 0;
+
+/* Tell caches using the pixels of the image that they may have changed. */
+static void image_tag_pixels_changed(Image *image)
+{
+  image->runtime.changed_timestamp = atomic_add_and_fetch_int32(&image_changed_timestamp, 1);
+}
+
+/* Image files being loaded ahead of time, see #BKE_image_prefetch_frame. */
+typedef struct ImagePrefetch {
+  struct ImagePrefetch *next, *prev;
+  char filepath[FILE_MAX];
+  char colorspace[64]; /* Same size as #ColorManagedColorspaceSettings.name. */
+  int flag;
+  int cfra;
+  /** Loaded buffer, only valid once loaded is set. */
+  ImBuf *ibuf;
+  bool loaded;
+} ImagePrefetch;
+
+static ListBase image_prefetch_list = {NULL, NULL};
+static ThreadMutex image_prefetch_mutex = BLI_MUTEX_INITIALIZER;
+static ThreadCondition image_prefetch_condition;
+static TaskPool *image_prefetch_pool = NULL;
+
 static void image_init(Image *ima, short source, short type);
 static void image_free_packedfiles(Image *ima);
 static void copy_image_packedfiles(ListBase *lb_dst, const ListBase *lb_src);
@@ -301,6 +331,7 @@ static void image_blend_read_data(BlendDataReader *reader, ID *id)
   }
   ima->gpuflag = 0;
   BLI_listbase_clear(&ima->gpu_refresh_areas);
+  image_tag_pixels_changed(ima);
 }
 
 static void image_blend_read_lib(BlendLibReader *UNUSED(reader), ID *id)
@@ -428,10 +459,13 @@ static struct ImBuf *imagecache_get(Image *image, int index)
 void BKE_images_init(void)
 {
   image_mutex = BLI_mutex_alloc();
+  BLI_condition_init(&image_prefetch_condition);
 }
 
 void BKE_images_exit(void)
 {
+  BKE_image_prefetch_discard(INT_MAX);
+  BLI_condition_end(&image_prefetch_condition);
   BLI_mutex_free(image_mutex);
 }
 
@@ -439,6 +473,7 @@ void BKE_images_exit(void)
 
 static void image_free_cached_frames(Image *image)
 {
+  image_tag_pixels_changed(image);
   if (image->cache) {
     IMB_moviecache_free(image->cache);
     image->cache = NULL;
@@ -496,6 +531,7 @@ void BKE_image_free_buffers_ex(Image *ima, bool do_lock)
   if (ima->rr) {
     RE_FreeRenderResult(ima->rr);
     ima->rr = NULL;
+    image_tag_pixels_changed(ima);
   }
 
   BKE_image_free_gputextures(ima);
@@ -591,6 +627,7 @@ static void image_assign_ibuf(Image *ima, ImBuf *ibuf, int index, int entry)
 
 static void image_remove_ibuf(Image *ima, int index, int entry)
 {
+  image_tag_pixels_changed(ima);
   if (index != IMA_NO_INDEX) {
     index = IMA_MAKE_INDEX(entry, index);
   }
@@ -4082,6 +4119,135 @@ static int image_num_files(Image *ima)
   return BLI_listbase_count(&ima->views);
 }
 
+static int image_sequence_load_flag(Image *ima)
+{
+  return IB_rect | IB_multilayer | IB_metadata | imbuf_alpha_flags_for_image(ima);
+}
+
+static void image_prefetch_task(TaskPool *__restrict UNUSED(pool), void *taskdata)
+{
+  ImagePrefetch *prefetch = taskdata;
+  ImBuf *ibuf = IMB_loadiffname(prefetch->filepath, prefetch->flag, prefetch->colorspace);
+
+  BLI_mutex_lock(&image_prefetch_mutex);
+  prefetch->ibuf = ibuf;
+  prefetch->loaded = true;
+  BLI_condition_notify_all(&image_prefetch_condition);
+  BLI_mutex_unlock(&image_prefetch_mutex);
+}
+
+/* Must be called with the prefetch mutex locked. */
+static ImagePrefetch *image_prefetch_find(const char *filepath, int flag, const char *colorspace)
+{
+  LISTBASE_FOREACH (ImagePrefetch *, prefetch, &image_prefetch_list) {
+    if (prefetch->flag == flag && STREQ(prefetch->filepath, filepath) &&
+        STREQ(prefetch->colorspace, colorspace)) {
+      return prefetch;
+    }
+  }
+  return NULL;
+}
+
+/* Take the buffer of a prefetched file, waiting for it when it is still loading. Returns NULL
+ * when the file wasn't prefetched with the same settings. */
+static ImBuf *image_prefetch_take(const char *filepath, int flag, const char *colorspace)
+{
+  ImagePrefetch *prefetch;
+  ImBuf *ibuf = NULL;
+
+  BLI_mutex_lock(&image_prefetch_mutex);
+  /* Search again after waiting, another thread may have taken it. */
+  while ((prefetch = image_prefetch_find(filepath, flag, colorspace)) && !prefetch->loaded) {
+    BLI_condition_wait(&image_prefetch_condition, &image_prefetch_mutex);
+  }
+  if (prefetch) {
+    ibuf = prefetch->ibuf;
+    BLI_remlink(&image_prefetch_list, prefetch);
+    MEM_freeN(prefetch);
+  }
+  BLI_mutex_unlock(&image_prefetch_mutex);
+
+  return ibuf;
+}
+
+/**
+ * Start loading the file an image sequence uses at a frame in the background, so it's ready when
+ * the image is used at that frame. Multi-view sequences aren't prefetched.
+ */
+void BKE_image_prefetch_frame(Image *ima, ImageUser *iuser, int cfra)
+{
+  if (ima->source != IMA_SRC_SEQUENCE || BKE_image_is_multiview(ima) || iuser == NULL) {
+    return;
+  }
+
+  ImagePrefetch *prefetch = MEM_callocN(sizeof(ImagePrefetch), __func__);
+  ImageUser iuser_t = *iuser;
+  bool is_in_range;
+  iuser_t.framenr = BKE_image_user_frame_get(iuser, cfra, &is_in_range);
+  iuser_t.view = 0;
+  BKE_image_user_file_path(&iuser_t, ima, prefetch->filepath);
+  BLI_strncpy(prefetch->colorspace, ima->colorspace_settings.name, sizeof(prefetch->colorspace));
+  prefetch->flag = image_sequence_load_flag(ima);
+  prefetch->cfra = cfra;
+
+  BLI_mutex_lock(&image_prefetch_mutex);
+  ImagePrefetch *other = image_prefetch_find(
+      prefetch->filepath, prefetch->flag, prefetch->colorspace);
+  if (other) {
+    /* Already loading, for another image using the same file. */
+    other->cfra = max_ii(other->cfra, cfra);
+    BLI_mutex_unlock(&image_prefetch_mutex);
+    MEM_freeN(prefetch);
+    return;
+  }
+  BLI_addtail(&image_prefetch_list, prefetch);
+  if (image_prefetch_pool == NULL) {
+    image_prefetch_pool = BLI_task_pool_create_background(NULL, TASK_PRIORITY_LOW);
+  }
+  BLI_mutex_unlock(&image_prefetch_mutex);
+
+  BLI_task_pool_push(image_prefetch_pool, image_prefetch_task, prefetch, false, NULL);
+}
+
+/**
+ * Free prefetched buffers of frames before cfra that haven't been used, waiting for them to be
+ * loaded. Pass INT_MAX to free all of them and stop the background loading.
+ */
+void BKE_image_prefetch_discard(int cfra)
+{
+  BLI_mutex_lock(&image_prefetch_mutex);
+  bool is_loading = true;
+  while (is_loading) {
+    is_loading = false;
+    LISTBASE_FOREACH (ImagePrefetch *, prefetch, &image_prefetch_list) {
+      if (prefetch->cfra < cfra && !prefetch->loaded) {
+        is_loading = true;
+        BLI_condition_wait(&image_prefetch_condition, &image_prefetch_mutex);
+        break;
+      }
+    }
+  }
+  LISTBASE_FOREACH_MUTABLE (ImagePrefetch *, prefetch, &image_prefetch_list) {
+    if (prefetch->cfra < cfra) {
+      if (prefetch->ibuf) {
+        IMB_freeImBuf(prefetch->ibuf);
+      }
+      BLI_remlink(&image_prefetch_list, prefetch);
+      MEM_freeN(prefetch);
+    }
+  }
+  TaskPool *pool = (cfra == INT_MAX) ? image_prefetch_pool : NULL;
+  if (pool) {
+    image_prefetch_pool = NULL;
+  }
+  BLI_mutex_unlock(&image_prefetch_mutex);
+
+  if (pool) {
+    BLI_task_pool_work_and_wait(pool);
+    BLI_task_pool_free(pool);
+  }
+}
+
 static ImBuf *load_sequence_single(
     Image *ima, ImageUser *iuser, int frame, const int view_id, bool *r_assign)
 {
@@ -4104,11 +4270,13 @@ static ImBuf *load_sequence_single(
   iuser_t.view = view_id;
   BKE_image_user_file_path(&iuser_t, ima, name);
 
-  flag = IB_rect | IB_multilayer | IB_metadata;
-  flag |= imbuf_alpha_flags_for_image(ima);
+  flag = image_sequence_load_flag(ima);
 
   /* read ibuf */
-  ibuf = IMB_loadiffname(name, flag, ima->colorspace_settings.name);
+  ibuf = image_prefetch_take(name, flag, ima->colorspace_settings.name);
+  if (ibuf == NULL) {
+    ibuf = IMB_loadiffname(name, flag, ima->colorspace_settings.name);
+  }
 
 #if 0
   if (ibuf) {
@@ -5649,9 +5817,10 @@ bool BKE_image_is_dirty(Image *image)
   return BKE_image_is_dirty_writable(image, NULL);
 }
 
-void BKE_image_mark_dirty(Image *UNUSED(image), ImBuf *ibuf)
+void BKE_image_mark_dirty(Image *image, ImBuf *ibuf)
 {
   ibuf->userflags |= IB_BITMAPDIRTY;
+  image_tag_pixels_changed(image);
 }
 
 bool BKE_image_buffer_format_writable(ImBuf *ibuf)
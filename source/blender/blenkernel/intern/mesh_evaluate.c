@@ -1419,6 +1419,151 @@ static bool loop_split_generator_check_cyclic_smooth_fan(const MLoop *mloops,
   }
 }
 
+/**
+ * Concurrent variant of #loop_split_generator_check_cyclic_smooth_fan. Walks the smooth fan
+ * around the vertex of \a ml_curr once, tagging all its loops in \a visited_loops so that the fan
+ * isn't walked again from its other loops.
+ *
+ * \return The entry point of the fan when it is cyclic, which is the loop that the serial walk
+ * over polys and their loops reaches first, or -1 when the fan is not cyclic.
+ */
+static int loop_split_generator_cyclic_smooth_fan_start(const MLoop *mloops,
+                                                        const MPoly *mpolys,
+                                                        const int (*edge_to_loops)[2],
+                                                        const int *loop_to_poly,
+                                                        const int *e2l_prev,
+                                                        BLI_bitmap *visited_loops,
+                                                        const MLoop *ml_curr,
+                                                        const MLoop *ml_prev,
+                                                        const int ml_curr_index,
+                                                        const int ml_prev_index,
+                                                        const int mp_curr_index,
+                                                        const int numLoops)
+{
+  const unsigned int mv_pivot_index = ml_curr->v; /* The vertex we are "fanning" around! */
+  const int *e2lfan_curr;
+  const MLoop *mlfan_curr;
+  int mlfan_curr_index, mlfan_vert_index, mpfan_curr_index;
+  int ml_start_index = ml_curr_index;
+  int mp_start_index = mp_curr_index;
+
+  e2lfan_curr = e2l_prev;
+  if (IS_EDGE_SHARP(e2lfan_curr)) {
+    return -1;
+  }
+
+  mlfan_curr = ml_prev;
+  mlfan_curr_index = ml_prev_index;
+  mlfan_vert_index = ml_curr_index;
+  mpfan_curr_index = mp_curr_index;
+
+  /* A fan cannot have more loops than the mesh, this only guards against invalid geometry. */
+  for (int i = 0; i < numLoops; i++) {
+    BKE_mesh_loop_manifold_fan_around_vert_next(mloops,
+                                                mpolys,
+                                                loop_to_poly,
+                                                e2lfan_curr,
+                                                mv_pivot_index,
+                                                &mlfan_curr,
+                                                &mlfan_curr_index,
+                                                &mlfan_vert_index,
+                                                &mpfan_curr_index);
+
+    e2lfan_curr = edge_to_loops[mlfan_curr->e];
+
+    if (IS_EDGE_SHARP(e2lfan_curr)) {
+      /* Not a cyclic smooth fan, its entry point is the loop using the sharp edge. */
+      return -1;
+    }
+    if (mlfan_vert_index == ml_curr_index) {
+      return ml_start_index;
+    }
+
+    /* Another thread may be walking the same fan from another loop, it finds the same entry
+     * point, so the walk continues regardless of the loop being tagged already. */
+    (void)BLI_BITMAP_TEST_AND_SET_ATOMIC(visited_loops, mlfan_vert_index);
+    if (mpfan_curr_index < mp_start_index ||
+        (mpfan_curr_index == mp_start_index && mlfan_vert_index < ml_start_index)) {
+      ml_start_index = mlfan_vert_index;
+      mp_start_index = mpfan_curr_index;
+    }
+  }
+  return -1;
+}
+
+typedef struct LoopSplitFanStartsData {
+  const LoopSplitTaskDataCommon *common_data;
+  BLI_bitmap *visited_loops;
+  BLI_bitmap *fan_starts;
+} LoopSplitFanStartsData;
+
+static void loop_split_fan_starts_tag_cb(void *__restrict userdata,
+                                         const int mp_index,
+                                         const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  LoopSplitFanStartsData *data = userdata;
+  const LoopSplitTaskDataCommon *common_data = data->common_data;
+  const MLoop *mloops = common_data->mloops;
+  const int(*edge_to_loops)[2] = (const int(*)[2])common_data->edge_to_loops;
+
+  const MPoly *mp = &common_data->mpolys[mp_index];
+  const int ml_last_index = (mp->loopstart + mp->totloop) - 1;
+  int ml_prev_index = ml_last_index;
+
+  for (int ml_curr_index = mp->loopstart; ml_curr_index <= ml_last_index;
+       ml_prev_index = ml_curr_index, ml_curr_index++) {
+    const MLoop *ml_curr = &mloops[ml_curr_index];
+    const MLoop *ml_prev = &mloops[ml_prev_index];
+
+    if (IS_EDGE_SHARP(edge_to_loops[ml_curr->e])) {
+      (void)BLI_BITMAP_TEST_AND_SET_ATOMIC(data->fan_starts, ml_curr_index);
+      continue;
+    }
+    if (BLI_BITMAP_TEST_AND_SET_ATOMIC(data->visited_loops, ml_curr_index)) {
+      /* Part of a fan walked from another loop already. */
+      continue;
+    }
+    const int ml_start_index = loop_split_generator_cyclic_smooth_fan_start(
+        mloops,
+        common_data->mpolys,
+        edge_to_loops,
+        common_data->loop_to_poly,
+        edge_to_loops[ml_prev->e],
+        data->visited_loops,
+        ml_curr,
+        ml_prev,
+        ml_curr_index,
+        ml_prev_index,
+        mp_index,
+        common_data->numLoops);
+    if (ml_start_index != -1) {
+      (void)BLI_BITMAP_TEST_AND_SET_ATOMIC(data->fan_starts, ml_start_index);
+    }
+  }
+}
+
+/**
+ * Tag the loops from which each smooth fan (or single sharp loop) gets processed.
+ * Unlike the serial walk done in #loop_split_generator, this is done for all polys in parallel.
+ */
+static BLI_bitmap *loop_split_fan_starts_tag(const LoopSplitTaskDataCommon *common_data)
+{
+  LoopSplitFanStartsData data = {
+      .common_data = common_data,
+      .visited_loops = BLI_BITMAP_NEW((size_t)common_data->numLoops, __func__),
+      .fan_starts = BLI_BITMAP_NEW((size_t)common_data->numLoops, __func__),
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = LOOP_SPLIT_TASK_BLOCK_SIZE;
+  BLI_task_parallel_range(
+      0, common_data->numPolys, &data, loop_split_fan_starts_tag_cb, &settings);
+
+  MEM_freeN(data.visited_loops);
+  return data.fan_starts;
+}
+
 static void loop_split_generator(TaskPool *pool, LoopSplitTaskDataCommon *common_data)
 {
   MLoopNorSpaceArray *lnors_spacearr = common_data->lnors_spacearr;
@@ -1439,7 +1584,10 @@ static void loop_split_generator(TaskPool *pool, LoopSplitTaskDataCommon *common
   int ml_curr_index;
   int ml_prev_index;
 
-  BLI_bitmap *skip_loops = BLI_BITMAP_NEW(numLoops, __func__);
+  /* When threaded, fan entry points are found in parallel beforehand,
+   * otherwise they are detected while walking over loops below. */
+  BLI_bitmap *fan_starts = pool ? loop_split_fan_starts_tag(common_data) : NULL;
+  BLI_bitmap *skip_loops = pool ? NULL : BLI_BITMAP_NEW(numLoops, __func__);
 
   LoopSplitTaskData *data_buff = NULL;
   int data_idx = 0;
@@ -1494,18 +1642,20 @@ static void loop_split_generator(TaskPool *pool, LoopSplitTaskDataCommon *common
        * the code, add more memory usage, and despite its logical complexity,
        * loop_manifold_fan_around_vert_next() is quite cheap in term of CPU cycles,
        * so really think it's not worth it. */
-      if (!IS_EDGE_SHARP(e2l_curr) && (BLI_BITMAP_TEST(skip_loops, ml_curr_index) ||
-                                       !loop_split_generator_check_cyclic_smooth_fan(mloops,
-                                                                                     mpolys,
-                                                                                     edge_to_loops,
-                                                                                     loop_to_poly,
-                                                                                     e2l_prev,
-                                                                                     skip_loops,
-                                                                                     ml_curr,
-                                                                                     ml_prev,
-                                                                                     ml_curr_index,
-                                                                                     ml_prev_index,
-                                                                                     mp_index))) {
+      if (fan_starts ? !BLI_BITMAP_TEST(fan_starts, ml_curr_index) :
+                       (!IS_EDGE_SHARP(e2l_curr) &&
+                        (BLI_BITMAP_TEST(skip_loops, ml_curr_index) ||
+                         !loop_split_generator_check_cyclic_smooth_fan(mloops,
+                                                                       mpolys,
+                                                                       edge_to_loops,
+                                                                       loop_to_poly,
+                                                                       e2l_prev,
+                                                                       skip_loops,
+                                                                       ml_curr,
+                                                                       ml_prev,
+                                                                       ml_curr_index,
+                                                                       ml_prev_index,
+                                                                       mp_index)))) {
         //              printf("SKIPPING!\n");
       }
       else {
@@ -1589,7 +1739,12 @@ static void loop_split_generator(TaskPool *pool, LoopSplitTaskDataCommon *common
   if (edge_vectors) {
     BLI_stack_free(edge_vectors);
   }
-  MEM_freeN(skip_loops);
+  if (fan_starts) {
+    MEM_freeN(fan_starts);
+  }
+  if (skip_loops) {
+    MEM_freeN(skip_loops);
+  }
 
 #ifdef DEBUG_TIME
   TIMEIT_END_AVERAGED(loop_split_generator);
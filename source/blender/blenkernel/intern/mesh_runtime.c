@@ -226,19 +226,38 @@ bool BKE_mesh_runtime_clear_edit_data(Mesh *mesh)
   return true;
 }
 
-void BKE_mesh_runtime_clear_geometry(Mesh *mesh)
+/**
+ * Free the runtime caches invalidated by the changes described by \a dirty_flag
+ * (a combination of #eMeshRuntimeDirtyFlag), keeping the ones which do not depend on them.
+ * Freed caches are rebuilt lazily the next time they are requested.
+ *
+ * \note Caches are freed immediately instead of being flagged, so this must not be called while
+ * other threads may read the caches of the mesh.
+ */
+void BKE_mesh_runtime_tag_dirty(Mesh *mesh, const int dirty_flag)
 {
-  if (mesh->runtime.bvh_cache) {
-    bvhcache_free(mesh->runtime.bvh_cache);
-    mesh->runtime.bvh_cache = NULL;
+  if (dirty_flag & (ME_RUNTIME_DIRTY_POSITIONS | ME_RUNTIME_DIRTY_TOPOLOGY)) {
+    /* BVH trees and the directions stored in the shrinkwrap boundary data use positions. */
+    if (mesh->runtime.bvh_cache) {
+      bvhcache_free(mesh->runtime.bvh_cache);
+      mesh->runtime.bvh_cache = NULL;
+    }
+    BKE_shrinkwrap_discard_boundary_data(mesh);
+    /* The triangulation of n-gons depends on the positions of their vertices. */
+    MEM_SAFE_FREE(mesh->runtime.looptris.array);
   }
-  MEM_SAFE_FREE(mesh->runtime.looptris.array);
-  /* TODO(sergey): Does this really belong here? */
-  if (mesh->runtime.subdiv_ccg != NULL) {
-    BKE_subdiv_ccg_destroy(mesh->runtime.subdiv_ccg);
-    mesh->runtime.subdiv_ccg = NULL;
+  if (dirty_flag & ME_RUNTIME_DIRTY_TOPOLOGY) {
+    /* TODO(sergey): Does this really belong here? */
+    if (mesh->runtime.subdiv_ccg != NULL) {
+      BKE_subdiv_ccg_destroy(mesh->runtime.subdiv_ccg);
+      mesh->runtime.subdiv_ccg = NULL;
+    }
   }
-  BKE_shrinkwrap_discard_boundary_data(mesh);
+}
+
+void BKE_mesh_runtime_clear_geometry(Mesh *mesh)
+{
+  BKE_mesh_runtime_tag_dirty(mesh, ME_RUNTIME_DIRTY_TOPOLOGY);
 }
 
 /** \} */
@@ -813,23 +813,14 @@ static const DupliGenerator gen_dupli_verts_pointcloud = {
 
 static void make_duplis_instances_component(const DupliContext *ctx)
 {
-  float(*positions)[3];
-  float(*rotations)[3];
-  float(*scales)[3];
+  float(*transforms)[4][4];
   InstancedData *instanced_data;
   const int amount = BKE_geometry_set_instances(
-      ctx->object->runtime.geometry_set_eval, &positions, &rotations, &scales, &instanced_data);
+      ctx->object->runtime.geometry_set_eval, &transforms, &instanced_data);
 
   for (int i = 0; i < amount; i++) {
     InstancedData *data = &instanced_data[i];
-
-    float scale_matrix[4][4];
-    size_to_mat4(scale_matrix, scales[i]);
-    float rotation_matrix[4][4];
-    eul_to_mat4(rotation_matrix, rotations[i]);
-    float instance_offset_matrix[4][4];
-    mul_m4_m4m4(instance_offset_matrix, rotation_matrix, scale_matrix);
-    copy_v3_v3(instance_offset_matrix[3], positions[i]);
+    float(*instance_offset_matrix)[4] = transforms[i];
 
     if (data->type == INSTANCE_DATA_TYPE_OBJECT) {
       Object *object = data->data.object;
@@ -27,6 +27,7 @@
  */
 
 #include "BLI_math_inline.h"
+#include "BLI_sys_types.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -100,6 +101,30 @@ MINLINE void straight_to_premul_v4(float color[4]);
 MINLINE void straight_uchar_to_premul_float(float result[4], const unsigned char color[4]);
 MINLINE void premul_float_to_straight_uchar(unsigned char *result, const float color[4]);
 
+/***************** Rows of RGBA Pixels ********************/
+
+/* Conversions of rows of pixels, using SSE2 when available.
+ * The byte conversions match the per pixel functions, except for the dither noise of the pixel
+ * at index x, `dither_random_value(x * dither_s_step, dither_t)`, which may differ in rounding.
+ * The sRGB byte conversion uses the table of linearrgb_to_srgb_ushort4(). */
+
+void straight_to_premul_rgba_row(float *rgba, const int num_pixels);
+void premul_to_straight_rgba_row(float *rgba, const int num_pixels);
+void rgba_float_to_uchar_row(unsigned char *r_col,
+                             const float *col_f,
+                             const int num_pixels,
+                             const bool predivide,
+                             const float dither,
+                             const float dither_s_step,
+                             const float dither_t);
+void linearrgb_to_srgb_uchar4_row(unsigned char *r_srgb,
+                                  const float *linear,
+                                  const int num_pixels,
+                                  const bool predivide,
+                                  const float dither,
+                                  const float dither_s_step,
+                                  const float dither_t);
+
 /************************** Other *************************/
 
 int constrain_rgb(float *r, float *g, float *b);
@@ -24,6 +24,8 @@
  * \ingroup bli
  */
 
+#include <string.h>
+
 #include "BLI_math.h"
 #include "BLI_utildefines.h"
 
@@ -549,6 +551,277 @@ void rgb_byte_set_hue_float_offset(unsigned char rgb[3], float hue_offset)
   rgb_float_to_uchar(rgb, rgb_float);
 }
 
+/* ********************************* pixel rows ********************************* */
+
+#ifdef __SSE2__
+
+/* Color channels of rgb with the alpha of rgba. */
+MALWAYS_INLINE __m128 rgba_keep_alpha_sse(const __m128 rgb, const __m128 rgba)
+{
+  const __m128 alpha_mask = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+  return _bli_math_blend_sse(alpha_mask, rgba, rgb);
+}
+
+MALWAYS_INLINE __m128 straight_to_premul_sse(const __m128 straight)
+{
+  const __m128 alpha = _mm_shuffle_ps(straight, straight, _MM_SHUFFLE(3, 3, 3, 3));
+  return rgba_keep_alpha_sse(_mm_mul_ps(straight, alpha), straight);
+}
+
+MALWAYS_INLINE __m128 premul_to_straight_sse(const __m128 premul)
+{
+  const __m128 alpha = _mm_shuffle_ps(premul, premul, _MM_SHUFFLE(3, 3, 3, 3));
+  const __m128 straight = _mm_mul_ps(premul, _mm_div_ps(_mm_set1_ps(1.0f), alpha));
+  /* Zero alpha keeps the color, see premul_to_straight_v4_v4(). */
+  const __m128 valid = _mm_cmpneq_ps(alpha, _mm_setzero_ps());
+  return rgba_keep_alpha_sse(_bli_math_blend_sse(valid, straight, premul), premul);
+}
+
+/* Same rounding as unit_float_to_uchar_clamp(), result in 32 bit lanes. */
+MALWAYS_INLINE __m128i unit_float_to_uchar_clamp_sse(const __m128 f)
+{
+  const __m128 clamped = _mm_min_ps(_mm_max_ps(f, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+  return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(clamped, _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f)));
+}
+
+/* Same rounding as unit_ushort_to_uchar() for values in 32 bit lanes, values above 255 are
+ * saturated when packing. */
+MALWAYS_INLINE __m128i unit_ushort_to_uchar_sse(const __m128i us)
+{
+  return _mm_srli_epi32(_mm_add_epi32(us, _mm_set1_epi32(128)), 8);
+}
+
+/* sinf() of four values, with the range reduction and polynomials of the Cephes library. */
+MALWAYS_INLINE __m128 sin_sse(__m128 x)
+{
+  const __m128 sign_mask = _mm_castsi128_ps(_mm_set1_epi32((int)0x80000000));
+  __m128 sign = _mm_and_ps(x, sign_mask);
+  x = _mm_andnot_ps(sign_mask, x);
+
+  /* Octant of x, rounded up to an even one. */
+  __m128i j = _mm_cvttps_epi32(_mm_mul_ps(x, _mm_set1_ps(1.27323954473516f)));
+  j = _mm_and_si128(_mm_add_epi32(j, _mm_set1_epi32(1)), _mm_set1_epi32(~1));
+  const __m128 y = _mm_cvtepi32_ps(j);
+  /* The result is negated in octants 4 to 7 and uses the cosine polynomial in 2, 3, 6 and 7. */
+  sign = _mm_xor_ps(
+      sign, _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(j, _mm_set1_epi32(4)), 29)));
+  const __m128 use_cos = _mm_castsi128_ps(
+      _mm_cmpeq_epi32(_mm_and_si128(j, _mm_set1_epi32(2)), _mm_set1_epi32(2)));
+
+  /* x - y * pi/4 in extended precision. */
+  x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(-0.78515625f)));
+  x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(-2.4187564849853515625e-4f)));
+  x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(-3.77489497744594108e-8f)));
+  const __m128 z = _mm_mul_ps(x, x);
+
+  __m128 c = _mm_set1_ps(2.443315711809948e-5f);
+  c = _mm_add_ps(_mm_mul_ps(c, z), _mm_set1_ps(-1.388731625493765e-3f));
+  c = _mm_add_ps(_mm_mul_ps(c, z), _mm_set1_ps(4.166664568298827e-2f));
+  c = _mm_mul_ps(_mm_mul_ps(c, z), z);
+  c = _mm_add_ps(_mm_sub_ps(c, _mm_mul_ps(z, _mm_set1_ps(0.5f))), _mm_set1_ps(1.0f));
+
+  __m128 s = _mm_set1_ps(-1.9515295891e-4f);
+  s = _mm_add_ps(_mm_mul_ps(s, z), _mm_set1_ps(8.3321608736e-3f));
+  s = _mm_add_ps(_mm_mul_ps(s, z), _mm_set1_ps(-1.6666654611e-1f));
+  s = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(s, z), x), x);
+
+  return _mm_xor_ps(_bli_math_blend_sse(use_cos, c, s), sign);
+}
+
+MALWAYS_INLINE __m128 fract_sse(const __m128 x)
+{
+  /* Truncation rounds negative values up, floorf() needs one less for those. */
+  __m128 floor = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+  floor = _mm_sub_ps(floor, _mm_and_ps(_mm_cmpgt_ps(floor, x), _mm_set1_ps(1.0f)));
+  return _mm_sub_ps(x, floor);
+}
+
+/* dither_random_value() of four pixels, the sines only differ from sinf() by rounding. */
+MALWAYS_INLINE __m128 dither_random_value_sse(const __m128 s, const __m128 t)
+{
+  const __m128 nrnd0 = _mm_mul_ps(
+      sin_sse(_mm_add_ps(_mm_mul_ps(s, _mm_set1_ps(12.9898f)),
+                         _mm_mul_ps(t, _mm_set1_ps(78.233f)))),
+      _mm_set1_ps(43758.5453f));
+  const __m128 nrnd1 = _mm_mul_ps(
+      sin_sse(_mm_add_ps(_mm_mul_ps(s, _mm_set1_ps(19.9898f)),
+                         _mm_mul_ps(t, _mm_set1_ps(119.233f)))),
+      _mm_set1_ps(43798.5453f));
+  return _mm_sub_ps(_mm_add_ps(fract_sse(nrnd0), fract_sse(nrnd1)), _mm_set1_ps(0.5f));
+}
+
+MALWAYS_INLINE __m128i rgba_float_to_uchar_pixel_sse(const float *col_f,
+                                                     const bool to_srgb,
+                                                     const bool predivide,
+                                                     const bool use_dither,
+                                                     const float dither_value)
+{
+  __m128 f = _mm_loadu_ps(col_f);
+  if (predivide) {
+    f = premul_to_straight_sse(f);
+  }
+  const __m128 dither_rgb = _mm_set_ps(0.0f, dither_value, dither_value, dither_value);
+
+  if (!to_srgb) {
+    return unit_float_to_uchar_clamp_sse(use_dither ? _mm_add_ps(f, dither_rgb) : f);
+  }
+
+  /* The lookup table and rounding of linearrgb_to_srgb_ushort4(), which is more accurate and
+   * faster than computing the powers for the conversion to bytes. */
+  float straight[4];
+  _mm_storeu_ps(straight, f);
+  const __m128i us = _mm_set_epi32(unit_float_to_ushort_clamp(straight[3]),
+                                   to_srgb_table_lookup(straight[2]),
+                                   to_srgb_table_lookup(straight[1]),
+                                   to_srgb_table_lookup(straight[0]));
+  const __m128i b = unit_ushort_to_uchar_sse(us);
+  if (!use_dither) {
+    return b;
+  }
+  const __m128 srgb = _mm_div_ps(_mm_cvtepi32_ps(us), _mm_set1_ps(65535.0f));
+  const __m128i b_dither = unit_float_to_uchar_clamp_sse(_mm_add_ps(srgb, dither_rgb));
+  /* Alpha is not dithered. */
+  return _mm_castps_si128(rgba_keep_alpha_sse(_mm_castsi128_ps(b_dither), _mm_castsi128_ps(b)));
+}
+
+#endif /* __SSE2__ */
+
+void straight_to_premul_rgba_row(float *rgba, const int num_pixels)
+{
+#ifdef __SSE2__
+  for (int i = 0; i < num_pixels; i++, rgba += 4) {
+    _mm_storeu_ps(rgba, straight_to_premul_sse(_mm_loadu_ps(rgba)));
+  }
+#else
+  for (int i = 0; i < num_pixels; i++, rgba += 4) {
+    straight_to_premul_v4(rgba);
+  }
+#endif
+}
+
+void premul_to_straight_rgba_row(float *rgba, const int num_pixels)
+{
+#ifdef __SSE2__
+  for (int i = 0; i < num_pixels; i++, rgba += 4) {
+    _mm_storeu_ps(rgba, premul_to_straight_sse(_mm_loadu_ps(rgba)));
+  }
+#else
+  for (int i = 0; i < num_pixels; i++, rgba += 4) {
+    premul_to_straight_v4(rgba);
+  }
+#endif
+}
+
+/* The options are constant for the whole row, inlining into the callers below lets the
+ * compiler move their branches out of the loop. */
+BLI_INLINE void rgba_float_to_uchar_row_ex(unsigned char *r_col,
+                                           const float *col_f,
+                                           const int num_pixels,
+                                           const bool to_srgb,
+                                           const bool predivide,
+                                           const float dither,
+                                           const float dither_s_step,
+                                           const float dither_t)
+{
+  const bool use_dither = dither != 0.0f;
+
+#ifdef __SSE2__
+  /* Groups of four pixels, to compute their dither together and write their bytes with a
+   * single store. */
+  for (int i = 0; i < num_pixels; i += 4) {
+    const int num = min_ii(num_pixels - i, 4);
+
+    float dither_values[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    if (use_dither) {
+      const __m128 s = _mm_mul_ps(_mm_cvtepi32_ps(_mm_set_epi32(i + 3, i + 2, i + 1, i)),
+                                  _mm_set1_ps(dither_s_step));
+      const __m128 noise = dither_random_value_sse(s, _mm_set1_ps(dither_t));
+      _mm_storeu_ps(dither_values,
+                    _mm_mul_ps(_mm_mul_ps(noise, _mm_set1_ps(0.0033f)), _mm_set1_ps(dither)));
+    }
+
+    __m128i pixels[4];
+    for (int j = 0; j < 4; j++) {
+      pixels[j] = (j < num) ? rgba_float_to_uchar_pixel_sse(col_f + (size_t)(i + j) * 4,
+                                                            to_srgb,
+                                                            predivide,
+                                                            use_dither,
+                                                            dither_values[j]) :
+                              _mm_setzero_si128();
+    }
+    const __m128i packed = _mm_packus_epi16(_mm_packs_epi32(pixels[0], pixels[1]),
+                                            _mm_packs_epi32(pixels[2], pixels[3]));
+    if (num == 4) {
+      _mm_storeu_si128((__m128i *)(r_col + (size_t)i * 4), packed);
+    }
+    else {
+      unsigned char bytes[16];
+      _mm_storeu_si128((__m128i *)bytes, packed);
+      memcpy(r_col + (size_t)i * 4, bytes, (size_t)num * 4);
+    }
+  }
+#else
+  for (int i = 0; i < num_pixels; i++) {
+    const float *from = col_f + (size_t)i * 4;
+    unsigned char *to = r_col + (size_t)i * 4;
+    float straight[4];
+    if (predivide) {
+      premul_to_straight_v4_v4(straight, from);
+      from = straight;
+    }
+
+    if (to_srgb) {
+      unsigned short us[4];
+      linearrgb_to_srgb_ushort4(us, from);
+      if (use_dither) {
+        const float srgb[3] = {us[0] / 65535.0f, us[1] / 65535.0f, us[2] / 65535.0f};
+        float_to_byte_dither_v3(to, srgb, dither, (float)i * dither_s_step, dither_t);
+        to[3] = unit_ushort_to_uchar(us[3]);
+      }
+      else {
+        to[0] = unit_ushort_to_uchar(us[0]);
+        to[1] = unit_ushort_to_uchar(us[1]);
+        to[2] = unit_ushort_to_uchar(us[2]);
+        to[3] = unit_ushort_to_uchar(us[3]);
+      }
+    }
+    else {
+      if (use_dither) {
+        float_to_byte_dither_v3(to, from, dither, (float)i * dither_s_step, dither_t);
+        to[3] = unit_float_to_uchar_clamp(from[3]);
+      }
+      else {
+        rgba_float_to_uchar(to, from);
+      }
+    }
+  }
+#endif
+}
+
+void rgba_float_to_uchar_row(unsigned char *r_col,
+                             const float *col_f,
+                             const int num_pixels,
+                             const bool predivide,
+                             const float dither,
+                             const float dither_s_step,
+                             const float dither_t)
+{
+  rgba_float_to_uchar_row_ex(
+      r_col, col_f, num_pixels, false, predivide, dither, dither_s_step, dither_t);
+}
+
+void linearrgb_to_srgb_uchar4_row(unsigned char *r_srgb,
+                                  const float *linear,
+                                  const int num_pixels,
+                                  const bool predivide,
+                                  const float dither,
+                                  const float dither_s_step,
+                                  const float dither_t)
+{
+  rgba_float_to_uchar_row_ex(
+      r_srgb, linear, num_pixels, true, predivide, dither, dither_s_step, dither_t);
+}
+
 /* fast sRGB conversion
  * LUT from linear float to 16-bit short
  * based on http://mysite.verizon.net/spitzak/conversion/
@@ -162,6 +162,36 @@ int BLI_cpu_support_sse41(void)
   return 0;
 }
 
+static unsigned int xgetbv_xcr0(void)
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  return (unsigned int)_xgetbv(0);
+#elif defined(__x86_64__) || defined(__i386__)
+  unsigned int eax, edx;
+  __asm__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return eax;
+#else
+  return 0;
+#endif
+}
+
+int BLI_cpu_support_f16c(void)
+{
+  int result[4], num;
+  __cpuid(result, 0);
+  num = result[0];
+
+  if (num >= 1) {
+    __cpuid(result, 0x00000001);
+    /* The instructions are VEX encoded, the OS has to preserve the AVX registers as well. */
+    const int required = ((int)1 << 27) | ((int)1 << 28) | ((int)1 << 29);
+    if ((result[2] & required) == required) {
+      return (xgetbv_xcr0() & 0x6) == 0x6;
+    }
+  }
+  return 0;
+}
+
 void BLI_hostname_get(char *buffer, size_t bufsize)
 {
 #ifndef WIN32
@@ -74,3 +74,59 @@ TEST(math_color, LinearRGBTosRGBRoundtrip)
     EXPECT_NEAR(orig_linear_color, linear_color, 1e-5);
   }
 }
+
+/* Seven pixels, so the row functions also convert pixels after their groups of four. */
+static const float row_pixels[7][4] = {
+    {0.1f, 0.2f, 0.3f, 0.5f},
+    {0.0f, 0.5f, 1.0f, 1.0f},
+    {0.2f, 0.4f, 0.6f, 0.0f},
+    {-0.1f, 1.5f, 0.002f, 0.25f},
+    {0.7f, 0.8f, 0.9f, 0.9f},
+    {2.0f, 0.3f, 0.1f, 1.2f},
+    {0.01f, 0.02f, 0.03f, 0.05f},
+};
+
+TEST(math_color, AlphaRows)
+{
+  float premul[7][4], straight[7][4];
+  memcpy(premul, row_pixels, sizeof(premul));
+  memcpy(straight, row_pixels, sizeof(straight));
+  straight_to_premul_rgba_row(&premul[0][0], 7);
+  premul_to_straight_rgba_row(&straight[0][0], 7);
+
+  for (int i = 0; i < 7; i++) {
+    float expected[4];
+    straight_to_premul_v4_v4(expected, row_pixels[i]);
+    EXPECT_V4_NEAR(expected, premul[i], 1e-6f);
+    premul_to_straight_v4_v4(expected, row_pixels[i]);
+    EXPECT_V4_NEAR(expected, straight[i], 1e-6f);
+  }
+}
+
+TEST(math_color, FloatToUcharRow)
+{
+  const float dither = 1.0f, dither_s_step = 1.0f / 7.0f, dither_t = 0.5f;
+  unsigned char result[7][4], result_srgb[7][4];
+  BLI_init_srgb_conversion();
+  rgba_float_to_uchar_row(
+      &result[0][0], &row_pixels[0][0], 7, true, dither, dither_s_step, dither_t);
+  linearrgb_to_srgb_uchar4_row(&result_srgb[0][0], &row_pixels[0][0], 7, false, 0.0f, 0.0f, 0.0f);
+
+  for (int i = 0; i < 7; i++) {
+    float straight[4];
+    premul_to_straight_v4_v4(straight, row_pixels[i]);
+    unsigned char expected[4];
+    float_to_byte_dither_v3(expected, straight, dither, i * dither_s_step, dither_t);
+    expected[3] = unit_float_to_uchar_clamp(straight[3]);
+    /* The dither noise may be rounded differently. */
+    for (int j = 0; j < 4; j++) {
+      EXPECT_NEAR(expected[j], result[i][j], 1);
+    }
+
+    unsigned short us[4];
+    linearrgb_to_srgb_ushort4(us, row_pixels[i]);
+    for (int j = 0; j < 4; j++) {
+      EXPECT_EQ(unit_ushort_to_uchar(us[j]), result_srgb[i][j]);
+    }
+  }
+}
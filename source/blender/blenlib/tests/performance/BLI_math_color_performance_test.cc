@@ -0,0 +1,148 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_math.h"
+#include "BLI_rand.h"
+#include "BLI_utildefines.h"
+
+#include "PIL_time.h"
+
+/* Size of an image row and number of rows converted per run, 4K frames. */
+#define ROW_WIDTH 3840
+#define ROW_NUM 2160
+#define NUM_RUN 5
+
+/* The per pixel loops the row functions replace in the image buffer conversions. */
+
+static void scalar_straight_to_premul(float *rgba, const int width)
+{
+  for (int x = 0; x < width; x++, rgba += 4) {
+    straight_to_premul_v4(rgba);
+  }
+}
+
+static void scalar_premul_to_straight(float *rgba, const int width)
+{
+  for (int x = 0; x < width; x++, rgba += 4) {
+    premul_to_straight_v4(rgba);
+  }
+}
+
+static void scalar_float_to_uchar_dither_predivide(
+    unsigned char *to, const float *from, const int width, const float dither, const float t)
+{
+  const float inv_width = 1.0f / width;
+  for (int x = 0; x < width; x++, from += 4, to += 4) {
+    float straight[4];
+    premul_to_straight_v4_v4(straight, from);
+    const float dither_value = dither_random_value(x * inv_width, t) * 0.0033f * dither;
+    to[0] = unit_float_to_uchar_clamp(dither_value + straight[0]);
+    to[1] = unit_float_to_uchar_clamp(dither_value + straight[1]);
+    to[2] = unit_float_to_uchar_clamp(dither_value + straight[2]);
+    to[3] = unit_float_to_uchar_clamp(straight[3]);
+  }
+}
+
+static void scalar_linearrgb_to_srgb_uchar(unsigned char *to, const float *from, const int width)
+{
+  for (int x = 0; x < width; x++, from += 4, to += 4) {
+    unsigned short us[4];
+    linearrgb_to_srgb_ushort4(us, from);
+    to[0] = unit_ushort_to_uchar(us[0]);
+    to[1] = unit_ushort_to_uchar(us[1]);
+    to[2] = unit_ushort_to_uchar(us[2]);
+    to[3] = unit_ushort_to_uchar(us[3]);
+  }
+}
+
+static float *color_rows_create()
+{
+  float *rows = (float *)MEM_mallocN(sizeof(float[4]) * ROW_WIDTH * ROW_NUM, __func__);
+  RNG *rng = BLI_rng_new(0);
+  for (int i = 0; i < ROW_WIDTH * ROW_NUM; i++) {
+    const float alpha = BLI_rng_get_float(rng);
+    rows[i * 4 + 0] = BLI_rng_get_float(rng) * alpha;
+    rows[i * 4 + 1] = BLI_rng_get_float(rng) * alpha;
+    rows[i * 4 + 2] = BLI_rng_get_float(rng) * alpha;
+    rows[i * 4 + 3] = alpha;
+  }
+  BLI_rng_free(rng);
+  return rows;
+}
+
+static void print_throughput(const char *id, const double time_scalar, const double time_rows)
+{
+  const double megapixels = (double)ROW_WIDTH * ROW_NUM * NUM_RUN / 1e6;
+  printf("\t%s:\n\t\tscalar: %.1f MP/s\n\t\trows: %.1f MP/s (%.2fx)\n",
+         id,
+         megapixels / time_scalar,
+         megapixels / time_rows,
+         time_scalar / time_rows);
+}
+
+#define BENCH_ROWS(r_time, expr) \
+  { \
+    const double _start = PIL_check_seconds_timer(); \
+    for (int run = 0; run < NUM_RUN; run++) { \
+      for (int y = 0; y < ROW_NUM; y++) { \
+        expr; \
+      } \
+    } \
+    r_time = PIL_check_seconds_timer() - _start; \
+  } \
+  (void)0
+
+TEST(math_color, AlphaRows)
+{
+  printf("\n========== STARTING %s ==========\n", __func__);
+  float *rows = color_rows_create();
+  double time_scalar, time_rows;
+
+  BENCH_ROWS(time_scalar, scalar_straight_to_premul(rows + y * ROW_WIDTH * 4, ROW_WIDTH));
+  BENCH_ROWS(time_rows, straight_to_premul_rgba_row(rows + y * ROW_WIDTH * 4, ROW_WIDTH));
+  print_throughput("Premultiply", time_scalar, time_rows);
+
+  BENCH_ROWS(time_scalar, scalar_premul_to_straight(rows + y * ROW_WIDTH * 4, ROW_WIDTH));
+  BENCH_ROWS(time_rows, premul_to_straight_rgba_row(rows + y * ROW_WIDTH * 4, ROW_WIDTH));
+  print_throughput("Unpremultiply", time_scalar, time_rows);
+
+  MEM_freeN(rows);
+  printf("========== ENDED %s ==========\n\n", __func__);
+}
+
+TEST(math_color, FloatRowsToUchar)
+{
+  printf("\n========== STARTING %s ==========\n", __func__);
+  BLI_init_srgb_conversion();
+  float *rows = color_rows_create();
+  unsigned char *result = (unsigned char *)MEM_mallocN(4 * ROW_WIDTH, __func__);
+  double time_scalar, time_rows;
+
+  BENCH_ROWS(time_scalar,
+             scalar_float_to_uchar_dither_predivide(
+                 result, rows + y * ROW_WIDTH * 4, ROW_WIDTH, 1.0f, (float)y / ROW_NUM));
+  BENCH_ROWS(time_rows,
+             rgba_float_to_uchar_row(result,
+                                     rows + y * ROW_WIDTH * 4,
+                                     ROW_WIDTH,
+                                     true,
+                                     1.0f,
+                                     1.0f / ROW_WIDTH,
+                                     (float)y / ROW_NUM));
+  print_throughput("Unpremultiply and dither to byte", time_scalar, time_rows);
+
+  BENCH_ROWS(time_scalar,
+             scalar_linearrgb_to_srgb_uchar(result, rows + y * ROW_WIDTH * 4, ROW_WIDTH));
+  BENCH_ROWS(
+      time_rows,
+      linearrgb_to_srgb_uchar4_row(
+          result, rows + y * ROW_WIDTH * 4, ROW_WIDTH, false, 0.0f, 1.0f / ROW_WIDTH, 0.0f));
+  print_throughput("Linear to sRGB byte", time_scalar, time_rows);
+
+  MEM_freeN(result);
+  MEM_freeN(rows);
+  printf("========== ENDED %s ==========\n\n", __func__);
+}
@@ -820,6 +820,15 @@ void blo_do_versions_userdef(UserDef *userdef)
     userdef->uiflag &= ~USER_UIFLAG_UNUSED_3;
   }
 
+  if (!USER_VERSION_ATLEAST(292, 9)) {
+    if (BLI_listbase_is_empty(&userdef->asset_libraries)) {
+      BKE_preferences_asset_library_default_add(userdef);
+    }
+    /* Zero disables the caches, only set the defaults once. */
+    userdef->geometry_nodes_cache_limit = 512;
+    userdef->compositor_cache_limit = 1024;
+  }
+
   /**
    * Versioning code until next subversion bump goes here.
    *
@@ -831,9 +840,6 @@ void blo_do_versions_userdef(UserDef *userdef)
    */
   {
     /* Keep this block, even when empty. */
-    if (BLI_listbase_is_empty(&userdef->asset_libraries)) {
-      BKE_preferences_asset_library_default_add(userdef);
-    }
   }
 
   LISTBASE_FOREACH (bTheme *, btheme, &userdef->themes) {
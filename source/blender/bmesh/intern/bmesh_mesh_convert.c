@@ -984,7 +984,7 @@ void BM_mesh_bm_to_me(Main *bmain, BMesh *bm, Mesh *me, const struct BMeshToMesh
   multires_topology_changed(me);
 
   /* To be removed as soon as COW is enabled by default.. */
-  BKE_mesh_runtime_clear_geometry(me);
+  BKE_mesh_runtime_tag_dirty(me, ME_RUNTIME_DIRTY_TOPOLOGY);
 }
 
 /**
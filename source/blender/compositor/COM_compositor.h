@@ -157,8 +157,11 @@ extern "C" {
  * The relevant ExecutionGroup (that can calculate the missing chunks; ExecutionGroup A)
  * is asked to calculate the area ExecutionGroup B is missing.
  * [@ref ExecutionGroup.scheduleAreaWhenPossible]
- * ExecutionGroup B checks what chunks the area spans, and tries to schedule these chunks.
- * If all input data is available these chunks are scheduled [@ref ExecutionGroup.scheduleChunk]
+ * ExecutionGroup A checks what chunks the area spans, schedules these chunks and registers the
+ * chunk of ExecutionGroup B as waiting for the ones that haven't been executed yet.
+ * Chunks whose input data is available are scheduled [@ref ExecutionGroup.scheduleChunk].
+ * The thread executing the last missing input of a waiting chunk schedules it, so no thread
+ * polls for chunks becoming available.
  *
  * <pre>
  *
@@ -195,7 +198,9 @@ extern "C" {
  *            .                                O                                            |
  * </pre>
  *
- * This happens until all chunks of (ExecutionGroup B) are finished executing or the user break's the process.
+ * All chunks of (ExecutionGroup B) are scheduled this way, after which the ExecutionGroup waits
+ * until they are finished executing. When the user breaks the process no more chunks are
+ * scheduled.
  *
  * NodeOperation like the ScaleOperation can influence the area of interest by reimplementing the
  * [@ref NodeOperation.determineAreaOfInterest] method
@@ -221,8 +226,8 @@ extern "C" {
  *
  * \see ExecutionGroup.execute Execute a complete ExecutionGroup.
  * Halts until finished or breaked by user
- * \see ExecutionGroup.scheduleChunkWhenPossible Tries to schedule a single chunk,
- * checks if all input data is available. Can trigger dependent chunks to be calculated
+ * \see ExecutionGroup.scheduleChunkWhenPossible Schedules a single chunk to be executed when
+ * all its input data is available. Can trigger dependent chunks to be calculated
  * \see ExecutionGroup.scheduleAreaWhenPossible
  * Tries to schedule an area. This can be multiple chunks
  * (is called from [@ref ExecutionGroup.scheduleChunkWhenPossible])
@@ -241,12 +246,12 @@ extern "C" {
  * For witching these between the state you need to recompile blender
  *
  * \subsection multithread Multi threaded
- * Default the work-scheduler will place all work as WorkPackage in a queue.
- * For every CPUcore a working thread is created.
- * These working threads will ask the WorkScheduler if there is work
- * for a specific Device.
- * the work-scheduler will find work for the device and the device
- * will be asked to execute the WorkPackage.
+ * Default the work-scheduler will push all work for the CPU as WorkPackage tasks in a task pool.
+ * The threads of the task scheduler execute them, threads running out of work steal tasks from
+ * other threads. Chunks scheduled by a thread when their inputs are executed are likely executed
+ * by the same thread, while their input data is still in its cache.
+ * Work for OpenCL devices is placed in a queue, for every OpenCL device a thread is created
+ * that takes work from it.
  *
  * \subsection singlethread Single threaded
  * For debugging reasons the multi-threading can be disabled.
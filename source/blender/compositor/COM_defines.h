@@ -58,6 +58,18 @@ typedef enum CompositorPriority {
   COM_PRIORITY_LOW = 0,
 } CompositorPriority;
 
+/**
+ * \brief Possible execution models of the compositor
+ * \see CompositorContext.getExecutionModel
+ * \ingroup Execution
+ */
+typedef enum eExecutionModel {
+  /** \brief Execute operations per chunk, reading every pixel through its inputs */
+  COM_EXECUTION_MODEL_TILED = 0,
+  /** \brief Execute operations one at a time over their whole output buffer */
+  COM_EXECUTION_MODEL_FULL_FRAME = 1,
+} eExecutionModel;
+
 // configurable items
 
 // chunk size determination
@@ -67,10 +79,11 @@ typedef enum CompositorPriority {
 
 // workscheduler threading models
 /**
- * COM_TM_QUEUE is a multi-threaded model, which uses the BLI_thread_queue pattern.
+ * COM_TM_TASK is a multi-threaded model, which executes chunks as tasks of a BLI_task pool.
+ * Threads steal tasks from each other when there is no work left in their own queue.
  * This is the default option.
  */
-#define COM_TM_QUEUE 1
+#define COM_TM_TASK 1
 
 /**
  * COM_TM_NOTHREAD is a single threading model, everything is executed in the caller thread.
@@ -79,9 +92,9 @@ typedef enum CompositorPriority {
 #define COM_TM_NOTHREAD 0
 
 /**
- * COM_CURRENT_THREADING_MODEL can be one of the above, COM_TM_QUEUE is currently default.
+ * COM_CURRENT_THREADING_MODEL can be one of the above, COM_TM_TASK is currently default.
  */
-#define COM_CURRENT_THREADING_MODEL COM_TM_QUEUE
+#define COM_CURRENT_THREADING_MODEL COM_TM_TASK
 // chunk order
 /**
  * \brief The order of chunks to be scheduled
@@ -102,6 +115,9 @@ typedef enum OrderOfChunks {
 
 #define COM_RULE_OF_THIRDS_DIVIDER 100.0f
 
+/** \brief size in chunks of the square blocks chunks of non-viewer outputs are scheduled in */
+#define COM_CHUNK_ORDER_BLOCK_SIZE 4
+
 #define COM_NUM_CHANNELS_VALUE 1
 #define COM_NUM_CHANNELS_VECTOR 3
 #define COM_NUM_CHANNELS_COLOR 4
@@ -17,6 +17,7 @@
  */
 
 #include "COM_CPUDevice.h"
+#include "COM_ReadBufferOperation.h"
 
 CPUDevice::CPUDevice(int thread_id) : m_thread_id(thread_id)
 {
@@ -29,8 +30,11 @@ void CPUDevice::execute(WorkPackage *work)
   rcti rect;
 
   executionGroup->determineChunkRect(&rect, chunkNumber);
+  MemoryBuffer **inputBuffers = executionGroup->getInputBuffersCPU(chunkNumber);
 
+  MemoryBuffer **previousBuffers = ReadBufferOperation::set_thread_chunk_buffers(inputBuffers);
   executionGroup->getOutputOperation()->executeRegion(&rect, chunkNumber);
+  ReadBufferOperation::set_thread_chunk_buffers(previousBuffers);
 
-  executionGroup->finalizeChunkExecution(chunkNumber, nullptr);
+  executionGroup->finalizeChunkExecution(chunkNumber, inputBuffers);
 }
@@ -22,8 +22,8 @@
 
 /**
  * \brief class representing a CPU device.
- * \note for every hardware thread in the system a CPUDevice instance
- * will exist in the workscheduler.
+ * \note the workscheduler executes every WorkPackage for the CPU with a CPUDevice instance of
+ * the thread of the task scheduler running it.
  */
 class CPUDevice : public Device {
  public:
@@ -263,10 +263,18 @@ class CompositorContext {
   {
     return this->m_fastCalculation;
   }
+  eExecutionModel getExecutionModel() const
+  {
+    return (eExecutionModel)this->getbNodeTree()->execution_mode;
+  }
   bool isGroupnodeBufferEnabled() const
   {
     return (this->getbNodeTree()->flag & NTREE_COM_GROUPNODE_BUFFER) != 0;
   }
+  bool isHalfBufferEnabled() const
+  {
+    return (this->getbNodeTree()->flag & NTREE_COM_HALF_BUFFERS) != 0;
+  }
 
   /**
    * \brief Get the render percentage as a factor.
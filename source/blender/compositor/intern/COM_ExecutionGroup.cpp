@@ -27,6 +27,7 @@
 #include "COM_Debug.h"
 #include "COM_ExecutionGroup.h"
 #include "COM_ExecutionSystem.h"
+#include "COM_MemoryPager.h"
 #include "COM_ReadBufferOperation.h"
 #include "COM_ViewerOperation.h"
 #include "COM_WorkScheduler.h"
@@ -46,6 +47,8 @@ ExecutionGroup::ExecutionGroup()
   this->m_isOutput = false;
   this->m_complex = false;
   this->m_chunkExecutionStates = nullptr;
+  this->m_chunkWaiters = nullptr;
+  this->m_chunkPendingInputs = nullptr;
   this->m_bTree = nullptr;
   this->m_height = 0;
   this->m_width = 0;
@@ -134,7 +137,11 @@ void ExecutionGroup::initExecution()
     for (index = 0; index < this->m_numberOfChunks; index++) {
       this->m_chunkExecutionStates[index] = COM_ES_NOT_SCHEDULED;
     }
+    this->m_chunkWaiters = new std::vector<ChunkWaiter>[this->m_numberOfChunks];
+    this->m_chunkPendingInputs = (int *)MEM_callocN(sizeof(int) * this->m_numberOfChunks,
+                                                    __func__);
   }
+  BLI_mutex_init(&this->m_chunkMutex);
 
   unsigned int maxNumber = 0;
 
@@ -156,6 +163,15 @@ void ExecutionGroup::deinitExecution()
     MEM_freeN(this->m_chunkExecutionStates);
     this->m_chunkExecutionStates = nullptr;
   }
+  if (this->m_chunkWaiters != nullptr) {
+    delete[] this->m_chunkWaiters;
+    this->m_chunkWaiters = nullptr;
+  }
+  if (this->m_chunkPendingInputs != nullptr) {
+    MEM_freeN(this->m_chunkPendingInputs);
+    this->m_chunkPendingInputs = nullptr;
+  }
+  BLI_mutex_end(&this->m_chunkMutex);
   this->m_numberOfChunks = 0;
   this->m_numberOfXChunks = 0;
   this->m_numberOfYChunks = 0;
@@ -229,6 +245,25 @@ void ExecutionGroup::execute(ExecutionSystem *graph)
     centerY = viewer->getCenterY();
     chunkorder = viewer->getChunkOrder();
   }
+  else {
+    /* Nobody watches the chunks of other outputs appear, schedule them in square blocks so
+     * neighboring chunks reading the same input chunks are executed close in time. */
+    const unsigned int block = COM_CHUNK_ORDER_BLOCK_SIZE;
+    index = 0;
+    for (unsigned int yBlock = 0; yBlock < this->m_numberOfYChunks; yBlock += block) {
+      for (unsigned int xBlock = 0; xBlock < this->m_numberOfXChunks; xBlock += block) {
+        const unsigned int yEnd = min(yBlock + block, this->m_numberOfYChunks);
+        const unsigned int xEnd = min(xBlock + block, this->m_numberOfXChunks);
+        for (unsigned int yChunk = yBlock; yChunk < yEnd; yChunk++) {
+          for (unsigned int xChunk = xBlock; xChunk < xEnd; xChunk++) {
+            chunkOrder[index++] = yChunk * this->m_numberOfXChunks + xChunk;
+          }
+        }
+      }
+    }
+    BLI_assert(index == this->m_numberOfChunks);
+    chunkorder = COM_TO_TOP_DOWN;
+  }
 
   const int border_width = BLI_rcti_size_x(&this->m_viewerBorder);
   const int border_height = BLI_rcti_size_y(&this->m_viewerBorder);
@@ -322,55 +357,65 @@ void ExecutionGroup::execute(ExecutionSystem *graph)
   DebugInfo::execution_group_started(this);
   DebugInfo::graphviz(graph);
 
-  bool breaked = false;
-  bool finished = false;
-  unsigned int startIndex = 0;
-  const int maxNumberEvaluated = BLI_system_thread_count() * 2;
-
-  while (!finished && !breaked) {
-    bool startEvaluated = false;
-    finished = true;
-    int numberEvaluated = 0;
-
-    for (index = startIndex;
-         index < this->m_numberOfChunks && numberEvaluated < maxNumberEvaluated;
-         index++) {
-      chunkNumber = chunkOrder[index];
-      int yChunk = chunkNumber / this->m_numberOfXChunks;
-      int xChunk = chunkNumber - (yChunk * this->m_numberOfXChunks);
-      const ChunkExecutionState state = this->m_chunkExecutionStates[chunkNumber];
-      if (state == COM_ES_NOT_SCHEDULED) {
-        scheduleChunkWhenPossible(graph, xChunk, yChunk);
-        finished = false;
-        startEvaluated = true;
-        numberEvaluated++;
-
-        if (bTree->update_draw) {
-          bTree->update_draw(bTree->udh);
-        }
-      }
-      else if (state == COM_ES_SCHEDULED) {
-        finished = false;
-        startEvaluated = true;
-        numberEvaluated++;
-      }
-      else if (state == COM_ES_EXECUTED && !startEvaluated) {
-        startIndex = index + 1;
-      }
-    }
-
-    WorkScheduler::finish();
-
+  /* Chunks are dispatched by the threads executing their inputs, there is no need to wait for
+   * groups of chunks to finish before scheduling the next ones. */
+  for (index = 0; index < this->m_numberOfChunks; index++) {
     if (bTree->test_break && bTree->test_break(bTree->tbh)) {
-      breaked = true;
+      break;
     }
+    scheduleChunkWhenPossible(chunkOrder[index]);
+  }
+  if (bTree->update_draw) {
+    bTree->update_draw(bTree->udh);
   }
+
+  WorkScheduler::finish();
   DebugInfo::execution_group_finished(this);
   DebugInfo::graphviz(graph);
 
   MEM_freeN(chunkOrder);
 }
 
+MemoryBuffer **ExecutionGroup::getInputBuffersCPU(int chunkNumber)
+{
+  bool has_paged_input = false;
+  for (unsigned int index = 0; index < this->m_cachedReadOperations.size(); index++) {
+    ReadBufferOperation *readOperation =
+        (ReadBufferOperation *)this->m_cachedReadOperations[index];
+    if (readOperation->getMemoryProxy()->get_pager()) {
+      has_paged_input = true;
+      break;
+    }
+  }
+  if (!has_paged_input) {
+    return nullptr;
+  }
+
+  rcti rect;
+  determineChunkRect(&rect, chunkNumber);
+  MemoryBuffer **memoryBuffers = (MemoryBuffer **)MEM_callocN(
+      sizeof(MemoryBuffer *) * this->m_cachedMaxReadBufferOffset, __func__);
+  for (unsigned int index = 0; index < this->m_cachedReadOperations.size(); index++) {
+    ReadBufferOperation *readOperation =
+        (ReadBufferOperation *)this->m_cachedReadOperations[index];
+    MemoryProxy *memoryProxy = readOperation->getMemoryProxy();
+    if (memoryProxy->get_pager() == nullptr) {
+      continue;
+    }
+    /* Only the part inside the buffer is stored, reads outside of it are zero anyway. */
+    WriteBufferOperation *writeOperation = memoryProxy->getWriteBufferOperation();
+    rcti area, buffer_rect, output;
+    this->determineDependingAreaOfInterest(&rect, readOperation, &area);
+    BLI_rcti_init(&buffer_rect, 0, writeOperation->getWidth(), 0, writeOperation->getHeight());
+    if (!BLI_rcti_isect(&area, &buffer_rect, &output)) {
+      BLI_rcti_init(&output, 0, 1, 0, 1);
+    }
+    memoryBuffers[readOperation->getOffset()] =
+        memoryProxy->getExecutor()->constructConsolidatedMemoryBuffer(memoryProxy, &output);
+  }
+  return memoryBuffers;
+}
+
 MemoryBuffer **ExecutionGroup::getInputBuffersOpenCL(int chunkNumber)
 {
   rcti rect;
@@ -397,17 +442,34 @@ MemoryBuffer **ExecutionGroup::getInputBuffersOpenCL(int chunkNumber)
 MemoryBuffer *ExecutionGroup::constructConsolidatedMemoryBuffer(MemoryProxy *memoryProxy,
                                                                 rcti *rect)
 {
-  MemoryBuffer *imageBuffer = memoryProxy->getBuffer();
   MemoryBuffer *result = new MemoryBuffer(memoryProxy, rect);
-  result->copyContentFrom(imageBuffer);
+  MemoryPager *pager = memoryProxy->get_pager();
+  if (pager == nullptr) {
+    result->copyContentFrom(memoryProxy->getBuffer());
+    return result;
+  }
+
+  /* Gather the chunks this group has written, parts that haven't been calculated are zero. */
+  result->clear();
+  rcti chunks;
+  determine_chunk_range(rect, &chunks);
+  for (int yChunk = chunks.ymin; yChunk < chunks.ymax; yChunk++) {
+    for (int xChunk = chunks.xmin; xChunk < chunks.xmax; xChunk++) {
+      pager->read_chunk(memoryProxy, yChunk * this->m_numberOfXChunks + xChunk, result);
+    }
+  }
   return result;
 }
 
 void ExecutionGroup::finalizeChunkExecution(int chunkNumber, MemoryBuffer **memoryBuffers)
 {
+  std::vector<ChunkWaiter> waiters;
+  BLI_mutex_lock(&this->m_chunkMutex);
   if (this->m_chunkExecutionStates[chunkNumber] == COM_ES_SCHEDULED) {
     this->m_chunkExecutionStates[chunkNumber] = COM_ES_EXECUTED;
   }
+  waiters.swap(this->m_chunkWaiters[chunkNumber]);
+  BLI_mutex_unlock(&this->m_chunkMutex);
 
   atomic_add_and_fetch_u(&this->m_chunksFinished, 1);
   if (memoryBuffers) {
@@ -436,6 +498,15 @@ void ExecutionGroup::finalizeChunkExecution(int chunkNumber, MemoryBuffer **memo
                  this->m_numberOfChunks);
     this->m_bTree->stats_draw(this->m_bTree->sdh, buf);
   }
+
+  /* Dispatch waiting chunks from this thread, the data they read is still in its cache. */
+  for (unsigned int index = 0; index < waiters.size(); index++) {
+    ExecutionGroup *group = waiters[index].group;
+    const unsigned int waiterChunkNumber = waiters[index].chunkNumber;
+    if (atomic_sub_and_fetch_int32(&group->m_chunkPendingInputs[waiterChunkNumber], 1) == 0) {
+      group->scheduleChunk(waiterChunkNumber);
+    }
+  }
 }
 
 inline void ExecutionGroup::determineChunkRect(rcti *rect,
@@ -481,15 +552,13 @@ MemoryBuffer *ExecutionGroup::allocateOutputBuffer(int /*chunkNumber*/, rcti *re
   return nullptr;
 }
 
-bool ExecutionGroup::scheduleAreaWhenPossible(ExecutionSystem *graph, rcti *area)
+void ExecutionGroup::determine_chunk_range(const rcti *area, rcti *r_chunks) const
 {
   if (this->m_singleThreaded) {
-    return scheduleChunkWhenPossible(graph, 0, 0);
+    BLI_rcti_init(r_chunks, 0, 1, 0, 1);
+    return;
   }
-  // find all chunks inside the rect
   // determine minxchunk, minychunk, maxxchunk, maxychunk where x and y are chunknumbers
-
-  int indexx, indexy;
   int minx = max_ii(area->xmin - m_viewerBorder.xmin, 0);
   int maxx = min_ii(area->xmax - m_viewerBorder.xmin, m_viewerBorder.xmax - m_viewerBorder.xmin);
   int miny = max_ii(area->ymin - m_viewerBorder.ymin, 0);
@@ -502,81 +571,68 @@ bool ExecutionGroup::scheduleAreaWhenPossible(ExecutionSystem *graph, rcti *area
   minychunk = max_ii(minychunk, 0);
   maxxchunk = min_ii(maxxchunk, (int)m_numberOfXChunks);
   maxychunk = min_ii(maxychunk, (int)m_numberOfYChunks);
+  BLI_rcti_init(r_chunks, minxchunk, maxxchunk, minychunk, maxychunk);
+}
 
-  bool result = true;
-  for (indexx = minxchunk; indexx < maxxchunk; indexx++) {
-    for (indexy = minychunk; indexy < maxychunk; indexy++) {
-      if (!scheduleChunkWhenPossible(graph, indexx, indexy)) {
-        result = false;
+void ExecutionGroup::scheduleAreaWhenPossible(const rcti *area,
+                                              ExecutionGroup *waiter,
+                                              unsigned int waiterChunkNumber)
+{
+  // find all chunks inside the rect
+  rcti chunks;
+  determine_chunk_range(area, &chunks);
+
+  for (int indexy = chunks.ymin; indexy < chunks.ymax; indexy++) {
+    for (int indexx = chunks.xmin; indexx < chunks.xmax; indexx++) {
+      const unsigned int chunkNumber = indexy * this->m_numberOfXChunks + indexx;
+      scheduleChunkWhenPossible(chunkNumber);
+
+      /* Checked under the lock, the chunk can be executed by now. */
+      BLI_mutex_lock(&this->m_chunkMutex);
+      if (this->m_chunkExecutionStates[chunkNumber] != COM_ES_EXECUTED) {
+        ChunkWaiter chunkWaiter = {waiter, waiterChunkNumber};
+        this->m_chunkWaiters[chunkNumber].push_back(chunkWaiter);
+        atomic_add_and_fetch_int32(&waiter->m_chunkPendingInputs[waiterChunkNumber], 1);
       }
+      BLI_mutex_unlock(&this->m_chunkMutex);
     }
   }
-
-  return result;
 }
 
-bool ExecutionGroup::scheduleChunk(unsigned int chunkNumber)
+void ExecutionGroup::scheduleChunk(unsigned int chunkNumber)
 {
-  if (this->m_chunkExecutionStates[chunkNumber] == COM_ES_NOT_SCHEDULED) {
-    this->m_chunkExecutionStates[chunkNumber] = COM_ES_SCHEDULED;
-    WorkScheduler::schedule(this, chunkNumber);
-    return true;
-  }
-  return false;
+  WorkScheduler::schedule(this, chunkNumber);
 }
 
-bool ExecutionGroup::scheduleChunkWhenPossible(ExecutionSystem *graph, int xChunk, int yChunk)
+void ExecutionGroup::scheduleChunkWhenPossible(unsigned int chunkNumber)
 {
-  if (xChunk < 0 || xChunk >= (int)this->m_numberOfXChunks) {
-    return true;
-  }
-  if (yChunk < 0 || yChunk >= (int)this->m_numberOfYChunks) {
-    return true;
-  }
-  int chunkNumber = yChunk * this->m_numberOfXChunks + xChunk;
-  // chunk is already executed
-  if (this->m_chunkExecutionStates[chunkNumber] == COM_ES_EXECUTED) {
-    return true;
-  }
-
-  // chunk is scheduled, but not executed
-  if (this->m_chunkExecutionStates[chunkNumber] == COM_ES_SCHEDULED) {
-    return false;
+  BLI_mutex_lock(&this->m_chunkMutex);
+  if (this->m_chunkExecutionStates[chunkNumber] != COM_ES_NOT_SCHEDULED) {
+    BLI_mutex_unlock(&this->m_chunkMutex);
+    return;
   }
-
-  // chunk is nor executed nor scheduled.
-  vector<MemoryProxy *> memoryProxies;
-  this->determineDependingMemoryProxies(&memoryProxies);
+  this->m_chunkExecutionStates[chunkNumber] = COM_ES_SCHEDULED;
+  /* Keep the chunk from being dispatched while its inputs are being scheduled. */
+  this->m_chunkPendingInputs[chunkNumber] = 1;
+  BLI_mutex_unlock(&this->m_chunkMutex);
 
   rcti rect;
-  determineChunkRect(&rect, xChunk, yChunk);
-  unsigned int index;
-  bool canBeExecuted = true;
+  determineChunkRect(&rect, chunkNumber);
   rcti area;
 
-  for (index = 0; index < this->m_cachedReadOperations.size(); index++) {
+  for (unsigned int index = 0; index < this->m_cachedReadOperations.size(); index++) {
     ReadBufferOperation *readOperation =
         (ReadBufferOperation *)this->m_cachedReadOperations[index];
     BLI_rcti_init(&area, 0, 0, 0, 0);
-    MemoryProxy *memoryProxy = memoryProxies[index];
     determineDependingAreaOfInterest(&rect, readOperation, &area);
-    ExecutionGroup *group = memoryProxy->getExecutor();
-
-    if (group != nullptr) {
-      if (!group->scheduleAreaWhenPossible(graph, &area)) {
-        canBeExecuted = false;
-      }
-    }
-    else {
-      throw "ERROR";
-    }
+    ExecutionGroup *group = readOperation->getMemoryProxy()->getExecutor();
+    BLI_assert(group != nullptr);
+    group->scheduleAreaWhenPossible(&area, this, chunkNumber);
   }
 
-  if (canBeExecuted) {
+  if (atomic_sub_and_fetch_int32(&this->m_chunkPendingInputs[chunkNumber], 1) == 0) {
     scheduleChunk(chunkNumber);
   }
-
-  return false;
 }
 
 void ExecutionGroup::determineDependingAreaOfInterest(rcti *input,
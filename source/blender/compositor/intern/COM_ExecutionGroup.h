@@ -23,6 +23,7 @@
 #endif
 
 #include "BLI_rect.h"
+#include "BLI_threads.h"
 #include "COM_CompositorContext.h"
 #include "COM_Device.h"
 #include "COM_MemoryProxy.h"
@@ -48,6 +49,7 @@ typedef enum ChunkExecutionState {
   COM_ES_NOT_SCHEDULED = 0,
   /**
    * \brief chunk is scheduled, but not yet executed
+   * \note the chunk can still be waiting for chunks of other groups it depends on.
    */
   COM_ES_SCHEDULED = 1,
   /**
@@ -158,6 +160,33 @@ class ExecutionGroup {
    */
   ChunkExecutionState *m_chunkExecutionStates;
 
+  /**
+   * \brief a chunk of another ExecutionGroup waiting for a chunk of this group to be executed
+   */
+  typedef struct ChunkWaiter {
+    ExecutionGroup *group;
+    unsigned int chunkNumber;
+  } ChunkWaiter;
+
+  /**
+   * \brief per chunk the chunks of other groups that wait for it to be executed.
+   * When the chunk is executed they are notified, the last input of a waiting chunk to be
+   * executed dispatches it to the WorkScheduler.
+   */
+  std::vector<ChunkWaiter> *m_chunkWaiters;
+
+  /**
+   * \brief per chunk the number of input chunks that haven't been executed yet.
+   * \note while the inputs of a chunk are being scheduled it is one more, so that the chunk
+   * can't be dispatched before all its inputs are known.
+   */
+  int *m_chunkPendingInputs;
+
+  /**
+   * \brief protects the chunkExecutionStates and chunkWaiters
+   */
+  ThreadMutex m_chunkMutex;
+
   /**
    * \brief indicator when this ExecutionGroup has valid Operations in its vector for Execution
    * \note When building the ExecutionGroup Operations are added via recursion.
@@ -210,35 +239,36 @@ class ExecutionGroup {
   void determineNumberOfChunks();
 
   /**
-   * \brief try to schedule a specific chunk.
-   * \note scheduling succeeds when all input requirements are met and the chunks hasn't been
-   * scheduled yet.
-   * \param graph:
-   * \param xChunk:
-   * \param yChunk:
-   * \return [true:false]
-   * true: package(s) are scheduled
-   * false: scheduling is deferred (depending workpackages are scheduled)
+   * \brief determine the chunks overlapping with an area.
+   * \note the result is a range of chunk indices, xmax and ymax are exclusive.
    */
-  bool scheduleChunkWhenPossible(ExecutionSystem *graph, int xChunk, int yChunk);
+  void determine_chunk_range(const rcti *area, rcti *r_chunks) const;
 
   /**
-   * \brief try to schedule a specific area.
-   * \note Check if a certain area is available, when not available this are will be checked.
+   * \brief schedule a chunk to be executed as soon as its inputs are available.
+   * \note the chunks of other groups the chunk depends on are scheduled as well. The chunk is
+   * dispatched to the WorkScheduler right away when they're all executed, otherwise by the
+   * thread executing the last of them. Scheduling a chunk again does nothing.
+   * \param chunkNumber:
+   */
+  void scheduleChunkWhenPossible(unsigned int chunkNumber);
+
+  /**
+   * \brief schedule the chunks of a specific area for a chunk of another group waiting for them.
    * \note This method is called from other ExecutionGroup's.
-   * \param graph:
-   * \param area:
-   * \return [true:false]
-   * true: package(s) are scheduled
-   * false: scheduling is deferred (depending workpackages are scheduled)
+   * \param area: the area the waiting chunk reads from this group
+   * \param waiter: the group of the waiting chunk
+   * \param waiterChunkNumber: the number of the waiting chunk
    */
-  bool scheduleAreaWhenPossible(ExecutionSystem *graph, rcti *area);
+  void scheduleAreaWhenPossible(const rcti *area,
+                                ExecutionGroup *waiter,
+                                unsigned int waiterChunkNumber);
 
   /**
-   * \brief add a chunk to the WorkScheduler.
+   * \brief add a chunk to the WorkScheduler, all its inputs must be executed.
    * \param chunknumber:
    */
-  bool scheduleChunk(unsigned int chunkNumber);
+  void scheduleChunk(unsigned int chunkNumber);
 
   /**
    * \brief determine the area of interest of a certain input area
@@ -348,9 +378,11 @@ class ExecutionGroup {
    * \brief get all inputbuffers needed to calculate an chunk
    * \note all inputbuffers must be executed
    * \param chunkNumber: the chunk to be calculated
-   * \return (MemoryBuffer **) the inputbuffers
+   * \return (MemoryBuffer **) the inputbuffers, only for the read operations of paged memory
+   * proxies, the others read from the buffer of their proxy. nullptr when no proxy is paged.
+   * \see MemoryPager
    */
-  MemoryBuffer **getInputBuffersCPU();
+  MemoryBuffer **getInputBuffersCPU(int chunkNumber);
 
   /**
    * \brief get all inputbuffers needed to calculate an chunk
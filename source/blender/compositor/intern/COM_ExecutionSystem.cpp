@@ -23,15 +23,20 @@
 
 #include "BKE_node.h"
 
+#include "DNA_userdef_types.h"
+
 #include "BLT_translation.h"
 
 #include "COM_Converter.h"
 #include "COM_Debug.h"
 #include "COM_ExecutionGroup.h"
+#include "COM_FullFrameExecutionModel.h"
+#include "COM_MemoryPager.h"
 #include "COM_NodeOperation.h"
 #include "COM_NodeOperationBuilder.h"
 #include "COM_ReadBufferOperation.h"
 #include "COM_WorkScheduler.h"
+#include "COM_WriteBufferOperation.h"
 
 #ifdef WITH_CXX_GUARDEDALLOC
 #  include "MEM_guardedalloc.h"
@@ -59,8 +64,10 @@ ExecutionSystem::ExecutionSystem(RenderData *rd,
     this->m_context.setQuality((CompositorQuality)editingtree->edit_quality);
   }
   this->m_context.setRendering(rendering);
-  this->m_context.setHasActiveOpenCLDevices(WorkScheduler::hasGPUDevices() &&
-                                            (editingtree->flag & NTREE_COM_OPENCL));
+  /* Full-frame execution doesn't schedule any work on OpenCL devices. */
+  this->m_context.setHasActiveOpenCLDevices(
+      WorkScheduler::hasGPUDevices() && (editingtree->flag & NTREE_COM_OPENCL) &&
+      m_context.getExecutionModel() == COM_EXECUTION_MODEL_TILED);
 
   this->m_context.setRenderData(rd);
   this->m_context.setViewSettings(viewSettings);
@@ -134,6 +141,12 @@ void ExecutionSystem::execute()
 
   DebugInfo::execute_started(this);
 
+  if (this->m_context.getExecutionModel() == COM_EXECUTION_MODEL_FULL_FRAME) {
+    FullFrameExecutionModel execution_model(this->m_context, this->m_operations);
+    execution_model.execute();
+    return;
+  }
+
   unsigned int order = 0;
   for (vector<NodeOperation *>::iterator iter = this->m_operations.begin();
        iter != this->m_operations.end();
@@ -147,10 +160,20 @@ void ExecutionSystem::execute()
   }
   unsigned int index;
 
+  /* With a memory limit buffers are stored per chunk, moving chunks to disk when needed. */
+  MemoryPager *pager = nullptr;
+  if (U.compositor_memory_limit > 0) {
+    pager = new MemoryPager((size_t)U.compositor_memory_limit * 1024 * 1024);
+  }
+
   // First allocale all write buffer
   for (index = 0; index < this->m_operations.size(); index++) {
     NodeOperation *operation = this->m_operations[index];
     if (operation->isWriteBufferOperation()) {
+      WriteBufferOperation *writeOperation = (WriteBufferOperation *)operation;
+      if (pager && !writeOperation->isSingleValue()) {
+        writeOperation->getMemoryProxy()->set_pager(pager);
+      }
       operation->setbNodeTree(this->m_context.getbNodeTree());
       operation->initExecution();
     }
@@ -197,6 +220,7 @@ void ExecutionSystem::execute()
     ExecutionGroup *executionGroup = this->m_groups[index];
     executionGroup->deinitExecution();
   }
+  delete pager;
 }
 
 void ExecutionSystem::executeGroups(CompositorPriority priority)
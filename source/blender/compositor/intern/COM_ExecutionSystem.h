@@ -174,6 +174,7 @@ class ExecutionSystem {
    * - initialize the NodeOperation's and ExecutionGroup's
    * - schedule the output ExecutionGroup's based on their priority
    * - deinitialize the ExecutionGroup's and NodeOperation's
+   * In full-frame execution this is all handled by a FullFrameExecutionModel.
    */
   void execute();
 
@@ -0,0 +1,633 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#include <typeinfo>
+
+#include "COM_FullFrameExecutionModel.h"
+
+#include "BLI_rect.h"
+#include "BLI_string.h"
+#include "BLI_task.h"
+#include "BLI_utildefines.h"
+
+#include "BLT_translation.h"
+
+#include "COM_BufferOperation.h"
+#include "COM_MemoryBuffer.h"
+#include "COM_MemoryProxy.h"
+#include "COM_NodeOperation.h"
+#include "COM_ReadBufferOperation.h"
+#include "COM_ResultCache.h"
+#include "COM_WriteBufferOperation.h"
+
+#ifdef WITH_CXX_GUARDEDALLOC
+#  include "MEM_guardedalloc.h"
+#endif
+
+/* Number of rows calculated by a single task, small enough to keep all threads busy on
+ * operations that are expensive per pixel. */
+#define COM_FULL_FRAME_ROWS_PER_TASK 32
+
+FullFrameExecutionModel::FullFrameExecutionModel(const CompositorContext &context,
+                                                 const Operations &operations)
+    : m_context(context),
+      m_operations(operations),
+      m_use_cache(ResultCache::is_enabled(context)),
+      m_use_half_buffers(context.isHalfBufferEnabled()),
+      m_operations_finished(0)
+{
+}
+
+FullFrameExecutionModel::~FullFrameExecutionModel()
+{
+  /* Restore the links, the operations may still be inspected after execution. */
+  for (unsigned int index = 0; index < m_relinked_inputs.size(); index++) {
+    m_relinked_inputs[index].first->setLink(m_relinked_inputs[index].second);
+  }
+  m_relinked_inputs.clear();
+
+  for (std::map<NodeOperation *, BufferOperation *>::iterator it = m_buffers.begin();
+       it != m_buffers.end();
+       ++it) {
+    BufferOperation *buffer_operation = it->second;
+    if (buffer_operation->getBuffer()) {
+      free_buffer(buffer_operation);
+    }
+    delete buffer_operation;
+  }
+  m_buffers.clear();
+}
+
+void FullFrameExecutionModel::execute()
+{
+  const bNodeTree *editingtree = m_context.getbNodeTree();
+  editingtree->stats_draw(editingtree->sdh, TIP_("Compositing | Determining order"));
+
+  determine_order();
+  create_buffers();
+
+  for (unsigned int index = 0; index < m_order.size(); index++) {
+    NodeOperation *operation = m_order[index];
+    if (operation->isBraked()) {
+      break;
+    }
+
+    execute_operation(operation);
+
+    m_operations_finished++;
+    update_progress();
+  }
+
+  editingtree->stats_draw(editingtree->sdh, TIP_("Compositing | De-initializing execution"));
+  deinit_operations();
+
+  /* Buffers of this execution are not used anymore, see #ResultCache.trim. */
+  ResultCache::trim();
+}
+
+void FullFrameExecutionModel::determine_order()
+{
+  std::map<NodeOperation *, bool> visited;
+  const bool rendering = m_context.isRendering();
+  const CompositorPriority priorities[3] = {
+      COM_PRIORITY_HIGH, COM_PRIORITY_MEDIUM, COM_PRIORITY_LOW};
+  const int num_priorities = m_context.isFastCalculation() ? 1 : 3;
+
+  /* Outputs with a higher priority are calculated first, same as in tiled execution. */
+  for (int priority = 0; priority < num_priorities; priority++) {
+    for (unsigned int index = 0; index < m_operations.size(); index++) {
+      NodeOperation *operation = m_operations[index];
+      if (operation->isOutputOperation(rendering) &&
+          operation->getRenderPriority() == priorities[priority]) {
+        determine_order(operation, visited);
+      }
+    }
+  }
+}
+
+void FullFrameExecutionModel::determine_order(NodeOperation *operation,
+                                              std::map<NodeOperation *, bool> &visited)
+{
+  if (visited[operation]) {
+    return;
+  }
+  visited[operation] = true;
+
+  MemoryBuffer *cached_result = lookup_cached_result(operation);
+  if (cached_result) {
+    /* Nothing above this operation has to be calculated for it. */
+    m_cached_results[operation] = cached_result;
+    return;
+  }
+
+  if (operation->isReadBufferOperation()) {
+    /* Read buffers are not linked to the write buffer filling their memory proxy. */
+    MemoryProxy *proxy = ((ReadBufferOperation *)operation)->getMemoryProxy();
+    if (proxy && proxy->getWriteBufferOperation()) {
+      determine_order(proxy->getWriteBufferOperation(), visited);
+    }
+  }
+
+  for (unsigned int index = 0; index < operation->getNumberOfInputSockets(); index++) {
+    NodeOperationInput *input = operation->getInputSocket(index);
+    if (input->isConnected()) {
+      determine_order(&input->getLink()->getOperation(), visited);
+    }
+  }
+
+  m_order.push_back(operation);
+}
+
+void FullFrameExecutionModel::create_buffers()
+{
+  const bool rendering = m_context.isRendering();
+
+  for (std::map<NodeOperation *, MemoryBuffer *>::iterator it = m_cached_results.begin();
+       it != m_cached_results.end();
+       ++it) {
+    const DataType datatype = it->first->getOutputSocket()->getDataType();
+    BufferOperation *buffer_operation = new BufferOperation(it->second, datatype);
+    buffer_operation->setbNodeTree(m_context.getbNodeTree());
+    m_buffers[it->first] = buffer_operation;
+    m_buffer_operations.insert(buffer_operation);
+    m_cache_owned_buffers.insert(it->second);
+  }
+
+  for (unsigned int index = 0; index < m_order.size(); index++) {
+    NodeOperation *operation = m_order[index];
+    if (operation->getNumberOfOutputSockets() == 0 || operation->isOutputOperation(rendering) ||
+        operation->isReadBufferOperation()) {
+      continue;
+    }
+    if (operation->getWidth() == 0 || operation->getHeight() == 0) {
+      /* Users read outside the bounds of an empty input, leave it to be read per pixel. */
+      continue;
+    }
+
+    /* The buffer is allocated when the operation is calculated, see #execute_operation. */
+    const DataType datatype = operation->getOutputSocket()->getDataType();
+    BufferOperation *buffer_operation = new BufferOperation(
+        datatype, operation->getWidth(), operation->getHeight());
+    buffer_operation->setbNodeTree(m_context.getbNodeTree());
+    m_buffers[operation] = buffer_operation;
+    m_buffer_operations.insert(buffer_operation);
+  }
+
+  /* Redirect all users of a calculated operation to its buffer. */
+  for (unsigned int index = 0; index < m_order.size(); index++) {
+    NodeOperation *operation = m_order[index];
+    for (unsigned int i = 0; i < operation->getNumberOfInputSockets(); i++) {
+      NodeOperationInput *input = operation->getInputSocket(i);
+      if (!input->isConnected()) {
+        continue;
+      }
+      NodeOperationOutput *link = input->getLink();
+      std::map<NodeOperation *, BufferOperation *>::iterator it = m_buffers.find(
+          &link->getOperation());
+      if (it != m_buffers.end()) {
+        m_relinked_inputs.push_back(std::make_pair(input, link));
+        input->setLink(it->second->getOutputSocket());
+      }
+    }
+  }
+
+  /* Count the readers of every buffer, to free it once they have all been calculated. */
+  for (unsigned int index = 0; index < m_order.size(); index++) {
+    std::set<BufferOperation *> read_buffers;
+    get_read_buffers(m_order[index], read_buffers);
+    for (std::set<BufferOperation *>::iterator it = read_buffers.begin(); it != read_buffers.end();
+         ++it) {
+      m_num_buffer_readers[*it]++;
+    }
+  }
+}
+
+void FullFrameExecutionModel::deinit_operations()
+{
+  /* Only operations in the order have been initialized, see #execute_operation. */
+  for (unsigned int index = 0; index < m_operations_finished; index++) {
+    m_order[index]->deinitExecution();
+  }
+}
+
+typedef struct FullFrameTaskData {
+  NodeOperation *operation;
+  /** Output buffer of the operation, nullptr for output operations. */
+  MemoryBuffer *output;
+  /** Input buffers passed to update_memory_buffer, nullptr to read the operation per pixel. */
+  MemoryBuffer **inputs;
+  const rcti *area;
+} FullFrameTaskData;
+
+static void full_frame_read_pixels(NodeOperation *operation, MemoryBuffer *output, rcti *rect)
+{
+  float *buffer = output->getBuffer();
+  const int num_channels = output->get_num_channels();
+
+  if (operation->isComplex()) {
+    void *data = operation->initializeTileData(rect);
+    for (int y = rect->ymin; y < rect->ymax; y++) {
+      int offset = (y * output->getWidth() + rect->xmin) * num_channels;
+      for (int x = rect->xmin; x < rect->xmax; x++) {
+        operation->read(&buffer[offset], x, y, data);
+        offset += num_channels;
+      }
+      if (operation->isBraked()) {
+        break;
+      }
+    }
+    if (data) {
+      operation->deinitializeTileData(rect, data);
+    }
+  }
+  else {
+    for (int y = rect->ymin; y < rect->ymax; y++) {
+      int offset = (y * output->getWidth() + rect->xmin) * num_channels;
+      for (int x = rect->xmin; x < rect->xmax; x++) {
+        operation->readSampled(&buffer[offset], x, y, COM_PS_NEAREST);
+        offset += num_channels;
+      }
+      if (operation->isBraked()) {
+        break;
+      }
+    }
+  }
+}
+
+static void full_frame_task_cb(void *__restrict userdata,
+                               const int task_index,
+                               const TaskParallelTLS *__restrict /*tls*/)
+{
+  FullFrameTaskData *data = (FullFrameTaskData *)userdata;
+  const rcti *area = data->area;
+
+  rcti rect;
+  const int ymin = area->ymin + task_index * COM_FULL_FRAME_ROWS_PER_TASK;
+  BLI_rcti_init(
+      &rect, area->xmin, area->xmax, ymin, min(ymin + COM_FULL_FRAME_ROWS_PER_TASK, area->ymax));
+
+  if (data->output == nullptr) {
+    data->operation->executeRegion(&rect, task_index);
+  }
+  else if (data->inputs) {
+    data->operation->update_memory_buffer(data->output, &rect, data->inputs);
+  }
+  else {
+    full_frame_read_pixels(data->operation, data->output, &rect);
+  }
+}
+
+static void full_frame_execute_area(FullFrameTaskData *data)
+{
+  if (BLI_rcti_is_empty(data->area)) {
+    return;
+  }
+  const int height = BLI_rcti_size_y(data->area);
+  const int num_tasks = (height + COM_FULL_FRAME_ROWS_PER_TASK - 1) /
+                        COM_FULL_FRAME_ROWS_PER_TASK;
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = !data->operation->isSingleThreaded();
+  BLI_task_parallel_range(0, num_tasks, data, full_frame_task_cb, &settings);
+}
+
+void FullFrameExecutionModel::execute_operation(NodeOperation *operation)
+{
+  std::map<NodeOperation *, BufferOperation *>::iterator it = m_buffers.find(operation);
+  BufferOperation *output_operation = (it != m_buffers.end()) ? it->second : nullptr;
+  if (output_operation) {
+    rcti rect;
+    BLI_rcti_init(&rect, 0, operation->getWidth(), 0, operation->getHeight());
+    const DataType datatype = operation->getOutputSocket()->getDataType();
+    output_operation->setBuffer(
+        new MemoryBuffer(datatype, &rect, operation->isSetOperation()));
+  }
+
+  /* Inputs packed as half floats are only unpacked while they are read. */
+  std::set<BufferOperation *> read_buffers;
+  get_read_buffers(operation, read_buffers);
+  for (std::set<BufferOperation *>::iterator it = read_buffers.begin(); it != read_buffers.end();
+       ++it) {
+    (*it)->getBuffer()->unpack_half();
+  }
+
+  calculate_operation(operation);
+
+  for (std::set<BufferOperation *>::iterator it = read_buffers.begin(); it != read_buffers.end();
+       ++it) {
+    (*it)->getBuffer()->release_unpacked();
+    if (--m_num_buffer_readers[*it] == 0) {
+      free_buffer(*it);
+    }
+  }
+
+  if (output_operation == nullptr || operation->isBraked()) {
+    return;
+  }
+  MemoryBuffer *output = output_operation->getBuffer();
+  if (m_use_half_buffers && operation->getOutputSocket()->getDataType() == COM_DT_COLOR &&
+      !output->is_a_single_elem()) {
+    output->pack_half();
+  }
+  add_cached_result(operation, output);
+}
+
+/**
+ * Free the buffer once it is not read anymore, unless the ResultCache owns it.
+ */
+void FullFrameExecutionModel::free_buffer(BufferOperation *buffer_operation)
+{
+  MemoryBuffer *buffer = buffer_operation->getBuffer();
+  if (m_cache_owned_buffers.find(buffer) == m_cache_owned_buffers.end()) {
+    delete buffer;
+  }
+  buffer_operation->setBuffer(nullptr);
+}
+
+void FullFrameExecutionModel::calculate_operation(NodeOperation *operation)
+{
+  /* Operations are initialized right before they are calculated, so all of their inputs are
+   * already available when #NodeOperation.initExecution reads from them. */
+  operation->setbNodeTree(m_context.getbNodeTree());
+  if (operation->isReadBufferOperation()) {
+    ((ReadBufferOperation *)operation)->updateMemoryBuffer();
+  }
+  operation->initExecution();
+
+  if (operation->isReadBufferOperation()) {
+    /* Reads directly from the memory proxy of its write buffer. */
+    return;
+  }
+
+  std::map<NodeOperation *, BufferOperation *>::iterator it = m_buffers.find(operation);
+  if (it == m_buffers.end()) {
+    execute_output_operation(operation);
+    return;
+  }
+
+  MemoryBuffer *output = it->second->getBuffer();
+  if (output->is_a_single_elem()) {
+    operation->readSampled(output->getBuffer(), 0.0f, 0.0f, COM_PS_NEAREST);
+    output->setCreatedState();
+    return;
+  }
+
+  rcti area;
+  BLI_rcti_init(&area, 0, operation->getWidth(), 0, operation->getHeight());
+
+  std::vector<MemoryBuffer *> inputs;
+  FullFrameTaskData data;
+  data.operation = operation;
+  data.output = output;
+  data.inputs = nullptr;
+  data.area = &area;
+  if (operation->isFullFrameOperation() && get_input_buffers(operation, inputs)) {
+    data.inputs = &inputs[0];
+  }
+  full_frame_execute_area(&data);
+  output->setCreatedState();
+}
+
+void FullFrameExecutionModel::execute_output_operation(NodeOperation *operation)
+{
+  rcti area;
+  get_output_area(operation, &area);
+
+  FullFrameTaskData data;
+  data.operation = operation;
+  data.output = nullptr;
+  data.inputs = nullptr;
+  data.area = &area;
+  full_frame_execute_area(&data);
+}
+
+bool FullFrameExecutionModel::get_input_buffers(NodeOperation *operation,
+                                                std::vector<MemoryBuffer *> &r_inputs)
+{
+  if (operation->isInputOperation()) {
+    return false;
+  }
+  for (unsigned int index = 0; index < operation->getNumberOfInputSockets(); index++) {
+    NodeOperationInput *input = operation->getInputSocket(index);
+    if (!input->isConnected()) {
+      return false;
+    }
+    NodeOperation *input_operation = &input->getLink()->getOperation();
+    if (m_buffer_operations.find(input_operation) == m_buffer_operations.end()) {
+      return false;
+    }
+    MemoryBuffer *buffer = ((BufferOperation *)input_operation)->getBuffer();
+    if (buffer->getWidth() != operation->getWidth() ||
+        buffer->getHeight() != operation->getHeight()) {
+      return false;
+    }
+    r_inputs.push_back(buffer);
+  }
+  return true;
+}
+
+/**
+ * Buffers read when calculating the operation, including the ones read through inputs that are
+ * not buffered themselves.
+ */
+void FullFrameExecutionModel::get_read_buffers(NodeOperation *operation,
+                                               std::set<BufferOperation *> &r_buffers)
+{
+  for (unsigned int index = 0; index < operation->getNumberOfInputSockets(); index++) {
+    NodeOperationInput *input = operation->getInputSocket(index);
+    if (!input->isConnected()) {
+      continue;
+    }
+    NodeOperation *input_operation = &input->getLink()->getOperation();
+    if (m_buffer_operations.find(input_operation) != m_buffer_operations.end()) {
+      r_buffers.insert((BufferOperation *)input_operation);
+    }
+    else if (!input_operation->isReadBufferOperation()) {
+      get_read_buffers(input_operation, r_buffers);
+    }
+  }
+}
+
+void FullFrameExecutionModel::get_output_area(NodeOperation *operation, rcti *r_area) const
+{
+  const bNodeTree *editingtree = m_context.getbNodeTree();
+  const RenderData *rd = m_context.getRenderData();
+  const float width = operation->getWidth();
+  const float height = operation->getHeight();
+  BLI_rcti_init(r_area, 0, operation->getWidth(), 0, operation->getHeight());
+  if (!operation->isOutputOperation(m_context.isRendering())) {
+    /* Write buffer operations fill the whole memory proxy. */
+    return;
+  }
+
+  const bool is_viewer = operation->isViewerOperation() || operation->isPreviewOperation();
+  const rctf *border = nullptr;
+  if (is_viewer) {
+    const rctf *viewer_border = &editingtree->viewer_border;
+    if ((editingtree->flag & NTREE_VIEWER_BORDER) && viewer_border->xmin < viewer_border->xmax &&
+        viewer_border->ymin < viewer_border->ymax) {
+      border = viewer_border;
+    }
+  }
+  else if (m_context.isRendering() && !operation->isFileOutputOperation() && rd &&
+           (rd->mode & R_BORDER) && !(rd->mode & R_CROP)) {
+    /* Same as ExecutionGroup.setRenderBorder, only operations writing render resolution
+     * buffers are limited to the border. */
+    border = &rd->border;
+  }
+
+  if (border) {
+    BLI_rcti_init(r_area,
+                  border->xmin * width,
+                  border->xmax * width,
+                  border->ymin * height,
+                  border->ymax * height);
+  }
+}
+
+void FullFrameExecutionModel::update_progress()
+{
+  const bNodeTree *editingtree = m_context.getbNodeTree();
+  editingtree->progress(editingtree->prh, (float)m_operations_finished / m_order.size());
+
+  char buf[128];
+  BLI_snprintf(buf,
+               sizeof(buf),
+               TIP_("Compositing | Operation %u-%u"),
+               m_operations_finished,
+               (unsigned int)m_order.size());
+  editingtree->stats_draw(editingtree->sdh, buf);
+}
+
+/**
+ * Only complex operations are worth keeping, calculating any other operation again is about as
+ * fast as reading its result.
+ */
+bool FullFrameExecutionModel::is_cache_candidate(NodeOperation *operation) const
+{
+  return m_use_cache && operation->isComplex() && operation->getNumberOfOutputSockets() > 0 &&
+         !operation->isOutputOperation(m_context.isRendering()) &&
+         !operation->isReadBufferOperation() && operation->getWidth() > 0 &&
+         operation->getHeight() > 0;
+}
+
+/**
+ * \return the key of the operation, nullptr when its result cannot be cached
+ */
+const std::string *FullFrameExecutionModel::get_cache_key(NodeOperation *operation)
+{
+  std::map<NodeOperation *, std::pair<bool, std::string>>::iterator it = m_cache_keys.find(
+      operation);
+  if (it == m_cache_keys.end()) {
+    std::string key;
+    bool valid = calc_cache_key(operation, &key);
+    if (key.size() > COM_RESULT_CACHE_MAX_KEY_SIZE) {
+      valid = false;
+      key.clear();
+    }
+    it = m_cache_keys.insert(std::make_pair(operation, std::make_pair(valid, std::move(key))))
+             .first;
+  }
+  return it->second.first ? &it->second.second : nullptr;
+}
+
+bool FullFrameExecutionModel::calc_cache_key(NodeOperation *operation, std::string *r_key)
+{
+  if (!operation->hasNodeKey()) {
+    return false;
+  }
+
+  std::string &key = *r_key;
+  ResultCache::append_bytes(key, operation->getNodeKey().data(), operation->getNodeKey().size());
+  ResultCache::append_string(key, typeid(*operation).name());
+  ResultCache::append(key, operation->getWidth());
+  ResultCache::append(key, operation->getHeight());
+  for (unsigned int index = 0; index < operation->getNumberOfOutputSockets(); index++) {
+    ResultCache::append(key, operation->getOutputSocket(index)->getDataType());
+  }
+
+  if (operation->isSetOperation()) {
+    /* Constants are not created by a node when they replace an unlinked input. */
+    float value[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    operation->readSampled(value, 0.0f, 0.0f, COM_PS_NEAREST);
+    ResultCache::append_bytes(key, value, sizeof(value));
+  }
+
+  if (operation->isReadBufferOperation()) {
+    MemoryProxy *proxy = ((ReadBufferOperation *)operation)->getMemoryProxy();
+    if (proxy == nullptr || proxy->getWriteBufferOperation() == nullptr) {
+      return false;
+    }
+    const std::string *write_key = get_cache_key(proxy->getWriteBufferOperation());
+    if (write_key == nullptr) {
+      return false;
+    }
+    ResultCache::append_bytes(key, write_key->data(), write_key->size());
+  }
+
+  for (unsigned int index = 0; index < operation->getNumberOfInputSockets(); index++) {
+    NodeOperationInput *input = operation->getInputSocket(index);
+    ResultCache::append(key, input->isConnected());
+    if (!input->isConnected()) {
+      continue;
+    }
+    NodeOperationOutput *link = input->getLink();
+    NodeOperation *input_operation = &link->getOperation();
+    const std::string *input_key = get_cache_key(input_operation);
+    if (input_key == nullptr) {
+      return false;
+    }
+    ResultCache::append_bytes(key, input_key->data(), input_key->size());
+    for (unsigned int i = 0; i < input_operation->getNumberOfOutputSockets(); i++) {
+      if (input_operation->getOutputSocket(i) == link) {
+        ResultCache::append(key, i);
+        break;
+      }
+    }
+  }
+  return true;
+}
+
+MemoryBuffer *FullFrameExecutionModel::lookup_cached_result(NodeOperation *operation)
+{
+  if (!is_cache_candidate(operation)) {
+    return nullptr;
+  }
+  const std::string *key = get_cache_key(operation);
+  if (key == nullptr) {
+    return nullptr;
+  }
+  MemoryBuffer *buffer = ResultCache::lookup(*key);
+  if (buffer == nullptr || buffer->getWidth() != operation->getWidth() ||
+      buffer->getHeight() != operation->getHeight()) {
+    return nullptr;
+  }
+  return buffer;
+}
+
+void FullFrameExecutionModel::add_cached_result(NodeOperation *operation, MemoryBuffer *buffer)
+{
+  if (!is_cache_candidate(operation)) {
+    return;
+  }
+  const std::string *key = get_cache_key(operation);
+  if (key != nullptr && ResultCache::add(*key, buffer)) {
+    m_cache_owned_buffers.insert(buffer);
+  }
+}
@@ -0,0 +1,145 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#pragma once
+
+#include <map>
+#include <set>
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+#include "COM_CompositorContext.h"
+#include "COM_defines.h"
+
+class BufferOperation;
+class MemoryBuffer;
+class NodeOperation;
+class NodeOperationInput;
+class NodeOperationOutput;
+
+/**
+ * \brief Executes the operations of an ExecutionSystem one at a time over their whole output.
+ *
+ * Operations are calculated in dependency order, starting at the inputs of the output operations.
+ * The result of every operation is stored in a MemoryBuffer for the whole frame, and the links to
+ * it are replaced by a BufferOperation reading from that buffer. A buffer is allocated right
+ * before its operation is calculated and freed once the last operation reading it has been
+ * calculated, so only the buffers still to be read are kept in memory. Operations that implement
+ * NodeOperation.update_memory_buffer fill their buffer row by row directly from the input
+ * buffers, all others are read pixel by pixel like a WriteBufferOperation does.
+ *
+ * Results of complex operations are kept in the ResultCache, operations that only feed cached
+ * results are not calculated at all in later executions.
+ *
+ * Constant operations get single element buffers. With NTREE_COM_HALF_BUFFERS color buffers are
+ * packed as half floats once calculated, and only unpacked while an operation reading them is
+ * calculated.
+ *
+ * There are no ExecutionGroup's, chunks or OpenCL devices involved.
+ * \see COM_EXECUTION_MODEL_FULL_FRAME
+ * \ingroup Execution
+ */
+class FullFrameExecutionModel {
+ public:
+  typedef std::vector<NodeOperation *> Operations;
+
+ private:
+  const CompositorContext &m_context;
+  const Operations &m_operations;
+
+  /**
+   * \brief operations to calculate, in dependency order
+   */
+  Operations m_order;
+
+  /**
+   * \brief output buffers of the calculated operations that have users
+   */
+  std::map<NodeOperation *, BufferOperation *> m_buffers;
+
+  /**
+   * \brief all BufferOperation's of m_buffers, to recognize inputs that have been calculated
+   */
+  std::set<NodeOperation *> m_buffer_operations;
+
+  /**
+   * \brief number of operations still to be calculated that read the buffer
+   */
+  std::map<BufferOperation *, int> m_num_buffer_readers;
+
+  /**
+   * \brief original links of the inputs that were redirected to a BufferOperation
+   */
+  std::vector<std::pair<NodeOperationInput *, NodeOperationOutput *>> m_relinked_inputs;
+
+  /**
+   * \brief operations whose result was found in the ResultCache, they are not calculated
+   */
+  std::map<NodeOperation *, MemoryBuffer *> m_cached_results;
+
+  /**
+   * \brief buffers of m_buffers owned by the ResultCache
+   */
+  std::set<MemoryBuffer *> m_cache_owned_buffers;
+
+  /**
+   * \brief cache keys of the visited operations, the first value is false when an operation
+   * cannot be cached
+   */
+  std::map<NodeOperation *, std::pair<bool, std::string>> m_cache_keys;
+
+  bool m_use_cache;
+  bool m_use_half_buffers;
+  unsigned int m_operations_finished;
+
+ public:
+  FullFrameExecutionModel(const CompositorContext &context, const Operations &operations);
+  ~FullFrameExecutionModel();
+
+  /**
+   * \brief initialize, calculate and deinitialize all operations needed by the outputs
+   */
+  void execute();
+
+ private:
+  void determine_order();
+  void determine_order(NodeOperation *operation, std::map<NodeOperation *, bool> &visited);
+  void create_buffers();
+  void init_operations();
+  void deinit_operations();
+
+  void execute_operation(NodeOperation *operation);
+  void calculate_operation(NodeOperation *operation);
+  void execute_output_operation(NodeOperation *operation);
+  bool get_input_buffers(NodeOperation *operation, std::vector<MemoryBuffer *> &r_inputs);
+  void get_read_buffers(NodeOperation *operation, std::set<BufferOperation *> &r_buffers);
+  void free_buffer(BufferOperation *buffer_operation);
+  void get_output_area(NodeOperation *operation, rcti *r_area) const;
+  void update_progress();
+
+  bool is_cache_candidate(NodeOperation *operation) const;
+  const std::string *get_cache_key(NodeOperation *operation);
+  bool calc_cache_key(NodeOperation *operation, std::string *r_key);
+  MemoryBuffer *lookup_cached_result(NodeOperation *operation);
+  void add_cached_result(NodeOperation *operation, MemoryBuffer *buffer);
+
+#ifdef WITH_CXX_GUARDEDALLOC
+  MEM_CXX_CLASS_ALLOC_FUNCS("COM:FullFrameExecutionModel")
+#endif
+};
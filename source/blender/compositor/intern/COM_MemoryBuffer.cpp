@@ -18,8 +18,26 @@
 
 #include "COM_MemoryBuffer.h"
 
+#include "BLI_system.h"
+#include "BLI_task.h"
+
 #include "MEM_guardedalloc.h"
 
+#if (defined(__GNUC__) && defined(__x86_64__)) || (defined(_MSC_VER) && defined(_M_X64))
+#  include <immintrin.h>
+#  define COM_HALF_USE_F16C
+#  ifdef _MSC_VER
+#    define COM_HALF_F16C_FUNC
+#  else
+#    define COM_HALF_F16C_FUNC __attribute__((target("f16c")))
+#  endif
+#endif
+
+/* Largest finite half float. */
+#define COM_HALF_MAX 65504.0f
+/* Number of floats converted by a single task when packing or unpacking. */
+#define COM_HALF_TASK_SIZE (1 << 16)
+
 using std::max;
 using std::min;
 
@@ -38,6 +56,9 @@ static unsigned int determine_num_channels(DataType datatype)
 
 unsigned int MemoryBuffer::determineBufferSize()
 {
+  if (this->m_is_a_single_elem) {
+    return 1;
+  }
   return getWidth() * getHeight();
 }
 
@@ -62,6 +83,8 @@ MemoryBuffer::MemoryBuffer(MemoryProxy *memoryProxy, unsigned int chunkNumber, r
       sizeof(float) * determineBufferSize() * this->m_num_channels, 16, "COM_MemoryBuffer");
   this->m_state = COM_MB_ALLOCATED;
   this->m_datatype = memoryProxy->getDataType();
+  this->m_half_buffer = nullptr;
+  this->m_is_a_single_elem = false;
 }
 
 MemoryBuffer::MemoryBuffer(MemoryProxy *memoryProxy, rcti *rect)
@@ -72,12 +95,14 @@ MemoryBuffer::MemoryBuffer(MemoryProxy *memoryProxy, rcti *rect)
   this->m_memoryProxy = memoryProxy;
   this->m_chunkNumber = -1;
   this->m_num_channels = determine_num_channels(memoryProxy->getDataType());
+  this->m_half_buffer = nullptr;
+  this->m_is_a_single_elem = false;
   this->m_buffer = (float *)MEM_mallocN_aligned(
       sizeof(float) * determineBufferSize() * this->m_num_channels, 16, "COM_MemoryBuffer");
   this->m_state = COM_MB_TEMPORARILY;
   this->m_datatype = memoryProxy->getDataType();
 }
-MemoryBuffer::MemoryBuffer(DataType dataType, rcti *rect)
+MemoryBuffer::MemoryBuffer(DataType dataType, rcti *rect, bool is_a_single_elem)
 {
   BLI_rcti_init(&this->m_rect, rect->xmin, rect->xmax, rect->ymin, rect->ymax);
   this->m_width = BLI_rcti_size_x(&this->m_rect);
@@ -86,6 +111,8 @@ MemoryBuffer::MemoryBuffer(DataType dataType, rcti *rect)
   this->m_memoryProxy = nullptr;
   this->m_chunkNumber = -1;
   this->m_num_channels = determine_num_channels(dataType);
+  this->m_half_buffer = nullptr;
+  this->m_is_a_single_elem = is_a_single_elem;
   this->m_buffer = (float *)MEM_mallocN_aligned(
       sizeof(float) * determineBufferSize() * this->m_num_channels, 16, "COM_MemoryBuffer");
   this->m_state = COM_MB_TEMPORARILY;
@@ -93,6 +120,7 @@ MemoryBuffer::MemoryBuffer(DataType dataType, rcti *rect)
 }
 MemoryBuffer *MemoryBuffer::duplicate()
 {
+  BLI_assert(!this->m_is_a_single_elem && this->m_buffer);
   MemoryBuffer *result = new MemoryBuffer(this->m_memoryProxy, &this->m_rect);
   memcpy(result->m_buffer,
          this->m_buffer,
@@ -101,6 +129,7 @@ MemoryBuffer *MemoryBuffer::duplicate()
 }
 void MemoryBuffer::clear()
 {
+  BLI_assert(this->m_buffer);
   memset(this->m_buffer, 0, this->determineBufferSize() * this->m_num_channels * sizeof(float));
 }
 
@@ -147,14 +176,257 @@ MemoryBuffer::~MemoryBuffer()
     MEM_freeN(this->m_buffer);
     this->m_buffer = nullptr;
   }
+  if (this->m_half_buffer) {
+    MEM_freeN(this->m_half_buffer);
+    this->m_half_buffer = nullptr;
+  }
+}
+
+float *MemoryBuffer::alloc_elem_row(int width)
+{
+  BLI_assert(this->m_is_a_single_elem);
+  float *row = (float *)MEM_mallocN_aligned(
+      sizeof(float) * width * this->m_num_channels, 16, "COM_MemoryBuffer row");
+  for (int x = 0; x < width; x++) {
+    memcpy(&row[x * this->m_num_channels], this->m_buffer, sizeof(float) * this->m_num_channels);
+  }
+  return row;
+}
+
+void MemoryBuffer::inflate()
+{
+  if (!this->m_is_a_single_elem) {
+    return;
+  }
+  float *elem = this->m_buffer;
+  this->m_is_a_single_elem = false;
+  const unsigned int size = determineBufferSize();
+  this->m_buffer = (float *)MEM_mallocN_aligned(
+      sizeof(float) * size * this->m_num_channels, 16, "COM_MemoryBuffer");
+  for (unsigned int i = 0; i < size; i++) {
+    memcpy(&this->m_buffer[i * this->m_num_channels], elem, sizeof(float) * this->m_num_channels);
+  }
+  MEM_freeN(elem);
+}
+
+size_t MemoryBuffer::get_memory_size() const
+{
+  const size_t num_floats = (this->m_is_a_single_elem ? 1 : (size_t)m_width * m_height) *
+                            m_num_channels;
+  size_t size = 0;
+  if (this->m_buffer) {
+    size += num_floats * sizeof(float);
+  }
+  if (this->m_half_buffer) {
+    size += num_floats * sizeof(uint16_t);
+  }
+  return size;
+}
+
+/* -------------------------------------------------------------------- */
+/** \name Half Float Storage
+ * \{ */
+
+typedef union FloatBits {
+  float f;
+  uint32_t u;
+} FloatBits;
+
+/**
+ * Round to nearest even, same as the hardware conversion.
+ * Based on float_to_half_fast3_rtne by Fabian Giesen.
+ */
+static uint16_t float_to_half(float value)
+{
+  FloatBits f;
+  f.f = value;
+  const uint32_t sign = f.u & 0x80000000u;
+  f.u ^= sign;
+
+  uint16_t result;
+  if (f.u >= 0x47800000u) {
+    /* Infinity or NaN, finite values are clamped before. */
+    result = (f.u > 0x7f800000u) ? 0x7e00 : 0x7c00;
+  }
+  else if (f.u < 0x38800000u) {
+    /* Denormal or zero, let the float addition do the rounding. */
+    FloatBits denorm_magic;
+    denorm_magic.u = ((127 - 15) + (23 - 10) + 1) << 23;
+    f.f += denorm_magic.f;
+    result = (uint16_t)(f.u - denorm_magic.u);
+  }
+  else {
+    const uint32_t mant_odd = (f.u >> 13) & 1;
+    f.u += ((uint32_t)(15 - 127) << 23) + 0xfff;
+    f.u += mant_odd;
+    result = (uint16_t)(f.u >> 13);
+  }
+  return result | (uint16_t)(sign >> 16);
+}
+
+static float half_to_float(uint16_t value)
+{
+  FloatBits f;
+  f.u = (uint32_t)(value & 0x7fff) << 13;
+  const uint32_t exponent = f.u & 0x0f800000u;
+  f.u += (uint32_t)(127 - 15) << 23;
+  if (exponent == 0x0f800000u) {
+    /* Infinity or NaN. */
+    f.u += (uint32_t)(128 - 16) << 23;
+  }
+  else if (exponent == 0) {
+    /* Denormal or zero. */
+    FloatBits magic;
+    magic.u = 113 << 23;
+    f.u += 1 << 23;
+    f.f -= magic.f;
+  }
+  f.u |= (uint32_t)(value & 0x8000) << 16;
+  return f.f;
+}
+
+static void float_to_half_array(const float *src, uint16_t *dst, size_t len)
+{
+  for (size_t i = 0; i < len; i++) {
+    dst[i] = float_to_half(clamp_f(src[i], -COM_HALF_MAX, COM_HALF_MAX));
+  }
+}
+
+static void half_to_float_array(const uint16_t *src, float *dst, size_t len)
+{
+  for (size_t i = 0; i < len; i++) {
+    dst[i] = half_to_float(src[i]);
+  }
 }
 
+#ifdef COM_HALF_USE_F16C
+COM_HALF_F16C_FUNC static void float_to_half_array_f16c(const float *src,
+                                                        uint16_t *dst,
+                                                        size_t len)
+{
+  const __m128 min = _mm_set1_ps(-COM_HALF_MAX);
+  const __m128 max = _mm_set1_ps(COM_HALF_MAX);
+  size_t i = 0;
+  for (; i + 4 <= len; i += 4) {
+    const __m128 value = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(&src[i]), min), max);
+    _mm_storel_epi64((__m128i *)&dst[i], _mm_cvtps_ph(value, _MM_FROUND_TO_NEAREST_INT));
+  }
+  float_to_half_array(&src[i], &dst[i], len - i);
+}
+
+COM_HALF_F16C_FUNC static void half_to_float_array_f16c(const uint16_t *src,
+                                                        float *dst,
+                                                        size_t len)
+{
+  size_t i = 0;
+  for (; i + 4 <= len; i += 4) {
+    _mm_storeu_ps(&dst[i], _mm_cvtph_ps(_mm_loadl_epi64((const __m128i *)&src[i])));
+  }
+  half_to_float_array(&src[i], &dst[i], len - i);
+}
+#endif
+
+static bool use_f16c()
+{
+#ifdef COM_HALF_USE_F16C
+  static const bool supported = BLI_cpu_support_f16c() != 0;
+  return supported;
+#else
+  return false;
+#endif
+}
+
+typedef struct HalfConvertData {
+  float *floats;
+  uint16_t *halfs;
+  size_t len;
+  bool to_half;
+} HalfConvertData;
+
+static void half_convert_task_cb(void *__restrict userdata,
+                                 const int task_index,
+                                 const TaskParallelTLS *__restrict /*tls*/)
+{
+  HalfConvertData *data = (HalfConvertData *)userdata;
+  const size_t start = (size_t)task_index * COM_HALF_TASK_SIZE;
+  const size_t len = min(data->len - start, (size_t)COM_HALF_TASK_SIZE);
+  float *floats = data->floats + start;
+  uint16_t *halfs = data->halfs + start;
+
+#ifdef COM_HALF_USE_F16C
+  if (use_f16c()) {
+    if (data->to_half) {
+      float_to_half_array_f16c(floats, halfs, len);
+    }
+    else {
+      half_to_float_array_f16c(halfs, floats, len);
+    }
+    return;
+  }
+#endif
+  if (data->to_half) {
+    float_to_half_array(floats, halfs, len);
+  }
+  else {
+    half_to_float_array(halfs, floats, len);
+  }
+}
+
+static void half_convert(float *floats, uint16_t *halfs, size_t len, bool to_half)
+{
+  HalfConvertData data;
+  data.floats = floats;
+  data.halfs = halfs;
+  data.len = len;
+  data.to_half = to_half;
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  const int num_tasks = (int)((len + COM_HALF_TASK_SIZE - 1) / COM_HALF_TASK_SIZE);
+  BLI_task_parallel_range(0, num_tasks, &data, half_convert_task_cb, &settings);
+}
+
+void MemoryBuffer::pack_half()
+{
+  BLI_assert(this->m_buffer);
+  if (this->m_half_buffer == nullptr) {
+    const size_t len = (size_t)determineBufferSize() * this->m_num_channels;
+    this->m_half_buffer = (uint16_t *)MEM_mallocN_aligned(
+        sizeof(uint16_t) * len, 16, "COM_MemoryBuffer half");
+    half_convert(this->m_buffer, this->m_half_buffer, len, true);
+  }
+  MEM_freeN(this->m_buffer);
+  this->m_buffer = nullptr;
+}
+
+void MemoryBuffer::unpack_half()
+{
+  if (this->m_buffer) {
+    return;
+  }
+  BLI_assert(this->m_half_buffer);
+  const size_t len = (size_t)determineBufferSize() * this->m_num_channels;
+  this->m_buffer = (float *)MEM_mallocN_aligned(sizeof(float) * len, 16, "COM_MemoryBuffer");
+  half_convert(this->m_buffer, this->m_half_buffer, len, false);
+}
+
+void MemoryBuffer::release_unpacked()
+{
+  if (this->m_half_buffer && this->m_buffer) {
+    MEM_freeN(this->m_buffer);
+    this->m_buffer = nullptr;
+  }
+}
+
+/** \} */
+
 void MemoryBuffer::copyContentFrom(MemoryBuffer *otherBuffer)
 {
   if (!otherBuffer) {
     BLI_assert(0);
     return;
   }
+  BLI_assert(otherBuffer->m_buffer);
   unsigned int otherY;
   unsigned int minX = max(this->m_rect.xmin, otherBuffer->m_rect.xmin);
   unsigned int maxX = min(this->m_rect.xmax, otherBuffer->m_rect.xmax);
@@ -169,6 +441,14 @@ void MemoryBuffer::copyContentFrom(MemoryBuffer *otherBuffer)
                   this->m_num_channels;
     offset = ((otherY - this->m_rect.ymin) * this->m_width + minX - this->m_rect.xmin) *
              this->m_num_channels;
+    if (otherBuffer->m_is_a_single_elem) {
+      for (unsigned int x = minX; x < maxX; x++, offset += this->m_num_channels) {
+        memcpy(&this->m_buffer[offset],
+               otherBuffer->m_buffer,
+               this->m_num_channels * sizeof(float));
+      }
+      continue;
+    }
     memcpy(&this->m_buffer[offset],
            &otherBuffer->m_buffer[otherOffset],
            (maxX - minX) * this->m_num_channels * sizeof(float));
@@ -177,6 +457,7 @@ void MemoryBuffer::copyContentFrom(MemoryBuffer *otherBuffer)
 
 void MemoryBuffer::writePixel(int x, int y, const float color[4])
 {
+  BLI_assert(!this->m_is_a_single_elem);
   if (x >= this->m_rect.xmin && x < this->m_rect.xmax && y >= this->m_rect.ymin &&
       y < this->m_rect.ymax) {
     const int offset = (this->m_width * (y - this->m_rect.ymin) + x - this->m_rect.xmin) *
@@ -187,6 +468,7 @@ void MemoryBuffer::writePixel(int x, int y, const float color[4])
 
 void MemoryBuffer::addPixel(int x, int y, const float color[4])
 {
+  BLI_assert(!this->m_is_a_single_elem);
   if (x >= this->m_rect.xmin && x < this->m_rect.xmax && y >= this->m_rect.ymin &&
       y < this->m_rect.ymax) {
     const int offset = (this->m_width * (y - this->m_rect.ymin) + x - this->m_rect.xmin) *
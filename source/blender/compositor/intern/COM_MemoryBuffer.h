@@ -27,6 +27,8 @@ class MemoryBuffer;
 #include "BLI_math.h"
 #include "BLI_rect.h"
 
+#include <stdint.h>
+
 /**
  * \brief state of a memory buffer
  * \ingroup Memory
@@ -82,9 +84,21 @@ class MemoryBuffer {
 
   /**
    * \brief the actual float buffer/data
+   * \note nullptr while the buffer is packed as half floats
    */
   float *m_buffer;
 
+  /**
+   * \brief half float copy of the data, only set while the buffer is packed
+   * \see pack_half
+   */
+  uint16_t *m_half_buffer;
+
+  /**
+   * \brief the whole buffer has the value of a single element, only that element is stored
+   */
+  bool m_is_a_single_elem;
+
   /**
    * \brief the number of channels of a single value in the buffer.
    * For value buffers this is 1, vector 3 and color 4
@@ -107,8 +121,10 @@ class MemoryBuffer {
 
   /**
    * \brief construct new temporarily MemoryBuffer for an area
+   * \param is_a_single_elem: all pixels of the area have the same value, only one element is
+   * allocated and all reads return it
    */
-  MemoryBuffer(DataType datatype, rcti *rect);
+  MemoryBuffer(DataType datatype, rcti *rect, bool is_a_single_elem = false);
 
   /**
    * \brief destructor
@@ -131,12 +147,84 @@ class MemoryBuffer {
   /**
    * \brief get the data of this MemoryBuffer
    * \note buffer should already be available in memory
+   * \note single element buffers only contain one element, see #get_elem
    */
   float *getBuffer()
   {
     return this->m_buffer;
   }
 
+  bool is_a_single_elem() const
+  {
+    return this->m_is_a_single_elem;
+  }
+
+  /**
+   * \brief number of floats between two horizontally adjacent elements, 0 for single element
+   * buffers
+   */
+  int get_elem_stride() const
+  {
+    return this->m_is_a_single_elem ? 0 : this->m_num_channels;
+  }
+
+  /**
+   * \brief get the element at the given coordinates, which must be inside the buffer rect
+   */
+  float *get_elem(int x, int y)
+  {
+    BLI_assert(x >= m_rect.xmin && x < m_rect.xmax && y >= m_rect.ymin && y < m_rect.ymax);
+    if (this->m_is_a_single_elem) {
+      return this->m_buffer;
+    }
+    return this->m_buffer +
+           ((y - m_rect.ymin) * this->m_width + x - m_rect.xmin) * this->m_num_channels;
+  }
+
+  /**
+   * \brief allocate a row of width copies of the element of a single element buffer, so it can
+   * be passed to functions stepping through rows of elements. Free with MEM_freeN.
+   */
+  float *alloc_elem_row(int width);
+
+  /**
+   * \brief allocate the whole area of a single element buffer, the element is copied to all of
+   * its pixels
+   */
+  void inflate();
+
+  /**
+   * \brief convert the data to half floats and free the float data
+   *
+   * Values outside of the half float range are clamped, precision is about 3 decimal digits.
+   * Until #unpack_half is called #getBuffer returns nullptr.
+   */
+  void pack_half();
+
+  /**
+   * \brief allocate the float data from the half float data of a packed buffer
+   * \note the half float data is kept, see #release_unpacked
+   */
+  void unpack_half();
+
+  /**
+   * \brief free the float data of an unpacked buffer, without converting it again
+   */
+  void release_unpacked();
+
+  /**
+   * \brief is the half float data of this buffer available, see #pack_half
+   */
+  bool is_half_packed() const
+  {
+    return this->m_half_buffer != nullptr;
+  }
+
+  /**
+   * \brief memory used by the data of this buffer in bytes
+   */
+  size_t get_memory_size() const;
+
   /**
    * \brief after execution the state will be set to available by calling this method
    */
@@ -160,7 +248,7 @@ class MemoryBuffer {
           x = 0;
         }
         if (x >= w) {
-          x = w;
+          x = w - 1;
         }
         break;
       case COM_MB_REPEAT:
@@ -176,7 +264,7 @@ class MemoryBuffer {
           y = 0;
         }
         if (y >= h) {
-          y = h;
+          y = h - 1;
         }
         break;
       case COM_MB_REPEAT:
@@ -240,11 +328,14 @@ class MemoryBuffer {
       /* clip result outside rect is zero */
       memset(result, 0, this->m_num_channels * sizeof(float));
     }
+    else if (this->m_is_a_single_elem) {
+      memcpy(result, this->m_buffer, sizeof(float) * this->m_num_channels);
+    }
     else {
       int u = x;
       int v = y;
       this->wrap_pixel(u, v, extend_x, extend_y);
-      const int offset = (this->m_width * y + x) * this->m_num_channels;
+      const int offset = (this->m_width * v + u) * this->m_num_channels;
       float *buffer = &this->m_buffer[offset];
       memcpy(result, buffer, sizeof(float) * this->m_num_channels);
     }
@@ -256,6 +347,11 @@ class MemoryBuffer {
                           MemoryBufferExtend extend_x = COM_MB_CLIP,
                           MemoryBufferExtend extend_y = COM_MB_CLIP)
   {
+    if (this->m_is_a_single_elem) {
+      memcpy(result, this->m_buffer, sizeof(float) * this->m_num_channels);
+      return;
+    }
+
     int u = x;
     int v = y;
 
@@ -291,6 +387,14 @@ class MemoryBuffer {
       copy_vn_fl(result, this->m_num_channels, 0.0f);
       return;
     }
+    if (this->m_is_a_single_elem) {
+      /* Same as interpolating the whole area filled with the element, pixels past the last row
+       * and column are zero. */
+      const float weight = single_elem_bilinear_weight(u, this->m_width, extend_x) *
+                           single_elem_bilinear_weight(v, this->m_height, extend_y);
+      mul_vn_vn_fl(result, this->m_buffer, this->m_num_channels, weight);
+      return;
+    }
     BLI_bilinear_interpolation_wrap_fl(this->m_buffer,
                                        result,
                                        this->m_width,
@@ -352,6 +456,15 @@ class MemoryBuffer {
  private:
   unsigned int determineBufferSize();
 
+  static inline float single_elem_bilinear_weight(float u, int size, MemoryBufferExtend extend)
+  {
+    const float a = u - floorf(u);
+    if (extend == COM_MB_REPEAT || (int)ceilf(u) < size) {
+      return 1.0f;
+    }
+    return 1.0f - a;
+  }
+
 #ifdef WITH_CXX_GUARDEDALLOC
   MEM_CXX_CLASS_ALLOC_FUNCS("COM:MemoryBuffer")
 #endif
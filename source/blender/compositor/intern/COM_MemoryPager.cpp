@@ -0,0 +1,320 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#include <string.h>
+
+#include "BLI_fileops.h"
+#include "BLI_path_util.h"
+#include "BLI_string.h"
+
+#include "BKE_appdir.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "COM_MemoryBuffer.h"
+#include "COM_MemoryPager.h"
+
+MemoryPager::MemoryPager(size_t memory_limit)
+{
+  this->m_memory_limit = memory_limit;
+  this->m_memory_used = 0;
+  this->m_memory_writing = 0;
+  this->m_file = nullptr;
+  this->m_file_path[0] = '\0';
+  this->m_file_size = 0;
+  this->m_file_failed = false;
+  BLI_mutex_init(&this->m_mutex);
+  BLI_condition_init(&this->m_loaded_condition);
+  BLI_mutex_init(&this->m_file_mutex);
+}
+
+MemoryPager::~MemoryPager()
+{
+  std::map<PageKey, MemoryPage *>::iterator it;
+  for (it = this->m_pages.begin(); it != this->m_pages.end(); ++it) {
+    free_page(it->second);
+  }
+  this->m_pages.clear();
+  this->m_lru.clear();
+
+  if (this->m_file) {
+    fclose(this->m_file);
+    BLI_delete(this->m_file_path, false, false);
+  }
+  BLI_mutex_end(&this->m_file_mutex);
+  BLI_condition_end(&this->m_loaded_condition);
+  BLI_mutex_end(&this->m_mutex);
+}
+
+size_t MemoryPager::get_page_size(const MemoryPage *page)
+{
+  return sizeof(float) * page->num_channels * BLI_rcti_size_x(&page->rect) *
+         BLI_rcti_size_y(&page->rect);
+}
+
+void MemoryPager::free_page(MemoryPage *page)
+{
+  BLI_assert(page->users == 0 && !page->writing && !page->loading);
+  if (page->data) {
+    MEM_freeN(page->data);
+  }
+  if (page->file_offset != -1) {
+    free_file_slot(page->file_offset, get_page_size(page));
+  }
+  delete page;
+}
+
+void MemoryPager::store_chunk(const MemoryProxy *proxy,
+                              unsigned int chunk_number,
+                              MemoryBuffer *buffer)
+{
+  BLI_assert(!buffer->is_a_single_elem());
+  MemoryPage *page = new MemoryPage();
+  page->rect = *buffer->getRect();
+  page->num_channels = buffer->get_num_channels();
+  page->file_offset = -1;
+  page->users = 0;
+  page->writing = false;
+  page->loading = false;
+  const size_t size = get_page_size(page);
+  page->data = (float *)MEM_mallocN_aligned(size, 16, "COM_MemoryPager page");
+  memcpy(page->data, buffer->getBuffer(), size);
+
+  BLI_mutex_lock(&this->m_mutex);
+  const PageKey key(proxy, chunk_number);
+  std::map<PageKey, MemoryPage *>::iterator it = this->m_pages.find(key);
+  if (it != this->m_pages.end()) {
+    MemoryPage *old_page = it->second;
+    if (old_page->data) {
+      this->m_memory_used -= get_page_size(old_page);
+      this->m_lru.erase(old_page->lru_position);
+    }
+    free_page(old_page);
+  }
+  this->m_pages[key] = page;
+  this->m_lru.push_front(page);
+  page->lru_position = this->m_lru.begin();
+  this->m_memory_used += size;
+  evict_pages();
+  BLI_mutex_unlock(&this->m_mutex);
+}
+
+bool MemoryPager::read_chunk(const MemoryProxy *proxy,
+                             unsigned int chunk_number,
+                             MemoryBuffer *buffer)
+{
+  BLI_mutex_lock(&this->m_mutex);
+  std::map<PageKey, MemoryPage *>::iterator it = this->m_pages.find(
+      PageKey(proxy, chunk_number));
+  if (it == this->m_pages.end()) {
+    BLI_mutex_unlock(&this->m_mutex);
+    return false;
+  }
+  MemoryPage *page = it->second;
+  while (page->loading) {
+    BLI_condition_wait(&this->m_loaded_condition, &this->m_mutex);
+  }
+  /* Pin the page while loading and copying, so the lock isn't held meanwhile. */
+  page->users++;
+  if (page->data) {
+    if (!page->writing) {
+      this->m_lru.splice(this->m_lru.begin(), this->m_lru, page->lru_position);
+    }
+  }
+  else {
+    page->loading = true;
+    BLI_mutex_unlock(&this->m_mutex);
+    float *data = load_page(page);
+    BLI_mutex_lock(&this->m_mutex);
+    page->loading = false;
+    BLI_condition_notify_all(&this->m_loaded_condition);
+    if (data == nullptr) {
+      page->users--;
+      BLI_mutex_unlock(&this->m_mutex);
+      return false;
+    }
+    page->data = data;
+    this->m_lru.push_front(page);
+    page->lru_position = this->m_lru.begin();
+    this->m_memory_used += get_page_size(page);
+  }
+  evict_pages();
+  BLI_mutex_unlock(&this->m_mutex);
+
+  rcti overlap;
+  if (BLI_rcti_isect(&page->rect, buffer->getRect(), &overlap)) {
+    const rcti *buffer_rect = buffer->getRect();
+    const int page_width = BLI_rcti_size_x(&page->rect);
+    const int buffer_width = buffer->getWidth();
+    const size_t row_size = sizeof(float) * page->num_channels * BLI_rcti_size_x(&overlap);
+    for (int y = overlap.ymin; y < overlap.ymax; y++) {
+      const float *src = page->data + ((y - page->rect.ymin) * page_width + overlap.xmin -
+                                       page->rect.xmin) *
+                                          page->num_channels;
+      float *dst = buffer->getBuffer() + ((y - buffer_rect->ymin) * buffer_width +
+                                          overlap.xmin - buffer_rect->xmin) *
+                                             page->num_channels;
+      memcpy(dst, src, row_size);
+    }
+  }
+
+  BLI_mutex_lock(&this->m_mutex);
+  page->users--;
+  evict_pages();
+  BLI_mutex_unlock(&this->m_mutex);
+  return true;
+}
+
+void MemoryPager::free_proxy(const MemoryProxy *proxy)
+{
+  BLI_mutex_lock(&this->m_mutex);
+  std::map<PageKey, MemoryPage *>::iterator it = this->m_pages.lower_bound(PageKey(proxy, 0));
+  while (it != this->m_pages.end() && it->first.first == proxy) {
+    MemoryPage *page = it->second;
+    if (page->data) {
+      this->m_memory_used -= get_page_size(page);
+      this->m_lru.erase(page->lru_position);
+    }
+    free_page(page);
+    it = this->m_pages.erase(it);
+  }
+  BLI_mutex_unlock(&this->m_mutex);
+}
+
+/* Called with the lock held, which is released while writing pages. */
+void MemoryPager::evict_pages()
+{
+  std::list<MemoryPage *>::iterator it = this->m_lru.end();
+  while (this->m_memory_used - this->m_memory_writing > this->m_memory_limit &&
+         it != this->m_lru.begin()) {
+    --it;
+    MemoryPage *page = *it;
+    if (page->users > 0) {
+      continue;
+    }
+    const size_t size = get_page_size(page);
+    if (page->file_offset != -1) {
+      MEM_freeN(page->data);
+      page->data = nullptr;
+      this->m_memory_used -= size;
+      it = this->m_lru.erase(it);
+      continue;
+    }
+    if (this->m_file_failed) {
+      return;
+    }
+
+    /* Readers can still copy the data of the page while it is written. */
+    this->m_lru.erase(it);
+    page->writing = true;
+    this->m_memory_writing += size;
+    const int64_t file_offset = alloc_file_slot(size);
+    BLI_mutex_unlock(&this->m_mutex);
+    const bool written = write_page(page, file_offset);
+    BLI_mutex_lock(&this->m_mutex);
+    page->writing = false;
+    this->m_memory_writing -= size;
+
+    if (written) {
+      page->file_offset = file_offset;
+    }
+    else {
+      free_file_slot(file_offset, size);
+      this->m_file_failed = true;
+    }
+    if (written && page->users == 0) {
+      MEM_freeN(page->data);
+      page->data = nullptr;
+      this->m_memory_used -= size;
+    }
+    else {
+      this->m_lru.push_front(page);
+      page->lru_position = this->m_lru.begin();
+    }
+    /* The list may have changed while the lock was released. */
+    it = this->m_lru.end();
+  }
+}
+
+int64_t MemoryPager::alloc_file_slot(size_t size)
+{
+  /* Use the smallest free slot the page fits in, the rest of it stays free. */
+  std::multimap<size_t, int64_t>::iterator it = this->m_free_slots.lower_bound(size);
+  if (it == this->m_free_slots.end()) {
+    const int64_t file_offset = this->m_file_size;
+    this->m_file_size += size;
+    return file_offset;
+  }
+  const size_t slot_size = it->first;
+  const int64_t file_offset = it->second;
+  this->m_free_slots.erase(it);
+  if (slot_size > size) {
+    this->m_free_slots.insert(std::make_pair(slot_size - size, file_offset + (int64_t)size));
+  }
+  return file_offset;
+}
+
+void MemoryPager::free_file_slot(int64_t file_offset, size_t size)
+{
+  this->m_free_slots.insert(std::make_pair(size, file_offset));
+}
+
+bool MemoryPager::write_page(const MemoryPage *page, int64_t file_offset)
+{
+  BLI_mutex_lock(&this->m_file_mutex);
+  if (this->m_file == nullptr) {
+    char filename[64];
+    BLI_snprintf(filename, sizeof(filename), "compositor_%p.pages", (void *)this);
+    BLI_join_dirfile(
+        this->m_file_path, sizeof(this->m_file_path), BKE_tempdir_session(), filename);
+    this->m_file = BLI_fopen(this->m_file_path, "w+b");
+    if (this->m_file == nullptr) {
+      printf("Compositor: cannot create scratch file %s, buffers are kept in memory\n",
+             this->m_file_path);
+      BLI_mutex_unlock(&this->m_file_mutex);
+      return false;
+    }
+  }
+
+  const size_t size = get_page_size(page);
+  const bool written = BLI_fseek(this->m_file, file_offset, SEEK_SET) == 0 &&
+                       fwrite(page->data, size, 1, this->m_file) == 1;
+  if (!written) {
+    printf("Compositor: cannot write scratch file %s, buffers are kept in memory\n",
+           this->m_file_path);
+  }
+  BLI_mutex_unlock(&this->m_file_mutex);
+  return written;
+}
+
+float *MemoryPager::load_page(const MemoryPage *page)
+{
+  BLI_assert(page->data == nullptr && page->file_offset != -1);
+  const size_t size = get_page_size(page);
+  float *data = (float *)MEM_mallocN_aligned(size, 16, "COM_MemoryPager page");
+  BLI_mutex_lock(&this->m_file_mutex);
+  const bool read = BLI_fseek(this->m_file, page->file_offset, SEEK_SET) == 0 &&
+                    fread(data, size, 1, this->m_file) == 1;
+  BLI_mutex_unlock(&this->m_file_mutex);
+  if (!read) {
+    printf("Compositor: cannot read scratch file %s\n", this->m_file_path);
+    MEM_freeN(data);
+    return nullptr;
+  }
+  return data;
+}
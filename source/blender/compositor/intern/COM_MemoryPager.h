@@ -0,0 +1,138 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#pragma once
+
+#include <list>
+#include <map>
+#include <stdint.h>
+#include <stdio.h>
+#include <utility>
+
+#include "BLI_rect.h"
+#include "BLI_threads.h"
+
+#ifdef WITH_CXX_GUARDEDALLOC
+#  include "MEM_guardedalloc.h"
+#endif
+
+class MemoryBuffer;
+class MemoryProxy;
+
+/**
+ * \brief Stores the chunks of write buffers within a memory limit.
+ *
+ * In tiled execution every write buffer normally keeps a buffer of its whole resolution for the
+ * whole execution. Buffers of a MemoryProxy using a pager are instead stored per chunk of the
+ * ExecutionGroup writing them. When the chunks use more memory than the limit, the least
+ * recently used ones are written to a scratch file in the temporary directory of the session
+ * and freed, they are read back when an area containing them is requested again.
+ *
+ * Chunks are written once and never change, so a chunk is only written to the file the first
+ * time it is evicted. Chunks being copied are pinned and never evicted, so the limit can be
+ * exceeded while many threads read large areas. The file is read and written without holding the
+ * lock of the pager, so other threads can copy chunks in memory meanwhile. The space of freed
+ * chunks in the file is reused for chunks written later.
+ * \see ExecutionGroup.constructConsolidatedMemoryBuffer
+ * \ingroup Memory
+ */
+class MemoryPager {
+ private:
+  typedef struct MemoryPage {
+    rcti rect;
+    unsigned int num_channels;
+    /** Float data of the page, nullptr while it is only stored in the scratch file. */
+    float *data;
+    /** Offset of the data in the scratch file, -1 when it has not been written yet. */
+    int64_t file_offset;
+    /** Number of threads copying data of this page, pinned pages are not evicted. */
+    int users;
+    /** The data is being written to the scratch file, the page is not in the LRU list then. */
+    bool writing;
+    /** The data is being read from the scratch file, other readers wait for it. */
+    bool loading;
+    std::list<struct MemoryPage *>::iterator lru_position;
+  } MemoryPage;
+
+  typedef std::pair<const MemoryProxy *, unsigned int> PageKey;
+
+  std::map<PageKey, MemoryPage *> m_pages;
+  /** Pages with their data in memory, most recently used first. */
+  std::list<MemoryPage *> m_lru;
+
+  size_t m_memory_limit;
+  size_t m_memory_used;
+  /** Memory of the pages being written, it is freed when they are done. */
+  size_t m_memory_writing;
+
+  FILE *m_file;
+  char m_file_path[1024];
+  int64_t m_file_size;
+  /** Unused space in the scratch file by size, to be reused for pages written later. */
+  std::multimap<size_t, int64_t> m_free_slots;
+  /** Writing the scratch file failed, pages are kept in memory from then on. */
+  bool m_file_failed;
+
+  /** Protects the pages and the state above. */
+  ThreadMutex m_mutex;
+  /** Notified when a page is done loading. */
+  ThreadCondition m_loaded_condition;
+  /** Protects the position of the scratch file during reading and writing. */
+  ThreadMutex m_file_mutex;
+
+ public:
+  /**
+   * \param memory_limit: memory used by the data of the stored chunks in bytes.
+   */
+  MemoryPager(size_t memory_limit);
+
+  /**
+   * \brief frees all pages and deletes the scratch file
+   */
+  ~MemoryPager();
+
+  /**
+   * \brief store a copy of the data of a calculated chunk of the buffer of the proxy
+   * \note a chunk is only stored once, storing it again replaces the data
+   */
+  void store_chunk(const MemoryProxy *proxy, unsigned int chunk_number, MemoryBuffer *buffer);
+
+  /**
+   * \brief copy the data of a stored chunk that overlaps with the rect of the buffer into it
+   * \return false when the chunk has not been stored
+   */
+  bool read_chunk(const MemoryProxy *proxy, unsigned int chunk_number, MemoryBuffer *buffer);
+
+  /**
+   * \brief free all chunks of the proxy
+   */
+  void free_proxy(const MemoryProxy *proxy);
+
+ private:
+  static size_t get_page_size(const MemoryPage *page);
+  void free_page(MemoryPage *page);
+  void evict_pages();
+  int64_t alloc_file_slot(size_t size);
+  void free_file_slot(int64_t offset, size_t size);
+  bool write_page(const MemoryPage *page, int64_t file_offset);
+  float *load_page(const MemoryPage *page);
+
+#ifdef WITH_CXX_GUARDEDALLOC
+  MEM_CXX_CLASS_ALLOC_FUNCS("COM:MemoryPager")
+#endif
+};
@@ -17,12 +17,15 @@
  */
 
 #include "COM_MemoryProxy.h"
+#include "COM_MemoryPager.h"
 
 MemoryProxy::MemoryProxy(DataType datatype)
 {
   this->m_writeBufferOperation = nullptr;
   this->m_executor = nullptr;
   this->m_datatype = datatype;
+  this->m_buffer = nullptr;
+  this->m_pager = nullptr;
 }
 
 void MemoryProxy::allocate(unsigned int width, unsigned int height)
@@ -33,11 +36,19 @@ void MemoryProxy::allocate(unsigned int width, unsigned int height)
   result.ymin = 0;
   result.ymax = height;
 
+  if (this->m_pager) {
+    /* Chunks are stored by the pager when they are written. */
+    this->m_buffer = nullptr;
+    return;
+  }
   this->m_buffer = new MemoryBuffer(this, 1, &result);
 }
 
 void MemoryProxy::free()
 {
+  if (this->m_pager) {
+    this->m_pager->free_proxy(this);
+  }
   if (this->m_buffer) {
     delete this->m_buffer;
     this->m_buffer = nullptr;
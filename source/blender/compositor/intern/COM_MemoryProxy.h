@@ -24,6 +24,7 @@ class MemoryProxy;
 #include "COM_MemoryBuffer.h"
 
 class ExecutionGroup;
+class MemoryPager;
 class WriteBufferOperation;
 
 /**
@@ -64,6 +65,11 @@ class MemoryProxy {
    */
   DataType m_datatype;
 
+  /**
+   * \brief pager storing the chunks of this buffer, nullptr when the whole buffer is allocated
+   */
+  MemoryPager *m_pager;
+
  public:
   MemoryProxy(DataType type);
 
@@ -102,6 +108,20 @@ class MemoryProxy {
     return this->m_writeBufferOperation;
   }
 
+  /**
+   * \brief store the chunks of this buffer in a pager instead of allocating the whole buffer
+   * \note must be set before #allocate, #getBuffer returns nullptr for paged buffers
+   */
+  void set_pager(MemoryPager *pager)
+  {
+    this->m_pager = pager;
+  }
+
+  MemoryPager *get_pager() const
+  {
+    return this->m_pager;
+  }
+
   /**
    * \brief allocate memory of size width x height
    */
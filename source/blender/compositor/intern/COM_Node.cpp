@@ -18,12 +18,20 @@
 
 #include <cstring>
 
+#include "BLI_listbase.h"
+
 #include "BKE_node.h"
 
+#include "DNA_color_types.h"
+#include "DNA_image_types.h"
+#include "DNA_node_types.h"
+#include "DNA_texture_types.h"
+
 #include "RNA_access.h"
 
 #include "COM_ExecutionSystem.h"
 #include "COM_NodeOperation.h"
+#include "COM_ResultCache.h"
 #include "COM_TranslateOperation.h"
 
 #include "COM_SocketProxyNode.h"
@@ -144,6 +152,373 @@ bNodeSocket *Node::getEditorOutputSocket(int editorNodeOutputSocketIndex)
   return nullptr;
 }
 
+bool Node::get_cache_key(const CompositorContext & /*context*/, std::string *r_key) const
+{
+  const bNode *node = this->getbNode();
+  if (node->id && GS(node->id->name) != ID_NT) {
+    return false;
+  }
+  return this->get_settings_key(r_key);
+}
+
+static void append_curve_mapping(std::string *r_key, const CurveMapping *cumap)
+{
+  ResultCache::append(*r_key, cumap->flag);
+  ResultCache::append(*r_key, cumap->clipr.xmin);
+  ResultCache::append(*r_key, cumap->clipr.xmax);
+  ResultCache::append(*r_key, cumap->clipr.ymin);
+  ResultCache::append(*r_key, cumap->clipr.ymax);
+  /* The curve points are stored outside of the struct and edited in place. */
+  for (int i = 0; i < CM_TOT; i++) {
+    const CurveMap *cuma = &cumap->cm[i];
+    ResultCache::append(*r_key, cuma->totpoint);
+    for (int a = 0; a < cuma->totpoint; a++) {
+      ResultCache::append(*r_key, cuma->curve[a].x);
+      ResultCache::append(*r_key, cuma->curve[a].y);
+      ResultCache::append(*r_key, cuma->curve[a].flag);
+    }
+    ResultCache::append(*r_key, cuma->ext_in);
+    ResultCache::append(*r_key, cuma->ext_out);
+  }
+  ResultCache::append(*r_key, cumap->black);
+  ResultCache::append(*r_key, cumap->white);
+  ResultCache::append(*r_key, cumap->tone);
+}
+
+static void append_color_band(std::string *r_key, const ColorBand *coba)
+{
+  ResultCache::append(*r_key, coba->tot);
+  ResultCache::append(*r_key, coba->ipotype);
+  ResultCache::append(*r_key, coba->ipotype_hue);
+  ResultCache::append(*r_key, coba->color_mode);
+  for (int i = 0; i < coba->tot; i++) {
+    const CBData *data = &coba->data[i];
+    ResultCache::append(*r_key, data->r);
+    ResultCache::append(*r_key, data->g);
+    ResultCache::append(*r_key, data->b);
+    ResultCache::append(*r_key, data->a);
+    ResultCache::append(*r_key, data->pos);
+  }
+}
+
+static void append_color_correction(std::string *r_key, const ColorCorrectionData *data)
+{
+  ResultCache::append(*r_key, data->saturation);
+  ResultCache::append(*r_key, data->contrast);
+  ResultCache::append(*r_key, data->gamma);
+  ResultCache::append(*r_key, data->gain);
+  ResultCache::append(*r_key, data->lift);
+}
+
+/**
+ * Append the node storage to the key field by field, so padding bytes, pointers and state only
+ * used for drawing are not part of it. Returns false for storage types not handled here.
+ */
+static bool append_node_storage(std::string *r_key, const bNode *node)
+{
+  switch (node->type) {
+    case CMP_NODE_TIME:
+    case CMP_NODE_CURVE_VEC:
+    case CMP_NODE_CURVE_RGB:
+    case CMP_NODE_HUECORRECT: {
+      append_curve_mapping(r_key, (const CurveMapping *)node->storage);
+      return true;
+    }
+    case CMP_NODE_VALTORGB: {
+      append_color_band(r_key, (const ColorBand *)node->storage);
+      return true;
+    }
+    case CMP_NODE_IMAGE:
+    case CMP_NODE_VIEWER:
+    case CMP_NODE_SPLITVIEWER: {
+      /* The current frame is calculated from the scene, see ImageNode.get_cache_key. */
+      const ImageUser *iuser = (const ImageUser *)node->storage;
+      ResultCache::append(*r_key, iuser->frames);
+      ResultCache::append(*r_key, iuser->offset);
+      ResultCache::append(*r_key, iuser->sfra);
+      ResultCache::append(*r_key, iuser->cycl);
+      ResultCache::append(*r_key, iuser->multi_index);
+      ResultCache::append(*r_key, iuser->view);
+      ResultCache::append(*r_key, iuser->layer);
+      ResultCache::append(*r_key, iuser->pass);
+      return true;
+    }
+    case CMP_NODE_ALPHAOVER: {
+      const NodeTwoFloats *data = (const NodeTwoFloats *)node->storage;
+      ResultCache::append(*r_key, data->x);
+      ResultCache::append(*r_key, data->y);
+      return true;
+    }
+    case CMP_NODE_BILATERALBLUR: {
+      const NodeBilateralBlurData *data = (const NodeBilateralBlurData *)node->storage;
+      ResultCache::append(*r_key, data->sigma_color);
+      ResultCache::append(*r_key, data->sigma_space);
+      ResultCache::append(*r_key, data->iter);
+      return true;
+    }
+    case CMP_NODE_BLUR:
+    case CMP_NODE_VECBLUR: {
+      /* The input size is written by the blur node itself. */
+      const NodeBlurData *data = (const NodeBlurData *)node->storage;
+      ResultCache::append(*r_key, data->sizex);
+      ResultCache::append(*r_key, data->sizey);
+      ResultCache::append(*r_key, data->samples);
+      ResultCache::append(*r_key, data->maxspeed);
+      ResultCache::append(*r_key, data->minspeed);
+      ResultCache::append(*r_key, data->relative);
+      ResultCache::append(*r_key, data->aspect);
+      ResultCache::append(*r_key, data->curved);
+      ResultCache::append(*r_key, data->fac);
+      ResultCache::append(*r_key, data->percentx);
+      ResultCache::append(*r_key, data->percenty);
+      ResultCache::append(*r_key, data->filtertype);
+      ResultCache::append(*r_key, data->bokeh);
+      ResultCache::append(*r_key, data->gamma);
+      return true;
+    }
+    case CMP_NODE_BOKEHIMAGE: {
+      const NodeBokehImage *data = (const NodeBokehImage *)node->storage;
+      ResultCache::append(*r_key, data->angle);
+      ResultCache::append(*r_key, data->flaps);
+      ResultCache::append(*r_key, data->rounding);
+      ResultCache::append(*r_key, data->catadioptric);
+      ResultCache::append(*r_key, data->lensshift);
+      return true;
+    }
+    case CMP_NODE_MASK_BOX: {
+      const NodeBoxMask *data = (const NodeBoxMask *)node->storage;
+      ResultCache::append(*r_key, data->x);
+      ResultCache::append(*r_key, data->y);
+      ResultCache::append(*r_key, data->rotation);
+      ResultCache::append(*r_key, data->height);
+      ResultCache::append(*r_key, data->width);
+      return true;
+    }
+    case CMP_NODE_MASK_ELLIPSE: {
+      const NodeEllipseMask *data = (const NodeEllipseMask *)node->storage;
+      ResultCache::append(*r_key, data->x);
+      ResultCache::append(*r_key, data->y);
+      ResultCache::append(*r_key, data->rotation);
+      ResultCache::append(*r_key, data->height);
+      ResultCache::append(*r_key, data->width);
+      return true;
+    }
+    case CMP_NODE_CHANNEL_MATTE:
+    case CMP_NODE_CHROMA_MATTE:
+    case CMP_NODE_COLOR_MATTE:
+    case CMP_NODE_DIFF_MATTE:
+    case CMP_NODE_DIST_MATTE:
+    case CMP_NODE_LUMA_MATTE: {
+      const NodeChroma *data = (const NodeChroma *)node->storage;
+      ResultCache::append(*r_key, data->t1);
+      ResultCache::append(*r_key, data->t2);
+      ResultCache::append(*r_key, data->t3);
+      ResultCache::append(*r_key, data->fsize);
+      ResultCache::append(*r_key, data->fstrength);
+      ResultCache::append(*r_key, data->falpha);
+      ResultCache::append(*r_key, data->key);
+      ResultCache::append(*r_key, data->algorithm);
+      ResultCache::append(*r_key, data->channel);
+      return true;
+    }
+    case CMP_NODE_COLOR_SPILL: {
+      const NodeColorspill *data = (const NodeColorspill *)node->storage;
+      ResultCache::append(*r_key, data->limchan);
+      ResultCache::append(*r_key, data->unspill);
+      ResultCache::append(*r_key, data->limscale);
+      ResultCache::append(*r_key, data->uspillr);
+      ResultCache::append(*r_key, data->uspillg);
+      ResultCache::append(*r_key, data->uspillb);
+      return true;
+    }
+    case CMP_NODE_COLORBALANCE: {
+      const NodeColorBalance *data = (const NodeColorBalance *)node->storage;
+      ResultCache::append(*r_key, data->slope);
+      ResultCache::append(*r_key, data->offset);
+      ResultCache::append(*r_key, data->power);
+      ResultCache::append(*r_key, data->offset_basis);
+      ResultCache::append(*r_key, data->lift);
+      ResultCache::append(*r_key, data->gamma);
+      ResultCache::append(*r_key, data->gain);
+      return true;
+    }
+    case CMP_NODE_COLORCORRECTION: {
+      const NodeColorCorrection *data = (const NodeColorCorrection *)node->storage;
+      append_color_correction(r_key, &data->master);
+      append_color_correction(r_key, &data->shadows);
+      append_color_correction(r_key, &data->midtones);
+      append_color_correction(r_key, &data->highlights);
+      ResultCache::append(*r_key, data->startmidtones);
+      ResultCache::append(*r_key, data->endmidtones);
+      return true;
+    }
+    case CMP_NODE_CROP: {
+      const NodeTwoXYs *data = (const NodeTwoXYs *)node->storage;
+      ResultCache::append(*r_key, data->x1);
+      ResultCache::append(*r_key, data->x2);
+      ResultCache::append(*r_key, data->y1);
+      ResultCache::append(*r_key, data->y2);
+      ResultCache::append(*r_key, data->fac_x1);
+      ResultCache::append(*r_key, data->fac_x2);
+      ResultCache::append(*r_key, data->fac_y1);
+      ResultCache::append(*r_key, data->fac_y2);
+      return true;
+    }
+    case CMP_NODE_DEFOCUS: {
+      const NodeDefocus *data = (const NodeDefocus *)node->storage;
+      ResultCache::append(*r_key, data->bktype);
+      ResultCache::append(*r_key, data->use_fft);
+      ResultCache::append(*r_key, data->preview);
+      ResultCache::append(*r_key, data->gamco);
+      ResultCache::append(*r_key, data->samples);
+      ResultCache::append(*r_key, data->no_zbuf);
+      ResultCache::append(*r_key, data->fstop);
+      ResultCache::append(*r_key, data->maxblur);
+      ResultCache::append(*r_key, data->bthresh);
+      ResultCache::append(*r_key, data->scale);
+      ResultCache::append(*r_key, data->rotation);
+      return true;
+    }
+    case CMP_NODE_DENOISE: {
+      const NodeDenoise *data = (const NodeDenoise *)node->storage;
+      ResultCache::append(*r_key, data->hdr);
+      return true;
+    }
+    case CMP_NODE_DILATEERODE: {
+      const NodeDilateErode *data = (const NodeDilateErode *)node->storage;
+      ResultCache::append(*r_key, data->falloff);
+      return true;
+    }
+    case CMP_NODE_DBLUR: {
+      const NodeDBlurData *data = (const NodeDBlurData *)node->storage;
+      ResultCache::append(*r_key, data->center_x);
+      ResultCache::append(*r_key, data->center_y);
+      ResultCache::append(*r_key, data->distance);
+      ResultCache::append(*r_key, data->angle);
+      ResultCache::append(*r_key, data->spin);
+      ResultCache::append(*r_key, data->zoom);
+      ResultCache::append(*r_key, data->iter);
+      ResultCache::append(*r_key, data->wrap);
+      return true;
+    }
+    case CMP_NODE_GLARE: {
+      const NodeGlare *data = (const NodeGlare *)node->storage;
+      ResultCache::append(*r_key, data->quality);
+      ResultCache::append(*r_key, data->type);
+      ResultCache::append(*r_key, data->iter);
+      ResultCache::append(*r_key, data->size);
+      ResultCache::append(*r_key, data->star_45);
+      ResultCache::append(*r_key, data->streaks);
+      ResultCache::append(*r_key, data->colmod);
+      ResultCache::append(*r_key, data->mix);
+      ResultCache::append(*r_key, data->threshold);
+      ResultCache::append(*r_key, data->fade);
+      ResultCache::append(*r_key, data->angle_ofs);
+      return true;
+    }
+    case CMP_NODE_KEYING: {
+      const NodeKeyingData *data = (const NodeKeyingData *)node->storage;
+      ResultCache::append(*r_key, data->screen_balance);
+      ResultCache::append(*r_key, data->despill_factor);
+      ResultCache::append(*r_key, data->despill_balance);
+      ResultCache::append(*r_key, data->edge_kernel_radius);
+      ResultCache::append(*r_key, data->edge_kernel_tolerance);
+      ResultCache::append(*r_key, data->clip_black);
+      ResultCache::append(*r_key, data->clip_white);
+      ResultCache::append(*r_key, data->dilate_distance);
+      ResultCache::append(*r_key, data->feather_distance);
+      ResultCache::append(*r_key, data->feather_falloff);
+      ResultCache::append(*r_key, data->blur_pre);
+      ResultCache::append(*r_key, data->blur_post);
+      return true;
+    }
+    case CMP_NODE_LENSDIST: {
+      const NodeLensDist *data = (const NodeLensDist *)node->storage;
+      ResultCache::append(*r_key, data->jit);
+      ResultCache::append(*r_key, data->proj);
+      ResultCache::append(*r_key, data->fit);
+      return true;
+    }
+    case CMP_NODE_MAP_VALUE: {
+      const TexMapping *texmap = (const TexMapping *)node->storage;
+      ResultCache::append(*r_key, texmap->loc);
+      ResultCache::append(*r_key, texmap->size);
+      ResultCache::append(*r_key, texmap->min);
+      ResultCache::append(*r_key, texmap->max);
+      ResultCache::append(*r_key, texmap->flag);
+      return true;
+    }
+    case CMP_NODE_SUNBEAMS: {
+      const NodeSunBeams *data = (const NodeSunBeams *)node->storage;
+      ResultCache::append(*r_key, data->source);
+      ResultCache::append(*r_key, data->ray_length);
+      return true;
+    }
+    case CMP_NODE_TONEMAP: {
+      const NodeTonemap *data = (const NodeTonemap *)node->storage;
+      ResultCache::append(*r_key, data->key);
+      ResultCache::append(*r_key, data->offset);
+      ResultCache::append(*r_key, data->gamma);
+      ResultCache::append(*r_key, data->f);
+      ResultCache::append(*r_key, data->m);
+      ResultCache::append(*r_key, data->a);
+      ResultCache::append(*r_key, data->c);
+      ResultCache::append(*r_key, data->type);
+      return true;
+    }
+    case CMP_NODE_TRANSLATE: {
+      const NodeTranslateData *data = (const NodeTranslateData *)node->storage;
+      ResultCache::append(*r_key, data->wrap_axis);
+      ResultCache::append(*r_key, data->relative);
+      return true;
+    }
+  }
+  /* Cryptomatte entries, file outputs, masks and tracking data. */
+  return false;
+}
+
+static bool append_socket_value(std::string *r_key, const bNodeSocket *sock)
+{
+  switch (sock->type) {
+    case SOCK_FLOAT: {
+      ResultCache::append(*r_key, ((const bNodeSocketValueFloat *)sock->default_value)->value);
+      return true;
+    }
+    case SOCK_VECTOR: {
+      ResultCache::append(*r_key, ((const bNodeSocketValueVector *)sock->default_value)->value);
+      return true;
+    }
+    case SOCK_RGBA: {
+      ResultCache::append(*r_key, ((const bNodeSocketValueRGBA *)sock->default_value)->value);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool Node::get_settings_key(std::string *r_key) const
+{
+  const bNode *node = this->getbNode();
+  ResultCache::append_string(*r_key, node->typeinfo->idname);
+  ResultCache::append(*r_key, node->custom1);
+  ResultCache::append(*r_key, node->custom2);
+  ResultCache::append(*r_key, node->custom3);
+  ResultCache::append(*r_key, node->custom4);
+
+  ResultCache::append(*r_key, node->storage != nullptr);
+  if (node->storage && !append_node_storage(r_key, node)) {
+    return false;
+  }
+
+  LISTBASE_FOREACH (const bNodeSocket *, sock, &node->inputs) {
+    ResultCache::append(*r_key, sock->default_value != nullptr);
+    if (sock->default_value && !append_socket_value(r_key, sock)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 /*******************
  **** NodeInput ****
  *******************/
@@ -20,6 +20,7 @@
 
 #include "DNA_node_types.h"
 #include <algorithm>
+#include <stdint.h>
 #include <string>
 #include <vector>
 
@@ -219,6 +220,18 @@ class Node {
    */
   void convertToOperations_invalid(NodeConverter *compiler) const;
 
+  /**
+   * \brief append a key identifying everything the operations of this node depend on, except for
+   * their input operations
+   *
+   * By default the key is made of the node settings, nodes using an ID data-block are not
+   * cached as the data-block can change without the node being edited. Nodes reading such data
+   * can still be cached by adding it to the key.
+   * \return false when the results of this node must not be cached
+   * \see ResultCache
+   */
+  virtual bool get_cache_key(const CompositorContext &context, std::string *r_key) const;
+
   void setInstanceKey(bNodeInstanceKey instance_key)
   {
     m_instanceKey = instance_key;
@@ -247,6 +260,12 @@ class Node {
 
   bNodeSocket *getEditorInputSocket(int editorNodeInputSocketIndex);
   bNodeSocket *getEditorOutputSocket(int editorNodeOutputSocketIndex);
+
+  /**
+   * \brief append the node type, its settings, storage and input socket values to the key
+   * \return false when the storage cannot be identified by its content
+   */
+  bool get_settings_key(std::string *r_key) const;
 };
 
 /**
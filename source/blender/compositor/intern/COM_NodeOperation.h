@@ -102,6 +102,19 @@ class NodeOperation : public SocketReader {
    */
   bool m_openCL;
 
+  /**
+   * \brief can this operation calculate a whole area at once in full-frame execution.
+   * \see NodeOperation.update_memory_buffer
+   */
+  bool m_fullFrame;
+
+  /**
+   * \brief key of the node settings this operation was created with
+   * \see ResultCache
+   */
+  std::string m_nodeKey;
+  bool m_hasNodeKey;
+
   /**
    * \brief mutex reference for very special node initializations
    * \note only use when you really know what you are doing.
@@ -200,6 +213,22 @@ class NodeOperation : public SocketReader {
   {
   }
 
+  /**
+   * \brief calculate an area of the output in full-frame execution
+   * \ingroup execution
+   * \note only called when #isFullFrameOperation is set and all inputs are available as
+   * buffers with the resolution of this operation, otherwise the output is read pixel by pixel.
+   * \param output: the buffer holding the whole output of this operation
+   * \param area: the area of the output to calculate, inside the bounds of output
+   * \param inputs: the buffers of all inputs, in input socket order. Inputs can be single element
+   * buffers, see MemoryBuffer.is_a_single_elem.
+   */
+  virtual void update_memory_buffer(MemoryBuffer * /*output*/,
+                                    rcti * /*area*/,
+                                    MemoryBuffer ** /*inputs*/)
+  {
+  }
+
   /**
    * \brief when a chunk is executed by an OpenCLDevice, this method is called
    * \ingroup execution
@@ -343,6 +372,34 @@ class NodeOperation : public SocketReader {
     return this->m_openCL;
   }
 
+  /**
+   * \brief does this NodeOperation implement #update_memory_buffer
+   * \see FullFrameExecutionModel
+   */
+  bool isFullFrameOperation() const
+  {
+    return this->m_fullFrame;
+  }
+
+  /**
+   * \brief set the key of the node settings this operation was created with, only operations
+   * with a key can have their result cached
+   * \see NodeOperationBuilder.addOperation
+   */
+  void setNodeKey(const std::string &key)
+  {
+    this->m_nodeKey = key;
+    this->m_hasNodeKey = true;
+  }
+  bool hasNodeKey() const
+  {
+    return this->m_hasNodeKey;
+  }
+  const std::string &getNodeKey() const
+  {
+    return this->m_nodeKey;
+  }
+
   virtual bool isViewerOperation() const
   {
     return false;
@@ -420,6 +477,14 @@ class NodeOperation : public SocketReader {
     this->m_openCL = openCL;
   }
 
+  /**
+   * \brief set if this NodeOperation implements #update_memory_buffer
+   */
+  void setFullFrameOperation(bool fullFrame)
+  {
+    this->m_fullFrame = fullFrame;
+  }
+
   /* allow the DebugInfo class to look at internals */
   friend class DebugInfo;
 
@@ -23,6 +23,7 @@
 #include "COM_ExecutionSystem.h"
 #include "COM_Node.h"
 #include "COM_NodeConverter.h"
+#include "COM_ResultCache.h"
 #include "COM_SocketProxyNode.h"
 
 #include "COM_NodeOperation.h"
@@ -38,7 +39,11 @@
 #include "COM_NodeOperationBuilder.h" /* own include */
 
 NodeOperationBuilder::NodeOperationBuilder(const CompositorContext *context, bNodeTree *b_nodetree)
-    : m_context(context), m_current_node(nullptr), m_active_viewer(nullptr)
+    : m_context(context),
+      m_current_node(nullptr),
+      m_current_key_valid(false),
+      m_current_num_operations(0),
+      m_active_viewer(nullptr)
 {
   m_graph.from_bNodeTree(*context, b_nodetree);
 }
@@ -52,16 +57,28 @@ void NodeOperationBuilder::convertToOperations(ExecutionSystem *system)
   /* interface handle for nodes */
   NodeConverter converter(this);
 
+  const bool use_cache = ResultCache::is_enabled(*m_context);
+  std::string context_key;
+  if (use_cache) {
+    ResultCache::append_context(context_key, *m_context);
+  }
+
   for (int index = 0; index < m_graph.nodes().size(); index++) {
     Node *node = (Node *)m_graph.nodes()[index];
 
     m_current_node = node;
+    m_current_key = context_key;
+    m_current_key_valid = use_cache && node->get_cache_key(*m_context, &m_current_key);
+    m_current_num_operations = 0;
 
     DebugInfo::node_to_operations(node);
     node->convertToOperations(converter, *m_context);
   }
 
   m_current_node = nullptr;
+  /* Operations added by the builder itself only depend on their inputs. */
+  m_current_key = context_key;
+  m_current_key_valid = use_cache;
 
   /* The input map constructed by nodes maps operation inputs to node inputs.
    * Inverting yields a map of node inputs to all connected operation inputs,
@@ -104,8 +121,10 @@ void NodeOperationBuilder::convertToOperations(ExecutionSystem *system)
 
   determineResolutions();
 
-  /* surround complex ops with read/write buffer */
-  add_complex_operation_buffers();
+  /* surround complex ops with read/write buffer, full-frame execution buffers every operation */
+  if (m_context->getExecutionModel() == COM_EXECUTION_MODEL_TILED) {
+    add_complex_operation_buffers();
+  }
 
   /* links not available from here on */
   /* XXX make m_links a local variable to avoid confusion! */
@@ -117,7 +136,9 @@ void NodeOperationBuilder::convertToOperations(ExecutionSystem *system)
   /*sort_operations();*/ /* not needed yet */
 
   /* create execution groups */
-  group_operations();
+  if (m_context->getExecutionModel() == COM_EXECUTION_MODEL_TILED) {
+    group_operations();
+  }
 
   /* transfer resulting operations to the system */
   system->set_operations(m_operations, m_groups);
@@ -126,6 +147,15 @@ void NodeOperationBuilder::convertToOperations(ExecutionSystem *system)
 void NodeOperationBuilder::addOperation(NodeOperation *operation)
 {
   m_operations.push_back(operation);
+
+  if (m_current_key_valid) {
+    /* Operations of the same node are told apart by the order they are added in. */
+    std::string key = m_current_key;
+    if (m_current_node) {
+      ResultCache::append(key, m_current_num_operations++);
+    }
+    operation->setNodeKey(key);
+  }
 }
 
 void NodeOperationBuilder::mapInputSocket(NodeInput *node_socket,
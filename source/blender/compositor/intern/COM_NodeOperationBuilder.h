@@ -89,6 +89,13 @@ class NodeOperationBuilder {
 
   Node *m_current_node;
 
+  /** Key of the node or the builder adding operations, see Node.get_cache_key */
+  std::string m_current_key;
+  /** Results of the added operations can be cached, see ResultCache */
+  bool m_current_key_valid;
+  /** Number of operations added for the current node */
+  unsigned int m_current_num_operations;
+
   /** Operation that will be writing to the viewer image
    *  Only one operation can occupy this place at a time,
    *  to avoid race conditions
@@ -0,0 +1,159 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#include <map>
+#include <string.h>
+
+#include "DNA_color_types.h"
+#include "DNA_scene_types.h"
+#include "DNA_userdef_types.h"
+
+#include "COM_MemoryBuffer.h"
+#include "COM_ResultCache.h"
+
+typedef struct ResultCacheEntry {
+  MemoryBuffer *buffer;
+  size_t size;
+  /** Value of #s_used_counter when the buffer was last added or looked up. */
+  uint64_t last_used;
+} ResultCacheEntry;
+
+static std::map<std::string, ResultCacheEntry> s_entries;
+static size_t s_size = 0;
+static uint64_t s_used_counter = 0;
+
+static size_t cache_limit()
+{
+  return (size_t)max_ii(U.compositor_cache_limit, 0) * 1024 * 1024;
+}
+
+bool ResultCache::is_enabled(const CompositorContext &context)
+{
+  return context.getExecutionModel() == COM_EXECUTION_MODEL_FULL_FRAME &&
+         U.compositor_cache_limit > 0;
+}
+
+MemoryBuffer *ResultCache::lookup(const std::string &key)
+{
+  std::map<std::string, ResultCacheEntry>::iterator it = s_entries.find(key);
+  if (it == s_entries.end()) {
+    return nullptr;
+  }
+  it->second.last_used = ++s_used_counter;
+  return it->second.buffer;
+}
+
+bool ResultCache::add(const std::string &key, MemoryBuffer *buffer)
+{
+  const size_t size = buffer->get_memory_size() + key.size();
+  if (size > cache_limit()) {
+    return false;
+  }
+  if (s_entries.find(key) != s_entries.end()) {
+    /* Operations computing the same result in one execution, e.g. of duplicated nodes. The
+     * stored buffer may still be read by the current execution, so it is kept. */
+    return false;
+  }
+
+  ResultCacheEntry entry;
+  entry.buffer = buffer;
+  entry.size = size;
+  entry.last_used = ++s_used_counter;
+  s_entries[key] = entry;
+  s_size += entry.size;
+  return true;
+}
+
+void ResultCache::trim()
+{
+  const size_t limit = cache_limit();
+  while (s_size > limit) {
+    std::map<std::string, ResultCacheEntry>::iterator oldest = s_entries.begin();
+    for (std::map<std::string, ResultCacheEntry>::iterator it = s_entries.begin();
+         it != s_entries.end();
+         ++it) {
+      if (it->second.last_used < oldest->second.last_used) {
+        oldest = it;
+      }
+    }
+    s_size -= oldest->second.size;
+    delete oldest->second.buffer;
+    s_entries.erase(oldest);
+  }
+}
+
+void ResultCache::clear()
+{
+  for (std::map<std::string, ResultCacheEntry>::iterator it = s_entries.begin();
+       it != s_entries.end();
+       ++it) {
+    delete it->second.buffer;
+  }
+  s_entries.clear();
+  s_size = 0;
+}
+
+void ResultCache::append_bytes(std::string &key, const void *data, size_t size)
+{
+  append(key, size);
+  key.append((const char *)data, size);
+}
+
+void ResultCache::append_string(std::string &key, const char *str)
+{
+  append_bytes(key, str, strlen(str));
+}
+
+void ResultCache::append_context(std::string &key, const CompositorContext &context)
+{
+  append(key, context.getFramenumber());
+  append(key, context.getQuality());
+  append(key, context.isFastCalculation());
+  append(key, context.isRendering());
+  append(key, context.isHalfBufferEnabled());
+  append_string(key, context.getViewName() ? context.getViewName() : "");
+
+  const RenderData *rd = context.getRenderData();
+  append(key, rd != nullptr);
+  if (rd) {
+    /* Settings read by nodes to determine resolutions and render borders. */
+    append(key, rd->xsch);
+    append(key, rd->ysch);
+    append(key, rd->size);
+    append(key, rd->mode & (R_BORDER | R_CROP));
+    append(key, rd->scemode & (R_FULL_SAMPLE | R_MULTIVIEW));
+    append(key, rd->border.xmin);
+    append(key, rd->border.xmax);
+    append(key, rd->border.ymin);
+    append(key, rd->border.ymax);
+  }
+
+  const ColorManagedViewSettings *view_settings = context.getViewSettings();
+  append(key, view_settings != nullptr);
+  if (view_settings) {
+    append_string(key, view_settings->look);
+    append_string(key, view_settings->view_transform);
+    append(key, view_settings->exposure);
+    append(key, view_settings->gamma);
+  }
+  const ColorManagedDisplaySettings *display_settings = context.getDisplaySettings();
+  append(key, display_settings != nullptr);
+  if (display_settings) {
+    append_string(key, display_settings->display_device);
+  }
+}
@@ -0,0 +1,108 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <type_traits>
+
+#include "COM_CompositorContext.h"
+
+class MemoryBuffer;
+
+/* Keys of operations reading from many other operations are not cached, to avoid spending more
+ * time and memory on the keys than on the results. */
+#define COM_RESULT_CACHE_MAX_KEY_SIZE (256 * 1024)
+
+/**
+ * \brief Keeps the output buffers of complex operations between executions of the compositor.
+ *
+ * Results are identified by a key combining the settings of the node an operation was created
+ * from with the keys of all operations it reads from, so editing a node only invalidates the
+ * results depending on it. Keys are byte strings that are compared completely, so results are
+ * never confused because of hash collisions. Data-blocks are identified by their session UUID
+ * and update counters instead of their content. Nodes depending on data that cannot be
+ * identified like that (masks, movie clips, textures, ...) are never cached, see
+ * Node.get_cache_key.
+ *
+ * The cache is only used in full-frame execution and is limited by
+ * #UserDef.compositor_cache_limit, the least recently used results are freed first.
+ * Access is serialized by the mutex of COM_execute.
+ * \see FullFrameExecutionModel
+ * \ingroup Execution
+ */
+class ResultCache {
+ public:
+  /**
+   * \brief are results of the given execution cached
+   */
+  static bool is_enabled(const CompositorContext &context);
+
+  /**
+   * \brief get the buffer stored with the given key, nullptr when there is none
+   * \note the buffer stays owned by the cache
+   */
+  static MemoryBuffer *lookup(const std::string &key);
+
+  /**
+   * \brief store a completely calculated buffer, the cache takes ownership of it
+   * \return false when the buffer was not stored, because it is larger than the whole cache or
+   * because a buffer with the same key is stored already. The caller keeps ownership then.
+   */
+  static bool add(const std::string &key, MemoryBuffer *buffer);
+
+  /**
+   * \brief free the least recently used buffers until the cache fits the user preference limit
+   * \note buffers added or looked up in the current execution may be freed as well, so only call
+   * this when the execution has finished.
+   */
+  static void trim();
+
+  /**
+   * \brief free all cached buffers
+   */
+  static void clear();
+
+  /**
+   * \brief append the execution settings that affect the result of all operations to the key
+   */
+  static void append_context(std::string &key, const CompositorContext &context);
+
+  /**
+   * \brief append a value to the key, only for types whose value is fully defined by their bytes
+   */
+  template<typename T> static void append(std::string &key, const T &value)
+  {
+    static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value,
+                  "Type may contain padding bytes or pointers");
+    key.append((const char *)&value, sizeof(T));
+  }
+  template<typename T, size_t N> static void append(std::string &key, const T (&values)[N])
+  {
+    for (size_t i = 0; i < N; i++) {
+      append(key, values[i]);
+    }
+  }
+  /**
+   * \brief append the size of the data and the data itself to the key
+   */
+  static void append_bytes(std::string &key, const void *data, size_t size);
+  static void append_string(std::string &key, const char *str);
+};
@@ -29,32 +29,43 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "BLI_task.h"
 #include "BLI_threads.h"
+#include "BLI_utildefines.h"
 #include "PIL_time.h"
 
+#include "atomic_ops.h"
+
 #include "BKE_global.h"
 
 #if COM_CURRENT_THREADING_MODEL == COM_TM_NOTHREAD
 #  ifndef DEBUG /* test this so we dont get warnings in debug builds */
 #    warning COM_CURRENT_THREADING_MODEL COM_TM_NOTHREAD is activated. Use only for debugging.
 #  endif
-#elif COM_CURRENT_THREADING_MODEL == COM_TM_QUEUE
+#elif COM_CURRENT_THREADING_MODEL == COM_TM_TASK
 /* do nothing - default */
 #else
 #  error COM_CURRENT_THREADING_MODEL No threading model selected
 #endif
 
-/** \brief list of all CPUDevices. for every hardware thread an instance of CPUDevice is created */
-static vector<CPUDevice *> g_cpudevices;
-static ThreadLocal(CPUDevice *) g_thread_device;
-
-#if COM_CURRENT_THREADING_MODEL == COM_TM_QUEUE
-/** \brief list of all thread for every CPUDevice in cpudevices a thread exists. */
+#if COM_CURRENT_THREADING_MODEL == COM_TM_TASK
+#  ifdef WITH_TBB
+/** \brief all scheduled work for the cpu, executed by the threads of the task scheduler */
+static TaskPool *g_cpupool = nullptr;
+#  else
+/* Without TBB task pools execute tasks right away in the thread pushing them, so the CPU work is
+ * executed by threads of our own. */
+/** \brief list of all threads executing CPU work */
 static ListBase g_cputhreads;
-static bool g_cpuInitialized = false;
 /** \brief all scheduled work for the cpu */
-static ThreadQueue *g_cpuqueue;
-static ThreadQueue *g_gpuqueue;
+static ThreadQueue *g_cpuqueue = nullptr;
+/** \brief index of the calling thread in #g_cputhreads, -1 for other threads */
+static thread_local int g_cpu_thread_id = -1;
+#  endif
+/** \brief number of scheduled work packages that haven't been executed yet */
+static int g_numPendingWork = 0;
+static ThreadMutex g_pendingMutex = BLI_MUTEX_INITIALIZER;
+static ThreadCondition g_pendingCondition;
 #  ifdef COM_OPENCL_ENABLED
 static cl_context g_context;
 static cl_program g_program;
@@ -64,25 +75,49 @@ static vector<OpenCLDevice *> g_gpudevices;
 /** \brief list of all thread for every GPUDevice in cpudevices a thread exists. */
 static ListBase g_gputhreads;
 /** \brief all scheduled work for the GPU. */
+static ThreadQueue *g_gpuqueue;
 static bool g_openclActive = false;
 static bool g_openclInitialized = false;
 #  endif
 #endif
 
-#if COM_CURRENT_THREADING_MODEL == COM_TM_QUEUE
+#if COM_CURRENT_THREADING_MODEL == COM_TM_TASK
+void WorkScheduler::work_finished()
+{
+  if (atomic_sub_and_fetch_int32(&g_numPendingWork, 1) == 0) {
+    BLI_mutex_lock(&g_pendingMutex);
+    BLI_condition_notify_all(&g_pendingCondition);
+    BLI_mutex_unlock(&g_pendingMutex);
+  }
+}
+
+#  ifdef WITH_TBB
+void WorkScheduler::thread_execute_cpu(TaskPool *__restrict /*pool*/, void *data)
+{
+  WorkPackage *work = (WorkPackage *)data;
+  CPUDevice device(current_thread_id());
+  device.execute(work);
+  delete work;
+  work_finished();
+}
+#  else
 void *WorkScheduler::thread_execute_cpu(void *data)
 {
-  CPUDevice *device = (CPUDevice *)data;
+  g_cpu_thread_id = POINTER_AS_INT(data);
+  CPUDevice device(current_thread_id());
   WorkPackage *work;
-  BLI_thread_local_set(g_thread_device, device);
+
   while ((work = (WorkPackage *)BLI_thread_queue_pop(g_cpuqueue))) {
-    device->execute(work);
+    device.execute(work);
     delete work;
+    work_finished();
   }
 
   return nullptr;
 }
+#  endif
 
+#  ifdef COM_OPENCL_ENABLED
 void *WorkScheduler::thread_execute_gpu(void *data)
 {
   Device *device = (Device *)data;
@@ -91,10 +126,12 @@ void *WorkScheduler::thread_execute_gpu(void *data)
   while ((work = (WorkPackage *)BLI_thread_queue_pop(g_gpuqueue))) {
     device->execute(work);
     delete work;
+    work_finished();
   }
 
   return nullptr;
 }
+#  endif
 #endif
 
 void WorkScheduler::schedule(ExecutionGroup *group, int chunkNumber)
@@ -104,14 +141,16 @@ void WorkScheduler::schedule(ExecutionGroup *group, int chunkNumber)
   CPUDevice device(0);
   device.execute(package);
   delete package;
-#elif COM_CURRENT_THREADING_MODEL == COM_TM_QUEUE
+#elif COM_CURRENT_THREADING_MODEL == COM_TM_TASK
+  atomic_add_and_fetch_int32(&g_numPendingWork, 1);
 #  ifdef COM_OPENCL_ENABLED
   if (group->isOpenCL() && g_openclActive) {
     BLI_thread_queue_push(g_gpuqueue, package);
+    return;
   }
-  else {
-    BLI_thread_queue_push(g_cpuqueue, package);
-  }
+#  endif
+#  ifdef WITH_TBB
+  BLI_task_pool_push(g_cpupool, thread_execute_cpu, package, false, nullptr);
 #  else
   BLI_thread_queue_push(g_cpuqueue, package);
 #  endif
@@ -120,16 +159,21 @@ void WorkScheduler::schedule(ExecutionGroup *group, int chunkNumber)
 
 void WorkScheduler::start(CompositorContext &context)
 {
-#if COM_CURRENT_THREADING_MODEL == COM_TM_QUEUE
-  unsigned int index;
+#if COM_CURRENT_THREADING_MODEL == COM_TM_TASK
+#  ifdef WITH_TBB
+  g_cpupool = BLI_task_pool_create(nullptr, TASK_PRIORITY_HIGH);
+#  else
+  const int num_cpu_threads = BLI_task_scheduler_num_threads();
   g_cpuqueue = BLI_thread_queue_init();
-  BLI_threadpool_init(&g_cputhreads, thread_execute_cpu, g_cpudevices.size());
-  for (index = 0; index < g_cpudevices.size(); index++) {
-    Device *device = g_cpudevices[index];
-    BLI_threadpool_insert(&g_cputhreads, device);
+  BLI_threadpool_init(&g_cputhreads, thread_execute_cpu, num_cpu_threads);
+  for (int index = 0; index < num_cpu_threads; index++) {
+    BLI_threadpool_insert(&g_cputhreads, POINTER_FROM_INT(index));
   }
+#  endif
+  BLI_condition_init(&g_pendingCondition);
 #  ifdef COM_OPENCL_ENABLED
   if (context.getHasActiveOpenCLDevices()) {
+    unsigned int index;
     g_gpuqueue = BLI_thread_queue_init();
     BLI_threadpool_init(&g_gputhreads, thread_execute_gpu, g_gpudevices.size());
     for (index = 0; index < g_gpudevices.size(); index++) {
@@ -146,27 +190,31 @@ void WorkScheduler::start(CompositorContext &context)
 }
 void WorkScheduler::finish()
 {
-#if COM_CURRENT_THREADING_MODEL == COM_TM_QUEUE
-#  ifdef COM_OPENCL_ENABLED
-  if (g_openclActive) {
-    BLI_thread_queue_wait_finish(g_gpuqueue);
-    BLI_thread_queue_wait_finish(g_cpuqueue);
-  }
-  else {
-    BLI_thread_queue_wait_finish(g_cpuqueue);
-  }
-#  else
-  BLI_thread_queue_wait_finish(cpuqueue);
+#if COM_CURRENT_THREADING_MODEL == COM_TM_TASK
+#  ifdef WITH_TBB
+  /* Help executing the CPU work, then wait for the work CPU and GPU schedule for each other. */
+  BLI_task_pool_work_and_wait(g_cpupool);
 #  endif
+  BLI_mutex_lock(&g_pendingMutex);
+  while (g_numPendingWork > 0) {
+    BLI_condition_wait(&g_pendingCondition, &g_pendingMutex);
+  }
+  BLI_mutex_unlock(&g_pendingMutex);
 #endif
 }
 void WorkScheduler::stop()
 {
-#if COM_CURRENT_THREADING_MODEL == COM_TM_QUEUE
+#if COM_CURRENT_THREADING_MODEL == COM_TM_TASK
+#  ifdef WITH_TBB
+  BLI_task_pool_free(g_cpupool);
+  g_cpupool = nullptr;
+#  else
   BLI_thread_queue_nowait(g_cpuqueue);
   BLI_threadpool_end(&g_cputhreads);
   BLI_thread_queue_free(g_cpuqueue);
   g_cpuqueue = nullptr;
+#  endif
+  BLI_condition_end(&g_pendingCondition);
 #  ifdef COM_OPENCL_ENABLED
   if (g_openclActive) {
     BLI_thread_queue_nowait(g_gpuqueue);
@@ -180,7 +228,7 @@ void WorkScheduler::stop()
 
 bool WorkScheduler::hasGPUDevices()
 {
-#if COM_CURRENT_THREADING_MODEL == COM_TM_QUEUE
+#if COM_CURRENT_THREADING_MODEL == COM_TM_TASK
 #  ifdef COM_OPENCL_ENABLED
   return !g_gpudevices.empty();
 #  else
@@ -191,7 +239,7 @@ bool WorkScheduler::hasGPUDevices()
 #endif
 }
 
-#if COM_CURRENT_THREADING_MODEL == COM_TM_QUEUE
+#if COM_CURRENT_THREADING_MODEL == COM_TM_TASK
 static void CL_CALLBACK clContextError(const char *errinfo,
                                        const void * /*private_info*/,
                                        size_t /*cb*/,
@@ -201,36 +249,9 @@ static void CL_CALLBACK clContextError(const char *errinfo,
 }
 #endif
 
-void WorkScheduler::initialize(bool use_opencl, int num_cpu_threads)
+void WorkScheduler::initialize(bool use_opencl)
 {
-#if COM_CURRENT_THREADING_MODEL == COM_TM_QUEUE
-  /* deinitialize if number of threads doesn't match */
-  if (g_cpudevices.size() != num_cpu_threads) {
-    Device *device;
-
-    while (!g_cpudevices.empty()) {
-      device = g_cpudevices.back();
-      g_cpudevices.pop_back();
-      device->deinitialize();
-      delete device;
-    }
-    if (g_cpuInitialized) {
-      BLI_thread_local_delete(g_thread_device);
-    }
-    g_cpuInitialized = false;
-  }
-
-  /* initialize CPU threads */
-  if (!g_cpuInitialized) {
-    for (int index = 0; index < num_cpu_threads; index++) {
-      CPUDevice *device = new CPUDevice(index);
-      device->initialize();
-      g_cpudevices.push_back(device);
-    }
-    BLI_thread_local_create(g_thread_device);
-    g_cpuInitialized = true;
-  }
-
+#if COM_CURRENT_THREADING_MODEL == COM_TM_TASK
 #  ifdef COM_OPENCL_ENABLED
   /* deinitialize OpenCL GPU's */
   if (use_opencl && !g_openclInitialized) {
@@ -325,20 +346,7 @@ void WorkScheduler::initialize(bool use_opencl, int num_cpu_threads)
 
 void WorkScheduler::deinitialize()
 {
-#if COM_CURRENT_THREADING_MODEL == COM_TM_QUEUE
-  /* deinitialize CPU threads */
-  if (g_cpuInitialized) {
-    Device *device;
-    while (!g_cpudevices.empty()) {
-      device = g_cpudevices.back();
-      g_cpudevices.pop_back();
-      device->deinitialize();
-      delete device;
-    }
-    BLI_thread_local_delete(g_thread_device);
-    g_cpuInitialized = false;
-  }
-
+#if COM_CURRENT_THREADING_MODEL == COM_TM_TASK
 #  ifdef COM_OPENCL_ENABLED
   /* deinitialize OpenCL GPU's */
   if (g_openclInitialized) {
@@ -366,6 +374,12 @@ void WorkScheduler::deinitialize()
 
 int WorkScheduler::current_thread_id()
 {
-  CPUDevice *device = (CPUDevice *)BLI_thread_local_get(g_thread_device);
-  return device->thread_id();
+#if COM_CURRENT_THREADING_MODEL == COM_TM_TASK && !defined(WITH_TBB)
+  /* Chunks are executed by our own threads. Full-frame operations and the work of the calling
+   * thread run on that thread only, while none of ours is executing anything. */
+  return (g_cpu_thread_id != -1) ? g_cpu_thread_id : 0;
+#else
+  /* Chunks and full-frame operations are both executed by the threads of the task scheduler. */
+  return BLI_task_parallel_thread_id(nullptr);
+#endif
 }
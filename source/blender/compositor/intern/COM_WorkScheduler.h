@@ -20,6 +20,7 @@
 
 #include "COM_ExecutionGroup.h"
 
+#include "BLI_task.h"
 #include "BLI_threads.h"
 
 #include "COM_Device.h"
@@ -31,17 +32,25 @@
  */
 class WorkScheduler {
 
-#if COM_CURRENT_THREADING_MODEL == COM_TM_QUEUE
+#if COM_CURRENT_THREADING_MODEL == COM_TM_TASK
   /**
-   * \brief are we being stopped.
+   * \brief a work package has been executed, wakes up #finish when it was the last one.
    */
-  static bool isStopping();
+  static void work_finished();
 
+#  ifdef WITH_TBB
   /**
-   * \brief main thread loop for cpudevices
+   * \brief task executing a work package on a CPUDevice of the thread running the task.
+   * idle threads of the task scheduler steal these tasks from busy ones.
+   */
+  static void thread_execute_cpu(TaskPool *__restrict pool, void *data);
+#  else
+  /**
+   * \brief main thread loop for the CPU threads used without TBB
    * inside this loop new work is queried and being executed
    */
   static void *thread_execute_cpu(void *data);
+#  endif
 
   /**
    * \brief main thread loop for gpudevices
@@ -64,16 +73,14 @@ class WorkScheduler {
   /**
    * \brief initialize the WorkScheduler
    *
-   * during initialization the mutexes are initialized.
-   * there are two mutexes (for every device type one)
-   * After mutex initialization the system is queried in order to count the number of CPUDevices
-   * and GPUDevices to be created. For every hardware thread a CPUDevice and for every OpenCL GPU
-   * device a OpenCLDevice is created. these devices are stored in a separate list (cpudevices &
-   * gpudevices)
+   * The system is queried for OpenCL GPU devices, for every device an OpenCLDevice is created.
+   * CPU work is executed by the threads of the task scheduler, each using a CPUDevice with the
+   * id of its thread. Without TBB, #start creates a thread for every CPU of the task scheduler
+   * instead.
    *
    * This function can be called multiple times to lazily initialize OpenCL.
    */
-  static void initialize(bool use_opencl, int num_cpu_threads);
+  static void initialize(bool use_opencl);
 
   /**
    * \brief deinitialize the WorkScheduler
@@ -83,8 +90,8 @@ class WorkScheduler {
 
   /**
    * \brief Start the execution
-   * this methods will start the WorkScheduler. Inside this method all threads are initialized.
-   * for every device a thread is created.
+   * this methods will start the WorkScheduler. Inside this method the task pool for CPU work is
+   * created and for every OpenCL device a thread is created.
    * \see initialize Initialization and query of the number of devices
    */
   static void start(CompositorContext &context);
@@ -97,7 +104,7 @@ class WorkScheduler {
   static void stop();
 
   /**
-   * \brief wait for all work to be completed.
+   * \brief wait for all work to be completed, including work scheduled while waiting.
    */
   static void finish();
 
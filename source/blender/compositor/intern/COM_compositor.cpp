@@ -25,6 +25,7 @@
 
 #include "COM_ExecutionSystem.h"
 #include "COM_MovieDistortionOperation.h"
+#include "COM_ResultCache.h"
 #include "COM_WorkScheduler.h"
 #include "COM_compositor.h"
 #include "clew.h"
@@ -78,7 +79,7 @@ void COM_execute(RenderData *rd,
 
   /* initialize workscheduler, will check if already done. TODO deinitialize somewhere */
   bool use_opencl = (editingtree->flag & NTREE_COM_OPENCL) != 0;
-  WorkScheduler::initialize(use_opencl, BKE_render_num_threads(rd));
+  WorkScheduler::initialize(use_opencl);
 
   /* set progress bar to 0% and status to init compositing */
   editingtree->progress(editingtree->prh, 0.0);
@@ -113,6 +114,7 @@ void COM_deinitialize()
   if (is_compositorMutex_init) {
     BLI_mutex_lock(&s_compositorMutex);
     WorkScheduler::deinitialize();
+    ResultCache::clear();
     is_compositorMutex_init = false;
     BLI_mutex_unlock(&s_compositorMutex);
     BLI_mutex_end(&s_compositorMutex);
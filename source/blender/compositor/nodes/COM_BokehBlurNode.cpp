@@ -17,9 +17,11 @@
  */
 
 #include "COM_BokehBlurNode.h"
+#include "COM_BokehBlurFFTOperation.h"
 #include "COM_BokehBlurOperation.h"
 #include "COM_ConvertDepthToRadiusOperation.h"
 #include "COM_ExecutionSystem.h"
+#include "COM_VariableSizeBokehBlurFFTOperation.h"
 #include "COM_VariableSizeBokehBlurOperation.h"
 #include "DNA_camera_types.h"
 #include "DNA_node_types.h"
@@ -39,8 +41,21 @@ void BokehBlurNode::convertToOperations(NodeConverter &converter,
 
   bool connectedSizeSocket = inputSizeSocket->isLinked();
   const bool extend_bounds = (b_node->custom1 & CMP_NODEFLAG_BLUR_EXTEND_BOUNDS) != 0;
+  const bool use_fft = (b_node->custom1 & CMP_NODEFLAG_BLUR_FFT) != 0;
 
-  if ((b_node->custom1 & CMP_NODEFLAG_BLUR_VARIABLE_SIZE) && connectedSizeSocket) {
+  if ((b_node->custom1 & CMP_NODEFLAG_BLUR_VARIABLE_SIZE) && connectedSizeSocket && use_fft) {
+    VariableSizeBokehBlurFFTOperation *operation = new VariableSizeBokehBlurFFTOperation();
+    operation->setThreshold(0.0f);
+    operation->setMaxBlur(b_node->custom4);
+    operation->setDoScaleSize(true);
+
+    converter.addOperation(operation);
+    converter.mapInputSocket(getInputSocket(0), operation->getInputSocket(0));
+    converter.mapInputSocket(getInputSocket(1), operation->getInputSocket(1));
+    converter.mapInputSocket(getInputSocket(2), operation->getInputSocket(2));
+    converter.mapOutputSocket(getOutputSocket(0), operation->getOutputSocket());
+  }
+  else if ((b_node->custom1 & CMP_NODEFLAG_BLUR_VARIABLE_SIZE) && connectedSizeSocket) {
     VariableSizeBokehBlurOperation *operation = new VariableSizeBokehBlurOperation();
     operation->setQuality(context.getQuality());
     operation->setThreshold(0.0f);
@@ -53,6 +68,22 @@ void BokehBlurNode::convertToOperations(NodeConverter &converter,
     converter.mapInputSocket(getInputSocket(2), operation->getInputSocket(2));
     converter.mapOutputSocket(getOutputSocket(0), operation->getOutputSocket());
   }
+  else if (use_fft) {
+    BokehBlurFFTOperation *operation = new BokehBlurFFTOperation();
+    operation->setExtendBounds(extend_bounds);
+
+    converter.addOperation(operation);
+    converter.mapInputSocket(getInputSocket(0), operation->getInputSocket(0));
+    converter.mapInputSocket(getInputSocket(1), operation->getInputSocket(1));
+    /* Sockets are switched, same as #BokehBlurOperation. */
+    converter.mapInputSocket(getInputSocket(2), operation->getInputSocket(3));
+    converter.mapInputSocket(getInputSocket(3), operation->getInputSocket(2));
+    converter.mapOutputSocket(getOutputSocket(0), operation->getOutputSocket());
+
+    if (!connectedSizeSocket) {
+      operation->setSize(this->getInputSocket(2)->getEditorValueFloat());
+    }
+  }
   else {
     BokehBlurOperation *operation = new BokehBlurOperation();
     operation->setQuality(context.getQuality());
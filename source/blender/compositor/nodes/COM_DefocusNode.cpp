@@ -23,8 +23,11 @@
 #include "COM_FastGaussianBlurOperation.h"
 #include "COM_GammaCorrectOperation.h"
 #include "COM_MathBaseOperation.h"
+#include "COM_ResultCache.h"
 #include "COM_SetValueOperation.h"
+#include "COM_VariableSizeBokehBlurFFTOperation.h"
 #include "COM_VariableSizeBokehBlurOperation.h"
+#include "BKE_camera.h"
 #include "DNA_camera_types.h"
 #include "DNA_node_types.h"
 #include "DNA_object_types.h"
@@ -100,30 +103,41 @@ void DefocusNode::convertToOperations(NodeConverter &converter,
   bokeh->deleteDataOnFinish();
   converter.addOperation(bokeh);
 
+  NodeOperation *operation;
+  if (data->use_fft) {
+    VariableSizeBokehBlurFFTOperation *fft_operation = new VariableSizeBokehBlurFFTOperation();
+    fft_operation->setMaxBlur(data->maxblur);
+    fft_operation->setThreshold(data->bthresh);
+    converter.addOperation(fft_operation);
+    operation = fft_operation;
+  }
+  else {
 #ifdef COM_DEFOCUS_SEARCH
-  InverseSearchRadiusOperation *search = new InverseSearchRadiusOperation();
-  search->setMaxBlur(data->maxblur);
-  converter.addOperation(search);
+    InverseSearchRadiusOperation *search = new InverseSearchRadiusOperation();
+    search->setMaxBlur(data->maxblur);
+    converter.addOperation(search);
 
-  converter.addLink(radiusOperation->getOutputSocket(0), search->getInputSocket(0));
+    converter.addLink(radiusOperation->getOutputSocket(0), search->getInputSocket(0));
 #endif
 
-  VariableSizeBokehBlurOperation *operation = new VariableSizeBokehBlurOperation();
-  if (data->preview) {
-    operation->setQuality(COM_QUALITY_LOW);
-  }
-  else {
-    operation->setQuality(context.getQuality());
+    VariableSizeBokehBlurOperation *blur_operation = new VariableSizeBokehBlurOperation();
+    if (data->preview) {
+      blur_operation->setQuality(COM_QUALITY_LOW);
+    }
+    else {
+      blur_operation->setQuality(context.getQuality());
+    }
+    blur_operation->setMaxBlur(data->maxblur);
+    blur_operation->setThreshold(data->bthresh);
+    converter.addOperation(blur_operation);
+#ifdef COM_DEFOCUS_SEARCH
+    converter.addLink(search->getOutputSocket(), blur_operation->getInputSocket(3));
+#endif
+    operation = blur_operation;
   }
-  operation->setMaxBlur(data->maxblur);
-  operation->setThreshold(data->bthresh);
-  converter.addOperation(operation);
 
   converter.addLink(bokeh->getOutputSocket(), operation->getInputSocket(1));
   converter.addLink(radiusOperation->getOutputSocket(), operation->getInputSocket(2));
-#ifdef COM_DEFOCUS_SEARCH
-  converter.addLink(search->getOutputSocket(), operation->getInputSocket(3));
-#endif
 
   if (data->gamco) {
     GammaCorrectOperation *correct = new GammaCorrectOperation();
@@ -141,3 +155,27 @@ void DefocusNode::convertToOperations(NodeConverter &converter,
     converter.mapOutputSocket(getOutputSocket(), operation->getOutputSocket());
   }
 }
+
+bool DefocusNode::get_cache_key(const CompositorContext &context, std::string *r_key) const
+{
+  bNode *node = this->getbNode();
+  if (!this->get_settings_key(r_key)) {
+    return false;
+  }
+
+  NodeDefocus *data = (NodeDefocus *)node->storage;
+  Scene *scene = node->id ? (Scene *)node->id : context.getScene();
+  Object *camob = scene ? scene->camera : nullptr;
+  const bool use_camera = !data->no_zbuf && camob && camob->type == OB_CAMERA;
+  ResultCache::append(*r_key, use_camera);
+  if (use_camera) {
+    /* Camera settings read by ConvertDepthToRadiusOperation. */
+    const Camera *camera = (const Camera *)camob->data;
+    ResultCache::append(*r_key, camera->lens);
+    ResultCache::append(
+        *r_key,
+        BKE_camera_sensor_size(camera->sensor_fit, camera->sensor_x, camera->sensor_y));
+    ResultCache::append(*r_key, BKE_camera_object_dof_distance(camob));
+  }
+  return true;
+}
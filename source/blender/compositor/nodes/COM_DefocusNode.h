@@ -28,4 +28,5 @@ class DefocusNode : public Node {
  public:
   DefocusNode(bNode *editorNode);
   void convertToOperations(NodeConverter &converter, const CompositorContext &context) const;
+  bool get_cache_key(const CompositorContext &context, std::string *r_key) const;
 };
@@ -18,11 +18,13 @@
 
 #include "COM_ImageNode.h"
 #include "BKE_node.h"
+#include "BKE_scene.h"
 #include "BLI_utildefines.h"
 #include "COM_ConvertOperation.h"
 #include "COM_ExecutionSystem.h"
 #include "COM_ImageOperation.h"
 #include "COM_MultilayerImageOperation.h"
+#include "COM_ResultCache.h"
 
 #include "COM_SeparateColorNode.h"
 #include "COM_SetColorOperation.h"
@@ -299,3 +301,39 @@ void ImageNode::convertToOperations(NodeConverter &converter,
     }
   }
 }
+
+bool ImageNode::get_cache_key(const CompositorContext &context, std::string *r_key) const
+{
+  if (!this->get_settings_key(r_key)) {
+    return false;
+  }
+
+  bNode *editorNode = this->getbNode();
+  Image *image = (Image *)editorNode->id;
+  ResultCache::append(*r_key, image != nullptr);
+  if (image == nullptr) {
+    return true;
+  }
+  if (ELEM(image->source, IMA_SRC_VIEWER, IMA_SRC_TILED)) {
+    /* Viewer images are written by the compositor itself. */
+    return false;
+  }
+
+  /* Pixels are edited in place when painting, the time-stamp tells the versions apart. */
+  ImageUser iuser = *(ImageUser *)editorNode->storage;
+  BKE_image_user_frame_calc(image, &iuser, context.getFramenumber());
+  if (BKE_image_is_multilayer(image) == false) {
+    iuser.multi_index = BKE_scene_multiview_view_id_get(context.getRenderData(),
+                                                        context.getViewName());
+  }
+  ResultCache::append(*r_key, image->id.session_uuid);
+  ResultCache::append(*r_key, image->runtime.changed_timestamp);
+  ResultCache::append_string(*r_key, image->colorspace_settings.name);
+  ResultCache::append(*r_key, image->alpha_mode);
+  ResultCache::append(*r_key, iuser.framenr);
+  ResultCache::append(*r_key, iuser.multi_index);
+  ResultCache::append(*r_key, iuser.layer);
+  ResultCache::append(*r_key, iuser.pass);
+  ResultCache::append(*r_key, iuser.view);
+  return true;
+}
@@ -44,4 +44,5 @@ class ImageNode : public Node {
  public:
   ImageNode(bNode *editorNode);
   void convertToOperations(NodeConverter &converter, const CompositorContext &context) const;
+  bool get_cache_key(const CompositorContext &context, std::string *r_key) const;
 };
@@ -18,6 +18,7 @@
 
 #include "COM_RenderLayersNode.h"
 #include "COM_RenderLayersProg.h"
+#include "COM_ResultCache.h"
 #include "COM_RotateOperation.h"
 #include "COM_ScaleOperation.h"
 #include "COM_SetColorOperation.h"
@@ -25,6 +26,8 @@
 #include "COM_SetVectorOperation.h"
 #include "COM_TranslateOperation.h"
 
+#include "BKE_global.h"
+
 RenderLayersNode::RenderLayersNode(bNode *editorNode) : Node(editorNode)
 {
   /* pass */
@@ -174,3 +177,36 @@ void RenderLayersNode::convertToOperations(NodeConverter &converter,
     missingRenderLink(converter);
   }
 }
+
+bool RenderLayersNode::get_cache_key(const CompositorContext &context,
+                                     std::string *r_key) const
+{
+  if (!this->get_settings_key(r_key)) {
+    return false;
+  }
+
+  Scene *scene = (Scene *)this->getbNode()->id;
+  Render *re = (scene) ? RE_GetSceneRender(scene) : nullptr;
+  ResultCache::append(*r_key, re != nullptr);
+  if (re != nullptr) {
+    if (G.is_rendering && !context.isRendering()) {
+      /* Passes are still being written while compositing from the editor. */
+      return false;
+    }
+    /* A new result is allocated for every render, the start time of the render identifies it. */
+    const bool has_result = RE_AcquireResultRead(re) != nullptr;
+    const double starttime = RE_GetStats(re)->starttime;
+    RE_ReleaseResult(re);
+    ResultCache::append(*r_key, scene->id.session_uuid);
+    ResultCache::append(*r_key, has_result);
+    ResultCache::append(*r_key, starttime);
+
+    ViewLayer *view_layer = (ViewLayer *)BLI_findlink(&scene->view_layers,
+                                                      this->getbNode()->custom1);
+    ResultCache::append(*r_key, view_layer != nullptr);
+    if (view_layer) {
+      ResultCache::append_string(*r_key, view_layer->name);
+    }
+  }
+  return true;
+}
@@ -32,6 +32,7 @@ class RenderLayersNode : public Node {
  public:
   RenderLayersNode(bNode *editorNode);
   void convertToOperations(NodeConverter &converter, const CompositorContext &context) const;
+  bool get_cache_key(const CompositorContext &context, std::string *r_key) const;
 
  private:
   void testSocketLink(NodeConverter &converter,
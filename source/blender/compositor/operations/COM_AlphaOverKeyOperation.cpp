@@ -20,35 +20,32 @@
 
 AlphaOverKeyOperation::AlphaOverKeyOperation()
 {
-  /* pass */
+  this->setFullFrameOperation(true);
 }
 
-void AlphaOverKeyOperation::executePixelSampled(float output[4],
-                                                float x,
-                                                float y,
-                                                PixelSampler sampler)
+void AlphaOverKeyOperation::update_memory_buffer_row(
+    float *output, const float *value, const float *color1, const float *color2, int width)
 {
-  float inputColor1[4];
-  float inputOverColor[4];
-  float value[4];
+  for (int i = 0; i < width; i++) {
+    if (color2[3] <= 0.0f) {
+      copy_v4_v4(output, color1);
+    }
+    else if (value[0] == 1.0f && color2[3] >= 1.0f) {
+      copy_v4_v4(output, color2);
+    }
+    else {
+      float premul = value[0] * color2[3];
+      float mul = 1.0f - premul;
 
-  this->m_inputValueOperation->readSampled(value, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputOverColor, x, y, sampler);
+      output[0] = (mul * color1[0]) + premul * color2[0];
+      output[1] = (mul * color1[1]) + premul * color2[1];
+      output[2] = (mul * color1[2]) + premul * color2[2];
+      output[3] = (mul * color1[3]) + value[0] * color2[3];
+    }
 
-  if (inputOverColor[3] <= 0.0f) {
-    copy_v4_v4(output, inputColor1);
-  }
-  else if (value[0] == 1.0f && inputOverColor[3] >= 1.0f) {
-    copy_v4_v4(output, inputOverColor);
-  }
-  else {
-    float premul = value[0] * inputOverColor[3];
-    float mul = 1.0f - premul;
-
-    output[0] = (mul * inputColor1[0]) + premul * inputOverColor[0];
-    output[1] = (mul * inputColor1[1]) + premul * inputOverColor[1];
-    output[2] = (mul * inputColor1[2]) + premul * inputOverColor[2];
-    output[3] = (mul * inputColor1[3]) + value[0] * inputOverColor[3];
+    output += COM_NUM_CHANNELS_COLOR;
+    value += COM_NUM_CHANNELS_VALUE;
+    color1 += COM_NUM_CHANNELS_COLOR;
+    color2 += COM_NUM_CHANNELS_COLOR;
   }
 }
@@ -31,8 +31,7 @@ class AlphaOverKeyOperation : public MixBaseOperation {
    */
   AlphaOverKeyOperation();
 
-  /**
-   * the inner loop of this program
-   */
-  void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+ protected:
+  void update_memory_buffer_row(
+      float *output, const float *value, const float *color1, const float *color2, int width);
 };
@@ -34,13 +34,12 @@ class AlphaOverMixedOperation : public MixBaseOperation {
    */
   AlphaOverMixedOperation();
 
-  /**
-   * the inner loop of this program
-   */
-  void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
-
   void setX(float x)
   {
     this->m_x = x;
   }
+
+ protected:
+  void update_memory_buffer_row(
+      float *output, const float *value, const float *color1, const float *color2, int width);
 };
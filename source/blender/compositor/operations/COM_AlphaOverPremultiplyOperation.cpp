@@ -20,35 +20,32 @@
 
 AlphaOverPremultiplyOperation::AlphaOverPremultiplyOperation()
 {
-  /* pass */
+  this->setFullFrameOperation(true);
 }
 
-void AlphaOverPremultiplyOperation::executePixelSampled(float output[4],
-                                                        float x,
-                                                        float y,
-                                                        PixelSampler sampler)
+void AlphaOverPremultiplyOperation::update_memory_buffer_row(
+    float *output, const float *value, const float *color1, const float *color2, int width)
 {
-  float inputColor1[4];
-  float inputOverColor[4];
-  float value[4];
+  for (int i = 0; i < width; i++) {
+    /* Zero alpha values should still permit an add of RGB data */
+    if (color2[3] < 0.0f) {
+      copy_v4_v4(output, color1);
+    }
+    else if (value[0] == 1.0f && color2[3] >= 1.0f) {
+      copy_v4_v4(output, color2);
+    }
+    else {
+      float mul = 1.0f - value[0] * color2[3];
 
-  this->m_inputValueOperation->readSampled(value, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputOverColor, x, y, sampler);
+      output[0] = (mul * color1[0]) + value[0] * color2[0];
+      output[1] = (mul * color1[1]) + value[0] * color2[1];
+      output[2] = (mul * color1[2]) + value[0] * color2[2];
+      output[3] = (mul * color1[3]) + value[0] * color2[3];
+    }
 
-  /* Zero alpha values should still permit an add of RGB data */
-  if (inputOverColor[3] < 0.0f) {
-    copy_v4_v4(output, inputColor1);
-  }
-  else if (value[0] == 1.0f && inputOverColor[3] >= 1.0f) {
-    copy_v4_v4(output, inputOverColor);
-  }
-  else {
-    float mul = 1.0f - value[0] * inputOverColor[3];
-
-    output[0] = (mul * inputColor1[0]) + value[0] * inputOverColor[0];
-    output[1] = (mul * inputColor1[1]) + value[0] * inputOverColor[1];
-    output[2] = (mul * inputColor1[2]) + value[0] * inputOverColor[2];
-    output[3] = (mul * inputColor1[3]) + value[0] * inputOverColor[3];
+    output += COM_NUM_CHANNELS_COLOR;
+    value += COM_NUM_CHANNELS_VALUE;
+    color1 += COM_NUM_CHANNELS_COLOR;
+    color2 += COM_NUM_CHANNELS_COLOR;
   }
 }
@@ -0,0 +1,218 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#include "COM_BokehBlurFFTOperation.h"
+#include "COM_FFTConvolution.h"
+
+#include "BLI_math.h"
+
+#include "MEM_guardedalloc.h"
+
+BokehBlurFFTOperation::BokehBlurFFTOperation()
+{
+  this->addInputSocket(COM_DT_COLOR);
+  this->addInputSocket(COM_DT_COLOR, COM_SC_NO_RESIZE);
+  this->addInputSocket(COM_DT_VALUE);
+  this->addInputSocket(COM_DT_VALUE);
+  this->addOutputSocket(COM_DT_COLOR);
+
+  this->m_size = 1.0f;
+  this->m_sizeavailable = false;
+  this->m_inputProgram = nullptr;
+  this->m_inputBokehProgram = nullptr;
+  this->m_inputBoundingBoxReader = nullptr;
+
+  this->m_extend_bounds = false;
+}
+
+void BokehBlurFFTOperation::initExecution()
+{
+  SingleThreadedOperation::initExecution();
+  this->m_inputProgram = getInputSocketReader(0);
+  this->m_inputBokehProgram = getInputSocketReader(1);
+  this->m_inputBoundingBoxReader = getInputSocketReader(2);
+}
+
+void BokehBlurFFTOperation::deinitExecution()
+{
+  this->m_inputProgram = nullptr;
+  this->m_inputBokehProgram = nullptr;
+  this->m_inputBoundingBoxReader = nullptr;
+  SingleThreadedOperation::deinitExecution();
+}
+
+MemoryBuffer *BokehBlurFFTOperation::createMemoryBuffer(rcti *rect2)
+{
+  MemoryBuffer *input = (MemoryBuffer *)this->m_inputProgram->initializeTileData(rect2);
+  updateSize();
+
+  const int width = getWidth();
+  const int height = getHeight();
+  rcti rect;
+  BLI_rcti_init(&rect, 0, width, 0, height);
+  MemoryBuffer *result = new MemoryBuffer(COM_DT_COLOR, &rect);
+  float *output = result->getBuffer();
+
+  /* Only pixels inside of the input buffer are gathered. */
+  rcti valid;
+  if (!BLI_rcti_isect(&rect, input->getRect(), &valid)) {
+    result->clear();
+    return result;
+  }
+
+  float *image = (float *)MEM_callocN(
+      sizeof(float) * width * height * COM_NUM_CHANNELS_COLOR, "BokehBlurFFT image");
+  for (int y = valid.ymin; y < valid.ymax; y++) {
+    for (int x = valid.xmin; x < valid.xmax; x++) {
+      input->read(&image[(y * width + x) * COM_NUM_CHANNELS_COLOR], x, y);
+    }
+  }
+
+  /* Kernel pixel (i, j) weights the input pixel (x - i + radius, y - j + radius), sampled from the
+   * bokeh the same way BokehBlurOperation does. */
+  const float max_dim = max(width, height);
+  const int radius = max_ii(this->m_size * max_dim / 100.0f, 0);
+  const int kernel_size = 2 * radius + 1;
+  const int bokeh_width = this->m_inputBokehProgram->getWidth();
+  const int bokeh_height = this->m_inputBokehProgram->getHeight();
+  const float bokeh_mid_x = bokeh_width / 2.0f;
+  const float bokeh_mid_y = bokeh_height / 2.0f;
+  const float m = radius > 0 ? (min(bokeh_width, bokeh_height) / 2.0f) / radius : 0.0f;
+  float *kernel = (float *)MEM_callocN(
+      sizeof(float) * kernel_size * kernel_size * COM_NUM_CHANNELS_COLOR, "BokehBlurFFT kernel");
+  /* The gathered area ends right before x + radius, so the first row and column stay empty. */
+  for (int j = 1; j < kernel_size; j++) {
+    for (int i = 1; i < kernel_size; i++) {
+      const float u = bokeh_mid_x + (i - radius) * m;
+      const float v = bokeh_mid_y + (j - radius) * m;
+      this->m_inputBokehProgram->readSampled(
+          &kernel[(j * kernel_size + i) * COM_NUM_CHANNELS_COLOR], u, v, COM_PS_NEAREST);
+    }
+  }
+  if (radius < 2) {
+    /* Small sizes add the input pixel itself once more. */
+    add_v4_fl(&kernel[(radius * kernel_size + radius) * COM_NUM_CHANNELS_COLOR], 1.0f);
+  }
+
+  /* Summed area table of the kernel, to sum the weights of the pixels inside of the input. */
+  const int table_size = kernel_size + 1;
+  double *table = (double *)MEM_callocN(
+      sizeof(double) * table_size * table_size * COM_NUM_CHANNELS_COLOR, "BokehBlurFFT table");
+  for (int j = 0; j < kernel_size; j++) {
+    for (int i = 0; i < kernel_size; i++) {
+      const float *weight = &kernel[(j * kernel_size + i) * COM_NUM_CHANNELS_COLOR];
+      double *sum = &table[((j + 1) * table_size + i + 1) * COM_NUM_CHANNELS_COLOR];
+      const double *left = sum - COM_NUM_CHANNELS_COLOR;
+      const double *up = &table[(j * table_size + i + 1) * COM_NUM_CHANNELS_COLOR];
+      const double *up_left = up - COM_NUM_CHANNELS_COLOR;
+      for (int c = 0; c < COM_NUM_CHANNELS_COLOR; c++) {
+        sum[c] = weight[c] + left[c] + up[c] - up_left[c];
+      }
+    }
+  }
+
+  fft_convolve(output,
+               image,
+               width,
+               height,
+               kernel,
+               kernel_size,
+               kernel_size,
+               COM_NUM_CHANNELS_COLOR,
+               COM_NUM_CHANNELS_COLOR);
+
+  for (int y = 0; y < height; y++) {
+    /* Kernel rows of the input rows inside of the valid area. */
+    const int j0 = max_ii(y + radius - valid.ymax + 1, 0);
+    const int j1 = min_ii(y + radius - valid.ymin, kernel_size - 1) + 1;
+    for (int x = 0; x < width; x++) {
+      float *out = &output[(y * width + x) * COM_NUM_CHANNELS_COLOR];
+      float bounding_box[4];
+      this->m_inputBoundingBoxReader->readSampled(bounding_box, x, y, COM_PS_NEAREST);
+      if (bounding_box[0] <= 0.0f) {
+        this->m_inputProgram->readSampled(out, x, y, COM_PS_NEAREST);
+        continue;
+      }
+
+      const int i0 = max_ii(x + radius - valid.xmax + 1, 0);
+      const int i1 = min_ii(x + radius - valid.xmin, kernel_size - 1) + 1;
+      if (i0 >= i1 || j0 >= j1) {
+        zero_v4(out);
+        continue;
+      }
+      const double *s11 = &table[(j1 * table_size + i1) * COM_NUM_CHANNELS_COLOR];
+      const double *s01 = &table[(j1 * table_size + i0) * COM_NUM_CHANNELS_COLOR];
+      const double *s10 = &table[(j0 * table_size + i1) * COM_NUM_CHANNELS_COLOR];
+      const double *s00 = &table[(j0 * table_size + i0) * COM_NUM_CHANNELS_COLOR];
+      for (int c = 0; c < COM_NUM_CHANNELS_COLOR; c++) {
+        const float multiplier = (float)(s11[c] - s01[c] - s10[c] + s00[c]);
+        out[c] *= 1.0f / multiplier;
+      }
+    }
+  }
+
+  MEM_freeN(table);
+  MEM_freeN(kernel);
+  MEM_freeN(image);
+  return result;
+}
+
+bool BokehBlurFFTOperation::determineDependingAreaOfInterest(rcti * /*input*/,
+                                                             ReadBufferOperation *readOperation,
+                                                             rcti *output)
+{
+  if (isCached()) {
+    return false;
+  }
+
+  rcti newInput;
+  BLI_rcti_init(&newInput, 0, this->getWidth(), 0, this->getHeight());
+  for (unsigned int index = 0; index < this->getNumberOfInputSockets(); index++) {
+    NodeOperation *operation = getInputOperation(index);
+    rcti operationInput = newInput;
+    if (index == 1) {
+      BLI_rcti_init(&operationInput, 0, operation->getWidth(), 0, operation->getHeight());
+    }
+    if (operation->determineDependingAreaOfInterest(&operationInput, readOperation, output)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void BokehBlurFFTOperation::updateSize()
+{
+  if (!this->m_sizeavailable) {
+    float result[4];
+    this->getInputSocketReader(3)->readSampled(result, 0, 0, COM_PS_NEAREST);
+    this->m_size = result[0];
+    CLAMP(this->m_size, 0.0f, 10.0f);
+    this->m_sizeavailable = true;
+  }
+}
+
+void BokehBlurFFTOperation::determineResolution(unsigned int resolution[2],
+                                                unsigned int preferredResolution[2])
+{
+  NodeOperation::determineResolution(resolution, preferredResolution);
+  if (this->m_extend_bounds) {
+    const float max_dim = max(resolution[0], resolution[1]);
+    resolution[0] += 2 * this->m_size * max_dim / 100.0f;
+    resolution[1] += 2 * this->m_size * max_dim / 100.0f;
+  }
+}
@@ -0,0 +1,66 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#pragma once
+
+#include "COM_SingleThreadedOperation.h"
+
+/**
+ * \brief Bokeh blur of the whole image at once with an FFT convolution.
+ *
+ * Gives the same result as BokehBlurOperation at full quality, but its cost hardly depends on the
+ * blur size. The image is convolved with the bokeh scaled to the blur size, the weights of the
+ * kernel pixels inside of the image are summed from a summed area table of the kernel.
+ * Has the same sockets as BokehBlurOperation.
+ */
+class BokehBlurFFTOperation : public SingleThreadedOperation {
+ private:
+  SocketReader *m_inputProgram;
+  SocketReader *m_inputBokehProgram;
+  SocketReader *m_inputBoundingBoxReader;
+  float m_size;
+  bool m_sizeavailable;
+  bool m_extend_bounds;
+
+  void updateSize();
+
+ public:
+  BokehBlurFFTOperation();
+
+  void initExecution();
+  void deinitExecution();
+
+  MemoryBuffer *createMemoryBuffer(rcti *rect);
+
+  bool determineDependingAreaOfInterest(rcti *input,
+                                        ReadBufferOperation *readOperation,
+                                        rcti *output);
+
+  void setSize(float size)
+  {
+    this->m_size = size;
+    this->m_sizeavailable = true;
+  }
+
+  void setExtendBounds(bool extend_bounds)
+  {
+    this->m_extend_bounds = extend_bounds;
+  }
+
+  void determineResolution(unsigned int resolution[2], unsigned int preferredResolution[2]);
+};
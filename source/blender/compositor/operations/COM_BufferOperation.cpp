@@ -0,0 +1,78 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#include "COM_BufferOperation.h"
+
+BufferOperation::BufferOperation(MemoryBuffer *buffer, DataType datatype)
+{
+  this->addOutputSocket(datatype);
+  this->m_buffer = buffer;
+  this->setWidth(buffer->getWidth());
+  this->setHeight(buffer->getHeight());
+  this->initMutex();
+}
+
+BufferOperation::BufferOperation(DataType datatype, unsigned int width, unsigned int height)
+{
+  this->addOutputSocket(datatype);
+  this->m_buffer = nullptr;
+  this->setWidth(width);
+  this->setHeight(height);
+  this->initMutex();
+}
+
+BufferOperation::~BufferOperation()
+{
+  this->deinitMutex();
+}
+
+void *BufferOperation::initializeTileData(rcti * /*rect*/)
+{
+  /* Complex users access the pixels of single element buffers directly. */
+  lockMutex();
+  this->m_buffer->inflate();
+  unlockMutex();
+  return this->m_buffer;
+}
+
+void BufferOperation::executePixelSampled(float output[4],
+                                          float x,
+                                          float y,
+                                          PixelSampler sampler)
+{
+  switch (sampler) {
+    case COM_PS_NEAREST:
+      this->m_buffer->read(output, x, y);
+      break;
+    case COM_PS_BILINEAR:
+    default:
+      this->m_buffer->readBilinear(output, x, y);
+      break;
+    case COM_PS_BICUBIC:
+      this->m_buffer->readBilinear(output, x, y);
+      break;
+  }
+}
+
+void BufferOperation::executePixelFiltered(
+    float output[4], float x, float y, float dx[2], float dy[2])
+{
+  const float uv[2] = {x, y};
+  const float deriv[2][2] = {{dx[0], dx[1]}, {dy[0], dy[1]}};
+  this->m_buffer->readEWA(output, uv, deriv);
+}
@@ -0,0 +1,58 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#pragma once
+
+#include "COM_MemoryBuffer.h"
+#include "COM_NodeOperation.h"
+
+/**
+ * \brief Input operation reading from an already calculated MemoryBuffer.
+ *
+ * Used in full-frame execution to replace the links to operations that have been calculated,
+ * so their users read from the output buffer instead of evaluating them again per pixel.
+ * \see FullFrameExecutionModel
+ */
+class BufferOperation : public NodeOperation {
+ private:
+  MemoryBuffer *m_buffer;
+
+ public:
+  BufferOperation(MemoryBuffer *buffer, DataType datatype);
+  /**
+   * \brief the buffer has to be set with #setBuffer before the operation is read
+   */
+  BufferOperation(DataType datatype, unsigned int width, unsigned int height);
+  ~BufferOperation();
+
+  MemoryBuffer *getBuffer()
+  {
+    return this->m_buffer;
+  }
+
+  void setBuffer(MemoryBuffer *buffer)
+  {
+    BLI_assert(buffer == nullptr || (buffer->getWidth() == (int)this->getWidth() &&
+                                     buffer->getHeight() == (int)this->getHeight()));
+    this->m_buffer = buffer;
+  }
+
+  void *initializeTileData(rcti *rect);
+  void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void executePixelFiltered(float output[4], float x, float y, float dx[2], float dy[2]);
+};
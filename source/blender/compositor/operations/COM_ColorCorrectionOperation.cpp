@@ -21,6 +21,8 @@
 
 #include "IMB_colormanagement.h"
 
+#include "MEM_guardedalloc.h"
+
 ColorCorrectionOperation::ColorCorrectionOperation()
 {
   this->addInputSocket(COM_DT_COLOR);
@@ -31,6 +33,7 @@ ColorCorrectionOperation::ColorCorrectionOperation()
   this->m_redChannelEnabled = true;
   this->m_greenChannelEnabled = true;
   this->m_blueChannelEnabled = true;
+  this->setFullFrameOperation(true);
 }
 void ColorCorrectionOperation::initExecution()
 {
@@ -57,102 +60,145 @@ void ColorCorrectionOperation::executePixelSampled(float output[4],
   this->m_inputImage->readSampled(inputImageColor, x, y, sampler);
   this->m_inputMask->readSampled(inputMask, x, y, sampler);
 
-  float level = (inputImageColor[0] + inputImageColor[1] + inputImageColor[2]) / 3.0f;
-  float contrast = this->m_data->master.contrast;
-  float saturation = this->m_data->master.saturation;
-  float gamma = this->m_data->master.gamma;
-  float gain = this->m_data->master.gain;
-  float lift = this->m_data->master.lift;
-  float r, g, b;
-
-  float value = inputMask[0];
-  value = min(1.0f, value);
-  const float mvalue = 1.0f - value;
-
-  float levelShadows = 0.0;
-  float levelMidtones = 0.0;
-  float levelHighlights = 0.0;
-#define MARGIN 0.10f
-#define MARGIN_DIV (0.5f / MARGIN)
-  if (level < this->m_data->startmidtones - MARGIN) {
-    levelShadows = 1.0f;
-  }
-  else if (level < this->m_data->startmidtones + MARGIN) {
-    levelMidtones = ((level - this->m_data->startmidtones) * MARGIN_DIV) + 0.5f;
-    levelShadows = 1.0f - levelMidtones;
-  }
-  else if (level < this->m_data->endmidtones - MARGIN) {
-    levelMidtones = 1.0f;
+  this->update_memory_buffer_row(output, inputImageColor, inputMask, 1);
+}
+
+void ColorCorrectionOperation::update_memory_buffer(MemoryBuffer *output,
+                                                    rcti *area,
+                                                    MemoryBuffer **inputs)
+{
+  BLI_assert(inputs[0]->get_num_channels() == COM_NUM_CHANNELS_COLOR);
+  BLI_assert(inputs[1]->get_num_channels() == COM_NUM_CHANNELS_VALUE);
+
+  const int width = BLI_rcti_size_x(area);
+  /* Constant inputs only store a single element, repeat it over the row. */
+  float *color_row = inputs[0]->is_a_single_elem() ? inputs[0]->alloc_elem_row(width) : nullptr;
+  float *mask_row = inputs[1]->is_a_single_elem() ? inputs[1]->alloc_elem_row(width) : nullptr;
+
+  for (int y = area->ymin; y < area->ymax; y++) {
+    const int offset = y * output->getWidth() + area->xmin;
+    this->update_memory_buffer_row(
+        output->getBuffer() + offset * COM_NUM_CHANNELS_COLOR,
+        color_row ? color_row : inputs[0]->getBuffer() + offset * COM_NUM_CHANNELS_COLOR,
+        mask_row ? mask_row : inputs[1]->getBuffer() + offset * COM_NUM_CHANNELS_VALUE,
+        width);
   }
-  else if (level < this->m_data->endmidtones + MARGIN) {
-    levelHighlights = ((level - this->m_data->endmidtones) * MARGIN_DIV) + 0.5f;
-    levelMidtones = 1.0f - levelHighlights;
+
+  if (color_row) {
+    MEM_freeN(color_row);
   }
-  else {
-    levelHighlights = 1.0f;
+  if (mask_row) {
+    MEM_freeN(mask_row);
   }
+}
+
+void ColorCorrectionOperation::update_memory_buffer_row(float *output,
+                                                        const float *color,
+                                                        const float *mask,
+                                                        int width)
+{
+  for (int i = 0; i < width; i++) {
+    float level = (color[0] + color[1] + color[2]) / 3.0f;
+    float contrast = this->m_data->master.contrast;
+    float saturation = this->m_data->master.saturation;
+    float gamma = this->m_data->master.gamma;
+    float gain = this->m_data->master.gain;
+    float lift = this->m_data->master.lift;
+    float r, g, b;
+
+    float value = mask[0];
+    value = min(1.0f, value);
+    const float mvalue = 1.0f - value;
+
+    float levelShadows = 0.0;
+    float levelMidtones = 0.0;
+    float levelHighlights = 0.0;
+#define MARGIN 0.10f
+#define MARGIN_DIV (0.5f / MARGIN)
+    if (level < this->m_data->startmidtones - MARGIN) {
+      levelShadows = 1.0f;
+    }
+    else if (level < this->m_data->startmidtones + MARGIN) {
+      levelMidtones = ((level - this->m_data->startmidtones) * MARGIN_DIV) + 0.5f;
+      levelShadows = 1.0f - levelMidtones;
+    }
+    else if (level < this->m_data->endmidtones - MARGIN) {
+      levelMidtones = 1.0f;
+    }
+    else if (level < this->m_data->endmidtones + MARGIN) {
+      levelHighlights = ((level - this->m_data->endmidtones) * MARGIN_DIV) + 0.5f;
+      levelMidtones = 1.0f - levelHighlights;
+    }
+    else {
+      levelHighlights = 1.0f;
+    }
 #undef MARGIN
 #undef MARGIN_DIV
-  contrast *= (levelShadows * this->m_data->shadows.contrast) +
-              (levelMidtones * this->m_data->midtones.contrast) +
-              (levelHighlights * this->m_data->highlights.contrast);
-  saturation *= (levelShadows * this->m_data->shadows.saturation) +
-                (levelMidtones * this->m_data->midtones.saturation) +
-                (levelHighlights * this->m_data->highlights.saturation);
-  gamma *= (levelShadows * this->m_data->shadows.gamma) +
-           (levelMidtones * this->m_data->midtones.gamma) +
-           (levelHighlights * this->m_data->highlights.gamma);
-  gain *= (levelShadows * this->m_data->shadows.gain) +
-          (levelMidtones * this->m_data->midtones.gain) +
-          (levelHighlights * this->m_data->highlights.gain);
-  lift += (levelShadows * this->m_data->shadows.lift) +
-          (levelMidtones * this->m_data->midtones.lift) +
-          (levelHighlights * this->m_data->highlights.lift);
-
-  float invgamma = 1.0f / gamma;
-  float luma = IMB_colormanagement_get_luminance(inputImageColor);
-
-  r = inputImageColor[0];
-  g = inputImageColor[1];
-  b = inputImageColor[2];
-
-  r = (luma + saturation * (r - luma));
-  g = (luma + saturation * (g - luma));
-  b = (luma + saturation * (b - luma));
-
-  r = 0.5f + ((r - 0.5f) * contrast);
-  g = 0.5f + ((g - 0.5f) * contrast);
-  b = 0.5f + ((b - 0.5f) * contrast);
-
-  /* Check for negative values to avoid nan. */
-  r = color_correct_powf_safe(r * gain + lift, invgamma, r);
-  g = color_correct_powf_safe(g * gain + lift, invgamma, g);
-  b = color_correct_powf_safe(b * gain + lift, invgamma, b);
-
-  // mix with mask
-  r = mvalue * inputImageColor[0] + value * r;
-  g = mvalue * inputImageColor[1] + value * g;
-  b = mvalue * inputImageColor[2] + value * b;
-
-  if (this->m_redChannelEnabled) {
-    output[0] = r;
-  }
-  else {
-    output[0] = inputImageColor[0];
-  }
-  if (this->m_greenChannelEnabled) {
-    output[1] = g;
-  }
-  else {
-    output[1] = inputImageColor[1];
-  }
-  if (this->m_blueChannelEnabled) {
-    output[2] = b;
-  }
-  else {
-    output[2] = inputImageColor[2];
+    contrast *= (levelShadows * this->m_data->shadows.contrast) +
+                (levelMidtones * this->m_data->midtones.contrast) +
+                (levelHighlights * this->m_data->highlights.contrast);
+    saturation *= (levelShadows * this->m_data->shadows.saturation) +
+                  (levelMidtones * this->m_data->midtones.saturation) +
+                  (levelHighlights * this->m_data->highlights.saturation);
+    gamma *= (levelShadows * this->m_data->shadows.gamma) +
+             (levelMidtones * this->m_data->midtones.gamma) +
+             (levelHighlights * this->m_data->highlights.gamma);
+    gain *= (levelShadows * this->m_data->shadows.gain) +
+            (levelMidtones * this->m_data->midtones.gain) +
+            (levelHighlights * this->m_data->highlights.gain);
+    lift += (levelShadows * this->m_data->shadows.lift) +
+            (levelMidtones * this->m_data->midtones.lift) +
+            (levelHighlights * this->m_data->highlights.lift);
+
+    float invgamma = 1.0f / gamma;
+    float luma = IMB_colormanagement_get_luminance(color);
+
+    r = color[0];
+    g = color[1];
+    b = color[2];
+
+    r = (luma + saturation * (r - luma));
+    g = (luma + saturation * (g - luma));
+    b = (luma + saturation * (b - luma));
+
+    r = 0.5f + ((r - 0.5f) * contrast);
+    g = 0.5f + ((g - 0.5f) * contrast);
+    b = 0.5f + ((b - 0.5f) * contrast);
+
+    /* Check for negative values to avoid nan. */
+    r = color_correct_powf_safe(r * gain + lift, invgamma, r);
+    g = color_correct_powf_safe(g * gain + lift, invgamma, g);
+    b = color_correct_powf_safe(b * gain + lift, invgamma, b);
+
+    // mix with mask
+    r = mvalue * color[0] + value * r;
+    g = mvalue * color[1] + value * g;
+    b = mvalue * color[2] + value * b;
+
+    if (this->m_redChannelEnabled) {
+      output[0] = r;
+    }
+    else {
+      output[0] = color[0];
+    }
+    if (this->m_greenChannelEnabled) {
+      output[1] = g;
+    }
+    else {
+      output[1] = color[1];
+    }
+    if (this->m_blueChannelEnabled) {
+      output[2] = b;
+    }
+    else {
+      output[2] = color[2];
+    }
+    output[3] = color[3];
+
+    output += COM_NUM_CHANNELS_COLOR;
+    color += COM_NUM_CHANNELS_COLOR;
+    mask += COM_NUM_CHANNELS_VALUE;
   }
-  output[3] = inputImageColor[3];
 }
 
 void ColorCorrectionOperation::deinitExecution()
@@ -33,6 +33,11 @@ class ColorCorrectionOperation : public NodeOperation {
   bool m_greenChannelEnabled;
   bool m_blueChannelEnabled;
 
+  /**
+   * Correct a row of pixels, used by both the tiled and the full-frame execution.
+   */
+  void update_memory_buffer_row(float *output, const float *color, const float *mask, int width);
+
  public:
   ColorCorrectionOperation();
 
@@ -41,6 +46,8 @@ class ColorCorrectionOperation : public NodeOperation {
    */
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
 
+  void update_memory_buffer(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
+
   /**
    * Initialize the execution
    */
@@ -0,0 +1,400 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2011, Blender Foundation.
+ */
+
+#include "COM_FFTConvolution.h"
+
+#include "BLI_math.h"
+#include "BLI_task.h"
+#include "BLI_utildefines.h"
+
+#include "MEM_guardedalloc.h"
+
+#include <string.h>
+
+/*
+ *  2D Fast Hartley Transform, used for convolution
+ */
+
+using fREAL = float;
+
+// returns next highest power of 2 of x, as well its log2 in L2
+static unsigned int nextPow2(unsigned int x, unsigned int *L2)
+{
+  unsigned int pw, x_notpow2 = x & (x - 1);
+  *L2 = 0;
+  while (x >>= 1) {
+    ++(*L2);
+  }
+  pw = 1 << (*L2);
+  if (x_notpow2) {
+    (*L2)++;
+    pw <<= 1;
+  }
+  return pw;
+}
+
+//------------------------------------------------------------------------------
+
+// from FXT library by Joerg Arndt, faster in order bitreversal
+// use: r = revbin_upd(r, h) where h = N>>1
+static unsigned int revbin_upd(unsigned int r, unsigned int h)
+{
+  while (!((r ^= h) & h)) {
+    h >>= 1;
+  }
+  return r;
+}
+//------------------------------------------------------------------------------
+static void FHT(fREAL *data, unsigned int M, unsigned int inverse)
+{
+  double tt, fc, dc, fs, ds, a = M_PI;
+  fREAL t1, t2;
+  int n2, bd, bl, istep, k, len = 1 << M, n = 1;
+
+  int i, j = 0;
+  unsigned int Nh = len >> 1;
+  for (i = 1; i < (len - 1); i++) {
+    j = revbin_upd(j, Nh);
+    if (j > i) {
+      t1 = data[i];
+      data[i] = data[j];
+      data[j] = t1;
+    }
+  }
+
+  do {
+    fREAL *data_n = &data[n];
+
+    istep = n << 1;
+    for (k = 0; k < len; k += istep) {
+      t1 = data_n[k];
+      data_n[k] = data[k] - t1;
+      data[k] += t1;
+    }
+
+    n2 = n >> 1;
+    if (n > 2) {
+      fc = dc = cos(a);
+      fs = ds = sqrt(1.0 - fc * fc);  // sin(a);
+      bd = n - 2;
+      for (bl = 1; bl < n2; bl++) {
+        fREAL *data_nbd = &data_n[bd];
+        fREAL *data_bd = &data[bd];
+        for (k = bl; k < len; k += istep) {
+          t1 = fc * (double)data_n[k] + fs * (double)data_nbd[k];
+          t2 = fs * (double)data_n[k] - fc * (double)data_nbd[k];
+          data_n[k] = data[k] - t1;
+          data_nbd[k] = data_bd[k] - t2;
+          data[k] += t1;
+          data_bd[k] += t2;
+        }
+        tt = fc * dc - fs * ds;
+        fs = fs * dc + fc * ds;
+        fc = tt;
+        bd -= 2;
+      }
+    }
+
+    if (n > 1) {
+      for (k = n2; k < len; k += istep) {
+        t1 = data_n[k];
+        data_n[k] = data[k] - t1;
+        data[k] += t1;
+      }
+    }
+
+    n = istep;
+    a *= 0.5;
+  } while (n < len);
+
+  if (inverse) {
+    fREAL sc = (fREAL)1 / (fREAL)len;
+    for (k = 0; k < len; k++) {
+      data[k] *= sc;
+    }
+  }
+}
+//------------------------------------------------------------------------------
+/* 2D Fast Hartley Transform, Mx/My -> log2 of width/height,
+ * nzp -> the row where zero pad data starts,
+ * inverse -> see above */
+static void FHT2D(
+    fREAL *data, unsigned int Mx, unsigned int My, unsigned int nzp, unsigned int inverse)
+{
+  unsigned int i, j, Nx, Ny, maxy;
+
+  Nx = 1 << Mx;
+  Ny = 1 << My;
+
+  // rows (forward transform skips 0 pad data)
+  maxy = inverse ? Ny : nzp;
+  for (j = 0; j < maxy; j++) {
+    FHT(&data[Nx * j], Mx, inverse);
+  }
+
+  // transpose data
+  if (Nx == Ny) {  // square
+    for (j = 0; j < Ny; j++) {
+      for (i = j + 1; i < Nx; i++) {
+        unsigned int op = i + (j << Mx), np = j + (i << My);
+        SWAP(fREAL, data[op], data[np]);
+      }
+    }
+  }
+  else {  // rectangular
+    unsigned int k, Nym = Ny - 1, stm = 1 << (Mx + My);
+    for (i = 0; stm > 0; i++) {
+#define PRED(k) (((k & Nym) << Mx) + (k >> My))
+      for (j = PRED(i); j > i; j = PRED(j)) {
+        /* pass */
+      }
+      if (j < i) {
+        continue;
+      }
+      for (k = i, j = PRED(i); j != i; k = j, j = PRED(j), stm--) {
+        SWAP(fREAL, data[j], data[k]);
+      }
+#undef PRED
+      stm--;
+    }
+  }
+
+  SWAP(unsigned int, Nx, Ny);
+  SWAP(unsigned int, Mx, My);
+
+  // now columns == transposed rows
+  for (j = 0; j < Ny; j++) {
+    FHT(&data[Nx * j], Mx, inverse);
+  }
+
+  // finalize
+  for (j = 0; j <= (Ny >> 1); j++) {
+    unsigned int jm = (Ny - j) & (Ny - 1);
+    unsigned int ji = j << Mx;
+    unsigned int jmi = jm << Mx;
+    for (i = 0; i <= (Nx >> 1); i++) {
+      unsigned int im = (Nx - i) & (Nx - 1);
+      fREAL A = data[ji + i];
+      fREAL B = data[jmi + i];
+      fREAL C = data[ji + im];
+      fREAL D = data[jmi + im];
+      fREAL E = (fREAL)0.5 * ((A + D) - (B + C));
+      data[ji + i] = A - E;
+      data[jmi + i] = B + E;
+      data[ji + im] = C + E;
+      data[jmi + im] = D - E;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+
+/* 2D convolution calc, d1 *= d2, M/N - > log2 of width/height */
+static void fht_convolve(fREAL *d1, const fREAL *d2, unsigned int M, unsigned int N)
+{
+  fREAL a, b;
+  unsigned int i, j, k, L, mj, mL;
+  unsigned int m = 1 << M, n = 1 << N;
+  unsigned int m2 = 1 << (M - 1), n2 = 1 << (N - 1);
+  unsigned int mn2 = m << (N - 1);
+
+  d1[0] *= d2[0];
+  d1[mn2] *= d2[mn2];
+  d1[m2] *= d2[m2];
+  d1[m2 + mn2] *= d2[m2 + mn2];
+  for (i = 1; i < m2; i++) {
+    k = m - i;
+    a = d1[i] * d2[i] - d1[k] * d2[k];
+    b = d1[k] * d2[i] + d1[i] * d2[k];
+    d1[i] = (b + a) * (fREAL)0.5;
+    d1[k] = (b - a) * (fREAL)0.5;
+    a = d1[i + mn2] * d2[i + mn2] - d1[k + mn2] * d2[k + mn2];
+    b = d1[k + mn2] * d2[i + mn2] + d1[i + mn2] * d2[k + mn2];
+    d1[i + mn2] = (b + a) * (fREAL)0.5;
+    d1[k + mn2] = (b - a) * (fREAL)0.5;
+  }
+  for (j = 1; j < n2; j++) {
+    L = n - j;
+    mj = j << M;
+    mL = L << M;
+    a = d1[mj] * d2[mj] - d1[mL] * d2[mL];
+    b = d1[mL] * d2[mj] + d1[mj] * d2[mL];
+    d1[mj] = (b + a) * (fREAL)0.5;
+    d1[mL] = (b - a) * (fREAL)0.5;
+    a = d1[m2 + mj] * d2[m2 + mj] - d1[m2 + mL] * d2[m2 + mL];
+    b = d1[m2 + mL] * d2[m2 + mj] + d1[m2 + mj] * d2[m2 + mL];
+    d1[m2 + mj] = (b + a) * (fREAL)0.5;
+    d1[m2 + mL] = (b - a) * (fREAL)0.5;
+  }
+  for (i = 1; i < m2; i++) {
+    k = m - i;
+    for (j = 1; j < n2; j++) {
+      L = n - j;
+      mj = j << M;
+      mL = L << M;
+      a = d1[i + mj] * d2[i + mj] - d1[k + mL] * d2[k + mL];
+      b = d1[k + mL] * d2[i + mj] + d1[i + mj] * d2[k + mL];
+      d1[i + mj] = (b + a) * (fREAL)0.5;
+      d1[k + mL] = (b - a) * (fREAL)0.5;
+      a = d1[i + mL] * d2[i + mL] - d1[k + mj] * d2[k + mj];
+      b = d1[k + mj] * d2[i + mL] + d1[i + mL] * d2[k + mj];
+      d1[i + mL] = (b + a) * (fREAL)0.5;
+      d1[k + mj] = (b - a) * (fREAL)0.5;
+    }
+  }
+}
+
+//------------------------------------------------------------------------------
+
+typedef struct FFTConvolveData {
+  float *dst;
+  const float *image;
+  const float *kernel;
+  int width;
+  int height;
+  int kernel_width;
+  int kernel_height;
+  int stride;
+} FFTConvolveData;
+
+/* Block add-overlap convolution of a single channel. */
+static void fft_convolve_channel(void *__restrict userdata,
+                                 const int ch,
+                                 const TaskParallelTLS *__restrict /*tls*/)
+{
+  const FFTConvolveData *data = (const FFTConvolveData *)userdata;
+  const int stride = data->stride;
+  const int imageWidth = data->width;
+  const int imageHeight = data->height;
+  const int kernelWidth = data->kernel_width;
+  const int kernelHeight = data->kernel_height;
+  unsigned int w2, h2, log2_w, log2_h;
+  int x, y;
+
+  // convolution result width & height, the transform needs at least two rows and columns
+  w2 = max_ii(2 * kernelWidth - 1, 2);
+  h2 = max_ii(2 * kernelHeight - 1, 2);
+  // FFT pow2 required size & log2
+  w2 = nextPow2(w2, &log2_w);
+  h2 = nextPow2(h2, &log2_h);
+
+  fREAL *data1 = (fREAL *)MEM_callocN(w2 * h2 * sizeof(fREAL), "convolve_fast FHT data1");
+  fREAL *data2 = (fREAL *)MEM_mallocN(w2 * h2 * sizeof(fREAL), "convolve_fast FHT data2");
+
+  // kernel -> data1, only needs to be transformed once and is re-used for every block
+  for (y = 0; y < kernelHeight; y++) {
+    fREAL *fp = &data1[y * w2];
+    const float *colp = &data->kernel[(size_t)y * kernelWidth * stride + ch];
+    for (x = 0; x < kernelWidth; x++) {
+      fp[x] = colp[x * stride];
+    }
+  }
+  FHT2D(data1, log2_w, log2_h, kernelHeight, 0);
+
+  for (y = 0; y < imageHeight; y++) {
+    float *colp = &data->dst[(size_t)y * imageWidth * stride + ch];
+    for (x = 0; x < imageWidth; x++) {
+      colp[x * stride] = 0.0f;
+    }
+  }
+
+  const int hw = kernelWidth >> 1;
+  const int hh = kernelHeight >> 1;
+  const int xbsz = (w2 + 1) - kernelWidth;
+  const int ybsz = (h2 + 1) - kernelHeight;
+  const int nxb = (imageWidth + xbsz - 1) / xbsz;
+  const int nyb = (imageHeight + ybsz - 1) / ybsz;
+
+  for (int ybl = 0; ybl < nyb; ybl++) {
+    for (int xbl = 0; xbl < nxb; xbl++) {
+      // image block -> data2
+      memset(data2, 0, w2 * h2 * sizeof(fREAL));
+      for (y = 0; y < ybsz; y++) {
+        const int yy = ybl * ybsz + y;
+        if (yy >= imageHeight) {
+          break;
+        }
+        fREAL *fp = &data2[y * w2];
+        const float *colp = &data->image[(size_t)yy * imageWidth * stride + ch];
+        for (x = 0; x < xbsz; x++) {
+          const int xx = xbl * xbsz + x;
+          if (xx >= imageWidth) {
+            break;
+          }
+          fp[x] = colp[xx * stride];
+        }
+      }
+
+      // forward FHT, zero pad data starts after the block rows
+      FHT2D(data2, log2_w, log2_h, ybsz, 0);
+
+      // FHT2D transposed data, row/col now swapped
+      // convolve & inverse FHT
+      fht_convolve(data2, data1, log2_h, log2_w);
+      FHT2D(data2, log2_h, log2_w, 0, 1);
+      // data again transposed, so in order again
+
+      // overlap-add result
+      for (y = 0; y < (int)h2; y++) {
+        const int yy = ybl * ybsz + y - hh;
+        if ((yy < 0) || (yy >= imageHeight)) {
+          continue;
+        }
+        const fREAL *fp = &data2[y * w2];
+        float *colp = &data->dst[(size_t)yy * imageWidth * stride + ch];
+        for (x = 0; x < (int)w2; x++) {
+          const int xx = xbl * xbsz + x - hw;
+          if ((xx < 0) || (xx >= imageWidth)) {
+            continue;
+          }
+          colp[xx * stride] += fp[x];
+        }
+      }
+    }
+  }
+
+  MEM_freeN(data2);
+  MEM_freeN(data1);
+}
+
+void fft_convolve(float *dst,
+                  const float *image,
+                  int width,
+                  int height,
+                  const float *kernel,
+                  int kernel_width,
+                  int kernel_height,
+                  int stride,
+                  int num_channels)
+{
+  BLI_assert(num_channels <= stride);
+  FFTConvolveData data;
+  data.dst = dst;
+  data.image = image;
+  data.kernel = kernel;
+  data.width = width;
+  data.height = height;
+  data.kernel_width = kernel_width;
+  data.kernel_height = kernel_height;
+  data.stride = stride;
+
+  /* Channels are independent, each one uses its own transform buffers. */
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  BLI_task_parallel_range(0, num_channels, &data, fft_convolve_channel, &settings);
+}
@@ -0,0 +1,43 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#pragma once
+
+/**
+ * \brief Convolve an image with a kernel using the 2D Fast Hartley Transform.
+ *
+ * The image is convolved in blocks which are added together (overlap-add), so the cost depends
+ * on the area of the image and the logarithm of the kernel size instead of their product. The
+ * result at pixel (x, y) is the sum of the image pixels around it weighted by the kernel, kernel
+ * pixel (i, j) weights the image pixel (x - i + kernel_width / 2, y - j + kernel_height / 2).
+ * Pixels outside of the image are zero.
+ *
+ * \param dst: output, width * height pixels. Only the convolved channels are written.
+ * \param stride: number of floats per pixel of dst, image and kernel.
+ * \param num_channels: number of channels of each pixel to convolve, from the first one. Channels
+ * are convolved in parallel.
+ */
+void fft_convolve(float *dst,
+                  const float *image,
+                  int width,
+                  int height,
+                  const float *kernel,
+                  int kernel_width,
+                  int kernel_height,
+                  int stride,
+                  int num_channels);
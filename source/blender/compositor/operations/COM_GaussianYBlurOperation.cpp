@@ -30,6 +30,7 @@ GaussianYBlurOperation::GaussianYBlurOperation() : BlurBaseOperation(COM_DT_COLO
   this->m_gausstab_sse = nullptr;
 #endif
   this->m_filtersize = 0;
+  this->setFullFrameOperation(true);
 }
 
 void *GaussianYBlurOperation::initializeTileData(rcti * /*rect*/)
@@ -117,6 +118,40 @@ void GaussianYBlurOperation::executePixel(float output[4], int x, int y, void *d
   mul_v4_v4fl(output, color_accum, 1.0f / multiplier_accum);
 }
 
+void GaussianYBlurOperation::update_memory_buffer(MemoryBuffer *output,
+                                                  rcti *area,
+                                                  MemoryBuffer **inputs)
+{
+  lockMutex();
+  if (!this->m_sizeavailable) {
+    updateGauss();
+  }
+  unlockMutex();
+
+  const int width = output->getWidth();
+  if (inputs[0]->is_a_single_elem()) {
+    /* The blurred weights are normalized, a constant input stays constant. */
+    const float *elem = inputs[0]->getBuffer();
+    for (int y = area->ymin; y < area->ymax; y++) {
+      float *out = output->getBuffer() + (y * width + area->xmin) * COM_NUM_CHANNELS_COLOR;
+      for (int x = area->xmin; x < area->xmax; x++) {
+        copy_v4_v4(out, elem);
+        out += COM_NUM_CHANNELS_COLOR;
+      }
+    }
+    return;
+  }
+
+  for (int y = area->ymin; y < area->ymax; y++) {
+    float *out = output->getBuffer() + (y * width + area->xmin) * COM_NUM_CHANNELS_COLOR;
+    for (int x = area->xmin; x < area->xmax; x++) {
+      /* Non-virtual call, the input buffer is the same one initializeTileData returns. */
+      GaussianYBlurOperation::executePixel(out, x, y, inputs[0]);
+      out += COM_NUM_CHANNELS_COLOR;
+    }
+  }
+}
+
 void GaussianYBlurOperation::executeOpenCL(OpenCLDevice *device,
                                            MemoryBuffer *outputMemoryBuffer,
                                            cl_mem clOutputBuffer,
@@ -20,6 +20,8 @@
 
 #include "BLI_math.h"
 
+#include "MEM_guardedalloc.h"
+
 /* ******** Mix Base Operation ******** */
 
 MixBaseOperation::MixBaseOperation()
@@ -52,15 +54,62 @@ void MixBaseOperation::executePixelSampled(float output[4], float x, float y, Pi
   this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
   this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
 
-  float value = inputValue[0];
-  if (this->useValueAlphaMultiply()) {
-    value *= inputColor2[3];
+  this->update_memory_buffer_row(output, inputValue, inputColor1, inputColor2, 1);
+}
+
+void MixBaseOperation::update_memory_buffer(MemoryBuffer *output,
+                                            rcti *area,
+                                            MemoryBuffer **inputs)
+{
+  BLI_assert(inputs[0]->get_num_channels() == COM_NUM_CHANNELS_VALUE);
+  BLI_assert(inputs[1]->get_num_channels() == COM_NUM_CHANNELS_COLOR);
+  BLI_assert(inputs[2]->get_num_channels() == COM_NUM_CHANNELS_COLOR);
+
+  const int width = BLI_rcti_size_x(area);
+  /* Constant inputs only store a single element, repeat it over the row. */
+  float *elem_rows[3] = {nullptr, nullptr, nullptr};
+  for (int i = 0; i < 3; i++) {
+    if (inputs[i]->is_a_single_elem()) {
+      elem_rows[i] = inputs[i]->alloc_elem_row(width);
+    }
+  }
+
+  for (int y = area->ymin; y < area->ymax; y++) {
+    const int offset = y * output->getWidth() + area->xmin;
+    const float *rows[3];
+    for (int i = 0; i < 3; i++) {
+      rows[i] = elem_rows[i] ? elem_rows[i] :
+                               inputs[i]->getBuffer() + offset * inputs[i]->get_num_channels();
+    }
+    this->update_memory_buffer_row(
+        output->getBuffer() + offset * COM_NUM_CHANNELS_COLOR, rows[0], rows[1], rows[2], width);
+  }
+
+  for (int i = 0; i < 3; i++) {
+    if (elem_rows[i]) {
+      MEM_freeN(elem_rows[i]);
+    }
+  }
+}
+
+void MixBaseOperation::update_memory_buffer_row(
+    float *output, const float *value, const float *color1, const float *color2, int width)
+{
+  for (int i = 0; i < width; i++) {
+    float fac = value[0];
+    if (this->useValueAlphaMultiply()) {
+      fac *= color2[3];
+    }
+    float facm = 1.0f - fac;
+    output[0] = facm * color1[0] + fac * color2[0];
+    output[1] = facm * color1[1] + fac * color2[1];
+    output[2] = facm * color1[2] + fac * color2[2];
+    output[3] = color1[3];
+    output += COM_NUM_CHANNELS_COLOR;
+    value += COM_NUM_CHANNELS_VALUE;
+    color1 += COM_NUM_CHANNELS_COLOR;
+    color2 += COM_NUM_CHANNELS_COLOR;
   }
-  float valuem = 1.0f - value;
-  output[0] = valuem * (inputColor1[0]) + value * (inputColor2[0]);
-  output[1] = valuem * (inputColor1[1]) + value * (inputColor2[1]);
-  output[2] = valuem * (inputColor1[2]) + value * (inputColor2[2]);
-  output[3] = inputColor1[3];
 }
 
 void MixBaseOperation::determineResolution(unsigned int resolution[2],
@@ -99,63 +148,57 @@ void MixBaseOperation::deinitExecution()
 
 MixAddOperation::MixAddOperation()
 {
-  /* pass */
+  this->setFullFrameOperation(true);
 }
 
-void MixAddOperation::executePixelSampled(float output[4], float x, float y, PixelSampler sampler)
+void MixAddOperation::update_memory_buffer_row(
+    float *output, const float *value, const float *color1, const float *color2, int width)
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
-
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
+  for (int i = 0; i < width; i++) {
+    float fac = value[0];
+    if (this->useValueAlphaMultiply()) {
+      fac *= color2[3];
+    }
+    output[0] = color1[0] + fac * color2[0];
+    output[1] = color1[1] + fac * color2[1];
+    output[2] = color1[2] + fac * color2[2];
+    output[3] = color1[3];
 
-  float value = inputValue[0];
-  if (this->useValueAlphaMultiply()) {
-    value *= inputColor2[3];
+    clampIfNeeded(output);
+    output += COM_NUM_CHANNELS_COLOR;
+    value += COM_NUM_CHANNELS_VALUE;
+    color1 += COM_NUM_CHANNELS_COLOR;
+    color2 += COM_NUM_CHANNELS_COLOR;
   }
-  output[0] = inputColor1[0] + value * inputColor2[0];
-  output[1] = inputColor1[1] + value * inputColor2[1];
-  output[2] = inputColor1[2] + value * inputColor2[2];
-  output[3] = inputColor1[3];
-
-  clampIfNeeded(output);
 }
 
 /* ******** Mix Blend Operation ******** */
 
 MixBlendOperation::MixBlendOperation()
 {
-  /* pass */
+  this->setFullFrameOperation(true);
 }
 
-void MixBlendOperation::executePixelSampled(float output[4],
-                                            float x,
-                                            float y,
-                                            PixelSampler sampler)
+void MixBlendOperation::update_memory_buffer_row(
+    float *output, const float *value, const float *color1, const float *color2, int width)
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
-  float value;
-
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
-  value = inputValue[0];
+  for (int i = 0; i < width; i++) {
+    float fac = value[0];
+    if (this->useValueAlphaMultiply()) {
+      fac *= color2[3];
+    }
+    float facm = 1.0f - fac;
+    output[0] = facm * color1[0] + fac * color2[0];
+    output[1] = facm * color1[1] + fac * color2[1];
+    output[2] = facm * color1[2] + fac * color2[2];
+    output[3] = color1[3];
 
-  if (this->useValueAlphaMultiply()) {
-    value *= inputColor2[3];
+    clampIfNeeded(output);
+    output += COM_NUM_CHANNELS_COLOR;
+    value += COM_NUM_CHANNELS_VALUE;
+    color1 += COM_NUM_CHANNELS_COLOR;
+    color2 += COM_NUM_CHANNELS_COLOR;
   }
-  float valuem = 1.0f - value;
-  output[0] = valuem * (inputColor1[0]) + value * (inputColor2[0]);
-  output[1] = valuem * (inputColor1[1]) + value * (inputColor2[1]);
-  output[2] = valuem * (inputColor1[2]) + value * (inputColor2[2]);
-  output[3] = inputColor1[3];
-
-  clampIfNeeded(output);
 }
 
 /* ******** Mix Burn Operation ******** */
@@ -290,66 +333,58 @@ void MixColorOperation::executePixelSampled(float output[4],
 
 MixDarkenOperation::MixDarkenOperation()
 {
-  /* pass */
+  this->setFullFrameOperation(true);
 }
 
-void MixDarkenOperation::executePixelSampled(float output[4],
-                                             float x,
-                                             float y,
-                                             PixelSampler sampler)
+void MixDarkenOperation::update_memory_buffer_row(
+    float *output, const float *value, const float *color1, const float *color2, int width)
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
-
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
+  for (int i = 0; i < width; i++) {
+    float fac = value[0];
+    if (this->useValueAlphaMultiply()) {
+      fac *= color2[3];
+    }
+    float facm = 1.0f - fac;
+    output[0] = min_ff(color1[0], color2[0]) * fac + color1[0] * facm;
+    output[1] = min_ff(color1[1], color2[1]) * fac + color1[1] * facm;
+    output[2] = min_ff(color1[2], color2[2]) * fac + color1[2] * facm;
+    output[3] = color1[3];
 
-  float value = inputValue[0];
-  if (this->useValueAlphaMultiply()) {
-    value *= inputColor2[3];
+    clampIfNeeded(output);
+    output += COM_NUM_CHANNELS_COLOR;
+    value += COM_NUM_CHANNELS_VALUE;
+    color1 += COM_NUM_CHANNELS_COLOR;
+    color2 += COM_NUM_CHANNELS_COLOR;
   }
-  float valuem = 1.0f - value;
-  output[0] = min_ff(inputColor1[0], inputColor2[0]) * value + inputColor1[0] * valuem;
-  output[1] = min_ff(inputColor1[1], inputColor2[1]) * value + inputColor1[1] * valuem;
-  output[2] = min_ff(inputColor1[2], inputColor2[2]) * value + inputColor1[2] * valuem;
-  output[3] = inputColor1[3];
-
-  clampIfNeeded(output);
 }
 
 /* ******** Mix Difference Operation ******** */
 
 MixDifferenceOperation::MixDifferenceOperation()
 {
-  /* pass */
+  this->setFullFrameOperation(true);
 }
 
-void MixDifferenceOperation::executePixelSampled(float output[4],
-                                                 float x,
-                                                 float y,
-                                                 PixelSampler sampler)
+void MixDifferenceOperation::update_memory_buffer_row(
+    float *output, const float *value, const float *color1, const float *color2, int width)
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
-
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
+  for (int i = 0; i < width; i++) {
+    float fac = value[0];
+    if (this->useValueAlphaMultiply()) {
+      fac *= color2[3];
+    }
+    float facm = 1.0f - fac;
+    output[0] = facm * color1[0] + fac * fabsf(color1[0] - color2[0]);
+    output[1] = facm * color1[1] + fac * fabsf(color1[1] - color2[1]);
+    output[2] = facm * color1[2] + fac * fabsf(color1[2] - color2[2]);
+    output[3] = color1[3];
 
-  float value = inputValue[0];
-  if (this->useValueAlphaMultiply()) {
-    value *= inputColor2[3];
+    clampIfNeeded(output);
+    output += COM_NUM_CHANNELS_COLOR;
+    value += COM_NUM_CHANNELS_VALUE;
+    color1 += COM_NUM_CHANNELS_COLOR;
+    color2 += COM_NUM_CHANNELS_COLOR;
   }
-  float valuem = 1.0f - value;
-  output[0] = valuem * inputColor1[0] + value * fabsf(inputColor1[0] - inputColor2[0]);
-  output[1] = valuem * inputColor1[1] + value * fabsf(inputColor1[1] - inputColor2[1]);
-  output[2] = valuem * inputColor1[2] + value * fabsf(inputColor1[2] - inputColor2[2]);
-  output[3] = inputColor1[3];
-
-  clampIfNeeded(output);
 }
 
 /* ******** Mix Difference Operation ******** */
@@ -577,51 +612,28 @@ void MixHueOperation::executePixelSampled(float output[4], float x, float y, Pix
 
 MixLightenOperation::MixLightenOperation()
 {
-  /* pass */
+  this->setFullFrameOperation(true);
 }
 
-void MixLightenOperation::executePixelSampled(float output[4],
-                                              float x,
-                                              float y,
-                                              PixelSampler sampler)
+void MixLightenOperation::update_memory_buffer_row(
+    float *output, const float *value, const float *color1, const float *color2, int width)
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
-
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
+  for (int i = 0; i < width; i++) {
+    float fac = value[0];
+    if (this->useValueAlphaMultiply()) {
+      fac *= color2[3];
+    }
+    output[0] = max_ff(fac * color2[0], color1[0]);
+    output[1] = max_ff(fac * color2[1], color1[1]);
+    output[2] = max_ff(fac * color2[2], color1[2]);
+    output[3] = color1[3];
 
-  float value = inputValue[0];
-  if (this->useValueAlphaMultiply()) {
-    value *= inputColor2[3];
-  }
-  float tmp;
-  tmp = value * inputColor2[0];
-  if (tmp > inputColor1[0]) {
-    output[0] = tmp;
-  }
-  else {
-    output[0] = inputColor1[0];
-  }
-  tmp = value * inputColor2[1];
-  if (tmp > inputColor1[1]) {
-    output[1] = tmp;
-  }
-  else {
-    output[1] = inputColor1[1];
-  }
-  tmp = value * inputColor2[2];
-  if (tmp > inputColor1[2]) {
-    output[2] = tmp;
-  }
-  else {
-    output[2] = inputColor1[2];
+    clampIfNeeded(output);
+    output += COM_NUM_CHANNELS_COLOR;
+    value += COM_NUM_CHANNELS_VALUE;
+    color1 += COM_NUM_CHANNELS_COLOR;
+    color2 += COM_NUM_CHANNELS_COLOR;
   }
-  output[3] = inputColor1[3];
-
-  clampIfNeeded(output);
 }
 
 /* ******** Mix Linear Light Operation ******** */
@@ -676,33 +688,29 @@ void MixLinearLightOperation::executePixelSampled(float output[4],
 
 MixMultiplyOperation::MixMultiplyOperation()
 {
-  /* pass */
+  this->setFullFrameOperation(true);
 }
 
-void MixMultiplyOperation::executePixelSampled(float output[4],
-                                               float x,
-                                               float y,
-                                               PixelSampler sampler)
+void MixMultiplyOperation::update_memory_buffer_row(
+    float *output, const float *value, const float *color1, const float *color2, int width)
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
-
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
+  for (int i = 0; i < width; i++) {
+    float fac = value[0];
+    if (this->useValueAlphaMultiply()) {
+      fac *= color2[3];
+    }
+    float facm = 1.0f - fac;
+    output[0] = color1[0] * (facm + fac * color2[0]);
+    output[1] = color1[1] * (facm + fac * color2[1]);
+    output[2] = color1[2] * (facm + fac * color2[2]);
+    output[3] = color1[3];
 
-  float value = inputValue[0];
-  if (this->useValueAlphaMultiply()) {
-    value *= inputColor2[3];
+    clampIfNeeded(output);
+    output += COM_NUM_CHANNELS_COLOR;
+    value += COM_NUM_CHANNELS_VALUE;
+    color1 += COM_NUM_CHANNELS_COLOR;
+    color2 += COM_NUM_CHANNELS_COLOR;
   }
-  float valuem = 1.0f - value;
-  output[0] = inputColor1[0] * (valuem + value * inputColor2[0]);
-  output[1] = inputColor1[1] * (valuem + value * inputColor2[1]);
-  output[2] = inputColor1[2] * (valuem + value * inputColor2[2]);
-  output[3] = inputColor1[3];
-
-  clampIfNeeded(output);
 }
 
 /* ******** Mix Ovelray Operation ******** */
@@ -801,34 +809,29 @@ void MixSaturationOperation::executePixelSampled(float output[4],
 
 MixScreenOperation::MixScreenOperation()
 {
-  /* pass */
+  this->setFullFrameOperation(true);
 }
 
-void MixScreenOperation::executePixelSampled(float output[4],
-                                             float x,
-                                             float y,
-                                             PixelSampler sampler)
+void MixScreenOperation::update_memory_buffer_row(
+    float *output, const float *value, const float *color1, const float *color2, int width)
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
-
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
+  for (int i = 0; i < width; i++) {
+    float fac = value[0];
+    if (this->useValueAlphaMultiply()) {
+      fac *= color2[3];
+    }
+    float facm = 1.0f - fac;
+    output[0] = 1.0f - (facm + fac * (1.0f - color2[0])) * (1.0f - color1[0]);
+    output[1] = 1.0f - (facm + fac * (1.0f - color2[1])) * (1.0f - color1[1]);
+    output[2] = 1.0f - (facm + fac * (1.0f - color2[2])) * (1.0f - color1[2]);
+    output[3] = color1[3];
 
-  float value = inputValue[0];
-  if (this->useValueAlphaMultiply()) {
-    value *= inputColor2[3];
+    clampIfNeeded(output);
+    output += COM_NUM_CHANNELS_COLOR;
+    value += COM_NUM_CHANNELS_VALUE;
+    color1 += COM_NUM_CHANNELS_COLOR;
+    color2 += COM_NUM_CHANNELS_COLOR;
   }
-  float valuem = 1.0f - value;
-
-  output[0] = 1.0f - (valuem + value * (1.0f - inputColor2[0])) * (1.0f - inputColor1[0]);
-  output[1] = 1.0f - (valuem + value * (1.0f - inputColor2[1])) * (1.0f - inputColor1[1]);
-  output[2] = 1.0f - (valuem + value * (1.0f - inputColor2[2])) * (1.0f - inputColor1[2]);
-  output[3] = inputColor1[3];
-
-  clampIfNeeded(output);
 }
 
 /* ******** Mix Soft Light Operation ******** */
@@ -881,32 +884,28 @@ void MixSoftLightOperation::executePixelSampled(float output[4],
 
 MixSubtractOperation::MixSubtractOperation()
 {
-  /* pass */
+  this->setFullFrameOperation(true);
 }
 
-void MixSubtractOperation::executePixelSampled(float output[4],
-                                               float x,
-                                               float y,
-                                               PixelSampler sampler)
+void MixSubtractOperation::update_memory_buffer_row(
+    float *output, const float *value, const float *color1, const float *color2, int width)
 {
-  float inputColor1[4];
-  float inputColor2[4];
-  float inputValue[4];
-
-  this->m_inputValueOperation->readSampled(inputValue, x, y, sampler);
-  this->m_inputColor1Operation->readSampled(inputColor1, x, y, sampler);
-  this->m_inputColor2Operation->readSampled(inputColor2, x, y, sampler);
+  for (int i = 0; i < width; i++) {
+    float fac = value[0];
+    if (this->useValueAlphaMultiply()) {
+      fac *= color2[3];
+    }
+    output[0] = color1[0] - fac * color2[0];
+    output[1] = color1[1] - fac * color2[1];
+    output[2] = color1[2] - fac * color2[2];
+    output[3] = color1[3];
 
-  float value = inputValue[0];
-  if (this->useValueAlphaMultiply()) {
-    value *= inputColor2[3];
+    clampIfNeeded(output);
+    output += COM_NUM_CHANNELS_COLOR;
+    value += COM_NUM_CHANNELS_VALUE;
+    color1 += COM_NUM_CHANNELS_COLOR;
+    color2 += COM_NUM_CHANNELS_COLOR;
   }
-  output[0] = inputColor1[0] - value * (inputColor2[0]);
-  output[1] = inputColor1[1] - value * (inputColor2[1]);
-  output[2] = inputColor1[2] - value * (inputColor2[2]);
-  output[3] = inputColor1[3];
-
-  clampIfNeeded(output);
 }
 
 /* ******** Mix Value Operation ******** */
@@ -43,6 +43,13 @@ class MixBaseOperation : public NodeOperation {
     }
   }
 
+  /**
+   * Mix a row of pixels, used by both the tiled and the full-frame execution.
+   * Subclasses that override this instead of executePixelSampled enable full-frame execution.
+   */
+  virtual void update_memory_buffer_row(
+      float *output, const float *value, const float *color1, const float *color2, int width);
+
  public:
   /**
    * Default constructor
@@ -54,6 +61,8 @@ class MixBaseOperation : public NodeOperation {
    */
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
 
+  void update_memory_buffer(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
+
   /**
    * Initialize the execution
    */
@@ -83,13 +92,19 @@ class MixBaseOperation : public NodeOperation {
 class MixAddOperation : public MixBaseOperation {
  public:
   MixAddOperation();
-  void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+
+ protected:
+  void update_memory_buffer_row(
+      float *output, const float *value, const float *color1, const float *color2, int width);
 };
 
 class MixBlendOperation : public MixBaseOperation {
  public:
   MixBlendOperation();
-  void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+
+ protected:
+  void update_memory_buffer_row(
+      float *output, const float *value, const float *color1, const float *color2, int width);
 };
 
 class MixColorBurnOperation : public MixBaseOperation {
@@ -107,13 +122,19 @@ class MixColorOperation : public MixBaseOperation {
 class MixDarkenOperation : public MixBaseOperation {
  public:
   MixDarkenOperation();
-  void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+
+ protected:
+  void update_memory_buffer_row(
+      float *output, const float *value, const float *color1, const float *color2, int width);
 };
 
 class MixDifferenceOperation : public MixBaseOperation {
  public:
   MixDifferenceOperation();
-  void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+
+ protected:
+  void update_memory_buffer_row(
+      float *output, const float *value, const float *color1, const float *color2, int width);
 };
 
 class MixDivideOperation : public MixBaseOperation {
@@ -143,7 +164,10 @@ class MixHueOperation : public MixBaseOperation {
 class MixLightenOperation : public MixBaseOperation {
  public:
   MixLightenOperation();
-  void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+
+ protected:
+  void update_memory_buffer_row(
+      float *output, const float *value, const float *color1, const float *color2, int width);
 };
 
 class MixLinearLightOperation : public MixBaseOperation {
@@ -155,7 +179,10 @@ class MixLinearLightOperation : public MixBaseOperation {
 class MixMultiplyOperation : public MixBaseOperation {
  public:
   MixMultiplyOperation();
-  void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+
+ protected:
+  void update_memory_buffer_row(
+      float *output, const float *value, const float *color1, const float *color2, int width);
 };
 
 class MixOverlayOperation : public MixBaseOperation {
@@ -173,7 +200,10 @@ class MixSaturationOperation : public MixBaseOperation {
 class MixScreenOperation : public MixBaseOperation {
  public:
   MixScreenOperation();
-  void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+
+ protected:
+  void update_memory_buffer_row(
+      float *output, const float *value, const float *color1, const float *color2, int width);
 };
 
 class MixSoftLightOperation : public MixBaseOperation {
@@ -185,7 +215,10 @@ class MixSoftLightOperation : public MixBaseOperation {
 class MixSubtractOperation : public MixBaseOperation {
  public:
   MixSubtractOperation();
-  void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+
+ protected:
+  void update_memory_buffer_row(
+      float *output, const float *value, const float *color1, const float *color2, int width);
 };
 
 class MixValueOperation : public MixBaseOperation {
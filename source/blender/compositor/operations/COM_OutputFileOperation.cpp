@@ -36,6 +36,8 @@
 #include "IMB_imbuf.h"
 #include "IMB_imbuf_types.h"
 
+#include "RE_pipeline.h"
+
 void add_exr_channels(void *exrhandle,
                       const char *layerName,
                       const DataType datatype,
@@ -245,13 +247,41 @@ void OutputSingleLayerOperation::executeRegion(rcti *rect, unsigned int /*tileNu
                     this->m_datatype);
 }
 
+/* Output file written by #write_single_layer, can be written in the background. */
+struct SingleLayerWrite {
+  ImBuf *ibuf;
+  ImageFormatData format;
+  ColorManagedViewSettings view_settings;
+  ColorManagedDisplaySettings display_settings;
+  char filename[FILE_MAX];
+};
+
+static bool write_single_layer(void *data)
+{
+  SingleLayerWrite *write = (SingleLayerWrite *)data;
+
+  IMB_colormanagement_imbuf_for_write(
+      write->ibuf, true, false, &write->view_settings, &write->display_settings, &write->format);
+
+  if (0 == BKE_imbuf_write(write->ibuf, write->filename, &write->format)) {
+    printf("Cannot save Node File Output to %s\n", write->filename);
+  }
+  else {
+    printf("Saved: %s\n", write->filename);
+  }
+
+  IMB_freeImBuf(write->ibuf);
+  MEM_freeN(write);
+  /* Failing to write a file output doesn't stop rendering. */
+  return true;
+}
+
 void OutputSingleLayerOperation::deinitExecution()
 {
   if (this->getWidth() * this->getHeight() != 0) {
 
     int size = get_datatype_size(this->m_datatype);
     ImBuf *ibuf = IMB_allocImBuf(this->getWidth(), this->getHeight(), this->m_format->planes, 0);
-    char filename[FILE_MAX];
     const char *suffix;
 
     ibuf->channels = size;
@@ -259,12 +289,15 @@ void OutputSingleLayerOperation::deinitExecution()
     ibuf->mall |= IB_rectfloat;
     ibuf->dither = this->m_rd->dither_intensity;
 
-    IMB_colormanagement_imbuf_for_write(
-        ibuf, true, false, m_viewSettings, m_displaySettings, this->m_format);
+    SingleLayerWrite *write = (SingleLayerWrite *)MEM_mallocN(sizeof(SingleLayerWrite), __func__);
+    write->ibuf = ibuf;
+    write->format = *this->m_format;
+    write->view_settings = *this->m_viewSettings;
+    write->display_settings = *this->m_displaySettings;
 
     suffix = BKE_scene_multiview_view_suffix_get(this->m_rd, this->m_viewName);
 
-    BKE_image_path_from_imformat(filename,
+    BKE_image_path_from_imformat(write->filename,
                                  this->m_path,
                                  BKE_main_blendfile_path_from_global(),
                                  this->m_rd->cfra,
@@ -273,14 +306,10 @@ void OutputSingleLayerOperation::deinitExecution()
                                  true,
                                  suffix);
 
-    if (0 == BKE_imbuf_write(ibuf, filename, this->m_format)) {
-      printf("Cannot save Node File Output to %s\n", filename);
-    }
-    else {
-      printf("Saved: %s\n", filename);
+    /* The buffer is owned by the image buffer now. */
+    if (!RE_WriteInBackground(write_single_layer, write)) {
+      write_single_layer(write);
     }
-
-    IMB_freeImBuf(ibuf);
   }
   this->m_outputBuffer = nullptr;
   this->m_imageInput = nullptr;
@@ -350,6 +379,45 @@ void OutputOpenExrMultiLayerOperation::executeRegion(rcti *rect, unsigned int /*
   }
 }
 
+/* Multi-layer file written by #write_multi_layer, can be written in the background. */
+struct MultiLayerWrite {
+  void *exrhandle;
+  unsigned int width, height;
+  char exr_codec;
+  char filename[FILE_MAX];
+  /** #LinkData of the buffers of the channels. */
+  ListBase buffers;
+};
+
+static bool write_multi_layer(void *data)
+{
+  MultiLayerWrite *write = (MultiLayerWrite *)data;
+
+  /* when the filename has no permissions, this can fail */
+  if (IMB_exr_begin_write(write->exrhandle,
+                          write->filename,
+                          write->width,
+                          write->height,
+                          write->exr_codec,
+                          nullptr)) {
+    IMB_exr_write_channels(write->exrhandle);
+  }
+  else {
+    /* TODO, get the error from openexr's exception */
+    /* XXX nice way to do report? */
+    printf("Error Writing Render Result, see console\n");
+  }
+
+  IMB_exr_close(write->exrhandle);
+  LISTBASE_FOREACH (LinkData *, link, &write->buffers) {
+    MEM_freeN(link->data);
+  }
+  BLI_freelistN(&write->buffers);
+  MEM_freeN(write);
+  /* Failing to write a file output doesn't stop rendering. */
+  return true;
+}
+
 void OutputOpenExrMultiLayerOperation::deinitExecution()
 {
   unsigned int width = this->getWidth();
@@ -385,24 +453,25 @@ void OutputOpenExrMultiLayerOperation::deinitExecution()
                        this->m_layers[i].outputBuffer);
     }
 
-    /* when the filename has no permissions, this can fail */
-    if (IMB_exr_begin_write(exrhandle, filename, width, height, this->m_exr_codec, nullptr)) {
-      IMB_exr_write_channels(exrhandle);
-    }
-    else {
-      /* TODO, get the error from openexr's exception */
-      /* XXX nice way to do report? */
-      printf("Error Writing Render Result, see console\n");
-    }
+    MultiLayerWrite *write = (MultiLayerWrite *)MEM_callocN(sizeof(MultiLayerWrite), __func__);
+    write->exrhandle = exrhandle;
+    write->width = width;
+    write->height = height;
+    write->exr_codec = this->m_exr_codec;
+    BLI_strncpy(write->filename, filename, sizeof(write->filename));
 
-    IMB_exr_close(exrhandle);
+    /* The channels point to the layer buffers, they're freed after writing. */
     for (unsigned int i = 0; i < this->m_layers.size(); i++) {
       if (this->m_layers[i].outputBuffer) {
-        MEM_freeN(this->m_layers[i].outputBuffer);
+        BLI_addtail(&write->buffers, BLI_genericNodeN(this->m_layers[i].outputBuffer));
         this->m_layers[i].outputBuffer = nullptr;
       }
 
       this->m_layers[i].imageInput = nullptr;
     }
+
+    if (!RE_WriteInBackground(write_multi_layer, write)) {
+      write_multi_layer(write);
+    }
   }
 }
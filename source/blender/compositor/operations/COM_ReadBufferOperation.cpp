@@ -28,9 +28,25 @@ ReadBufferOperation::ReadBufferOperation(DataType datatype)
   this->m_buffer = nullptr;
 }
 
+/* Input buffers of paged memory proxies for the chunk executed by the thread. */
+static thread_local MemoryBuffer **g_thread_chunk_buffers = nullptr;
+
+MemoryBuffer **ReadBufferOperation::set_thread_chunk_buffers(MemoryBuffer **memoryBuffers)
+{
+  MemoryBuffer **previous = g_thread_chunk_buffers;
+  g_thread_chunk_buffers = memoryBuffers;
+  return previous;
+}
+
+MemoryBuffer *ReadBufferOperation::get_thread_chunk_buffer(unsigned int offset)
+{
+  BLI_assert(g_thread_chunk_buffers != nullptr);
+  return g_thread_chunk_buffers[offset];
+}
+
 void *ReadBufferOperation::initializeTileData(rcti * /*rect*/)
 {
-  return m_buffer;
+  return get_read_buffer();
 }
 
 void ReadBufferOperation::determineResolution(unsigned int resolution[2],
@@ -54,21 +70,22 @@ void ReadBufferOperation::executePixelSampled(float output[4],
                                               float y,
                                               PixelSampler sampler)
 {
+  MemoryBuffer *buffer = get_read_buffer();
   if (m_single_value) {
     /* write buffer has a single value stored at (0,0) */
-    m_buffer->read(output, 0, 0);
+    buffer->read(output, 0, 0);
   }
   else {
     switch (sampler) {
       case COM_PS_NEAREST:
-        m_buffer->read(output, x, y);
+        buffer->read(output, x, y);
         break;
       case COM_PS_BILINEAR:
       default:
-        m_buffer->readBilinear(output, x, y);
+        buffer->readBilinear(output, x, y);
         break;
       case COM_PS_BICUBIC:
-        m_buffer->readBilinear(output, x, y);
+        buffer->readBilinear(output, x, y);
         break;
     }
   }
@@ -81,29 +98,31 @@ void ReadBufferOperation::executePixelExtend(float output[4],
                                              MemoryBufferExtend extend_x,
                                              MemoryBufferExtend extend_y)
 {
+  MemoryBuffer *buffer = get_read_buffer();
   if (m_single_value) {
     /* write buffer has a single value stored at (0,0) */
-    m_buffer->read(output, 0, 0);
+    buffer->read(output, 0, 0);
   }
   else if (sampler == COM_PS_NEAREST) {
-    m_buffer->read(output, x, y, extend_x, extend_y);
+    buffer->read(output, x, y, extend_x, extend_y);
   }
   else {
-    m_buffer->readBilinear(output, x, y, extend_x, extend_y);
+    buffer->readBilinear(output, x, y, extend_x, extend_y);
   }
 }
 
 void ReadBufferOperation::executePixelFiltered(
     float output[4], float x, float y, float dx[2], float dy[2])
 {
+  MemoryBuffer *buffer = get_read_buffer();
   if (m_single_value) {
     /* write buffer has a single value stored at (0,0) */
-    m_buffer->read(output, 0, 0);
+    buffer->read(output, 0, 0);
   }
   else {
     const float uv[2] = {x, y};
     const float deriv[2][2] = {{dx[0], dx[1]}, {dy[0], dy[1]}};
-    m_buffer->readEWA(output, uv, deriv);
+    buffer->readEWA(output, uv, deriv);
   }
 }
 
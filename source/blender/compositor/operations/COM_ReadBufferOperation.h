@@ -27,8 +27,19 @@ class ReadBufferOperation : public NodeOperation {
   MemoryProxy *m_memoryProxy;
   bool m_single_value; /* single value stored in buffer, copied from associated write operation */
   unsigned int m_offset;
+  /** Buffer of the memory proxy, nullptr when its chunks are stored by a MemoryPager. */
   MemoryBuffer *m_buffer;
 
+  /**
+   * \brief buffer to read from, for paged memory proxies the consolidated buffer of the chunk the
+   * calling thread executes
+   */
+  MemoryBuffer *get_read_buffer() const
+  {
+    return this->m_buffer ? this->m_buffer : get_thread_chunk_buffer(this->m_offset);
+  }
+  static MemoryBuffer *get_thread_chunk_buffer(unsigned int offset);
+
  public:
   ReadBufferOperation(DataType datatype);
   void setMemoryProxy(MemoryProxy *memoryProxy)
@@ -71,4 +82,12 @@ class ReadBufferOperation : public NodeOperation {
   }
   void readResolutionFromWriteBuffer();
   void updateMemoryBuffer();
+
+  /**
+   * \brief set the input buffers of the chunk the calling thread executes, indexed by the
+   * offsets of the read operations, see ExecutionGroup.getInputBuffersCPU
+   * \return the buffers that were set before, to be restored when the chunk is done. A thread
+   * waiting for a parallel loop inside of a chunk can execute another chunk meanwhile.
+   */
+  static MemoryBuffer **set_thread_chunk_buffers(MemoryBuffer **memoryBuffers);
 };
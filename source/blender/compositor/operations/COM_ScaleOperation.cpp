@@ -35,6 +35,17 @@ BaseScaleOperation::BaseScaleOperation()
   m_variable_size = false;
 }
 
+void BaseScaleOperation::sample_input(
+    MemoryBuffer *input, float output[4], float x, float y, PixelSampler sampler)
+{
+  if (sampler == COM_PS_NEAREST) {
+    input->read(output, x, y);
+  }
+  else {
+    input->readBilinear(output, x, y);
+  }
+}
+
 ScaleOperation::ScaleOperation() : BaseScaleOperation()
 {
   this->addInputSocket(COM_DT_COLOR);
@@ -42,6 +53,7 @@ ScaleOperation::ScaleOperation() : BaseScaleOperation()
   this->addInputSocket(COM_DT_VALUE);
   this->addOutputSocket(COM_DT_COLOR);
   this->setResolutionInputSocketIndex(0);
+  this->setFullFrameOperation(true);
   this->m_inputOperation = nullptr;
   this->m_inputXOperation = nullptr;
   this->m_inputYOperation = nullptr;
@@ -80,6 +92,25 @@ void ScaleOperation::executePixelSampled(float output[4], float x, float y, Pixe
   this->m_inputOperation->readSampled(output, nx, ny, effective_sampler);
 }
 
+void ScaleOperation::update_memory_buffer(MemoryBuffer *output,
+                                          rcti *area,
+                                          MemoryBuffer **inputs)
+{
+  /* Same as reading the output with COM_PS_NEAREST in tiled execution. */
+  const PixelSampler effective_sampler = getEffectiveSampler(COM_PS_NEAREST);
+  const int width = output->getWidth();
+
+  for (int y = area->ymin; y < area->ymax; y++) {
+    float *out = output->getBuffer() + (y * width + area->xmin) * COM_NUM_CHANNELS_COLOR;
+    for (int x = area->xmin; x < area->xmax; x++) {
+      const float nx = this->m_centerX + (x - this->m_centerX) / *inputs[1]->get_elem(x, y);
+      const float ny = this->m_centerY + (y - this->m_centerY) / *inputs[2]->get_elem(x, y);
+      sample_input(inputs[0], out, nx, ny, effective_sampler);
+      out += COM_NUM_CHANNELS_COLOR;
+    }
+  }
+}
+
 bool ScaleOperation::determineDependingAreaOfInterest(rcti *input,
                                                       ReadBufferOperation *readOperation,
                                                       rcti *output)
@@ -117,6 +148,7 @@ ScaleAbsoluteOperation::ScaleAbsoluteOperation() : BaseScaleOperation()
   this->addInputSocket(COM_DT_VALUE);
   this->addOutputSocket(COM_DT_COLOR);
   this->setResolutionInputSocketIndex(0);
+  this->setFullFrameOperation(true);
   this->m_inputOperation = nullptr;
   this->m_inputXOperation = nullptr;
   this->m_inputYOperation = nullptr;
@@ -165,6 +197,29 @@ void ScaleAbsoluteOperation::executePixelSampled(float output[4],
   this->m_inputOperation->readSampled(output, nx, ny, effective_sampler);
 }
 
+void ScaleAbsoluteOperation::update_memory_buffer(MemoryBuffer *output,
+                                                  rcti *area,
+                                                  MemoryBuffer **inputs)
+{
+  /* Same as reading the output with COM_PS_NEAREST in tiled execution. */
+  const PixelSampler effective_sampler = getEffectiveSampler(COM_PS_NEAREST);
+  const int width = output->getWidth();
+  const float fwidth = this->getWidth();
+  const float fheight = this->getHeight();
+
+  for (int y = area->ymin; y < area->ymax; y++) {
+    float *out = output->getBuffer() + (y * width + area->xmin) * COM_NUM_CHANNELS_COLOR;
+    for (int x = area->xmin; x < area->xmax; x++) {
+      const float relativeXScale = *inputs[1]->get_elem(x, y) / fwidth;
+      const float relativeYScale = *inputs[2]->get_elem(x, y) / fheight;
+      const float nx = this->m_centerX + (x - this->m_centerX) / relativeXScale;
+      const float ny = this->m_centerY + (y - this->m_centerY) / relativeYScale;
+      sample_input(inputs[0], out, nx, ny, effective_sampler);
+      out += COM_NUM_CHANNELS_COLOR;
+    }
+  }
+}
+
 bool ScaleAbsoluteOperation::determineDependingAreaOfInterest(rcti *input,
                                                               ReadBufferOperation *readOperation,
                                                               rcti *output)
@@ -39,6 +39,12 @@ class BaseScaleOperation : public NodeOperation {
     return (m_sampler == -1) ? sampler : (PixelSampler)m_sampler;
   }
 
+  /**
+   * Sample the input buffer in full-frame execution, like a BufferOperation would.
+   */
+  static void sample_input(
+      MemoryBuffer *input, float output[4], float x, float y, PixelSampler sampler);
+
   int m_sampler;
   bool m_variable_size;
 };
@@ -57,6 +63,7 @@ class ScaleOperation : public BaseScaleOperation {
                                         ReadBufferOperation *readOperation,
                                         rcti *output);
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
 
   void initExecution();
   void deinitExecution();
@@ -75,6 +82,7 @@ class ScaleAbsoluteOperation : public BaseScaleOperation {
                                         ReadBufferOperation *readOperation,
                                         rcti *output);
   void executePixelSampled(float output[4], float x, float y, PixelSampler sampler);
+  void update_memory_buffer(MemoryBuffer *output, rcti *area, MemoryBuffer **inputs);
 
   void initExecution();
   void deinitExecution();
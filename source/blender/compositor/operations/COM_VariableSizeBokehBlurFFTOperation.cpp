@@ -0,0 +1,325 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#include "COM_VariableSizeBokehBlurFFTOperation.h"
+#include "COM_FFTConvolution.h"
+
+#include "BLI_math.h"
+
+#include "MEM_guardedalloc.h"
+
+/* Maximum number of blur sizes that are convolved. */
+#define COM_BOKEH_FFT_LAYERS 8
+/* Color and weight of each pixel, the weights are convolved with every bokeh channel. */
+#define COM_BOKEH_FFT_CHANNELS (2 * COM_NUM_CHANNELS_COLOR)
+
+VariableSizeBokehBlurFFTOperation::VariableSizeBokehBlurFFTOperation()
+{
+  this->addInputSocket(COM_DT_COLOR);
+  this->addInputSocket(COM_DT_COLOR, COM_SC_NO_RESIZE);  // do not resize the bokeh image.
+  this->addInputSocket(COM_DT_VALUE);                    // radius
+  this->addOutputSocket(COM_DT_COLOR);
+
+  this->m_inputProgram = nullptr;
+  this->m_inputBokehProgram = nullptr;
+  this->m_inputSizeProgram = nullptr;
+  this->m_maxBlur = 32.0f;
+  this->m_threshold = 1.0f;
+  this->m_do_size_scale = false;
+}
+
+void VariableSizeBokehBlurFFTOperation::initExecution()
+{
+  SingleThreadedOperation::initExecution();
+  this->m_inputProgram = getInputSocketReader(0);
+  this->m_inputBokehProgram = getInputSocketReader(1);
+  this->m_inputSizeProgram = getInputSocketReader(2);
+}
+
+void VariableSizeBokehBlurFFTOperation::deinitExecution()
+{
+  this->m_inputProgram = nullptr;
+  this->m_inputBokehProgram = nullptr;
+  this->m_inputSizeProgram = nullptr;
+  SingleThreadedOperation::deinitExecution();
+}
+
+/**
+ * Position of a size between the layer radii: the size is between layer r_layer and the next one
+ * at r_factor. A layer of -1 means it is smaller than all layers.
+ */
+static void layer_position(
+    const float *radii, int num_layers, float size, int *r_layer, float *r_factor)
+{
+  *r_layer = -1;
+  *r_factor = 0.0f;
+  for (int layer = num_layers - 1; layer >= 0; layer--) {
+    if (size >= radii[layer]) {
+      *r_layer = layer;
+      if (layer < num_layers - 1) {
+        *r_factor = (size - radii[layer]) / (radii[layer + 1] - radii[layer]);
+      }
+      return;
+    }
+  }
+}
+
+/**
+ * Kernel of the bokeh scaled to the given radius, sampled like VariableSizeBokehBlurOperation.
+ * Bokeh channels are stored twice, to convolve the color and the weights.
+ */
+static float *create_kernel(MemoryBuffer *bokeh, float radius, int *r_size)
+{
+  const int extent = max_ii((int)ceilf(radius) - 1, 0);
+  const int size = 2 * extent + 1;
+  float *kernel = (float *)MEM_mallocN(sizeof(float) * size * size * COM_BOKEH_FFT_CHANNELS,
+                                       "VariableSizeBokehBlurFFT kernel");
+  for (int j = 0; j < size; j++) {
+    const float dy = j - extent;
+    for (int i = 0; i < size; i++) {
+      const float dx = i - extent;
+      float *weight = &kernel[(j * size + i) * COM_BOKEH_FFT_CHANNELS];
+      const float uv[2] = {
+          (float)(COM_BLUR_BOKEH_PIXELS / 2) +
+              (dx / radius) * (float)((COM_BLUR_BOKEH_PIXELS / 2) - 1),
+          (float)(COM_BLUR_BOKEH_PIXELS / 2) +
+              (dy / radius) * (float)((COM_BLUR_BOKEH_PIXELS / 2) - 1),
+      };
+      bokeh->read(weight, uv[0], uv[1]);
+      copy_v4_v4(weight + COM_NUM_CHANNELS_COLOR, weight);
+    }
+  }
+  *r_size = size;
+  return kernel;
+}
+
+MemoryBuffer *VariableSizeBokehBlurFFTOperation::createMemoryBuffer(rcti *rect2)
+{
+  MemoryBuffer *color_input = (MemoryBuffer *)this->m_inputProgram->initializeTileData(rect2);
+  MemoryBuffer *bokeh_input = (MemoryBuffer *)this->m_inputBokehProgram->initializeTileData(
+      rect2);
+  MemoryBuffer *size_input = (MemoryBuffer *)this->m_inputSizeProgram->initializeTileData(rect2);
+
+  BLI_assert(bokeh_input->getWidth() == COM_BLUR_BOKEH_PIXELS);
+  BLI_assert(bokeh_input->getHeight() == COM_BLUR_BOKEH_PIXELS);
+
+  const int width = getWidth();
+  const int height = getHeight();
+  const size_t num_pixels = (size_t)width * height;
+  rcti rect;
+  BLI_rcti_init(&rect, 0, width, 0, height);
+  MemoryBuffer *result = new MemoryBuffer(COM_DT_COLOR, &rect);
+  float *output = result->getBuffer();
+
+  const float max_dim = max(width, height);
+  const float scalar = this->m_do_size_scale ? (max_dim / 100.0f) : 1.0f;
+  int maxBlurScalar = (int)(size_input->getMaximumValue() * scalar);
+  CLAMP(maxBlurScalar, 1, this->m_maxBlur);
+
+  /* Radii of the layers, a radius of 1 or less only covers the pixel itself. */
+  const float min_radius = max_ff(this->m_threshold, 1.0f);
+  const float max_radius = maxBlurScalar;
+  int num_layers = 1;
+  float radii[COM_BOKEH_FFT_LAYERS] = {max_radius};
+  if (max_radius > min_radius) {
+    num_layers = min_ii(COM_BOKEH_FFT_LAYERS, (int)ceilf(max_radius - min_radius) + 1);
+    for (int layer = 0; layer < num_layers; layer++) {
+      radii[layer] = min_radius * powf(max_radius / min_radius, layer / (float)(num_layers - 1));
+    }
+  }
+
+  float *colors = (float *)MEM_mallocN(sizeof(float) * num_pixels * COM_NUM_CHANNELS_COLOR,
+                                       "VariableSizeBokehBlurFFT colors");
+  float *sizes = (float *)MEM_mallocN(sizeof(float) * num_pixels,
+                                      "VariableSizeBokehBlurFFT sizes");
+  int *layers = (int *)MEM_mallocN(sizeof(int) * num_pixels, "VariableSizeBokehBlurFFT layers");
+  float *factors = (float *)MEM_mallocN(sizeof(float) * num_pixels,
+                                        "VariableSizeBokehBlurFFT factors");
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      const size_t index = (size_t)y * width + x;
+      float size[4];
+      color_input->read(&colors[index * COM_NUM_CHANNELS_COLOR], x, y);
+      size_input->read(size, x, y);
+      sizes[index] = size[0] * scalar;
+      if (sizes[index] > this->m_threshold) {
+        layer_position(
+            radii, num_layers, min_ff(sizes[index], max_radius), &layers[index], &factors[index]);
+      }
+      else {
+        layers[index] = -1;
+        factors[index] = 0.0f;
+      }
+    }
+  }
+
+  const size_t buffer_len = num_pixels * COM_BOKEH_FFT_CHANNELS;
+  float *image = (float *)MEM_mallocN(sizeof(float) * buffer_len,
+                                      "VariableSizeBokehBlurFFT image");
+  float *convolved = (float *)MEM_mallocN(sizeof(float) * buffer_len,
+                                          "VariableSizeBokehBlurFFT convolved");
+  /* Sum of the layers below the current one, each convolved with its own radius. */
+  float *lower_layers = (float *)MEM_callocN(sizeof(float) * buffer_len,
+                                             "VariableSizeBokehBlurFFT lower layers");
+  float *accum = (float *)MEM_callocN(sizeof(float) * buffer_len,
+                                      "VariableSizeBokehBlurFFT accum");
+
+  for (int layer = 0; layer < num_layers && !isBraked(); layer++) {
+    int kernel_size;
+    float *kernel = create_kernel(bokeh_input, radii[layer], &kernel_size);
+
+    /* Pixels of this layer and all larger ones, blurred with the radius of this layer. */
+    for (size_t index = 0; index < num_pixels; index++) {
+      float weight = 0.0f;
+      if (layers[index] >= layer) {
+        weight = 1.0f;
+      }
+      else if (layers[index] >= 0 && layers[index] + 1 == layer) {
+        weight = factors[index];
+      }
+      float *pixel = &image[index * COM_BOKEH_FFT_CHANNELS];
+      mul_v4_v4fl(pixel, &colors[index * COM_NUM_CHANNELS_COLOR], weight);
+      copy_v4_fl(pixel + COM_NUM_CHANNELS_COLOR, weight);
+    }
+    fft_convolve(convolved,
+                 image,
+                 width,
+                 height,
+                 kernel,
+                 kernel_size,
+                 kernel_size,
+                 COM_BOKEH_FFT_CHANNELS,
+                 COM_BOKEH_FFT_CHANNELS);
+
+    /* Pixels with a size around this layer use it as their result. */
+    for (size_t index = 0; index < num_pixels; index++) {
+      float coefficient = 0.0f;
+      if (layers[index] == layer) {
+        coefficient = 1.0f - factors[index];
+      }
+      else if (layers[index] >= 0 && layers[index] + 1 == layer) {
+        coefficient = factors[index];
+      }
+      if (coefficient == 0.0f) {
+        continue;
+      }
+      for (int c = 0; c < COM_BOKEH_FFT_CHANNELS; c++) {
+        const size_t offset = index * COM_BOKEH_FFT_CHANNELS + c;
+        accum[offset] += coefficient * (lower_layers[offset] + convolved[offset]);
+      }
+    }
+
+    if (layer + 1 < num_layers) {
+      /* Only the pixels of this layer, blurred with its radius. */
+      for (size_t index = 0; index < num_pixels; index++) {
+        float weight = 0.0f;
+        if (layers[index] == layer) {
+          weight = 1.0f - factors[index];
+        }
+        else if (layers[index] >= 0 && layers[index] + 1 == layer) {
+          weight = factors[index];
+        }
+        float *pixel = &image[index * COM_BOKEH_FFT_CHANNELS];
+        mul_v4_v4fl(pixel, &colors[index * COM_NUM_CHANNELS_COLOR], weight);
+        copy_v4_fl(pixel + COM_NUM_CHANNELS_COLOR, weight);
+      }
+      fft_convolve(convolved,
+                   image,
+                   width,
+                   height,
+                   kernel,
+                   kernel_size,
+                   kernel_size,
+                   COM_BOKEH_FFT_CHANNELS,
+                   COM_BOKEH_FFT_CHANNELS);
+      for (size_t offset = 0; offset < buffer_len; offset++) {
+        lower_layers[offset] += convolved[offset];
+      }
+    }
+
+    MEM_freeN(kernel);
+  }
+
+  /* The pixel itself is weighted by the center of the bokeh in every layer, but should only
+   * count once with a weight of one. */
+  float center_weight[4];
+  bokeh_input->read(
+      center_weight, (float)(COM_BLUR_BOKEH_PIXELS / 2), (float)(COM_BLUR_BOKEH_PIXELS / 2));
+
+  for (size_t index = 0; index < num_pixels; index++) {
+    const float *color = &colors[index * COM_NUM_CHANNELS_COLOR];
+    const float *color_accum = &accum[index * COM_BOKEH_FFT_CHANNELS];
+    const float *multiplier_accum = color_accum + COM_NUM_CHANNELS_COLOR;
+    float *out = &output[index * COM_NUM_CHANNELS_COLOR];
+    const float size_center = sizes[index];
+
+    if (layers[index] < 0) {
+      copy_v4_v4(out, color);
+    }
+    else {
+      for (int c = 0; c < COM_NUM_CHANNELS_COLOR; c++) {
+        out[c] = (color_accum[c] + (1.0f - center_weight[c]) * color[c]) /
+                 (multiplier_accum[c] + 1.0f - center_weight[c]);
+      }
+    }
+
+    /* blend in out values over the threshold, otherwise we get sharp, ugly transitions */
+    if ((size_center > this->m_threshold) && (size_center < this->m_threshold * 2.0f)) {
+      /* factor from 0-1 */
+      float fac = (size_center - this->m_threshold) / this->m_threshold;
+      interp_v4_v4v4(out, color, out, fac);
+    }
+  }
+
+  MEM_freeN(accum);
+  MEM_freeN(lower_layers);
+  MEM_freeN(convolved);
+  MEM_freeN(image);
+  MEM_freeN(factors);
+  MEM_freeN(layers);
+  MEM_freeN(sizes);
+  MEM_freeN(colors);
+  return result;
+}
+
+bool VariableSizeBokehBlurFFTOperation::determineDependingAreaOfInterest(
+    rcti * /*input*/, ReadBufferOperation *readOperation, rcti *output)
+{
+  if (isCached()) {
+    return false;
+  }
+
+  rcti newInput;
+  BLI_rcti_init(&newInput, 0, this->getWidth(), 0, this->getHeight());
+  rcti bokehInput;
+  BLI_rcti_init(&bokehInput, 0, COM_BLUR_BOKEH_PIXELS, 0, COM_BLUR_BOKEH_PIXELS);
+
+  NodeOperation *operation = getInputOperation(2);
+  if (operation->determineDependingAreaOfInterest(&newInput, readOperation, output)) {
+    return true;
+  }
+  operation = getInputOperation(1);
+  if (operation->determineDependingAreaOfInterest(&bokehInput, readOperation, output)) {
+    return true;
+  }
+  operation = getInputOperation(0);
+  if (operation->determineDependingAreaOfInterest(&newInput, readOperation, output)) {
+    return true;
+  }
+  return false;
+}
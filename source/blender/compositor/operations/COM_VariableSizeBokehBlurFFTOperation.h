@@ -0,0 +1,71 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#pragma once
+
+#include "COM_SingleThreadedOperation.h"
+
+/**
+ * \brief Approximation of VariableSizeBokehBlurOperation using FFT convolutions.
+ *
+ * The blur sizes are sliced into layers of increasing radius. Every pixel is spread over the two
+ * layers around its size, and each layer is convolved with the bokeh scaled to its radius. Like
+ * in the brute-force blur a pixel is only blurred by neighbors with at least its own size using
+ * its own size, which is the sum of the layers below its size plus all pixels of larger sizes
+ * convolved at its layer. The result is interpolated between the two layers around its size.
+ *
+ * The cost depends on the number of layers instead of the blur size, the difference to the
+ * brute-force result comes from quantizing the sizes.
+ * Has the same sockets as VariableSizeBokehBlurOperation.
+ */
+class VariableSizeBokehBlurFFTOperation : public SingleThreadedOperation {
+ private:
+  int m_maxBlur;
+  float m_threshold;
+  bool m_do_size_scale; /* scale size, matching 'BokehBlurNode' */
+  SocketReader *m_inputProgram;
+  SocketReader *m_inputBokehProgram;
+  SocketReader *m_inputSizeProgram;
+
+ public:
+  VariableSizeBokehBlurFFTOperation();
+
+  void initExecution();
+  void deinitExecution();
+
+  MemoryBuffer *createMemoryBuffer(rcti *rect);
+
+  bool determineDependingAreaOfInterest(rcti *input,
+                                        ReadBufferOperation *readOperation,
+                                        rcti *output);
+
+  void setMaxBlur(int maxRadius)
+  {
+    this->m_maxBlur = maxRadius;
+  }
+
+  void setThreshold(float threshold)
+  {
+    this->m_threshold = threshold;
+  }
+
+  void setDoScaleSize(bool scale_size)
+  {
+    this->m_do_size_scale = scale_size;
+  }
+};
@@ -17,6 +17,7 @@
  */
 
 #include "COM_WriteBufferOperation.h"
+#include "COM_MemoryPager.h"
 #include "COM_OpenCLDevice.h"
 #include "COM_defines.h"
 #include <cstdio>
@@ -56,11 +57,16 @@ void WriteBufferOperation::deinitExecution()
   this->m_memoryProxy->free();
 }
 
-void WriteBufferOperation::executeRegion(rcti *rect, unsigned int /*tileNumber*/)
+void WriteBufferOperation::executeRegion(rcti *rect, unsigned int tileNumber)
 {
-  MemoryBuffer *memoryBuffer = this->m_memoryProxy->getBuffer();
+  MemoryPager *pager = this->m_memoryProxy->get_pager();
+  /* Paged buffers are written to a buffer of the chunk, which is then stored by the pager. */
+  MemoryBuffer *memoryBuffer = pager ? new MemoryBuffer(this->m_memoryProxy, rect) :
+                                       this->m_memoryProxy->getBuffer();
   float *buffer = memoryBuffer->getBuffer();
   const int num_channels = memoryBuffer->get_num_channels();
+  const int buffer_xmin = memoryBuffer->getRect()->xmin;
+  const int buffer_ymin = memoryBuffer->getRect()->ymin;
   if (this->m_input->isComplex()) {
     void *data = this->m_input->initializeTileData(rect);
     int x1 = rect->xmin;
@@ -71,7 +77,8 @@ void WriteBufferOperation::executeRegion(rcti *rect, unsigned int /*tileNumber*/
     int y;
     bool breaked = false;
     for (y = y1; y < y2 && (!breaked); y++) {
-      int offset4 = (y * memoryBuffer->getWidth() + x1) * num_channels;
+      int offset4 = ((y - buffer_ymin) * memoryBuffer->getWidth() + x1 - buffer_xmin) *
+                    num_channels;
       for (x = x1; x < x2; x++) {
         this->m_input->read(&(buffer[offset4]), x, y, data);
         offset4 += num_channels;
@@ -95,7 +102,8 @@ void WriteBufferOperation::executeRegion(rcti *rect, unsigned int /*tileNumber*/
     int y;
     bool breaked = false;
     for (y = y1; y < y2 && (!breaked); y++) {
-      int offset4 = (y * memoryBuffer->getWidth() + x1) * num_channels;
+      int offset4 = ((y - buffer_ymin) * memoryBuffer->getWidth() + x1 - buffer_xmin) *
+                    num_channels;
       for (x = x1; x < x2; x++) {
         this->m_input->readSampled(&(buffer[offset4]), x, y, COM_PS_NEAREST);
         offset4 += num_channels;
@@ -106,11 +114,16 @@ void WriteBufferOperation::executeRegion(rcti *rect, unsigned int /*tileNumber*/
     }
   }
   memoryBuffer->setCreatedState();
+
+  if (pager) {
+    pager->store_chunk(this->m_memoryProxy, tileNumber, memoryBuffer);
+    delete memoryBuffer;
+  }
 }
 
 void WriteBufferOperation::executeOpenCLRegion(OpenCLDevice *device,
                                                rcti * /*rect*/,
-                                               unsigned int /*chunkNumber*/,
+                                               unsigned int chunkNumber,
                                                MemoryBuffer **inputMemoryBuffers,
                                                MemoryBuffer *outputBuffer)
 {
@@ -181,7 +194,13 @@ void WriteBufferOperation::executeOpenCLRegion(OpenCLDevice *device,
     printf("CLERROR[%d]: %s\n", error, clewErrorString(error));
   }
 
-  this->getMemoryProxy()->getBuffer()->copyContentFrom(outputBuffer);
+  MemoryPager *pager = this->m_memoryProxy->get_pager();
+  if (pager) {
+    pager->store_chunk(this->m_memoryProxy, chunkNumber, outputBuffer);
+  }
+  else {
+    this->getMemoryProxy()->getBuffer()->copyContentFrom(outputBuffer);
+  }
 
   // STEP 4
   while (!clMemToCleanUp->empty()) {
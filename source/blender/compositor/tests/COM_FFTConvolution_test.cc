@@ -0,0 +1,139 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "BLI_array.hh"
+#include "BLI_rand.hh"
+
+#include "COM_FFTConvolution.h"
+
+namespace blender::compositor::tests {
+
+static void fill_random(Array<float> &values, RandomNumberGenerator &rng)
+{
+  for (float &value : values) {
+    value = rng.get_float() * 2.0f - 1.0f;
+  }
+}
+
+/* Convolution by summing the products of all image and kernel pixels, with the same conventions
+ * as #fft_convolve: kernel pixel (kx, ky) weights the image pixel
+ * (x - kx + kernel_width / 2, y - ky + kernel_height / 2). */
+static void direct_convolve(float *dst,
+                            const float *image,
+                            const int width,
+                            const int height,
+                            const float *kernel,
+                            const int kernel_width,
+                            const int kernel_height,
+                            const int stride,
+                            const int num_channels)
+{
+  const int center_x = kernel_width / 2;
+  const int center_y = kernel_height / 2;
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      for (int c = 0; c < num_channels; c++) {
+        double sum = 0.0;
+        for (int ky = 0; ky < kernel_height; ky++) {
+          const int iy = y - ky + center_y;
+          if (iy < 0 || iy >= height) {
+            continue;
+          }
+          for (int kx = 0; kx < kernel_width; kx++) {
+            const int ix = x - kx + center_x;
+            if (ix < 0 || ix >= width) {
+              continue;
+            }
+            sum += (double)image[(iy * width + ix) * stride + c] *
+                   (double)kernel[(ky * kernel_width + kx) * stride + c];
+          }
+        }
+        dst[(y * width + x) * stride + c] = (float)sum;
+      }
+    }
+  }
+}
+
+static void test_fft_convolve(const int width,
+                              const int height,
+                              const int kernel_width,
+                              const int kernel_height,
+                              const int stride,
+                              const int num_channels)
+{
+  RandomNumberGenerator rng(width * 7919 + height * 104729 + kernel_width * 31 + kernel_height);
+
+  Array<float> image(width * height * stride);
+  Array<float> kernel(kernel_width * kernel_height * stride);
+  fill_random(image, rng);
+  fill_random(kernel, rng);
+
+  /* Channels that are not convolved must be left untouched. */
+  const float unused = 12345.0f;
+  Array<float> expected(image.size(), unused);
+  Array<float> result(image.size(), unused);
+
+  direct_convolve(expected.data(),
+                  image.data(),
+                  width,
+                  height,
+                  kernel.data(),
+                  kernel_width,
+                  kernel_height,
+                  stride,
+                  num_channels);
+  fft_convolve(result.data(),
+               image.data(),
+               width,
+               height,
+               kernel.data(),
+               kernel_width,
+               kernel_height,
+               stride,
+               num_channels);
+
+  /* The sums have up to a few hundred terms in [-1, 1]. */
+  const float epsilon = 1e-3f;
+  for (const int64_t i : image.index_range()) {
+    EXPECT_NEAR(result[i], expected[i], epsilon) << "at index " << i;
+  }
+}
+
+TEST(fft_convolution, SinglePixelKernel)
+{
+  test_fft_convolve(16, 16, 1, 1, 1, 1);
+}
+
+TEST(fft_convolution, OddKernel)
+{
+  test_fft_convolve(37, 23, 9, 7, 1, 1);
+}
+
+TEST(fft_convolution, EvenKernel)
+{
+  test_fft_convolve(29, 31, 8, 6, 1, 1);
+}
+
+TEST(fft_convolution, KernelLargerThanImage)
+{
+  test_fft_convolve(11, 9, 21, 17, 1, 1);
+}
+
+TEST(fft_convolution, MultipleBlocks)
+{
+  /* Large enough to be split into several blocks that overlap when added. */
+  test_fft_convolve(150, 97, 15, 13, 1, 1);
+}
+
+TEST(fft_convolution, ColorChannels)
+{
+  test_fft_convolve(33, 27, 11, 9, 4, 3);
+}
+
+TEST(fft_convolution, AllChannels)
+{
+  test_fft_convolve(20, 18, 5, 5, 4, 4);
+}
+
+}  // namespace blender::compositor::tests
@@ -163,7 +163,7 @@ static int voxel_remesh_exec(bContext *C, wmOperator *op)
 
   if (mesh->flag & ME_REMESH_REPROJECT_VOLUME || mesh->flag & ME_REMESH_REPROJECT_PAINT_MASK ||
       mesh->flag & ME_REMESH_REPROJECT_SCULPT_FACE_SETS) {
-    BKE_mesh_runtime_clear_geometry(mesh);
+    BKE_mesh_runtime_tag_dirty(mesh, ME_RUNTIME_DIRTY_POSITIONS);
   }
 
   if (mesh->flag & ME_REMESH_REPROJECT_VOLUME) {
@@ -179,7 +179,7 @@ static int voxel_remesh_exec(bContext *C, wmOperator *op)
   }
 
   if (mesh->flag & ME_REMESH_REPROJECT_VERTEX_COLORS) {
-    BKE_mesh_runtime_clear_geometry(mesh);
+    BKE_mesh_runtime_tag_dirty(mesh, ME_RUNTIME_DIRTY_POSITIONS);
     BKE_remesh_reproject_vertex_paint(new_mesh, mesh);
   }
 
@@ -878,7 +878,7 @@ static void quadriflow_start_job(void *customdata, short *stop, short *do_update
   }
 
   if (qj->preserve_paint_mask) {
-    BKE_mesh_runtime_clear_geometry(mesh);
+    BKE_mesh_runtime_tag_dirty(mesh, ME_RUNTIME_DIRTY_POSITIONS);
     BKE_mesh_remesh_reproject_paint_mask(new_mesh, mesh);
   }
 
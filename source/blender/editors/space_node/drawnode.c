@@ -1505,6 +1505,7 @@ static void node_composit_buts_defocus(uiLayout *layout, bContext *C, PointerRNA
   uiItemR(col, ptr, "angle", DEFAULT_FLAGS, NULL, ICON_NONE);
 
   uiItemR(layout, ptr, "use_gamma_correction", DEFAULT_FLAGS, NULL, ICON_NONE);
+  uiItemR(layout, ptr, "use_fft", DEFAULT_FLAGS, NULL, ICON_NONE);
 
   col = uiLayoutColumn(layout, false);
   uiLayoutSetActive(col, RNA_boolean_get(ptr, "use_zbuffer") == true);
@@ -2381,6 +2382,7 @@ static void node_composit_buts_bokehblur(uiLayout *layout, bContext *UNUSED(C),
   // uiItemR(layout, ptr, "f_stop", DEFAULT_FLAGS, NULL, ICON_NONE); /* UNUSED */
   uiItemR(layout, ptr, "blur_max", DEFAULT_FLAGS, NULL, ICON_NONE);
   uiItemR(layout, ptr, "use_extended_bounds", DEFAULT_FLAGS, NULL, ICON_NONE);
+  uiItemR(layout, ptr, "use_fft", DEFAULT_FLAGS, NULL, ICON_NONE);
 }
 
 static void node_composit_backdrop_viewer(
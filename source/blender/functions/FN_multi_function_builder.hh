@@ -23,11 +23,76 @@
  */
 
 #include <functional>
+#include <type_traits>
 
 #include "FN_multi_function.hh"
 
 namespace blender::fn {
 
+namespace multi_function_builder_detail {
+
+template<typename T> struct SingleElementAccessor {
+  const T &value;
+
+  const T &operator[](const int64_t UNUSED(index)) const
+  {
+    return value;
+  }
+};
+
+template<typename T> struct ArrayAccessor {
+  const T *data;
+
+  const T &operator[](const int64_t index) const
+  {
+    return data[index];
+  }
+};
+
+/**
+ * Call \a fn with an object that gives access to the elements of the virtual span. When the span
+ * is a single value or an array, the accessor does not check the category of the span for every
+ * element, so that the loop in \a fn can be inlined and vectorized. This is only done for trivial
+ * types like float, float3 and int, to limit the number of generated code paths.
+ */
+template<typename T, typename Fn> inline void devirtualize_vspan(const VSpan<T> &span, const Fn &fn)
+{
+  if constexpr (std::is_trivial_v<T>) {
+    if (span.is_single_element()) {
+      fn(SingleElementAccessor<T>{span.as_single_element()});
+      return;
+    }
+    if (span.is_full_array()) {
+      fn(ArrayAccessor<T>{span.as_full_array().data()});
+      return;
+    }
+  }
+  fn(span);
+}
+
+/**
+ * Like #IndexMask::foreach_index, but the loop over a range uses plain integers, which helps the
+ * compiler to vectorize it.
+ */
+template<typename Fn> inline void foreach_index_in_mask(const IndexMask mask, const Fn &fn)
+{
+  if (mask.is_range()) {
+    const IndexRange range = mask.as_range();
+    const int64_t start = range.start();
+    const int64_t end = range.one_after_last();
+    for (int64_t i = start; i < end; i++) {
+      fn(i);
+    }
+  }
+  else {
+    for (const int64_t i : mask.indices()) {
+      fn(i);
+    }
+  }
+}
+
+}  // namespace multi_function_builder_detail
+
 /**
  * Generates a multi-function with the following parameters:
  * 1. single input (SI) of type In1
@@ -57,9 +122,14 @@ template<typename In1, typename Out1> class CustomMF_SI_SO : public MultiFunctio
 
   template<typename ElementFuncT> static FunctionT create_function(ElementFuncT element_fn)
   {
+    using namespace multi_function_builder_detail;
     return [=](IndexMask mask, VSpan<In1> in1, MutableSpan<Out1> out1) {
-      mask.foreach_index(
-          [&](int i) { new (static_cast<void *>(&out1[i])) Out1(element_fn(in1[i])); });
+      Out1 *out1_data = out1.data();
+      devirtualize_vspan(in1, [&](const auto &in1_elements) {
+        foreach_index_in_mask(mask, [&](const int64_t i) {
+          new (static_cast<void *>(out1_data + i)) Out1(element_fn(in1_elements[i]));
+        });
+      });
     };
   }
 
@@ -100,9 +170,17 @@ class CustomMF_SI_SI_SO : public MultiFunction {
 
   template<typename ElementFuncT> static FunctionT create_function(ElementFuncT element_fn)
   {
+    using namespace multi_function_builder_detail;
     return [=](IndexMask mask, VSpan<In1> in1, VSpan<In2> in2, MutableSpan<Out1> out1) {
-      mask.foreach_index(
-          [&](int i) { new (static_cast<void *>(&out1[i])) Out1(element_fn(in1[i], in2[i])); });
+      Out1 *out1_data = out1.data();
+      devirtualize_vspan(in1, [&](const auto &in1_elements) {
+        devirtualize_vspan(in2, [&](const auto &in2_elements) {
+          foreach_index_in_mask(mask, [&](const int64_t i) {
+            new (static_cast<void *>(out1_data + i))
+                Out1(element_fn(in1_elements[i], in2_elements[i]));
+          });
+        });
+      });
     };
   }
 
@@ -147,13 +225,22 @@ class CustomMF_SI_SI_SI_SO : public MultiFunction {
 
   template<typename ElementFuncT> static FunctionT create_function(ElementFuncT element_fn)
   {
+    using namespace multi_function_builder_detail;
     return [=](IndexMask mask,
                VSpan<In1> in1,
                VSpan<In2> in2,
                VSpan<In3> in3,
                MutableSpan<Out1> out1) {
-      mask.foreach_index([&](int i) {
-        new (static_cast<void *>(&out1[i])) Out1(element_fn(in1[i], in2[i], in3[i]));
+      Out1 *out1_data = out1.data();
+      devirtualize_vspan(in1, [&](const auto &in1_elements) {
+        devirtualize_vspan(in2, [&](const auto &in2_elements) {
+          devirtualize_vspan(in3, [&](const auto &in3_elements) {
+            foreach_index_in_mask(mask, [&](const int64_t i) {
+              new (static_cast<void *>(out1_data + i))
+                  Out1(element_fn(in1_elements[i], in2_elements[i], in3_elements[i]));
+            });
+          });
+        });
       });
     };
   }
@@ -192,8 +279,10 @@ template<typename Mut1> class CustomMF_SM : public MultiFunction {
 
   template<typename ElementFuncT> static FunctionT create_function(ElementFuncT element_fn)
   {
+    using namespace multi_function_builder_detail;
     return [=](IndexMask mask, MutableSpan<Mut1> mut1) {
-      mask.foreach_index([&](int i) { element_fn(mut1[i]); });
+      Mut1 *mut1_data = mut1.data();
+      foreach_index_in_mask(mask, [&](const int64_t i) { element_fn(mut1_data[i]); });
     };
   }
 
@@ -219,12 +308,16 @@ template<typename From, typename To> class CustomMF_Convert : public MultiFuncti
 
   void call(IndexMask mask, MFParams params, MFContext UNUSED(context)) const override
   {
+    using namespace multi_function_builder_detail;
     VSpan<From> inputs = params.readonly_single_input<From>(0);
     MutableSpan<To> outputs = params.uninitialized_single_output<To>(1);
+    To *outputs_data = outputs.data();
 
-    for (int64_t i : mask) {
-      new (static_cast<void *>(&outputs[i])) To(inputs[i]);
-    }
+    devirtualize_vspan(inputs, [&](const auto &input_elements) {
+      foreach_index_in_mask(mask, [&](const int64_t i) {
+        new (static_cast<void *>(outputs_data + i)) To(input_elements[i]);
+      });
+    });
   }
 };
 
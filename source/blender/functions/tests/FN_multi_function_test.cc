@@ -2,6 +2,8 @@
 
 #include "testing/testing.h"
 
+#include "BLI_timeit.hh"
+
 #include "FN_multi_function.hh"
 #include "FN_multi_function_builder.hh"
 
@@ -249,6 +251,29 @@ TEST(multi_function, CustomMF_SI_SI_SO)
   EXPECT_EQ(outputs[3], 90);
 }
 
+TEST(multi_function, CustomMF_SI_SI_SO_Range)
+{
+  CustomMF_SI_SI_SO<float, float, float> fn("add", [](float a, float b) { return a + b; });
+
+  Array<float> values_a = {1.0f, 2.0f, 3.0f, 4.0f};
+  float value_b = 0.5f;
+  Array<float> outputs(values_a.size(), -1.0f);
+
+  MFParamsBuilder params(fn, values_a.size());
+  params.add_readonly_single_input(values_a.as_span());
+  params.add_readonly_single_input(&value_b);
+  params.add_uninitialized_single_output(outputs.as_mutable_span());
+
+  MFContextBuilder context;
+
+  fn.call(IndexRange(1, 3), params, context);
+
+  EXPECT_EQ(outputs[0], -1.0f);
+  EXPECT_EQ(outputs[1], 2.5f);
+  EXPECT_EQ(outputs[2], 3.5f);
+  EXPECT_EQ(outputs[3], 4.5f);
+}
+
 TEST(multi_function, CustomMF_SI_SI_SI_SO)
 {
   CustomMF_SI_SI_SI_SO<int, std::string, bool, uint> fn{
@@ -296,6 +321,49 @@ TEST(multi_function, CustomMF_SM)
   EXPECT_EQ(values[4], "e");
 }
 
+/**
+ * Set this to 1 to activate the benchmark. It compares the builder functions to a loop that
+ * accesses every element through the virtual span, as they did before.
+ */
+#if 0
+static void add_elementwise_reference(IndexMask mask,
+                                      VSpan<float> in1,
+                                      VSpan<float> in2,
+                                      MutableSpan<float> out1)
+{
+  mask.foreach_index([&](int i) { new (static_cast<void *>(&out1[i])) float(in1[i] + in2[i]); });
+}
+
+TEST(multi_function, CustomMF_SI_SI_SO_Benchmark)
+{
+  const int64_t size = 10000000;
+  Array<float> values_a(size, 1.0f);
+  const float value_b = 2.0f;
+  Array<float> outputs(size);
+
+  using ReferenceFunctionT =
+      std::function<void(IndexMask, VSpan<float>, VSpan<float>, MutableSpan<float>)>;
+  CustomMF_SI_SI_SO<float, float, float> reference_fn(
+      "add reference", ReferenceFunctionT(add_elementwise_reference));
+  CustomMF_SI_SI_SO<float, float, float> fn("add", [](float a, float b) { return a + b; });
+
+  for (int i = 0; i < 3; i++) {
+    for (const MultiFunction *function : {(MultiFunction *)&reference_fn, (MultiFunction *)&fn}) {
+      MFParamsBuilder params(*function, size);
+      params.add_readonly_single_input(values_a.as_span());
+      params.add_readonly_single_input(&value_b);
+      params.add_uninitialized_single_output(outputs.as_mutable_span());
+      MFContextBuilder context;
+
+      SCOPED_TIMER(function->name());
+      function->call(IndexRange(size), params, context);
+    }
+  }
+  /* Print the value for simple error checking and to avoid some compiler optimizations. */
+  std::cout << "Value: " << outputs[size / 2] << "\n";
+}
+#endif
+
 TEST(multi_function, CustomMF_Constant)
 {
   CustomMF_Constant<int> fn{42};
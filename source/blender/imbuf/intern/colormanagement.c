@@ -1728,13 +1728,7 @@ static void *do_display_buffer_apply_thread(void *handle_v)
       memcpy(display_buffer, linear_buffer, ((size_t)width) * height * channels * sizeof(float));
 
       if (is_straight_alpha && channels == 4) {
-        const size_t i_last = ((size_t)width) * height;
-        size_t i;
-        float *fp;
-
-        for (i = 0, fp = display_buffer; i != i_last; i++, fp += channels) {
-          straight_to_premul_v4(fp);
-        }
+        IMB_buffer_float_premultiply(display_buffer, width, height);
       }
     }
 
@@ -2368,13 +2362,9 @@ void IMB_colormanagement_imbuf_to_float_texture(float *out_buffer,
     }
     else if (in_channels == 4) {
       /* Copy or convert RGBA. */
+      memcpy(out, in, sizeof(float[4]) * width);
       if (use_unpremultiply) {
-        for (int x = 0; x < width; x++, in += 4, out += 4) {
-          premul_to_straight_v4_v4(out, in);
-        }
-      }
-      else {
-        memcpy(out, in, sizeof(float[4]) * width);
+        premul_to_straight_rgba_row(out, width);
       }
     }
   }
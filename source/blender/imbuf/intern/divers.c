@@ -64,33 +64,11 @@ static void clear_dither_context(DitherContext *di)
 /** \name Generic Buffer Conversion
  * \{ */
 
-MINLINE void ushort_to_byte_v4(uchar b[4], const unsigned short us[4])
-{
-  b[0] = unit_ushort_to_uchar(us[0]);
-  b[1] = unit_ushort_to_uchar(us[1]);
-  b[2] = unit_ushort_to_uchar(us[2]);
-  b[3] = unit_ushort_to_uchar(us[3]);
-}
-
 MINLINE unsigned char ftochar(float value)
 {
   return unit_float_to_uchar_clamp(value);
 }
 
-MINLINE void ushort_to_byte_dither_v4(
-    uchar b[4], const unsigned short us[4], DitherContext *di, float s, float t)
-{
-#define USHORTTOFLOAT(val) ((float)val / 65535.0f)
-  float dither_value = dither_random_value(s, t) * 0.0033f * di->dither;
-
-  b[0] = ftochar(dither_value + USHORTTOFLOAT(us[0]));
-  b[1] = ftochar(dither_value + USHORTTOFLOAT(us[1]));
-  b[2] = ftochar(dither_value + USHORTTOFLOAT(us[2]));
-  b[3] = unit_ushort_to_uchar(us[3]);
-
-#undef USHORTTOFLOAT
-}
-
 MINLINE void float_to_byte_dither_v4(
     uchar b[4], const float f[4], DitherContext *di, float s, float t)
 {
@@ -182,63 +160,12 @@ void IMB_buffer_byte_from_float(uchar *rect_to,
       uchar *to = rect_to + ((size_t)stride_to) * y * 4;
 
       if (profile_to == profile_from) {
-        float straight[4];
-
         /* no color space conversion */
-        if (dither && predivide) {
-          for (x = 0; x < width; x++, from += 4, to += 4) {
-            premul_to_straight_v4_v4(straight, from);
-            float_to_byte_dither_v4(to, straight, di, (float)x * inv_width, t);
-          }
-        }
-        else if (dither) {
-          for (x = 0; x < width; x++, from += 4, to += 4) {
-            float_to_byte_dither_v4(to, from, di, (float)x * inv_width, t);
-          }
-        }
-        else if (predivide) {
-          for (x = 0; x < width; x++, from += 4, to += 4) {
-            premul_to_straight_v4_v4(straight, from);
-            rgba_float_to_uchar(to, straight);
-          }
-        }
-        else {
-          for (x = 0; x < width; x++, from += 4, to += 4) {
-            rgba_float_to_uchar(to, from);
-          }
-        }
+        rgba_float_to_uchar_row(to, from, width, predivide, dither, inv_width, t);
       }
       else if (profile_to == IB_PROFILE_SRGB) {
         /* convert from linear to sRGB */
-        unsigned short us[4];
-        float straight[4];
-
-        if (dither && predivide) {
-          for (x = 0; x < width; x++, from += 4, to += 4) {
-            premul_to_straight_v4_v4(straight, from);
-            linearrgb_to_srgb_ushort4(us, from);
-            ushort_to_byte_dither_v4(to, us, di, (float)x * inv_width, t);
-          }
-        }
-        else if (dither) {
-          for (x = 0; x < width; x++, from += 4, to += 4) {
-            linearrgb_to_srgb_ushort4(us, from);
-            ushort_to_byte_dither_v4(to, us, di, (float)x * inv_width, t);
-          }
-        }
-        else if (predivide) {
-          for (x = 0; x < width; x++, from += 4, to += 4) {
-            premul_to_straight_v4_v4(straight, from);
-            linearrgb_to_srgb_ushort4(us, from);
-            ushort_to_byte_v4(to, us);
-          }
-        }
-        else {
-          for (x = 0; x < width; x++, from += 4, to += 4) {
-            linearrgb_to_srgb_ushort4(us, from);
-            ushort_to_byte_v4(to, us);
-          }
-        }
+        linearrgb_to_srgb_uchar4_row(to, from, width, predivide, dither, inv_width, t);
       }
       else if (profile_to == IB_PROFILE_LINEAR_RGB) {
         /* convert from sRGB to linear */
@@ -860,21 +787,15 @@ void IMB_color_to_bw(ImBuf *ibuf)
 
 void IMB_buffer_float_unpremultiply(float *buf, int width, int height)
 {
-  size_t total = ((size_t)width) * height;
-  float *fp = buf;
-  while (total--) {
-    premul_to_straight_v4(fp);
-    fp += 4;
+  for (int y = 0; y < height; y++) {
+    premul_to_straight_rgba_row(buf + ((size_t)width) * y * 4, width);
   }
 }
 
 void IMB_buffer_float_premultiply(float *buf, int width, int height)
 {
-  size_t total = ((size_t)width) * height;
-  float *fp = buf;
-  while (total--) {
-    straight_to_premul_v4(fp);
-    fp += 4;
+  for (int y = 0; y < height; y++) {
+    straight_to_premul_rgba_row(buf + ((size_t)width) * y * 4, width);
   }
 }
 
@@ -27,6 +27,7 @@
 #include "MEM_guardedalloc.h"
 
 #include "BLI_math_base.h"
+#include "BLI_math_color.h"
 #include "BLI_utildefines.h"
 
 #include "IMB_filter.h"
@@ -668,18 +669,9 @@ void IMB_premultiply_rect(unsigned int *rect, char planes, int w, int h)
 
 void IMB_premultiply_rect_float(float *rect_float, int channels, int w, int h)
 {
-  float val, *cp;
-  int x, y;
-
   if (channels == 4) {
-    cp = rect_float;
-    for (y = 0; y < h; y++) {
-      for (x = 0; x < w; x++, cp += 4) {
-        val = cp[3];
-        cp[0] = cp[0] * val;
-        cp[1] = cp[1] * val;
-        cp[2] = cp[2] * val;
-      }
+    for (int y = 0; y < h; y++) {
+      straight_to_premul_rgba_row(rect_float + ((size_t)w) * y * 4, w);
     }
   }
 }
@@ -730,18 +722,9 @@ void IMB_unpremultiply_rect(unsigned int *rect, char planes, int w, int h)
 
 void IMB_unpremultiply_rect_float(float *rect_float, int channels, int w, int h)
 {
-  float val, *fp;
-  int x, y;
-
   if (channels == 4) {
-    fp = rect_float;
-    for (y = 0; y < h; y++) {
-      for (x = 0; x < w; x++, fp += 4) {
-        val = fp[3] != 0.0f ? 1.0f / fp[3] : 1.0f;
-        fp[0] = fp[0] * val;
-        fp[1] = fp[1] * val;
-        fp[2] = fp[2] * val;
-      }
+    for (int y = 0; y < h; y++) {
+      premul_to_straight_rgba_row(rect_float + ((size_t)w) * y * 4, w);
     }
   }
 }
@@ -78,6 +78,7 @@ _CRTIMP void __cdecl _invalid_parameter_noinfo(void)
 }
 #include "BLI_blenlib.h"
 #include "BLI_math_color.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 
 #include "BKE_idprop.h"
@@ -407,6 +408,48 @@ static void openexr_header_metadata_callback(void *data,
   header->insert(propname, StringAttribute(prop));
 }
 
+struct ExrHalfSaveData {
+  const ImBuf *ibuf;
+  RGBAZ *pixels;
+};
+
+static void imb_save_openexr_half_row_cb(void *__restrict userdata,
+                                         const int y,
+                                         const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const ExrHalfSaveData *data = (const ExrHalfSaveData *)userdata;
+  const ImBuf *ibuf = data->ibuf;
+  const int channels = ibuf->channels;
+  const int width = ibuf->x;
+  /* The file starts with the top scanline. */
+  RGBAZ *to = data->pixels + (size_t)(ibuf->y - 1 - y) * width;
+
+  if (ibuf->rect_float) {
+    const float *from = ibuf->rect_float + (size_t)channels * y * width;
+
+    for (int j = width; j > 0; j--) {
+      to->r = from[0];
+      to->g = (channels >= 2) ? from[1] : from[0];
+      to->b = (channels >= 3) ? from[2] : from[0];
+      to->a = (channels >= 4) ? from[3] : 1.0f;
+      to++;
+      from += channels;
+    }
+  }
+  else {
+    const unsigned char *from = (const unsigned char *)ibuf->rect + (size_t)4 * y * width;
+
+    for (int j = width; j > 0; j--) {
+      to->r = srgb_to_linearrgb((float)from[0] / 255.0f);
+      to->g = srgb_to_linearrgb((float)from[1] / 255.0f);
+      to->b = srgb_to_linearrgb((float)from[2] / 255.0f);
+      to->a = channels >= 4 ? (float)from[3] / 255.0f : 1.0f;
+      to++;
+      from += 4;
+    }
+  }
+}
+
 static bool imb_save_openexr_half(ImBuf *ibuf, const char *name, const int flags)
 {
   const int channels = ibuf->channels;
@@ -465,38 +508,11 @@ static bool imb_save_openexr_half(ImBuf *ibuf, const char *name, const int flags
                                sizeof(float),
                                sizeof(float) * -width));
     }
-    if (ibuf->rect_float) {
-      float *from;
-
-      for (int i = ibuf->y - 1; i >= 0; i--) {
-        from = ibuf->rect_float + channels * i * width;
-
-        for (int j = ibuf->x; j > 0; j--) {
-          to->r = from[0];
-          to->g = (channels >= 2) ? from[1] : from[0];
-          to->b = (channels >= 3) ? from[2] : from[0];
-          to->a = (channels >= 4) ? from[3] : 1.0f;
-          to++;
-          from += channels;
-        }
-      }
-    }
-    else {
-      unsigned char *from;
-
-      for (int i = ibuf->y - 1; i >= 0; i--) {
-        from = (unsigned char *)ibuf->rect + 4 * i * width;
-
-        for (int j = ibuf->x; j > 0; j--) {
-          to->r = srgb_to_linearrgb((float)from[0] / 255.0f);
-          to->g = srgb_to_linearrgb((float)from[1] / 255.0f);
-          to->b = srgb_to_linearrgb((float)from[2] / 255.0f);
-          to->a = channels >= 4 ? (float)from[3] / 255.0f : 1.0f;
-          to++;
-          from += 4;
-        }
-      }
-    }
+    /* Convert in threads, OpenEXR only threads the compression of the scanlines. */
+    ExrHalfSaveData save_data = {ibuf, to};
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    BLI_task_parallel_range(0, height, &save_data, imb_save_openexr_half_row_cb, &settings);
 
     exr_printf("OpenEXR-save: Writing OpenEXR file of height %d.\n", height);
 
@@ -1093,6 +1109,34 @@ void IMB_exr_clear_channels(void *handle)
   BLI_freelistN(&data->channels);
 }
 
+/* Channel of a multilayer file which is stored as half float. */
+struct ExrHalfChannel {
+  const float *rect;
+  int xstride;
+  half *rect_half;
+};
+
+struct ExrHalfConvertData {
+  std::vector<ExrHalfChannel> channels;
+  int width;
+};
+
+static void imb_exr_half_convert_row_cb(void *__restrict userdata,
+                                        const int y,
+                                        const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const ExrHalfConvertData *data = (const ExrHalfConvertData *)userdata;
+  const size_t offset = (size_t)y * data->width;
+
+  for (const ExrHalfChannel &chan : data->channels) {
+    const float *from = chan.rect + offset * chan.xstride;
+    half *to = chan.rect_half + offset;
+    for (int x = 0; x < data->width; x++, from += chan.xstride) {
+      to[x] = *from;
+    }
+  }
+}
+
 void IMB_exr_write_channels(void *handle)
 {
   ExrHandle *data = (ExrHandle *)handle;
@@ -1110,14 +1154,13 @@ void IMB_exr_write_channels(void *handle)
       current_rect_half = rect_half;
     }
 
+    ExrHalfConvertData convert_data;
+    convert_data.width = data->width;
+
     for (echan = (ExrChannel *)data->channels.first; echan; echan = echan->next) {
       /* Writing starts from last scanline, stride negative. */
       if (echan->use_half_float) {
-        float *rect = echan->rect;
-        half *cur = current_rect_half;
-        for (size_t i = 0; i < num_pixels; i++, cur++) {
-          *cur = rect[i * echan->xstride];
-        }
+        convert_data.channels.push_back({echan->rect, echan->xstride, current_rect_half});
         half *rect_to_write = current_rect_half + (data->height - 1L) * data->width;
         frameBuffer.insert(
             echan->name,
@@ -1134,6 +1177,15 @@ void IMB_exr_write_channels(void *handle)
       }
     }
 
+    /* Half channels are converted in threads, float channels are written from the render
+     * buffers without copies. */
+    if (!convert_data.channels.empty()) {
+      TaskParallelSettings settings;
+      BLI_parallel_range_settings_defaults(&settings);
+      BLI_task_parallel_range(
+          0, data->height, &convert_data, imb_exr_half_convert_row_cb, &settings);
+    }
+
     data->ofile->setFrameBuffer(frameBuffer);
     try {
       data->ofile->writePixels(data->height);
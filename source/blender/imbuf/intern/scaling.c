@@ -23,6 +23,11 @@
  */
 
 #include <math.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
 
 #include "BLI_math_color.h"
 #include "BLI_math_interp.h"
@@ -908,648 +913,477 @@ static bool q_scale_linear_interpolation(struct ImBuf *ibuf, int newx, int newy)
   return true;
 }
 
-static ImBuf *scaledownx(struct ImBuf *ibuf, int newx)
-{
-  const int do_rect = (ibuf->rect != NULL);
-  const int do_float = (ibuf->rect_float != NULL);
-  const size_t rect_size = ibuf->x * ibuf->y * 4;
+/* -------------------------------------------------------------------- */
+/** \name Box and Linear Scaling
+ *
+ * The filters are separable, each pass scales one axis with a filter of which the samples only
+ * depend on the position along that axis. The samples are computed once per pass, with the same
+ * floating point steps as the original per pixel loops so the results are unchanged, after
+ * which rows of the output are computed in parallel.
+ * \{ */
 
-  uchar *rect, *_newrect, *newrect;
-  float *rectf, *_newrectf, *newrectf;
-  float sample, add, val[4], nval[4], valf[4], nvalf[4];
-  int x, y;
+/* Pixels of the scaling passes, the four channels as floats. */
+#ifdef __SSE2__
+typedef __m128 ScalePixel;
 
-  rectf = _newrectf = newrectf = NULL;
-  rect = _newrect = newrect = NULL;
-  nval[0] = nval[1] = nval[2] = nval[3] = 0.0f;
-  nvalf[0] = nvalf[1] = nvalf[2] = nvalf[3] = 0.0f;
+MINLINE ScalePixel scale_pixel_zero(void)
+{
+  return _mm_setzero_ps();
+}
 
-  if (!do_rect && !do_float) {
-    return ibuf;
-  }
+MINLINE ScalePixel scale_pixel_load_float(const float *p)
+{
+  return _mm_loadu_ps(p);
+}
 
-  if (do_rect) {
-    _newrect = MEM_mallocN(sizeof(uchar[4]) * newx * ibuf->y, "scaledownx");
-    if (_newrect == NULL) {
-      return ibuf;
-    }
-  }
-  if (do_float) {
-    _newrectf = MEM_mallocN(sizeof(float[4]) * newx * ibuf->y, "scaledownxf");
-    if (_newrectf == NULL) {
-      if (_newrect) {
-        MEM_freeN(_newrect);
-      }
-      return ibuf;
-    }
-  }
+MINLINE ScalePixel scale_pixel_load_byte(const uchar *p)
+{
+  int packed;
+  memcpy(&packed, p, sizeof(packed));
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i bytes = _mm_cvtsi32_si128(packed);
+  return _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(bytes, zero), zero));
+}
 
-  add = (ibuf->x - 0.01) / newx;
+MINLINE ScalePixel scale_pixel_add(const ScalePixel a, const ScalePixel b)
+{
+  return _mm_add_ps(a, b);
+}
 
-  if (do_rect) {
-    rect = (uchar *)ibuf->rect;
-    newrect = _newrect;
-  }
-  if (do_float) {
-    rectf = ibuf->rect_float;
-    newrectf = _newrectf;
-  }
+MINLINE ScalePixel scale_pixel_sub(const ScalePixel a, const ScalePixel b)
+{
+  return _mm_sub_ps(a, b);
+}
 
-  for (y = ibuf->y; y > 0; y--) {
-    sample = 0.0f;
-    val[0] = val[1] = val[2] = val[3] = 0.0f;
-    valf[0] = valf[1] = valf[2] = valf[3] = 0.0f;
+MINLINE ScalePixel scale_pixel_add_fl(const ScalePixel a, const float f)
+{
+  return _mm_add_ps(a, _mm_set1_ps(f));
+}
 
-    for (x = newx; x > 0; x--) {
-      if (do_rect) {
-        nval[0] = -val[0] * sample;
-        nval[1] = -val[1] * sample;
-        nval[2] = -val[2] * sample;
-        nval[3] = -val[3] * sample;
-      }
-      if (do_float) {
-        nvalf[0] = -valf[0] * sample;
-        nvalf[1] = -valf[1] * sample;
-        nvalf[2] = -valf[2] * sample;
-        nvalf[3] = -valf[3] * sample;
-      }
+MINLINE ScalePixel scale_pixel_mul_fl(const ScalePixel a, const float f)
+{
+  return _mm_mul_ps(a, _mm_set1_ps(f));
+}
 
-      sample += add;
-
-      while (sample >= 1.0f) {
-        sample -= 1.0f;
-
-        if (do_rect) {
-          nval[0] += rect[0];
-          nval[1] += rect[1];
-          nval[2] += rect[2];
-          nval[3] += rect[3];
-          rect += 4;
-        }
-        if (do_float) {
-          nvalf[0] += rectf[0];
-          nvalf[1] += rectf[1];
-          nvalf[2] += rectf[2];
-          nvalf[3] += rectf[3];
-          rectf += 4;
-        }
-      }
+MINLINE ScalePixel scale_pixel_div_fl(const ScalePixel a, const float f)
+{
+  return _mm_div_ps(a, _mm_set1_ps(f));
+}
 
-      if (do_rect) {
-        val[0] = rect[0];
-        val[1] = rect[1];
-        val[2] = rect[2];
-        val[3] = rect[3];
-        rect += 4;
-
-        newrect[0] = roundf((nval[0] + sample * val[0]) / add);
-        newrect[1] = roundf((nval[1] + sample * val[1]) / add);
-        newrect[2] = roundf((nval[2] + sample * val[2]) / add);
-        newrect[3] = roundf((nval[3] + sample * val[3]) / add);
-
-        newrect += 4;
-      }
-      if (do_float) {
+MINLINE void scale_pixel_store_float(float *p, const ScalePixel a)
+{
+  _mm_storeu_ps(p, a);
+}
 
-        valf[0] = rectf[0];
-        valf[1] = rectf[1];
-        valf[2] = rectf[2];
-        valf[3] = rectf[3];
-        rectf += 4;
+MINLINE void scale_pixel_store_byte_i(uchar *p, const __m128i i)
+{
+  const __m128i words = _mm_packs_epi32(i, i);
+  const int packed = _mm_cvtsi128_si32(_mm_packus_epi16(words, words));
+  memcpy(p, &packed, sizeof(packed));
+}
 
-        newrectf[0] = ((nvalf[0] + sample * valf[0]) / add);
-        newrectf[1] = ((nvalf[1] + sample * valf[1]) / add);
-        newrectf[2] = ((nvalf[2] + sample * valf[2]) / add);
-        newrectf[3] = ((nvalf[3] + sample * valf[3]) / add);
+/* Same as converting the result of roundf() to uchar. */
+MINLINE void scale_pixel_store_byte_round(uchar *p, const ScalePixel a)
+{
+  __m128i i = _mm_cvttps_epi32(a);
+  const __m128 fraction = _mm_sub_ps(a, _mm_cvtepi32_ps(i));
+  /* The comparison masks are -1 where the value is rounded away from zero. */
+  i = _mm_sub_epi32(i, _mm_castps_si128(_mm_cmpge_ps(fraction, _mm_set1_ps(0.5f))));
+  i = _mm_add_epi32(i, _mm_castps_si128(_mm_cmple_ps(fraction, _mm_set1_ps(-0.5f))));
+  scale_pixel_store_byte_i(p, i);
+}
 
-        newrectf += 4;
-      }
+/* Same as converting to uchar. */
+MINLINE void scale_pixel_store_byte_trunc(uchar *p, const ScalePixel a)
+{
+  scale_pixel_store_byte_i(p, _mm_cvttps_epi32(a));
+}
+#else
+typedef struct ScalePixel {
+  float v[4];
+} ScalePixel;
 
-      sample -= 1.0f;
-    }
-  }
+MINLINE ScalePixel scale_pixel_zero(void)
+{
+  ScalePixel r = {{0.0f, 0.0f, 0.0f, 0.0f}};
+  return r;
+}
 
-  if (do_rect) {
-    // printf("%ld %ld\n", (uchar *)rect - ((uchar *)ibuf->rect), rect_size);
-    BLI_assert((uchar *)rect - ((uchar *)ibuf->rect) == rect_size); /* see bug T26502. */
-    imb_freerectImBuf(ibuf);
-    ibuf->mall |= IB_rect;
-    ibuf->rect = (unsigned int *)_newrect;
-  }
-  if (do_float) {
-    // printf("%ld %ld\n", rectf - ibuf->rect_float, rect_size);
-    BLI_assert((rectf - ibuf->rect_float) == rect_size); /* see bug T26502. */
-    imb_freerectfloatImBuf(ibuf);
-    ibuf->mall |= IB_rectfloat;
-    ibuf->rect_float = _newrectf;
-  }
-  (void)rect_size; /* UNUSED in release builds */
+MINLINE ScalePixel scale_pixel_load_float(const float *p)
+{
+  ScalePixel r = {{p[0], p[1], p[2], p[3]}};
+  return r;
+}
 
-  ibuf->x = newx;
-  return ibuf;
+MINLINE ScalePixel scale_pixel_load_byte(const uchar *p)
+{
+  ScalePixel r = {{p[0], p[1], p[2], p[3]}};
+  return r;
 }
 
-static ImBuf *scaledowny(struct ImBuf *ibuf, int newy)
+MINLINE ScalePixel scale_pixel_add(const ScalePixel a, const ScalePixel b)
 {
-  const int do_rect = (ibuf->rect != NULL);
-  const int do_float = (ibuf->rect_float != NULL);
-  const size_t rect_size = ibuf->x * ibuf->y * 4;
+  ScalePixel r = {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}};
+  return r;
+}
 
-  uchar *rect, *_newrect, *newrect;
-  float *rectf, *_newrectf, *newrectf;
-  float sample, add, val[4], nval[4], valf[4], nvalf[4];
-  int x, y, skipx;
+MINLINE ScalePixel scale_pixel_sub(const ScalePixel a, const ScalePixel b)
+{
+  ScalePixel r = {{a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]}};
+  return r;
+}
 
-  rectf = _newrectf = newrectf = NULL;
-  rect = _newrect = newrect = NULL;
-  nval[0] = nval[1] = nval[2] = nval[3] = 0.0f;
-  nvalf[0] = nvalf[1] = nvalf[2] = nvalf[3] = 0.0f;
+MINLINE ScalePixel scale_pixel_add_fl(const ScalePixel a, const float f)
+{
+  ScalePixel r = {{a.v[0] + f, a.v[1] + f, a.v[2] + f, a.v[3] + f}};
+  return r;
+}
 
-  if (!do_rect && !do_float) {
-    return ibuf;
-  }
+MINLINE ScalePixel scale_pixel_mul_fl(const ScalePixel a, const float f)
+{
+  ScalePixel r = {{a.v[0] * f, a.v[1] * f, a.v[2] * f, a.v[3] * f}};
+  return r;
+}
 
-  if (do_rect) {
-    _newrect = MEM_mallocN(sizeof(uchar[4]) * newy * ibuf->x, "scaledowny");
-    if (_newrect == NULL) {
-      return ibuf;
-    }
-  }
-  if (do_float) {
-    _newrectf = MEM_mallocN(sizeof(float[4]) * newy * ibuf->x, "scaledownyf");
-    if (_newrectf == NULL) {
-      if (_newrect) {
-        MEM_freeN(_newrect);
-      }
-      return ibuf;
-    }
-  }
+MINLINE ScalePixel scale_pixel_div_fl(const ScalePixel a, const float f)
+{
+  ScalePixel r = {{a.v[0] / f, a.v[1] / f, a.v[2] / f, a.v[3] / f}};
+  return r;
+}
 
-  add = (ibuf->y - 0.01) / newy;
-  skipx = 4 * ibuf->x;
+MINLINE void scale_pixel_store_float(float *p, const ScalePixel a)
+{
+  p[0] = a.v[0];
+  p[1] = a.v[1];
+  p[2] = a.v[2];
+  p[3] = a.v[3];
+}
 
-  for (x = skipx - 4; x >= 0; x -= 4) {
-    if (do_rect) {
-      rect = ((uchar *)ibuf->rect) + x;
-      newrect = _newrect + x;
-    }
-    if (do_float) {
-      rectf = ibuf->rect_float + x;
-      newrectf = _newrectf + x;
-    }
+MINLINE void scale_pixel_store_byte_round(uchar *p, const ScalePixel a)
+{
+  p[0] = roundf(a.v[0]);
+  p[1] = roundf(a.v[1]);
+  p[2] = roundf(a.v[2]);
+  p[3] = roundf(a.v[3]);
+}
 
-    sample = 0.0f;
-    val[0] = val[1] = val[2] = val[3] = 0.0f;
-    valf[0] = valf[1] = valf[2] = valf[3] = 0.0f;
+MINLINE void scale_pixel_store_byte_trunc(uchar *p, const ScalePixel a)
+{
+  p[0] = a.v[0];
+  p[1] = a.v[1];
+  p[2] = a.v[2];
+  p[3] = a.v[3];
+}
+#endif /* __SSE2__ */
 
-    for (y = newy; y > 0; y--) {
-      if (do_rect) {
-        nval[0] = -val[0] * sample;
-        nval[1] = -val[1] * sample;
-        nval[2] = -val[2] * sample;
-        nval[3] = -val[3] * sample;
-      }
-      if (do_float) {
-        nvalf[0] = -valf[0] * sample;
-        nvalf[1] = -valf[1] * sample;
-        nvalf[2] = -valf[2] * sample;
-        nvalf[3] = -valf[3] * sample;
-      }
+/**
+ * Box filter sample of a pixel when scaling down: the sum of the pixels from \a first to
+ * \a first + \a num - 1 and a part of the pixels on both sides, partly used by the neighbors.
+ */
+typedef struct ScaleDownSample {
+  int first;
+  int num;
+  /** The part of the pixel before first that was already used by the previous pixel. */
+  float sample_start;
+  /** The part of the pixel after the whole pixels. */
+  float sample_end;
+} ScaleDownSample;
+
+static ScaleDownSample *scaledown_samples(int len, int newlen, float *r_add)
+{
+  ScaleDownSample *samples = MEM_malloc_arrayN(newlen, sizeof(*samples), "scaledown samples");
+  const float add = (len - 0.01) / newlen;
+  float sample = 0.0f;
+  int next = 0;
 
-      sample += add;
-
-      while (sample >= 1.0f) {
-        sample -= 1.0f;
-
-        if (do_rect) {
-          nval[0] += rect[0];
-          nval[1] += rect[1];
-          nval[2] += rect[2];
-          nval[3] += rect[3];
-          rect += skipx;
-        }
-        if (do_float) {
-          nvalf[0] += rectf[0];
-          nvalf[1] += rectf[1];
-          nvalf[2] += rectf[2];
-          nvalf[3] += rectf[3];
-          rectf += skipx;
-        }
-      }
+  for (int i = 0; i < newlen; i++) {
+    samples[i].first = next;
+    samples[i].sample_start = sample;
 
-      if (do_rect) {
-        val[0] = rect[0];
-        val[1] = rect[1];
-        val[2] = rect[2];
-        val[3] = rect[3];
-        rect += skipx;
-
-        newrect[0] = roundf((nval[0] + sample * val[0]) / add);
-        newrect[1] = roundf((nval[1] + sample * val[1]) / add);
-        newrect[2] = roundf((nval[2] + sample * val[2]) / add);
-        newrect[3] = roundf((nval[3] + sample * val[3]) / add);
-
-        newrect += skipx;
-      }
-      if (do_float) {
+    sample += add;
+    while (sample >= 1.0f) {
+      sample -= 1.0f;
+      next++;
+    }
 
-        valf[0] = rectf[0];
-        valf[1] = rectf[1];
-        valf[2] = rectf[2];
-        valf[3] = rectf[3];
-        rectf += skipx;
+    samples[i].num = next - samples[i].first;
+    samples[i].sample_end = sample;
+    /* The pixel after the whole pixels. */
+    next++;
+    sample -= 1.0f;
+  }
+  BLI_assert(next == len); /* see bug T26502. */
 
-        newrectf[0] = ((nvalf[0] + sample * valf[0]) / add);
-        newrectf[1] = ((nvalf[1] + sample * valf[1]) / add);
-        newrectf[2] = ((nvalf[2] + sample * valf[2]) / add);
-        newrectf[3] = ((nvalf[3] + sample * valf[3]) / add);
+  *r_add = add;
+  return samples;
+}
 
-        newrectf += skipx;
-      }
+/**
+ * Linear filter sample of a pixel when scaling up, between the pixels \a index and the next one.
+ */
+typedef struct ScaleUpSample {
+  int index;
+  int next;
+  float sample;
+} ScaleUpSample;
+
+static ScaleUpSample *scaleup_samples(int len, int newlen)
+{
+  ScaleUpSample *samples = MEM_malloc_arrayN(newlen, sizeof(*samples), "scaleup samples");
+  const float add = (len - 1.001) / (newlen - 1.0);
+  float sample = 0.0f;
+  int index = 0;
 
+  for (int i = 0; i < newlen; i++) {
+    if (sample >= 1.0f) {
       sample -= 1.0f;
+      index++;
     }
+    samples[i].index = index;
+    samples[i].next = min_ii(index + 1, len - 1);
+    samples[i].sample = sample;
+    sample += add;
   }
 
-  if (do_rect) {
-    // printf("%ld %ld\n", (uchar *)rect - ((uchar *)ibuf->rect), rect_size);
-    BLI_assert((uchar *)rect - ((uchar *)ibuf->rect) == rect_size); /* see bug T26502. */
-    imb_freerectImBuf(ibuf);
-    ibuf->mall |= IB_rect;
-    ibuf->rect = (unsigned int *)_newrect;
-  }
-  if (do_float) {
-    // printf("%ld %ld\n", rectf - ibuf->rect_float, rect_size);
-    BLI_assert((rectf - ibuf->rect_float) == rect_size); /* see bug T26502. */
-    imb_freerectfloatImBuf(ibuf);
-    ibuf->mall |= IB_rectfloat;
-    ibuf->rect_float = (float *)_newrectf;
-  }
-  (void)rect_size; /* UNUSED in release builds */
-
-  ibuf->y = newy;
-  return ibuf;
+  return samples;
 }
 
-static ImBuf *scaleupx(struct ImBuf *ibuf, int newx)
-{
-  uchar *rect, *_newrect = NULL, *newrect;
-  float *rectf, *_newrectf = NULL, *newrectf;
-  float sample, add;
-  float val_a, nval_a, diff_a;
-  float val_b, nval_b, diff_b;
-  float val_g, nval_g, diff_g;
-  float val_r, nval_r, diff_r;
-  float val_af, nval_af, diff_af;
-  float val_bf, nval_bf, diff_bf;
-  float val_gf, nval_gf, diff_gf;
-  float val_rf, nval_rf, diff_rf;
+typedef struct ScalePassData {
+  const uchar *rect;
+  const float *rectf;
+  uchar *newrect;
+  float *newrectf;
+  /** Size of the input, the pass changes one of them. */
   int x, y;
-  bool do_rect = false, do_float = false;
+  /** Size of the output along the scaled axis. */
+  int newlen;
 
-  val_a = nval_a = diff_a = val_b = nval_b = diff_b = 0;
-  val_g = nval_g = diff_g = val_r = nval_r = diff_r = 0;
-  val_af = nval_af = diff_af = val_bf = nval_bf = diff_bf = 0;
-  val_gf = nval_gf = diff_gf = val_rf = nval_rf = diff_rf = 0;
-  if (ibuf == NULL) {
-    return NULL;
-  }
-  if (ibuf->rect == NULL && ibuf->rect_float == NULL) {
-    return ibuf;
-  }
+  const ScaleDownSample *down_samples;
+  float add;
+  const ScaleUpSample *up_samples;
+} ScalePassData;
 
-  if (ibuf->rect) {
-    do_rect = true;
-    _newrect = MEM_mallocN(newx * ibuf->y * sizeof(int), "scaleupx");
-    if (_newrect == NULL) {
-      return ibuf;
-    }
-  }
-  if (ibuf->rect_float) {
-    do_float = true;
-    _newrectf = MEM_mallocN(sizeof(float[4]) * newx * ibuf->y, "scaleupxf");
-    if (_newrectf == NULL) {
-      if (_newrect) {
-        MEM_freeN(_newrect);
+/**
+ * Box filter the pixels along a line of the input, \a step is the distance between pixels in
+ * floats or bytes.
+ */
+#define SCALEDOWN_PIXEL(r_pixel, s, line, step, load) \
+  { \
+    ScalePixel _val = (s)->first > 0 ? load((line) + (size_t)((s)->first - 1) * (step)) : \
+                                       scale_pixel_zero(); \
+    ScalePixel _nval = scale_pixel_mul_fl(_val, -(s)->sample_start); \
+    for (int _i = 0; _i < (s)->num; _i++) { \
+      _nval = scale_pixel_add(_nval, load((line) + (size_t)((s)->first + _i) * (step))); \
+    } \
+    _val = load((line) + (size_t)((s)->first + (s)->num) * (step)); \
+    r_pixel = scale_pixel_add(_nval, scale_pixel_mul_fl(_val, (s)->sample_end)); \
+  } \
+  ((void)0)
+
+static void scaledown_x_thread_do(void *data_v, int start_scanline, int num_scanlines)
+{
+  const ScalePassData *data = data_v;
+  const int newx = data->newlen;
+
+  for (int y = start_scanline; y < start_scanline + num_scanlines; y++) {
+    const size_t row = (size_t)y * data->x * 4;
+    const size_t newrow = (size_t)y * newx * 4;
+
+    for (int x = 0; x < newx; x++) {
+      const ScaleDownSample *s = &data->down_samples[x];
+      ScalePixel pixel;
+      if (data->newrect) {
+        SCALEDOWN_PIXEL(pixel, s, data->rect + row, 4, scale_pixel_load_byte);
+        scale_pixel_store_byte_round(data->newrect + newrow + x * 4,
+                                     scale_pixel_div_fl(pixel, data->add));
+      }
+      if (data->newrectf) {
+        SCALEDOWN_PIXEL(pixel, s, data->rectf + row, 4, scale_pixel_load_float);
+        scale_pixel_store_float(data->newrectf + newrow + x * 4,
+                                scale_pixel_div_fl(pixel, data->add));
       }
-      return ibuf;
     }
   }
+}
 
-  add = (ibuf->x - 1.001) / (newx - 1.0);
-
-  rect = (uchar *)ibuf->rect;
-  rectf = (float *)ibuf->rect_float;
-  newrect = _newrect;
-  newrectf = _newrectf;
-
-  for (y = ibuf->y; y > 0; y--) {
-
-    sample = 0;
-
-    if (do_rect) {
-      val_a = rect[0];
-      nval_a = rect[4];
-      diff_a = nval_a - val_a;
-      val_a += 0.5f;
-
-      val_b = rect[1];
-      nval_b = rect[5];
-      diff_b = nval_b - val_b;
-      val_b += 0.5f;
-
-      val_g = rect[2];
-      nval_g = rect[6];
-      diff_g = nval_g - val_g;
-      val_g += 0.5f;
-
-      val_r = rect[3];
-      nval_r = rect[7];
-      diff_r = nval_r - val_r;
-      val_r += 0.5f;
-
-      rect += 8;
+static void scaledown_y_thread_do(void *data_v, int start_scanline, int num_scanlines)
+{
+  const ScalePassData *data = data_v;
+  const size_t skipx = (size_t)data->x * 4;
+
+  for (int y = start_scanline; y < start_scanline + num_scanlines; y++) {
+    const ScaleDownSample *s = &data->down_samples[y];
+    const size_t newrow = (size_t)y * skipx;
+
+    for (int x = 0; x < data->x; x++) {
+      ScalePixel pixel;
+      if (data->newrect) {
+        SCALEDOWN_PIXEL(pixel, s, data->rect + x * 4, skipx, scale_pixel_load_byte);
+        scale_pixel_store_byte_round(data->newrect + newrow + x * 4,
+                                     scale_pixel_div_fl(pixel, data->add));
+      }
+      if (data->newrectf) {
+        SCALEDOWN_PIXEL(pixel, s, data->rectf + x * 4, skipx, scale_pixel_load_float);
+        scale_pixel_store_float(data->newrectf + newrow + x * 4,
+                                scale_pixel_div_fl(pixel, data->add));
+      }
     }
-    if (do_float) {
-      val_af = rectf[0];
-      nval_af = rectf[4];
-      diff_af = nval_af - val_af;
-
-      val_bf = rectf[1];
-      nval_bf = rectf[5];
-      diff_bf = nval_bf - val_bf;
-
-      val_gf = rectf[2];
-      nval_gf = rectf[6];
-      diff_gf = nval_gf - val_gf;
+  }
+}
 
-      val_rf = rectf[3];
-      nval_rf = rectf[7];
-      diff_rf = nval_rf - val_rf;
+#undef SCALEDOWN_PIXEL
 
-      rectf += 8;
-    }
-    for (x = newx; x > 0; x--) {
-      if (sample >= 1.0f) {
-        sample -= 1.0f;
-
-        if (do_rect) {
-          val_a = nval_a;
-          nval_a = rect[0];
-          diff_a = nval_a - val_a;
-          val_a += 0.5f;
-
-          val_b = nval_b;
-          nval_b = rect[1];
-          diff_b = nval_b - val_b;
-          val_b += 0.5f;
-
-          val_g = nval_g;
-          nval_g = rect[2];
-          diff_g = nval_g - val_g;
-          val_g += 0.5f;
-
-          val_r = nval_r;
-          nval_r = rect[3];
-          diff_r = nval_r - val_r;
-          val_r += 0.5f;
-          rect += 4;
-        }
-        if (do_float) {
-          val_af = nval_af;
-          nval_af = rectf[0];
-          diff_af = nval_af - val_af;
-
-          val_bf = nval_bf;
-          nval_bf = rectf[1];
-          diff_bf = nval_bf - val_bf;
-
-          val_gf = nval_gf;
-          nval_gf = rectf[2];
-          diff_gf = nval_gf - val_gf;
-
-          val_rf = nval_rf;
-          nval_rf = rectf[3];
-          diff_rf = nval_rf - val_rf;
-          rectf += 4;
-        }
-      }
-      if (do_rect) {
-        newrect[0] = val_a + sample * diff_a;
-        newrect[1] = val_b + sample * diff_b;
-        newrect[2] = val_g + sample * diff_g;
-        newrect[3] = val_r + sample * diff_r;
-        newrect += 4;
+/**
+ * Interpolate the pixels along a line of the input, \a step is the distance between pixels in
+ * floats or bytes. Bytes are rounded by adding a half before truncating.
+ */
+#define SCALEUP_PIXEL(r_pixel, s, line, step, load, offset) \
+  { \
+    const ScalePixel _val = load((line) + (size_t)(s)->index * (step)); \
+    const ScalePixel _nval = load((line) + (size_t)(s)->next * (step)); \
+    const ScalePixel _diff = scale_pixel_sub(_nval, _val); \
+    r_pixel = scale_pixel_add(scale_pixel_add_fl(_val, offset), \
+                              scale_pixel_mul_fl(_diff, (s)->sample)); \
+  } \
+  ((void)0)
+
+static void scaleup_x_thread_do(void *data_v, int start_scanline, int num_scanlines)
+{
+  const ScalePassData *data = data_v;
+  const int newx = data->newlen;
+
+  for (int y = start_scanline; y < start_scanline + num_scanlines; y++) {
+    const size_t row = (size_t)y * data->x * 4;
+    const size_t newrow = (size_t)y * newx * 4;
+
+    for (int x = 0; x < newx; x++) {
+      const ScaleUpSample *s = &data->up_samples[x];
+      ScalePixel pixel;
+      if (data->newrect) {
+        SCALEUP_PIXEL(pixel, s, data->rect + row, 4, scale_pixel_load_byte, 0.5f);
+        scale_pixel_store_byte_trunc(data->newrect + newrow + x * 4, pixel);
       }
-      if (do_float) {
-        newrectf[0] = val_af + sample * diff_af;
-        newrectf[1] = val_bf + sample * diff_bf;
-        newrectf[2] = val_gf + sample * diff_gf;
-        newrectf[3] = val_rf + sample * diff_rf;
-        newrectf += 4;
+      if (data->newrectf) {
+        SCALEUP_PIXEL(pixel, s, data->rectf + row, 4, scale_pixel_load_float, 0.0f);
+        scale_pixel_store_float(data->newrectf + newrow + x * 4, pixel);
       }
-      sample += add;
     }
   }
+}
 
-  if (do_rect) {
-    imb_freerectImBuf(ibuf);
-    ibuf->mall |= IB_rect;
-    ibuf->rect = (unsigned int *)_newrect;
-  }
-  if (do_float) {
-    imb_freerectfloatImBuf(ibuf);
-    ibuf->mall |= IB_rectfloat;
-    ibuf->rect_float = (float *)_newrectf;
+static void scaleup_y_thread_do(void *data_v, int start_scanline, int num_scanlines)
+{
+  const ScalePassData *data = data_v;
+  const size_t skipx = (size_t)data->x * 4;
+
+  for (int y = start_scanline; y < start_scanline + num_scanlines; y++) {
+    const ScaleUpSample *s = &data->up_samples[y];
+    const size_t newrow = (size_t)y * skipx;
+
+    for (int x = 0; x < data->x; x++) {
+      ScalePixel pixel;
+      if (data->newrect) {
+        SCALEUP_PIXEL(pixel, s, data->rect + x * 4, skipx, scale_pixel_load_byte, 0.5f);
+        scale_pixel_store_byte_trunc(data->newrect + newrow + x * 4, pixel);
+      }
+      if (data->newrectf) {
+        SCALEUP_PIXEL(pixel, s, data->rectf + x * 4, skipx, scale_pixel_load_float, 0.0f);
+        scale_pixel_store_float(data->newrectf + newrow + x * 4, pixel);
+      }
+    }
   }
-
-  ibuf->x = newx;
-  return ibuf;
 }
 
-static ImBuf *scaleupy(struct ImBuf *ibuf, int newy)
+#undef SCALEUP_PIXEL
+
+/**
+ * Run a scaling pass from \a ibuf to a buffer of \a newx by \a newy, which differs from the size
+ * of \a ibuf along one axis. The samples of \a data are freed.
+ */
+static ImBuf *scale_pass(
+    struct ImBuf *ibuf, int newx, int newy, ScanlineThreadFunc do_thread, ScalePassData *data)
 {
-  uchar *rect, *_newrect = NULL, *newrect;
-  float *rectf, *_newrectf = NULL, *newrectf;
-  float sample, add;
-  float val_a, nval_a, diff_a;
-  float val_b, nval_b, diff_b;
-  float val_g, nval_g, diff_g;
-  float val_r, nval_r, diff_r;
-  float val_af, nval_af, diff_af;
-  float val_bf, nval_bf, diff_bf;
-  float val_gf, nval_gf, diff_gf;
-  float val_rf, nval_rf, diff_rf;
-  int x, y, skipx;
-  bool do_rect = false, do_float = false;
-
-  val_a = nval_a = diff_a = val_b = nval_b = diff_b = 0;
-  val_g = nval_g = diff_g = val_r = nval_r = diff_r = 0;
-  val_af = nval_af = diff_af = val_bf = nval_bf = diff_bf = 0;
-  val_gf = nval_gf = diff_gf = val_rf = nval_rf = diff_rf = 0;
-  if (ibuf == NULL) {
-    return NULL;
-  }
-  if (ibuf->rect == NULL && ibuf->rect_float == NULL) {
-    return ibuf;
-  }
+  uchar *newrect = NULL;
+  float *newrectf = NULL;
 
   if (ibuf->rect) {
-    do_rect = true;
-    _newrect = MEM_mallocN(ibuf->x * newy * sizeof(int), "scaleupy");
-    if (_newrect == NULL) {
-      return ibuf;
-    }
+    newrect = MEM_mallocN(sizeof(uchar[4]) * newx * newy, "scale pass");
   }
   if (ibuf->rect_float) {
-    do_float = true;
-    _newrectf = MEM_mallocN(sizeof(float[4]) * ibuf->x * newy, "scaleupyf");
-    if (_newrectf == NULL) {
-      if (_newrect) {
-        MEM_freeN(_newrect);
-      }
-      return ibuf;
-    }
+    newrectf = MEM_mallocN(sizeof(float[4]) * newx * newy, "scale pass float");
   }
 
-  add = (ibuf->y - 1.001) / (newy - 1.0);
-  skipx = 4 * ibuf->x;
-
-  rect = (uchar *)ibuf->rect;
-  rectf = (float *)ibuf->rect_float;
-  newrect = _newrect;
-  newrectf = _newrectf;
-
-  for (x = ibuf->x; x > 0; x--) {
-
-    sample = 0;
-    if (do_rect) {
-      rect = ((uchar *)ibuf->rect) + 4 * (x - 1);
-      newrect = _newrect + 4 * (x - 1);
-
-      val_a = rect[0];
-      nval_a = rect[skipx];
-      diff_a = nval_a - val_a;
-      val_a += 0.5f;
-
-      val_b = rect[1];
-      nval_b = rect[skipx + 1];
-      diff_b = nval_b - val_b;
-      val_b += 0.5f;
-
-      val_g = rect[2];
-      nval_g = rect[skipx + 2];
-      diff_g = nval_g - val_g;
-      val_g += 0.5f;
-
-      val_r = rect[3];
-      nval_r = rect[skipx + 3];
-      diff_r = nval_r - val_r;
-      val_r += 0.5f;
-
-      rect += 2 * skipx;
-    }
-    if (do_float) {
-      rectf = ibuf->rect_float + 4 * (x - 1);
-      newrectf = _newrectf + 4 * (x - 1);
-
-      val_af = rectf[0];
-      nval_af = rectf[skipx];
-      diff_af = nval_af - val_af;
-
-      val_bf = rectf[1];
-      nval_bf = rectf[skipx + 1];
-      diff_bf = nval_bf - val_bf;
-
-      val_gf = rectf[2];
-      nval_gf = rectf[skipx + 2];
-      diff_gf = nval_gf - val_gf;
-
-      val_rf = rectf[3];
-      nval_rf = rectf[skipx + 3];
-      diff_rf = nval_rf - val_rf;
-
-      rectf += 2 * skipx;
+  if ((ibuf->rect && newrect == NULL) || (ibuf->rect_float && newrectf == NULL)) {
+    MEM_SAFE_FREE(newrect);
+    MEM_SAFE_FREE(newrectf);
+  }
+  else {
+    data->rect = (uchar *)ibuf->rect;
+    data->rectf = ibuf->rect_float;
+    data->newrect = newrect;
+    data->newrectf = newrectf;
+    data->x = ibuf->x;
+    data->y = ibuf->y;
+
+    IMB_processor_apply_threaded_scanlines(newy, do_thread, data);
+
+    if (newrect) {
+      imb_freerectImBuf(ibuf);
+      ibuf->mall |= IB_rect;
+      ibuf->rect = (unsigned int *)newrect;
     }
-
-    for (y = newy; y > 0; y--) {
-      if (sample >= 1.0f) {
-        sample -= 1.0f;
-
-        if (do_rect) {
-          val_a = nval_a;
-          nval_a = rect[0];
-          diff_a = nval_a - val_a;
-          val_a += 0.5f;
-
-          val_b = nval_b;
-          nval_b = rect[1];
-          diff_b = nval_b - val_b;
-          val_b += 0.5f;
-
-          val_g = nval_g;
-          nval_g = rect[2];
-          diff_g = nval_g - val_g;
-          val_g += 0.5f;
-
-          val_r = nval_r;
-          nval_r = rect[3];
-          diff_r = nval_r - val_r;
-          val_r += 0.5f;
-          rect += skipx;
-        }
-        if (do_float) {
-          val_af = nval_af;
-          nval_af = rectf[0];
-          diff_af = nval_af - val_af;
-
-          val_bf = nval_bf;
-          nval_bf = rectf[1];
-          diff_bf = nval_bf - val_bf;
-
-          val_gf = nval_gf;
-          nval_gf = rectf[2];
-          diff_gf = nval_gf - val_gf;
-
-          val_rf = nval_rf;
-          nval_rf = rectf[3];
-          diff_rf = nval_rf - val_rf;
-          rectf += skipx;
-        }
-      }
-      if (do_rect) {
-        newrect[0] = val_a + sample * diff_a;
-        newrect[1] = val_b + sample * diff_b;
-        newrect[2] = val_g + sample * diff_g;
-        newrect[3] = val_r + sample * diff_r;
-        newrect += skipx;
-      }
-      if (do_float) {
-        newrectf[0] = val_af + sample * diff_af;
-        newrectf[1] = val_bf + sample * diff_bf;
-        newrectf[2] = val_gf + sample * diff_gf;
-        newrectf[3] = val_rf + sample * diff_rf;
-        newrectf += skipx;
-      }
-      sample += add;
+    if (newrectf) {
+      imb_freerectfloatImBuf(ibuf);
+      ibuf->mall |= IB_rectfloat;
+      ibuf->rect_float = newrectf;
     }
+    ibuf->x = newx;
+    ibuf->y = newy;
   }
 
-  if (do_rect) {
-    imb_freerectImBuf(ibuf);
-    ibuf->mall |= IB_rect;
-    ibuf->rect = (unsigned int *)_newrect;
+  if (data->down_samples) {
+    MEM_freeN((void *)data->down_samples);
   }
-  if (do_float) {
-    imb_freerectfloatImBuf(ibuf);
-    ibuf->mall |= IB_rectfloat;
-    ibuf->rect_float = (float *)_newrectf;
+  if (data->up_samples) {
+    MEM_freeN((void *)data->up_samples);
   }
-
-  ibuf->y = newy;
   return ibuf;
 }
 
+static ImBuf *scaledownx(struct ImBuf *ibuf, int newx)
+{
+  ScalePassData data = {NULL};
+  data.newlen = newx;
+  data.down_samples = scaledown_samples(ibuf->x, newx, &data.add);
+  return scale_pass(ibuf, newx, ibuf->y, scaledown_x_thread_do, &data);
+}
+
+static ImBuf *scaledowny(struct ImBuf *ibuf, int newy)
+{
+  ScalePassData data = {NULL};
+  data.newlen = newy;
+  data.down_samples = scaledown_samples(ibuf->y, newy, &data.add);
+  return scale_pass(ibuf, ibuf->x, newy, scaledown_y_thread_do, &data);
+}
+
+static ImBuf *scaleupx(struct ImBuf *ibuf, int newx)
+{
+  ScalePassData data = {NULL};
+  data.newlen = newx;
+  data.up_samples = scaleup_samples(ibuf->x, newx);
+  return scale_pass(ibuf, newx, ibuf->y, scaleup_x_thread_do, &data);
+}
+
+static ImBuf *scaleupy(struct ImBuf *ibuf, int newy)
+{
+  ScalePassData data = {NULL};
+  data.newlen = newy;
+  data.up_samples = scaleup_samples(ibuf->y, newy);
+  return scale_pass(ibuf, ibuf->x, newy, scaleup_y_thread_do, &data);
+}
+
+/** \} */
+
 static void scalefast_Z_ImBuf(ImBuf *ibuf, int newx, int newy)
 {
   int *zbuf, *newzbuf, *_newzbuf = NULL;
@@ -113,6 +113,12 @@ typedef struct ImageTile {
   char label[64];
 } ImageTile;
 
+typedef struct Image_Runtime {
+  /** Changed when the pixels of the image may have changed, identifies them in caches. */
+  int changed_timestamp;
+  char _pad[4];
+} Image_Runtime;
+
 /* iuser->flag */
 #define IMA_ANIM_ALWAYS (1 << 0)
 /* #define IMA_UNUSED_1         (1 << 1) */
@@ -193,6 +199,9 @@ typedef struct Image {
   /** ImageView. */
   ListBase views;
   struct Stereo3dFormat *stereo3d_format;
+
+  /** Runtime data (keep last). */
+  Image_Runtime runtime;
 } Image;
 
 /* **************** IMAGE ********************* */
@@ -402,6 +402,12 @@ typedef struct bNodeLink {
 #define NTREE_QUALITY_MEDIUM 1
 #define NTREE_QUALITY_LOW 2
 
+/* tree->execution_mode */
+typedef enum eNodeTreeExecutionMode {
+  NTREE_EXECUTION_MODE_TILED = 0,
+  NTREE_EXECUTION_MODE_FULL_FRAME = 1,
+} eNodeTreeExecutionMode;
+
 /* tree->chunksize */
 #define NTREE_CHUNKSIZE_32 32
 #define NTREE_CHUNKSIZE_64 64
@@ -447,7 +453,9 @@ typedef struct bNodeTree {
   short is_updating;
   /** Generic temporary flag for recursion check (DFS/BFS). */
   short done;
-  char _pad2[4];
+  /** Execution model of the compositor, see #eNodeTreeExecutionMode. */
+  short execution_mode;
+  char _pad2[2];
 
   /** Specific node type this tree is used for. */
   int nodetype DNA_DEPRECATED;
@@ -513,6 +521,7 @@ typedef struct bNodeTree {
 #define NTREE_TWO_PASS (1 << 2)             /* two pass */
 #define NTREE_COM_GROUPNODE_BUFFER (1 << 3) /* use groupnode buffers */
 #define NTREE_VIEWER_BORDER (1 << 4)        /* use a border for viewer nodes */
+#define NTREE_COM_HALF_BUFFERS (1 << 6)     /* store color buffers as half floats */
 /* NOTE: DEPRECATED, use (id->tag & LIB_TAG_LOCALIZED) instead. */
 
 /* tree is localized copy, free when deleting node groups */
@@ -614,6 +623,7 @@ enum {
 enum {
   CMP_NODEFLAG_BLUR_VARIABLE_SIZE = (1 << 0),
   CMP_NODEFLAG_BLUR_EXTEND_BOUNDS = (1 << 1),
+  CMP_NODEFLAG_BLUR_FFT = (1 << 2),
 };
 
 typedef struct NodeFrame {
@@ -768,7 +778,7 @@ typedef struct NodeVertexCol {
 
 /* qdn: Defocus blur node */
 typedef struct NodeDefocus {
-  char bktype, _pad0, preview, gamco;
+  char bktype, use_fft, preview, gamco;
   short samples, no_zbuf;
   float fstop, maxblur, bthresh, scale;
   float rotation;
@@ -759,10 +759,12 @@ typedef struct UserDef {
   short gp_manhattandist, gp_euclideandist, gp_eraser;
   /** #eGP_UserdefSettings. */
   short gp_settings;
-  char _pad13[4];
+  /** Memory used by tiled compositor buffers before tiles are moved to disk (in megabytes). */
+  int compositor_memory_limit;
   struct SolidLight light_param[4];
   float light_ambient[3];
-  char _pad3[4];
+  /** Memory used to keep compositor results between executions (in megabytes). */
+  int compositor_cache_limit;
   short gizmo_flag, gizmo_size;
   short edit_studio_light;
   short lookdev_sphere_size;
@@ -773,7 +775,8 @@ typedef struct UserDef {
   int prefetchframes;
   /** Control the rotation step of the view when PAD2, PAD4, PAD6&PAD8 is use. */
   float pad_rot_angle;
-  char _pad12[4];
+  /** Memory used to keep geometry nodes results between evaluations (in megabytes). */
+  int geometry_nodes_cache_limit;
   /** Rotating view icon size. */
   short rvisize;
   /** Rotating view icon brightness. */
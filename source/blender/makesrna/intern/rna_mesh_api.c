@@ -184,7 +184,7 @@ static void rna_Mesh_flip_normals(Mesh *mesh)
   BKE_mesh_polygons_flip(mesh->mpoly, mesh->mloop, &mesh->ldata, mesh->totpoly);
   BKE_mesh_tessface_clear(mesh);
   BKE_mesh_calc_normals(mesh);
-  BKE_mesh_runtime_clear_geometry(mesh);
+  BKE_mesh_runtime_tag_dirty(mesh, ME_RUNTIME_DIRTY_TOPOLOGY);
 
   DEG_id_tag_update(&mesh->id, 0);
 }
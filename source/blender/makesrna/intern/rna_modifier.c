@@ -33,6 +33,7 @@
 #include "MEM_guardedalloc.h"
 
 #include "BLI_math.h"
+#include "BLI_path_util.h"
 
 #include "BLT_translation.h"
 
@@ -602,6 +603,7 @@ const EnumPropertyItem rna_enum_axis_flag_xyz_items[] = {
 
 #  include "BKE_cachefile.h"
 #  include "BKE_context.h"
+#  include "BKE_geometry_nodes_profile.h"
 #  include "BKE_mesh_runtime.h"
 #  include "BKE_modifier.h"
 #  include "BKE_object.h"
@@ -1617,6 +1619,24 @@ static void rna_NodesModifier_node_group_update(Main *bmain, Scene *scene, Point
   MOD_nodes_update_interface(object, nmd);
 }
 
+static void rna_NodesModifier_debug_profile_clear(NodesModifierData *nmd)
+{
+  BKE_geometry_nodes_profile_clear(&nmd->modifier.session_uuid);
+}
+
+static bool rna_NodesModifier_debug_profile_write_chrome_trace(NodesModifierData *nmd,
+                                                               const char *filepath)
+{
+  return BKE_geometry_nodes_profile_write_chrome_trace(filepath, &nmd->modifier.session_uuid);
+}
+
+static void rna_NodesModifier_debug_profile_node_stats(NodesModifierData *nmd,
+                                                       const char *node_name,
+                                                       float r_stats[4])
+{
+  BKE_geometry_nodes_profile_node_stats(&nmd->modifier.session_uuid, node_name, r_stats);
+}
+
 static IDProperty *rna_NodesModifierSettings_properties(PointerRNA *ptr, bool create)
 {
   NodesModifierSettings *settings = ptr->data;
@@ -6977,6 +6997,8 @@ static void rna_def_modifier_nodes(BlenderRNA *brna)
 {
   StructRNA *srna;
   PropertyRNA *prop;
+  FunctionRNA *func;
+  PropertyRNA *parm;
 
   srna = RNA_def_struct(brna, "NodesModifier", "Modifier");
   RNA_def_struct_ui_text(srna, "Nodes Modifier", "");
@@ -6997,6 +7019,42 @@ static void rna_def_modifier_nodes(BlenderRNA *brna)
 
   RNA_define_lib_overridable(false);
 
+  /* Profiling, see `bpy.app.debug_geometry_nodes_profile`. */
+
+  func = RNA_def_function(srna, "debug_profile_clear", "rna_NodesModifier_debug_profile_clear");
+  RNA_def_function_ui_description(func, "Remove the recorded node execution statistics");
+
+  func = RNA_def_function(srna,
+                          "debug_profile_write_chrome_trace",
+                          "rna_NodesModifier_debug_profile_write_chrome_trace");
+  RNA_def_function_ui_description(
+      func, "Write the recorded node executions to a file in the Chrome trace event format");
+  parm = RNA_def_string_file_path(
+      func, "filepath", NULL, FILE_MAX, "File Path", "Output path for the trace file");
+  RNA_def_parameter_flags(parm, 0, PARM_REQUIRED);
+  parm = RNA_def_boolean(func, "success", false, "", "True when the file has been written");
+  RNA_def_function_return(func, parm);
+
+  func = RNA_def_function(
+      srna, "debug_profile_node_stats", "rna_NodesModifier_debug_profile_node_stats");
+  RNA_def_function_ui_description(
+      func, "Accumulated statistics of all recorded executions of a node in this modifier");
+  parm = RNA_def_string(func, "node_name", NULL, MAX_NAME, "Node Name", "");
+  RNA_def_parameter_flags(parm, 0, PARM_REQUIRED);
+  parm = RNA_def_float_vector(func,
+                              "stats",
+                              4,
+                              NULL,
+                              0.0f,
+                              FLT_MAX,
+                              "Statistics",
+                              "Wall time and thread time in seconds, the number of processed "
+                              "elements and the size of the outputs in bytes",
+                              0.0f,
+                              FLT_MAX);
+  RNA_def_parameter_flags(parm, PROP_THICK_WRAP, 0);
+  RNA_def_function_output(func, parm);
+
   rna_def_modifier_nodes_settings(brna);
 }
 
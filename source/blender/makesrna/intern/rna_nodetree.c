@@ -6876,6 +6876,14 @@ static void def_cmp_defocus(StructRNA *srna)
       prop, "Gamma Correction", "Enable gamma correction before and after main process");
   RNA_def_property_update(prop, NC_NODE | NA_EDITED, "rna_Node_update");
 
+  prop = RNA_def_property(srna, "use_fft", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "use_fft", 1);
+  RNA_def_property_ui_text(prop,
+                           "FFT",
+                           "Approximate the blur with FFT convolutions of a few blur sizes, much "
+                           "faster for large blur sizes");
+  RNA_def_property_update(prop, NC_NODE | NA_EDITED, "rna_Node_update");
+
   /* TODO */
   prop = RNA_def_property(srna, "f_stop", PROP_FLOAT, PROP_NONE);
   RNA_def_property_float_sdna(prop, NULL, "fstop");
@@ -7679,6 +7687,14 @@ static void def_cmp_bokehblur(StructRNA *srna)
       prop, "Extend Bounds", "Extend bounds of the input image to fully fit blurred image");
   RNA_def_property_update(prop, NC_NODE | NA_EDITED, "rna_Node_update");
 
+  prop = RNA_def_property(srna, "use_fft", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "custom1", CMP_NODEFLAG_BLUR_FFT);
+  RNA_def_property_ui_text(prop,
+                           "FFT",
+                           "Blur the whole image at once using FFT convolution, much faster for "
+                           "large sizes (variable sizes are approximated)");
+  RNA_def_property_update(prop, NC_NODE | NA_EDITED, "rna_Node_update");
+
 #  if 0
   prop = RNA_def_property(srna, "f_stop", PROP_FLOAT, PROP_NONE);
   RNA_def_property_float_sdna(prop, NULL, "custom3");
@@ -10249,12 +10265,40 @@ static void rna_def_composite_nodetree(BlenderRNA *brna)
   StructRNA *srna;
   PropertyRNA *prop;
 
+  static const EnumPropertyItem execution_mode_items[] = {
+      {NTREE_EXECUTION_MODE_TILED,
+       "TILED",
+       0,
+       "Tiled",
+       "Evaluate the node tree in tiles, pixel by pixel"},
+      {NTREE_EXECUTION_MODE_FULL_FRAME,
+       "FULL_FRAME",
+       0,
+       "Full Frame",
+       "Evaluate each node for the whole image at once, in dependency order"},
+      {0, NULL, 0, NULL, NULL},
+  };
+
   srna = RNA_def_struct(brna, "CompositorNodeTree", "NodeTree");
   RNA_def_struct_ui_text(
       srna, "Compositor Node Tree", "Node tree consisting of linked nodes used for compositing");
   RNA_def_struct_sdna(srna, "bNodeTree");
   RNA_def_struct_ui_icon(srna, ICON_RENDERLAYERS);
 
+  prop = RNA_def_property(srna, "execution_mode", PROP_ENUM, PROP_NONE);
+  RNA_def_property_enum_sdna(prop, NULL, "execution_mode");
+  RNA_def_property_enum_items(prop, execution_mode_items);
+  RNA_def_property_ui_text(prop, "Execution Mode", "Set how the compositor evaluates nodes");
+  RNA_def_property_update(prop, NC_NODE | NA_EDITED, "rna_NodeTree_update");
+
+  prop = RNA_def_property(srna, "use_half_buffers", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", NTREE_COM_HALF_BUFFERS);
+  RNA_def_property_ui_text(prop,
+                           "Half Float Buffers",
+                           "Store calculated colors as half floats while they are not used, "
+                           "halving their memory usage (Full Frame only)");
+  RNA_def_property_update(prop, NC_NODE | NA_EDITED, "rna_NodeTree_update");
+
   prop = RNA_def_property(srna, "render_quality", PROP_ENUM, PROP_NONE);
   RNA_def_property_enum_sdna(prop, NULL, "render_quality");
   RNA_def_property_enum_items(prop, node_quality_items);
@@ -300,6 +300,7 @@ ModifierTypeInfo modifierType_Armature = {
 
     /* initData */ initData,
     /* requiredDataMask */ requiredDataMask,
+    /* writtenDataMask */ NULL,
     /* freeData */ NULL,
     /* isDisabled */ isDisabled,
     /* updateDepsgraph */ updateDepsgraph,
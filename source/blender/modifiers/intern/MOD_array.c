@@ -1023,6 +1023,7 @@ ModifierTypeInfo modifierType_Array = {
 
     /* initData */ initData,
     /* requiredDataMask */ NULL,
+    /* writtenDataMask */ NULL,
     /* freeData */ NULL,
     /* isDisabled */ isDisabled,
     /* updateDepsgraph */ updateDepsgraph,
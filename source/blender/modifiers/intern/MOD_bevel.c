@@ -451,6 +451,7 @@ ModifierTypeInfo modifierType_Bevel = {
     /* modifyVolume */ NULL,
     /* initData */ initData,
     /* requiredDataMask */ requiredDataMask,
+    /* writtenDataMask */ NULL,
     /* freeData */ freeData,
     /* isDisabled */ isDisabled,
     /* updateDepsgraph */ NULL,
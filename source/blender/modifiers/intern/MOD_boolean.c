@@ -824,6 +824,7 @@ ModifierTypeInfo modifierType_Boolean = {
 
     /* initData */ initData,
     /* requiredDataMask */ requiredDataMask,
+    /* writtenDataMask */ NULL,
     /* freeData */ NULL,
     /* isDisabled */ isDisabled,
     /* updateDepsgraph */ updateDepsgraph,
@@ -351,6 +351,7 @@ ModifierTypeInfo modifierType_Build = {
 
     /* initData */ initData,
     /* requiredDataMask */ NULL,
+    /* writtenDataMask */ NULL,
     /* freeData */ NULL,
     /* isDisabled */ NULL,
     /* updateDepsgraph */ NULL,
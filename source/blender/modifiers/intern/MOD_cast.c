@@ -595,6 +595,7 @@ ModifierTypeInfo modifierType_Cast = {
 
     /* initData */ initData,
     /* requiredDataMask */ requiredDataMask,
+    /* writtenDataMask */ NULL,
     /* freeData */ NULL,
     /* isDisabled */ isDisabled,
     /* updateDepsgraph */ updateDepsgraph,
@@ -315,6 +315,7 @@ ModifierTypeInfo modifierType_Cloth = {
 
     /* initData */ initData,
     /* requiredDataMask */ requiredDataMask,
+    /* writtenDataMask */ NULL,
     /* freeData */ freeData,
     /* isDisabled */ NULL,
     /* updateDepsgraph */ updateDepsgraph,
@@ -316,6 +316,7 @@ ModifierTypeInfo modifierType_Collision = {
 
     /* initData */ initData,
     /* requiredDataMask */ NULL,
+    /* writtenDataMask */ NULL,
     /* freeData */ freeData,
     /* isDisabled */ NULL,
     /* updateDepsgraph */ updateDepsgraph,
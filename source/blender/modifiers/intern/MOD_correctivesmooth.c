@@ -856,6 +856,7 @@ ModifierTypeInfo modifierType_CorrectiveSmooth = {
 
     /* initData */ initData,
     /* requiredDataMask */ requiredDataMask,
+    /* writtenDataMask */ NULL,
     /* freeData */ freeData,
     /* isDisabled */ NULL,
     /* updateDepsgraph */ NULL,
@@ -101,6 +101,31 @@ static void requiredDataMask(Object *UNUSED(ob),
   BKE_object_data_transfer_dttypes_to_cdmask(dtmd->data_types, r_cddata_masks);
 }
 
+static void writtenDataMask(Object *UNUSED(ob),
+                            ModifierData *md,
+                            CustomData_MeshMasks *r_cddata_masks)
+{
+  DataTransferModifierData *dtmd = (DataTransferModifierData *)md;
+
+  BKE_object_data_transfer_dttypes_to_cdmask(dtmd->data_types, r_cddata_masks);
+
+  /* Some data is stored in the geometry arrays themselves (flags, bevel weights and creases),
+   * setting custom normals may also tag edges as sharp. */
+  if (dtmd->data_types & DT_TYPE_SHAPEKEY) {
+    r_cddata_masks->vmask |= CD_MASK_SHAPEKEY;
+  }
+  if (dtmd->data_types & DT_TYPE_BWEIGHT_VERT) {
+    r_cddata_masks->vmask |= CD_MASK_MVERT;
+  }
+  if (dtmd->data_types & (DT_TYPE_SHARP_EDGE | DT_TYPE_SEAM | DT_TYPE_CREASE |
+                          DT_TYPE_BWEIGHT_EDGE | DT_TYPE_LNOR)) {
+    r_cddata_masks->emask |= CD_MASK_MEDGE;
+  }
+  if (dtmd->data_types & DT_TYPE_SHARP_FACE) {
+    r_cddata_masks->pmask |= CD_MASK_MPOLY;
+  }
+}
+
 static bool dependsOnNormals(ModifierData *md)
 {
   DataTransferModifierData *dtmd = (DataTransferModifierData *)md;
@@ -499,6 +524,7 @@ ModifierTypeInfo modifierType_DataTransfer = {
 
     /* initData */ initData,
     /* requiredDataMask */ requiredDataMask,
+    /* writtenDataMask */ writtenDataMask,
     /* freeData */ NULL,
     /* isDisabled */ isDisabled,
     /* updateDepsgraph */ updateDepsgraph,
@@ -191,6 +191,7 @@ ModifierTypeInfo modifierType_EdgeSplit = {
 
     /* initData */ initData,
     /* requiredDataMask */ NULL,
+    /* writtenDataMask */ NULL,
     /* freeData */ NULL,
     /* isDisabled */ NULL,
     /* updateDepsgraph */ NULL,
@@ -639,6 +639,7 @@ ModifierTypeInfo modifierType_LaplacianSmooth = {
 
     /* initData */ init_data,
     /* requiredDataMask */ required_data_mask,
+    /* writtenDataMask */ NULL,
     /* freeData */ NULL,
     /* isDisabled */ is_disabled,
     /* updateDepsgraph */ NULL,
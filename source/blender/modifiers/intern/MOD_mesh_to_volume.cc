@@ -300,6 +300,7 @@ ModifierTypeInfo modifierType_MeshToVolume = {
 
     /* initData */ initData,
     /* requiredDataMask */ nullptr,
+    /* writtenDataMask */ nullptr,
     /* freeData */ nullptr,
     /* isDisabled */ nullptr,
     /* updateDepsgraph */ updateDepsgraph,
@@ -393,6 +393,7 @@ ModifierTypeInfo modifierType_MeshCache = {
 
     /* initData */ initData,
     /* requiredDataMask */ NULL,
+    /* writtenDataMask */ NULL,
     /* freeData */ NULL,
     /* isDisabled */ isDisabled,
     /* updateDepsgraph */ NULL,
@@ -239,6 +239,7 @@ ModifierTypeInfo modifierType_Mirror = {
 
     /* initData */ initData,
     /* requiredDataMask */ NULL,
+    /* writtenDataMask */ NULL,
     /* freeData */ NULL,
     /* isDisabled */ NULL,
     /* updateDepsgraph */ updateDepsgraph,
@@ -21,20 +21,28 @@
  * \ingroup modifiers
  */
 
+#include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
 
 #include "MEM_guardedalloc.h"
 
 #include "BLI_float3.hh"
+#include "BLI_hash_md5.h"
 #include "BLI_listbase.h"
 #include "BLI_set.hh"
 #include "BLI_string.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "DNA_collection_types.h"
 #include "DNA_defaults.h"
+#include "DNA_material_types.h"
 #include "DNA_mesh_types.h"
 #include "DNA_meshdata_types.h"
 #include "DNA_modifier_types.h"
@@ -43,8 +51,12 @@
 #include "DNA_pointcloud_types.h"
 #include "DNA_scene_types.h"
 #include "DNA_screen_types.h"
+#include "DNA_texture_types.h"
+#include "DNA_userdef_types.h"
 
 #include "BKE_customdata.h"
+#include "BKE_geometry_nodes_profile.hh"
+#include "BKE_global.h"
 #include "BKE_idprop.h"
 #include "BKE_lib_query.h"
 #include "BKE_mesh.h"
@@ -82,6 +94,7 @@ using blender::Span;
 using blender::StringRef;
 using blender::Vector;
 using blender::fn::GMutablePointer;
+using blender::fn::GPointer;
 using blender::fn::GValueMap;
 using blender::nodes::GeoNodeExecParams;
 using namespace blender::nodes::derived_node_tree_types;
@@ -192,38 +205,525 @@ static bool isDisabled(const struct Scene *UNUSED(scene),
   return false;
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Geometry Nodes Result Cache
+ *
+ * The outputs of expensive nodes are kept between evaluations of the modifier, so that they are
+ * not computed again when only nodes further down the tree changed, or when the frame changed
+ * without affecting them. Results are identified by a key containing everything they depend on:
+ * the node type and settings, unlinked input values and, recursively, the keys of the linked
+ * nodes. Keys are compared completely, so results are never confused because of a hash
+ * collision. Geometry passed to the modifier is too large to be copied into keys, so it is
+ * represented by its layout and the MD5 digests of its attribute arrays. Nodes depending on data
+ * that cannot be represented like that (objects, collections and instances) are never cached.
+ *
+ * The least recently used results are freed when the memory used by all caches exceeds
+ * #UserDef.geometry_nodes_cache_limit.
+ * \{ */
+
+/* Keys of nodes that depend on many other nodes are not cached, to avoid spending more time and
+ * memory on the keys than on the results. */
+static constexpr int64_t cache_key_size_limit = 64 * 1024;
+
+template<typename T> static void key_append(std::string &key, const T &value)
+{
+  /* Only types without padding bytes, whose value is fully defined by their bytes. */
+  static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>);
+  key.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+static void key_append_string(std::string &key, const StringRef str)
+{
+  key_append(key, str.size());
+  key.append(str.data(), (size_t)str.size());
+}
+
+static void key_append_digest(std::string &key, const void *data, const size_t size)
+{
+  char digest[16];
+  BLI_hash_md5_buffer(static_cast<const char *>(data), size, digest);
+  key_append(key, size);
+  key.append(digest, sizeof(digest));
+}
+
+static bool customdata_append_key(std::string &key, const CustomData &data, const int totelem)
+{
+  key_append(key, totelem);
+  key_append(key, data.totlayer);
+  for (const int i : IndexRange(data.totlayer)) {
+    const CustomDataLayer &layer = data.layers[i];
+    if (ELEM(layer.type, CD_MDISPS, CD_GRID_PAINT_MASK, CD_BM_ELEM_PYPTR)) {
+      /* These layers point to data that is not part of the digest. */
+      return false;
+    }
+    key_append(key, layer.type);
+    key_append(key, layer.active);
+    key_append(key, layer.active_rnd);
+    key_append_string(key, layer.name);
+    if (layer.type == CD_MDEFORMVERT) {
+      /* Use the weights, not the pointers to them. */
+      std::string weights;
+      const MDeformVert *dverts = static_cast<const MDeformVert *>(layer.data);
+      for (const int j : IndexRange(totelem)) {
+        const MDeformVert &dvert = dverts[j];
+        key_append(weights, dvert.totweight);
+        for (const int k : IndexRange(dvert.totweight)) {
+          key_append(weights, dvert.dw[k].def_nr);
+          key_append(weights, dvert.dw[k].weight);
+        }
+      }
+      key_append_digest(key, weights.data(), weights.size());
+    }
+    else {
+      key_append_digest(key, layer.data, (size_t)CustomData_sizeof(layer.type) * totelem);
+    }
+  }
+  return true;
+}
+
+static int64_t customdata_memory_size(const CustomData &data, const int totelem)
+{
+  int64_t size = 0;
+  for (const int i : IndexRange(data.totlayer)) {
+    size += (int64_t)CustomData_sizeof(data.layers[i].type) * totelem;
+  }
+  return size;
+}
+
+static void materials_append_key(std::string &key, Material **materials, const int totcol)
+{
+  key_append(key, totcol);
+  for (const int i : IndexRange(totcol)) {
+    /* The session UUID is never reused, contrary to the address of a freed material. */
+    key_append(key, (materials[i] == nullptr) ? 0u : materials[i]->id.session_uuid);
+  }
+}
+
+/**
+ * Append the content of a geometry to the key, or return false when the geometry contains data
+ * that cannot be represented. Materials are identified by their session UUID, so that a cached
+ * geometry is only used while those materials still exist.
+ */
+static bool geometry_set_append_key(std::string &key, const GeometrySet &geometry_set)
+{
+  if (geometry_set.has_instances()) {
+    return false;
+  }
+  const MeshComponent *component = geometry_set.get_component_for_read<MeshComponent>();
+  const Mesh *mesh = (component == nullptr) ? nullptr : component->get_for_read();
+  key_append(key, mesh != nullptr);
+  if (mesh != nullptr) {
+    /* Sort the vertex groups, so that the key does not depend on the order in the map. */
+    Vector<std::pair<std::string, int>> vertex_groups;
+    for (auto item : component->vertex_group_names().items()) {
+      vertex_groups.append({item.key, item.value});
+    }
+    std::sort(vertex_groups.begin(), vertex_groups.end());
+    key_append(key, vertex_groups.size());
+    for (const std::pair<std::string, int> &vertex_group : vertex_groups) {
+      key_append_string(key, vertex_group.first);
+      key_append(key, vertex_group.second);
+    }
+    if (!customdata_append_key(key, mesh->vdata, mesh->totvert) ||
+        !customdata_append_key(key, mesh->edata, mesh->totedge) ||
+        !customdata_append_key(key, mesh->ldata, mesh->totloop) ||
+        !customdata_append_key(key, mesh->pdata, mesh->totpoly)) {
+      return false;
+    }
+    materials_append_key(key, mesh->mat, mesh->totcol);
+    key_append(key, mesh->flag);
+    key_append(key, mesh->smoothresh);
+  }
+  const PointCloud *pointcloud = geometry_set.get_pointcloud_for_read();
+  key_append(key, pointcloud != nullptr);
+  if (pointcloud != nullptr) {
+    if (!customdata_append_key(key, pointcloud->pdata, pointcloud->totpoint)) {
+      return false;
+    }
+    materials_append_key(key, pointcloud->mat, pointcloud->totcol);
+  }
+  return true;
+}
+
+/**
+ * Append a socket value to the key, or return false when it cannot be represented. Values
+ * referencing data-blocks are never part of keys, since their content is not known here.
+ */
+static bool value_append_key(std::string &key, const GPointer value)
+{
+  const CPPType &type = *value.type();
+  key_append_string(key, type.name());
+  if (type.is<GeometrySet>()) {
+    return geometry_set_append_key(key, *static_cast<const GeometrySet *>(value.get()));
+  }
+  if (type.is<std::string>()) {
+    key_append_string(key, *static_cast<const std::string *>(value.get()));
+    return true;
+  }
+  if (type.is<float>() || type.is<int>() || type.is<bool>() || type.is<float3>() ||
+      type.is<blender::Color4f>()) {
+    /* These types have no padding bytes. */
+    key.append(static_cast<const char *>(value.get()), (size_t)type.size());
+    return true;
+  }
+  return false;
+}
+
+static void color_band_append_key(std::string &key, const ColorBand &color_band)
+{
+  key_append(key, color_band.tot);
+  key_append(key, color_band.ipotype);
+  key_append(key, color_band.ipotype_hue);
+  key_append(key, color_band.color_mode);
+  for (const int i : IndexRange(color_band.tot)) {
+    const CBData &data = color_band.data[i];
+    key_append(key, data.r);
+    key_append(key, data.g);
+    key_append(key, data.b);
+    key_append(key, data.a);
+    key_append(key, data.pos);
+  }
+}
+
+/**
+ * Append the settings stored in the node storage to the key, field by field, so that padding
+ * bytes and pointers are not part of it. Returns false for storage types not handled here.
+ */
+static bool node_storage_append_key(std::string &key, const bNode &bnode)
+{
+  if (bnode.storage == nullptr) {
+    return true;
+  }
+  switch (bnode.type) {
+    case GEO_NODE_ATTRIBUTE_COMPARE: {
+      const NodeAttributeCompare &storage = *static_cast<const NodeAttributeCompare *>(
+          bnode.storage);
+      key_append(key, storage.operation);
+      key_append(key, storage.input_type_a);
+      key_append(key, storage.input_type_b);
+      return true;
+    }
+    case GEO_NODE_ATTRIBUTE_MATH: {
+      const NodeAttributeMath &storage = *static_cast<const NodeAttributeMath *>(bnode.storage);
+      key_append(key, storage.operation);
+      key_append(key, storage.input_type_a);
+      key_append(key, storage.input_type_b);
+      return true;
+    }
+    case GEO_NODE_ATTRIBUTE_MIX: {
+      const NodeAttributeMix &storage = *static_cast<const NodeAttributeMix *>(bnode.storage);
+      key_append(key, storage.blend_type);
+      key_append(key, storage.input_type_factor);
+      key_append(key, storage.input_type_a);
+      key_append(key, storage.input_type_b);
+      return true;
+    }
+    case GEO_NODE_ATTRIBUTE_COLOR_RAMP: {
+      const NodeAttributeColorRamp &storage = *static_cast<const NodeAttributeColorRamp *>(
+          bnode.storage);
+      color_band_append_key(key, storage.color_ramp);
+      return true;
+    }
+    case SH_NODE_VALTORGB: {
+      color_band_append_key(key, *static_cast<const ColorBand *>(bnode.storage));
+      return true;
+    }
+    case FN_NODE_INPUT_VECTOR: {
+      const NodeInputVector &storage = *static_cast<const NodeInputVector *>(bnode.storage);
+      for (const int i : IndexRange(3)) {
+        key_append(key, storage.vector[i]);
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+static int64_t value_memory_size(const GPointer value)
+{
+  if (value.type()->is<GeometrySet>()) {
+    const GeometrySet &geometry_set = *static_cast<const GeometrySet *>(value.get());
+    int64_t size = sizeof(GeometrySet);
+    if (const Mesh *mesh = geometry_set.get_mesh_for_read()) {
+      size += customdata_memory_size(mesh->vdata, mesh->totvert);
+      size += customdata_memory_size(mesh->edata, mesh->totedge);
+      size += customdata_memory_size(mesh->ldata, mesh->totloop);
+      size += customdata_memory_size(mesh->pdata, mesh->totpoly);
+    }
+    if (const PointCloud *pointcloud = geometry_set.get_pointcloud_for_read()) {
+      size += customdata_memory_size(pointcloud->pdata, pointcloud->totpoint);
+    }
+    return size;
+  }
+  return value.type()->size();
+}
+
+static int64_t geometry_nodes_cache_limit()
+{
+  return (int64_t)U.geometry_nodes_cache_limit * 1024 * 1024;
+}
+
+class GeometryNodesCache;
+
+/* The caches of all the modifiers, the least recently used results are freed across all of them.
+ * The mutex protects the caches, their memory size and the usage counter. */
+static std::mutex geometry_nodes_caches_mutex;
+static Set<GeometryNodesCache *> geometry_nodes_caches;
+static int64_t geometry_nodes_cache_memory_size = 0;
+static uint64_t geometry_nodes_cache_usage_counter = 0;
+
+/**
+ * Results cached for one modifier. It is stored in the runtime data of the original modifier,
+ * so that it is kept when the evaluated copies are recreated.
+ */
+class GeometryNodesCache {
+ private:
+  struct Entry {
+    /** Values of the available outputs of the node, owned by the cache. */
+    Vector<GMutablePointer> values;
+    int64_t memory_size;
+    uint64_t last_used;
+  };
+
+  Map<std::string, Entry> entries_;
+
+ public:
+  GeometryNodesCache()
+  {
+    std::lock_guard lock{geometry_nodes_caches_mutex};
+    geometry_nodes_caches.add_new(this);
+  }
+
+  ~GeometryNodesCache()
+  {
+    std::lock_guard lock{geometry_nodes_caches_mutex};
+    geometry_nodes_caches.remove_contained(this);
+    for (Entry &entry : entries_.values()) {
+      free_entry(entry);
+    }
+  }
+
+  /**
+   * Copy the values cached for the key into the allocator.
+   * Returns false when there are no values of the given types for this key.
+   */
+  bool lookup(const std::string &key,
+              Span<const CPPType *> types,
+              blender::LinearAllocator<> &allocator,
+              Vector<GMutablePointer> &r_values)
+  {
+    std::lock_guard lock{geometry_nodes_caches_mutex};
+    Entry *entry = entries_.lookup_ptr(key);
+    if (entry == nullptr || entry->values.size() != types.size()) {
+      return false;
+    }
+    for (const int i : types.index_range()) {
+      if (*entry->values[i].type() != *types[i]) {
+        return false;
+      }
+    }
+    entry->last_used = geometry_nodes_cache_usage_counter++;
+    for (const GMutablePointer value : entry->values) {
+      const CPPType &type = *value.type();
+      void *buffer = allocator.allocate(type.size(), type.alignment());
+      type.copy_to_uninitialized(value.get(), buffer);
+      r_values.append({type, buffer});
+    }
+    return true;
+  }
+
+  void add(const std::string &key, Span<GMutablePointer> values)
+  {
+    const int64_t limit = geometry_nodes_cache_limit();
+    int64_t memory_size = (int64_t)key.size();
+    for (const GMutablePointer value : values) {
+      memory_size += value_memory_size(value);
+    }
+    if (memory_size > limit) {
+      return;
+    }
+    Entry entry;
+    entry.memory_size = memory_size;
+    for (const GMutablePointer value : values) {
+      const CPPType &type = *value.type();
+      void *buffer = MEM_mallocN_aligned(type.size(), type.alignment(), __func__);
+      type.copy_to_uninitialized(value.get(), buffer);
+      entry.values.append({type, buffer});
+    }
+
+    std::lock_guard lock{geometry_nodes_caches_mutex};
+    entry.last_used = geometry_nodes_cache_usage_counter++;
+    geometry_nodes_cache_memory_size += memory_size;
+    if (entries_.contains(key)) {
+      /* Computed concurrently by another evaluation. */
+      free_entry(entry);
+      return;
+    }
+    entries_.add_new(key, std::move(entry));
+    free_least_recently_used(limit);
+  }
+
+ private:
+  /**
+   * Free the least recently used results of all modifiers until the memory fits the limit.
+   * The result added last is never freed, it fits the limit by itself.
+   */
+  static void free_least_recently_used(const int64_t limit)
+  {
+    while (geometry_nodes_cache_memory_size > limit) {
+      GeometryNodesCache *oldest_cache = nullptr;
+      const std::string *oldest_key = nullptr;
+      uint64_t oldest_usage = UINT64_MAX;
+      for (GeometryNodesCache *cache : geometry_nodes_caches) {
+        for (auto item : cache->entries_.items()) {
+          if (item.value.last_used < oldest_usage) {
+            oldest_cache = cache;
+            oldest_key = &item.key;
+            oldest_usage = item.value.last_used;
+          }
+        }
+      }
+      if (oldest_usage == geometry_nodes_cache_usage_counter - 1) {
+        break;
+      }
+      Entry oldest_entry = oldest_cache->entries_.pop(std::string(*oldest_key));
+      free_entry(oldest_entry);
+    }
+  }
+
+  static void free_entry(Entry &entry)
+  {
+    for (GMutablePointer value : entry.values) {
+      value.destruct();
+      MEM_freeN(value.get());
+    }
+    entry.values.clear();
+    geometry_nodes_cache_memory_size -= entry.memory_size;
+    entry.memory_size = 0;
+  }
+};
+
+/** Get the cache stored in the original modifier, or null when caching is disabled. */
+static GeometryNodesCache *geometry_nodes_cache_ensure(ModifierData *md)
+{
+  if (geometry_nodes_cache_limit() == 0) {
+    return nullptr;
+  }
+  ModifierData *md_orig = BKE_modifier_get_original(md);
+  /* Several depsgraphs may evaluate the same modifier at the same time. */
+  static std::mutex mutex;
+  std::lock_guard lock{mutex};
+  if (md_orig->runtime == nullptr) {
+    md_orig->runtime = OBJECT_GUARDED_NEW(GeometryNodesCache);
+  }
+  return static_cast<GeometryNodesCache *>(md_orig->runtime);
+}
+
+/**
+ * Only nodes that are expensive compared to copying their output geometry are cached.
+ * Other nodes would mostly use memory and force copies of geometry that could be modified
+ * in place otherwise.
+ */
+static bool node_supports_caching(const bNode &bnode)
+{
+  return ELEM(bnode.type,
+              GEO_NODE_POINT_DISTRIBUTE,
+              GEO_NODE_BOOLEAN,
+              GEO_NODE_SUBDIVISION_SURFACE,
+              GEO_NODE_TRIANGULATE,
+              GEO_NODE_EDGE_SPLIT);
+}
+
+/** \} */
+
+/**
+ * Evaluates the nodes required to compute the group outputs. Nodes are scheduled in a task pool
+ * once all the nodes they depend on have been executed, so that independent branches of the tree
+ * are computed in parallel. Since every node only sees the values of its own inputs, the result
+ * does not depend on the order in which the nodes are executed.
+ */
 class GeometryNodesEvaluator {
  private:
+  /** Per-node state, only created for nodes that have to be executed. */
+  struct NodeState {
+    /** Number of executed nodes this node still has to wait for. */
+    std::atomic<int> missing_dependencies = 0;
+    /** Nodes that depend on outputs of this node, without duplicates. */
+    Vector<const DNode *> users;
+    /**
+     * Values created while executing the node are allocated here. A node is only executed by
+     * one thread at a time, so this does not have to be protected.
+     */
+    blender::LinearAllocator<> allocator;
+    /** True when the outputs have been loaded from the cache, the node is not executed then. */
+    bool is_cached = false;
+    Vector<GMutablePointer> cached_outputs;
+  };
+
   blender::LinearAllocator<> allocator_;
+  /** Protects #value_by_input_, which is accessed by all tasks. */
+  std::mutex value_by_input_mutex_;
   Map<const DInputSocket *, GMutablePointer> value_by_input_;
+  Map<const DNode *, std::unique_ptr<NodeState>> node_states_;
+  /** Outputs of the group input node, their values are known before the evaluation starts. */
+  Set<const DOutputSocket *> group_input_sockets_;
   Vector<const DInputSocket *> group_outputs_;
   blender::nodes::MultiFunctionByNode &mf_by_node_;
   const blender::nodes::DataTypeConversions &conversions_;
   const blender::bke::PersistentDataHandleMap &handle_map_;
   const Object *self_object_;
+  /** When true, the evaluation is cancelled once #G.is_break is set. */
+  const bool use_break_;
+  std::atomic<bool> is_cancelled_ = false;
+  /** May be null, when results are not cached. */
+  GeometryNodesCache *cache_;
+  /**
+   * Memoized keys of group input values, see #group_input_key. They are only computed when a
+   * cached node depends on them, because geometry has to be read completely for that.
+   */
+  Map<const DOutputSocket *, std::optional<std::string>> group_input_keys_;
+  /** Memoized cache keys of nodes, see #node_cache_key. */
+  Map<const DNode *, std::optional<std::string>> node_keys_;
+  /** Identifies the modifier in recorded profile events. */
+  const ModifierData &modifier_;
+  /** True when node executions are recorded, see #BKE_geometry_nodes_profile_is_enabled. */
+  const bool use_profile_;
 
  public:
   GeometryNodesEvaluator(const Map<const DOutputSocket *, GMutablePointer> &group_input_data,
                          Vector<const DInputSocket *> group_outputs,
                          blender::nodes::MultiFunctionByNode &mf_by_node,
                          const blender::bke::PersistentDataHandleMap &handle_map,
-                         const Object *self_object)
+                         const Object *self_object,
+                         const bool use_break,
+                         GeometryNodesCache *cache,
+                         const ModifierData &modifier)
       : group_outputs_(std::move(group_outputs)),
         mf_by_node_(mf_by_node),
         conversions_(blender::nodes::get_implicit_type_conversions()),
         handle_map_(handle_map),
-        self_object_(self_object)
+        self_object_(self_object),
+        use_break_(use_break),
+        cache_(cache),
+        modifier_(modifier),
+        use_profile_(BKE_geometry_nodes_profile_is_enabled())
   {
     for (auto item : group_input_data.items()) {
-      this->forward_to_inputs(*item.key, item.value);
+      group_input_sockets_.add_new(item.key);
+      this->forward_to_inputs(*item.key, item.value, allocator_);
     }
   }
 
   Vector<GMutablePointer> execute()
   {
+    for (const DInputSocket *group_output : group_outputs_) {
+      this->add_required_nodes(*group_output);
+    }
+    this->execute_required_nodes();
+
     Vector<GMutablePointer> results;
     for (const DInputSocket *group_output : group_outputs_) {
-      GMutablePointer result = this->get_input_value(*group_output);
+      GMutablePointer result = this->get_input_value(*group_output, allocator_);
       results.append(result);
     }
     for (GMutablePointer value : value_by_input_.values()) {
@@ -232,73 +732,407 @@ class GeometryNodesEvaluator {
     return results;
   }
 
+  /**
+   * Nodes that have not been executed yet output default values from now on. This can be called
+   * from any thread.
+   */
+  void cancel()
+  {
+    is_cancelled_ = true;
+  }
+
  private:
-  GMutablePointer get_input_value(const DInputSocket &socket_to_compute)
+  /**
+   * Get the node computing the value of the given input, or null when the value does not come
+   * from the execution of another node.
+   */
+  const DNode *find_origin_node(const DInputSocket &socket) const
   {
-    std::optional<GMutablePointer> value = value_by_input_.pop_try(&socket_to_compute);
-    if (value.has_value()) {
-      /* This input has been computed before, return it directly. */
-      return *value;
+    Span<const DOutputSocket *> from_sockets = socket.linked_sockets();
+    BLI_assert(from_sockets.size() + socket.linked_group_inputs().size() <= 1);
+    if (from_sockets.size() == 0) {
+      return nullptr;
+    }
+    const DOutputSocket &from_socket = *from_sockets[0];
+    if (!from_socket.is_available()) {
+      /* A default value is used instead. */
+      return nullptr;
     }
+    if (group_input_sockets_.contains(&from_socket)) {
+      /* The value has been forwarded already. */
+      return nullptr;
+    }
+    return &from_socket.node();
+  }
 
-    Span<const DOutputSocket *> from_sockets = socket_to_compute.linked_sockets();
-    Span<const DGroupInput *> from_group_inputs = socket_to_compute.linked_group_inputs();
-    const int total_inputs = from_sockets.size() + from_group_inputs.size();
-    BLI_assert(total_inputs <= 1);
+  /** Create the state of all the nodes the given input depends on. */
+  void add_required_nodes(const DInputSocket &socket_to_compute)
+  {
+    const DNode *origin_node = find_origin_node(socket_to_compute);
+    if (origin_node == nullptr || node_states_.contains(origin_node)) {
+      return;
+    }
 
-    if (total_inputs == 0) {
-      /* The input is not connected, use the value from the socket itself. */
-      return get_unlinked_input_value(socket_to_compute);
+    Vector<const DNode *> nodes_to_check = {origin_node};
+    node_states_.add_new(origin_node, std::make_unique<NodeState>());
+    while (!nodes_to_check.is_empty()) {
+      const DNode &node = *nodes_to_check.pop_last();
+      NodeState &state = *node_states_.lookup(&node);
+      if (this->load_cached_outputs(node, state)) {
+        /* The nodes this node depends on don't have to be executed for it. */
+        continue;
+      }
+      for (const DInputSocket *input_socket : node.inputs()) {
+        if (!input_socket->is_available()) {
+          continue;
+        }
+        const DNode *dependency = find_origin_node(*input_socket);
+        if (dependency == nullptr) {
+          continue;
+        }
+        if (!node_states_.contains(dependency)) {
+          node_states_.add_new(dependency, std::make_unique<NodeState>());
+          nodes_to_check.append(dependency);
+        }
+        NodeState &dependency_state = *node_states_.lookup(dependency);
+        if (!dependency_state.users.contains(&node)) {
+          dependency_state.users.append(&node);
+          state.missing_dependencies++;
+        }
+      }
+    }
+  }
+
+  /**
+   * Key of the value a group input passes to the input socket, nothing when it cannot be
+   * represented. This has to be called before the evaluation starts, while the value is still
+   * stored for the socket.
+   */
+  std::optional<std::string> group_input_key(const DOutputSocket &from_socket,
+                                             const DInputSocket &socket)
+  {
+    if (ELEM(from_socket.bsocket()->type, SOCK_OBJECT, SOCK_COLLECTION)) {
+      return std::nullopt;
+    }
+    const GMutablePointer value = value_by_input_.lookup(&socket);
+    /* Converted values differ between the linked sockets, only memoize the original value. */
+    const bool is_converted = from_socket.typeinfo() != socket.typeinfo();
+    if (!is_converted) {
+      if (const std::optional<std::string> *key = group_input_keys_.lookup_ptr(&from_socket)) {
+        return *key;
+      }
     }
-    if (from_group_inputs.size() == 1) {
-      /* The input gets its value from the input of a group that is not further connected. */
-      return get_unlinked_input_value(socket_to_compute);
+    std::optional<std::string> key{std::in_place};
+    if (!value_append_key(*key, value)) {
+      key.reset();
     }
+    if (!is_converted) {
+      group_input_keys_.add_new(&from_socket, key);
+    }
+    return key;
+  }
 
-    /* Compute the socket now. */
-    const DOutputSocket &from_socket = *from_sockets[0];
-    this->compute_output_and_forward(from_socket);
-    return value_by_input_.pop(&socket_to_compute);
+  /** Append an unlinked input value to the key, false when it cannot be represented. */
+  bool unlinked_input_append_key(std::string &key, const DInputSocket &socket)
+  {
+    const bNodeSocket *bsocket = (socket.linked_group_inputs().size() == 0) ?
+                                     socket.bsocket() :
+                                     socket.linked_group_inputs()[0]->bsocket();
+    if (ELEM(bsocket->type, SOCK_OBJECT, SOCK_COLLECTION, SOCK_GEOMETRY)) {
+      return false;
+    }
+    blender::LinearAllocator<> allocator;
+    GMutablePointer value = this->get_unlinked_input_value(socket, allocator);
+    const bool success = value_append_key(key, value);
+    value.destruct();
+    return success;
+  }
+
+  /**
+   * Compute a key identifying the outputs of a node from its settings and everything its inputs
+   * depend on. Returns nothing when the node depends on data that cannot be represented.
+   */
+  std::optional<std::string> node_cache_key(const DNode &node)
+  {
+    if (const std::optional<std::string> *key = node_keys_.lookup_ptr(&node)) {
+      return *key;
+    }
+    std::optional<std::string> key = this->compute_node_cache_key(node);
+    if (key.has_value() && (int64_t)key->size() > cache_key_size_limit) {
+      key.reset();
+    }
+    node_keys_.add_new(&node, key);
+    return key;
   }
 
-  void compute_output_and_forward(const DOutputSocket &socket_to_compute)
+  std::optional<std::string> compute_node_cache_key(const DNode &node)
   {
-    const DNode &node = socket_to_compute.node();
     const bNode &bnode = *node.bnode();
+    std::string key;
+    key_append_string(key, bnode.typeinfo->idname);
+    key_append(key, bnode.custom1);
+    key_append(key, bnode.custom2);
+    key_append(key, bnode.custom3);
+    key_append(key, bnode.custom4);
+    if (!node_storage_append_key(key, bnode)) {
+      return std::nullopt;
+    }
+
+    for (const DInputSocket *input_socket : node.inputs()) {
+      if (!input_socket->is_available()) {
+        continue;
+      }
+      key_append(key, input_socket->index());
+      Span<const DOutputSocket *> from_sockets = input_socket->linked_sockets();
+      if (from_sockets.size() == 0) {
+        if (!this->unlinked_input_append_key(key, *input_socket)) {
+          return std::nullopt;
+        }
+        continue;
+      }
+      const DOutputSocket &from_socket = *from_sockets[0];
+      if (!from_socket.is_available()) {
+        /* The default value of the type is used. */
+        key_append_string(key, from_socket.idname());
+      }
+      else if (group_input_sockets_.contains(&from_socket)) {
+        const std::optional<std::string> input_key = this->group_input_key(from_socket,
+                                                                           *input_socket);
+        if (!input_key.has_value()) {
+          return std::nullopt;
+        }
+        key_append_string(key, *input_key);
+      }
+      else {
+        const std::optional<std::string> from_key = this->node_cache_key(from_socket.node());
+        if (!from_key.has_value()) {
+          return std::nullopt;
+        }
+        key_append_string(key, *from_key);
+        key_append(key, from_socket.index());
+      }
+    }
+    return key;
+  }
+
+  /** Load the outputs of the node from the cache when possible. */
+  bool load_cached_outputs(const DNode &node, NodeState &state)
+  {
+    if (cache_ == nullptr || !node_supports_caching(*node.bnode())) {
+      return false;
+    }
+    const std::optional<std::string> key = this->node_cache_key(node);
+    if (!key.has_value()) {
+      return false;
+    }
+    Vector<const CPPType *> output_types;
+    for (const DOutputSocket *output_socket : node.outputs()) {
+      if (output_socket->is_available()) {
+        output_types.append(blender::nodes::socket_cpp_type_get(*output_socket->typeinfo()));
+      }
+    }
+    state.is_cached = cache_->lookup(*key, output_types, state.allocator, state.cached_outputs);
+    return state.is_cached;
+  }
+
+  struct NodeTaskData {
+    GeometryNodesEvaluator *evaluator;
+    const DNode *node;
+  };
+
+  static void node_task_run(TaskPool *__restrict pool, void *taskdata)
+  {
+    NodeTaskData *data = static_cast<NodeTaskData *>(taskdata);
+    data->evaluator->execute_node_and_schedule_users(pool, *data->node);
+  }
+
+  void schedule_node(TaskPool *pool, const DNode &node)
+  {
+    NodeTaskData *data = static_cast<NodeTaskData *>(MEM_mallocN(sizeof(NodeTaskData), __func__));
+    data->evaluator = this;
+    data->node = &node;
+    BLI_task_pool_push(pool, node_task_run, data, true, nullptr);
+  }
+
+  void execute_required_nodes()
+  {
+    if (node_states_.is_empty()) {
+      return;
+    }
+    TaskPool *pool = BLI_task_pool_create(this, TASK_PRIORITY_HIGH);
+    for (auto item : node_states_.items()) {
+      if (item.value->missing_dependencies == 0) {
+        this->schedule_node(pool, *item.key);
+      }
+    }
+    BLI_task_pool_work_and_wait(pool);
+    BLI_task_pool_free(pool);
+  }
+
+  bool is_cancelled()
+  {
+    if (use_break_ && G.is_break) {
+      is_cancelled_ = true;
+    }
+    return is_cancelled_;
+  }
 
-    if (!socket_to_compute.is_available()) {
-      /* If the output is not available, use a default value. */
-      const CPPType &type = *blender::nodes::socket_cpp_type_get(*socket_to_compute.typeinfo());
-      void *buffer = allocator_.allocate(type.size(), type.alignment());
-      type.copy_to_uninitialized(type.default_value(), buffer);
-      this->forward_to_inputs(socket_to_compute, {type, buffer});
+  void execute_node_and_schedule_users(TaskPool *pool, const DNode &node)
+  {
+    NodeState &state = *node_states_.lookup(&node);
+    if (state.is_cached) {
+      int output_index = 0;
+      for (const DOutputSocket *output_socket : node.outputs()) {
+        if (output_socket->is_available()) {
+          GMutablePointer value = state.cached_outputs[output_index++];
+          this->forward_to_inputs(*output_socket, value, state.allocator);
+        }
+      }
+      this->schedule_ready_users(pool, state);
       return;
     }
 
+    blender::LinearAllocator<> &allocator = state.allocator;
+    const bNode &bnode = *node.bnode();
+
     /* Prepare inputs required to execute the node. */
-    GValueMap<StringRef> node_inputs_map{allocator_};
+    GValueMap<StringRef> node_inputs_map{allocator};
     for (const DInputSocket *input_socket : node.inputs()) {
       if (input_socket->is_available()) {
-        GMutablePointer value = this->get_input_value(*input_socket);
+        GMutablePointer value = this->get_input_value(*input_socket, allocator);
         node_inputs_map.add_new_direct(input_socket->identifier(), value);
       }
     }
 
     /* Execute the node. */
-    GValueMap<StringRef> node_outputs_map{allocator_};
+    GValueMap<StringRef> node_outputs_map{allocator};
     GeoNodeExecParams params{bnode, node_inputs_map, node_outputs_map, handle_map_, self_object_};
-    this->execute_node(node, params);
+    bool is_executed = false;
+    int64_t start_ns = 0;
+    int64_t thread_start_ns = 0;
+    if (this->is_cancelled()) {
+      this->execute_unknown_node(node, params);
+    }
+    else {
+      if (use_profile_) {
+        start_ns = blender::bke::geometry_nodes_profile_time_ns();
+        thread_start_ns = blender::bke::geometry_nodes_profile_thread_time_ns();
+      }
+      this->execute_node(node, params, allocator);
+      is_executed = true;
+    }
+
+    Vector<GMutablePointer> output_values;
+    for (const DOutputSocket *output_socket : node.outputs()) {
+      if (output_socket->is_available()) {
+        output_values.append(node_outputs_map.extract(output_socket->identifier()));
+      }
+    }
+
+    if (is_executed && use_profile_) {
+      this->add_profile_event(node, start_ns, thread_start_ns, output_values);
+    }
+
+    /* Results of a cancelled evaluation are incomplete and must not be reused. */
+    if (is_executed && !this->is_cancelled() && cache_ != nullptr &&
+        node_supports_caching(bnode)) {
+      const std::optional<std::string> *key = node_keys_.lookup_ptr(&node);
+      if (key != nullptr && key->has_value()) {
+        cache_->add(**key, output_values);
+      }
+    }
 
     /* Forward computed outputs to linked input sockets. */
+    int output_index = 0;
     for (const DOutputSocket *output_socket : node.outputs()) {
       if (output_socket->is_available()) {
-        GMutablePointer value = node_outputs_map.extract(output_socket->identifier());
-        this->forward_to_inputs(*output_socket, value);
+        this->forward_to_inputs(*output_socket, output_values[output_index++], allocator);
+      }
+    }
+
+    this->schedule_ready_users(pool, state);
+  }
+
+  void add_profile_event(const DNode &node,
+                         const int64_t start_ns,
+                         const int64_t thread_start_ns,
+                         Span<GMutablePointer> output_values)
+  {
+    blender::bke::GeometryNodesProfileEvent event;
+    event.duration_ns = blender::bke::geometry_nodes_profile_time_ns() - start_ns;
+    event.thread_duration_ns = blender::bke::geometry_nodes_profile_thread_time_ns() -
+                               thread_start_ns;
+    event.start_ns = start_ns;
+    event.modifier_uuid = modifier_.session_uuid;
+    event.object_name = self_object_->id.name + 2;
+    event.modifier_name = modifier_.name;
+    event.node_name = node.bnode()->name;
+    event.elements = 0;
+    event.bytes = 0;
+    for (const GMutablePointer value : output_values) {
+      event.bytes += value_memory_size(value);
+      if (!value.type()->is<GeometrySet>()) {
+        continue;
+      }
+      const GeometrySet &geometry_set = *static_cast<const GeometrySet *>(value.get());
+      if (const MeshComponent *component = geometry_set.get_component_for_read<MeshComponent>()) {
+        event.elements += component->attribute_domain_size(ATTR_DOMAIN_POINT);
+      }
+      if (const PointCloudComponent *component =
+              geometry_set.get_component_for_read<PointCloudComponent>()) {
+        event.elements += component->attribute_domain_size(ATTR_DOMAIN_POINT);
+      }
+      if (const InstancesComponent *component =
+              geometry_set.get_component_for_read<InstancesComponent>()) {
+        event.elements += component->instances_amount();
+      }
+    }
+    blender::bke::geometry_nodes_profile_add_event(std::move(event));
+  }
+
+  void schedule_ready_users(TaskPool *pool, const NodeState &state)
+  {
+    /* All inputs of the users may be available now. */
+    for (const DNode *user : state.users) {
+      NodeState &user_state = *node_states_.lookup(user);
+      if (user_state.missing_dependencies.fetch_sub(1) == 1) {
+        this->schedule_node(pool, *user);
+      }
+    }
+  }
+
+  GMutablePointer get_input_value(const DInputSocket &socket_to_compute,
+                                  blender::LinearAllocator<> &allocator)
+  {
+    {
+      std::lock_guard lock{value_by_input_mutex_};
+      std::optional<GMutablePointer> value = value_by_input_.pop_try(&socket_to_compute);
+      if (value.has_value()) {
+        /* This input has been computed before, return it directly. */
+        return *value;
       }
     }
+
+    Span<const DOutputSocket *> from_sockets = socket_to_compute.linked_sockets();
+    if (from_sockets.size() == 0) {
+      /* The input is not connected or gets its value from the input of a group that is not
+       * further connected, use the value from the socket itself. */
+      return get_unlinked_input_value(socket_to_compute, allocator);
+    }
+
+    /* The linked output is not available, so it was not computed. Use its default value. */
+    const DOutputSocket &from_socket = *from_sockets[0];
+    BLI_assert(!from_socket.is_available());
+    const CPPType &from_type = *blender::nodes::socket_cpp_type_get(*from_socket.typeinfo());
+    const CPPType &to_type = *blender::nodes::socket_cpp_type_get(*socket_to_compute.typeinfo());
+    void *buffer = allocator.allocate(to_type.size(), to_type.alignment());
+    this->convert_value(from_type, from_type.default_value(), to_type, buffer);
+    return {to_type, buffer};
   }
 
-  void execute_node(const DNode &node, GeoNodeExecParams params)
+  void execute_node(const DNode &node,
+                    GeoNodeExecParams params,
+                    blender::LinearAllocator<> &allocator)
   {
     const bNode &bnode = params.node();
 
@@ -311,7 +1145,7 @@ class GeometryNodesEvaluator {
     /* Use the multi-function implementation if it exists. */
     const MultiFunction *multi_function = mf_by_node_.lookup_default(&node, nullptr);
     if (multi_function != nullptr) {
-      this->execute_multi_function_node(node, params, *multi_function);
+      this->execute_multi_function_node(node, params, *multi_function, allocator);
       return;
     }
 
@@ -321,7 +1155,8 @@ class GeometryNodesEvaluator {
 
   void execute_multi_function_node(const DNode &node,
                                    GeoNodeExecParams params,
-                                   const MultiFunction &fn)
+                                   const MultiFunction &fn,
+                                   blender::LinearAllocator<> &allocator)
   {
     MFContextBuilder fn_context;
     MFParamsBuilder fn_params{fn, 1};
@@ -337,7 +1172,7 @@ class GeometryNodesEvaluator {
     for (const DOutputSocket *dsocket : node.outputs()) {
       if (dsocket->is_available()) {
         const CPPType &type = *blender::nodes::socket_cpp_type_get(*dsocket->typeinfo());
-        void *buffer = allocator_.allocate(type.size(), type.alignment());
+        void *buffer = allocator.allocate(type.size(), type.alignment());
         fn_params.add_uninitialized_single_output(GMutableSpan(type, buffer, 1));
         output_data.append(GMutablePointer(type, buffer));
       }
@@ -367,12 +1202,28 @@ class GeometryNodesEvaluator {
     }
   }
 
-  void forward_to_inputs(const DOutputSocket &from_socket, GMutablePointer value_to_forward)
+  void convert_value(const CPPType &from_type,
+                     const void *from_value,
+                     const CPPType &to_type,
+                     void *r_to_value)
+  {
+    if (conversions_.is_convertible(from_type, to_type)) {
+      conversions_.convert(from_type, to_type, from_value, r_to_value);
+    }
+    else {
+      to_type.copy_to_uninitialized(to_type.default_value(), r_to_value);
+    }
+  }
+
+  void forward_to_inputs(const DOutputSocket &from_socket,
+                         GMutablePointer value_to_forward,
+                         blender::LinearAllocator<> &allocator)
   {
     Span<const DInputSocket *> to_sockets_all = from_socket.linked_sockets();
 
     const CPPType &from_type = *value_to_forward.type();
 
+    Vector<std::pair<const DInputSocket *, GMutablePointer>> values_to_add;
     Vector<const DInputSocket *> to_sockets_same_type;
     for (const DInputSocket *to_socket : to_sockets_all) {
       const CPPType &to_type = *blender::nodes::socket_cpp_type_get(*to_socket->typeinfo());
@@ -380,14 +1231,9 @@ class GeometryNodesEvaluator {
         to_sockets_same_type.append(to_socket);
       }
       else {
-        void *buffer = allocator_.allocate(to_type.size(), to_type.alignment());
-        if (conversions_.is_convertible(from_type, to_type)) {
-          conversions_.convert(from_type, to_type, value_to_forward.get(), buffer);
-        }
-        else {
-          to_type.copy_to_uninitialized(to_type.default_value(), buffer);
-        }
-        value_by_input_.add_new(to_socket, GMutablePointer{to_type, buffer});
+        void *buffer = allocator.allocate(to_type.size(), to_type.alignment());
+        this->convert_value(from_type, value_to_forward.get(), to_type, buffer);
+        values_to_add.append({to_socket, GMutablePointer{to_type, buffer}});
       }
     }
 
@@ -398,7 +1244,7 @@ class GeometryNodesEvaluator {
     else if (to_sockets_same_type.size() == 1) {
       /* This value is only used on one input socket, no need to copy it. */
       const DInputSocket *to_socket = to_sockets_same_type[0];
-      value_by_input_.add_new(to_socket, value_to_forward);
+      values_to_add.append({to_socket, value_to_forward});
     }
     else {
       /* Multiple inputs use the value, make a copy for every input except for one. */
@@ -406,16 +1252,22 @@ class GeometryNodesEvaluator {
       Span<const DInputSocket *> other_to_sockets = to_sockets_same_type.as_span().drop_front(1);
       const CPPType &type = *value_to_forward.type();
 
-      value_by_input_.add_new(first_to_socket, value_to_forward);
+      values_to_add.append({first_to_socket, value_to_forward});
       for (const DInputSocket *to_socket : other_to_sockets) {
-        void *buffer = allocator_.allocate(type.size(), type.alignment());
+        void *buffer = allocator.allocate(type.size(), type.alignment());
         type.copy_to_uninitialized(value_to_forward.get(), buffer);
-        value_by_input_.add_new(to_socket, GMutablePointer{type, buffer});
+        values_to_add.append({to_socket, GMutablePointer{type, buffer}});
       }
     }
+
+    std::lock_guard lock{value_by_input_mutex_};
+    for (const std::pair<const DInputSocket *, GMutablePointer> &item : values_to_add) {
+      value_by_input_.add_new(item.first, item.second);
+    }
   }
 
-  GMutablePointer get_unlinked_input_value(const DInputSocket &socket)
+  GMutablePointer get_unlinked_input_value(const DInputSocket &socket,
+                                           blender::LinearAllocator<> &allocator)
   {
     bNodeSocket *bsocket;
     if (socket.linked_group_inputs().size() == 0) {
@@ -425,7 +1277,7 @@ class GeometryNodesEvaluator {
       bsocket = socket.linked_group_inputs()[0]->bsocket();
     }
     const CPPType &type = *blender::nodes::socket_cpp_type_get(*socket.typeinfo());
-    void *buffer = allocator_.allocate(type.size(), type.alignment());
+    void *buffer = allocator.allocate(type.size(), type.alignment());
 
     if (bsocket->type == SOCK_OBJECT) {
       Object *object = ((bNodeSocketValueObject *)bsocket->default_value)->value;
@@ -808,8 +1660,8 @@ static void fill_data_handle_map(const DerivedNodeTree &tree,
 
 /**
  * Evaluate a node group to compute the output geometry.
- * Currently, this uses a fairly basic and inefficient algorithm that might compute things more
- * often than necessary. It's going to be replaced soon.
+ * Every required node is executed once, independent branches of the tree are computed in
+ * parallel, see #GeometryNodesEvaluator.
  */
 static GeometrySet compute_geometry(const DerivedNodeTree &tree,
                                     Span<const DOutputSocket *> group_input_sockets,
@@ -852,8 +1704,26 @@ static GeometrySet compute_geometry(const DerivedNodeTree &tree,
   blender::bke::PersistentDataHandleMap handle_map;
   fill_data_handle_map(tree, handle_map);
 
-  GeometryNodesEvaluator evaluator{
-      group_inputs, group_outputs, mf_by_node, handle_map, ctx->object};
+  /* Allow cancelling final renders, the viewport is always evaluated entirely. */
+  const bool use_break = DEG_get_mode(ctx->depsgraph) == DAG_EVAL_RENDER;
+
+  /* Only use the cache when there are results worth keeping. */
+  GeometryNodesCache *cache = nullptr;
+  for (const DNode *node : tree.nodes()) {
+    if (node_supports_caching(*node->bnode())) {
+      cache = geometry_nodes_cache_ensure(&nmd->modifier);
+      break;
+    }
+  }
+
+  GeometryNodesEvaluator evaluator{group_inputs,
+                                   group_outputs,
+                                   mf_by_node,
+                                   handle_map,
+                                   ctx->object,
+                                   use_break,
+                                   cache,
+                                   nmd->modifier};
   Vector<GMutablePointer> results = evaluator.execute();
   BLI_assert(results.size() == 1);
   GMutablePointer result = results[0];
@@ -1082,6 +1952,15 @@ static void copyData(const ModifierData *md, ModifierData *target, const int fla
   }
 }
 
+static void freeRuntimeData(void *runtime_data_v)
+{
+  if (runtime_data_v == nullptr) {
+    return;
+  }
+  GeometryNodesCache *cache = static_cast<GeometryNodesCache *>(runtime_data_v);
+  OBJECT_GUARDED_DELETE(cache, GeometryNodesCache);
+}
+
 static void freeData(ModifierData *md)
 {
   NodesModifierData *nmd = reinterpret_cast<NodesModifierData *>(md);
@@ -1089,6 +1968,8 @@ static void freeData(ModifierData *md)
     IDP_FreeProperty_ex(nmd->settings.properties, false);
     nmd->settings.properties = nullptr;
   }
+  freeRuntimeData(md->runtime);
+  md->runtime = nullptr;
 }
 
 static void requiredDataMask(Object *UNUSED(ob),
@@ -1125,6 +2006,7 @@ ModifierTypeInfo modifierType_Nodes = {
 
     /* initData */ initData,
     /* requiredDataMask */ requiredDataMask,
+    /* writtenDataMask */ nullptr,
     /* freeData */ freeData,
     /* isDisabled */ isDisabled,
     /* updateDepsgraph */ updateDepsgraph,
@@ -1132,7 +2014,7 @@ ModifierTypeInfo modifierType_Nodes = {
     /* dependsOnNormals */ nullptr,
     /* foreachIDLink */ foreachIDLink,
     /* foreachTexLink */ nullptr,
-    /* freeRuntimeData */ nullptr,
+    /* freeRuntimeData */ freeRuntimeData,
     /* panelRegister */ panelRegister,
     /* blendWrite */ blendWrite,
     /* blendRead */ blendRead,
@@ -64,6 +64,7 @@ ModifierTypeInfo modifierType_None = {
 
     /* initData */ NULL,
     /* requiredDataMask */ NULL,
+    /* writtenDataMask */ NULL,
     /* freeData */ NULL,
     /* isDisabled */ isDisabled,
     /* updateDepsgraph */ NULL,
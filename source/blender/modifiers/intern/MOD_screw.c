@@ -1264,6 +1264,7 @@ ModifierTypeInfo modifierType_Screw = {
 
     /* initData */ initData,
     /* requiredDataMask */ NULL,
+    /* writtenDataMask */ NULL,
     /* freeData */ NULL,
     /* isDisabled */ NULL,
     /* updateDepsgraph */ updateDepsgraph,
@@ -145,6 +145,7 @@ ModifierTypeInfo modifierType_ShapeKey = {
 
     /* initData */ NULL,
     /* requiredDataMask */ NULL,
+    /* writtenDataMask */ NULL,
     /* freeData */ NULL,
     /* isDisabled */ NULL,
     /* updateDepsgraph */ NULL,
@@ -557,6 +557,7 @@ ModifierTypeInfo modifierType_SimpleDeform = {
 
     /* initData */ initData,
     /* requiredDataMask */ requiredDataMask,
+    /* writtenDataMask */ NULL,
     /* freeData */ NULL,
     /* isDisabled */ NULL,
     /* updateDepsgraph */ updateDepsgraph,
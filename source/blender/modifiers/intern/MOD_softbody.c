@@ -124,6 +124,7 @@ ModifierTypeInfo modifierType_Softbody = {
 
     /* initData */ NULL,
     /* requiredDataMask */ NULL,
+    /* writtenDataMask */ NULL,
     /* freeData */ NULL,
     /* isDisabled */ NULL,
     /* updateDepsgraph */ updateDepsgraph,
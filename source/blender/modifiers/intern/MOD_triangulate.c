@@ -182,6 +182,7 @@ ModifierTypeInfo modifierType_Triangulate = {
 
     /* initData */ initData,
     /* requiredDataMask */ NULL,  // requiredDataMask,
+    /* writtenDataMask */ NULL,
     /* freeData */ NULL,
     /* isDisabled */ NULL,
     /* updateDepsgraph */ NULL,
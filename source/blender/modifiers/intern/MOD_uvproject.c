@@ -75,6 +75,13 @@ static void requiredDataMask(Object *UNUSED(ob),
   r_cddata_masks->lmask |= CD_MLOOPUV;
 }
 
+static void writtenDataMask(Object *UNUSED(ob),
+                            ModifierData *UNUSED(md),
+                            CustomData_MeshMasks *r_cddata_masks)
+{
+  r_cddata_masks->lmask |= CD_MASK_MLOOPUV;
+}
+
 static void foreachIDLink(ModifierData *md, Object *ob, IDWalkFunc walk, void *userData)
 {
   UVProjectModifierData *umd = (UVProjectModifierData *)md;
@@ -375,6 +382,7 @@ ModifierTypeInfo modifierType_UVProject = {
 
     /* initData */ initData,
     /* requiredDataMask */ requiredDataMask,
+    /* writtenDataMask */ writtenDataMask,
     /* freeData */ NULL,
     /* isDisabled */ NULL,
     /* updateDepsgraph */ updateDepsgraph,
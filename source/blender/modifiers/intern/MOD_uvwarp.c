@@ -82,6 +82,13 @@ static void requiredDataMask(Object *UNUSED(ob),
   }
 }
 
+static void writtenDataMask(Object *UNUSED(ob),
+                            ModifierData *UNUSED(md),
+                            CustomData_MeshMasks *r_cddata_masks)
+{
+  r_cddata_masks->lmask |= CD_MASK_MLOOPUV;
+}
+
 static void matrix_from_obj_pchan(float mat[4][4], Object *ob, const char *bonename)
 {
   bPoseChannel *pchan = BKE_pose_channel_find_name(ob->pose, bonename);
@@ -346,6 +353,7 @@ ModifierTypeInfo modifierType_UVWarp = {
 
     /* initData */ initData,
     /* requiredDataMask */ requiredDataMask,
+    /* writtenDataMask */ writtenDataMask,
     /* freeData */ NULL,
     /* isDisabled */ NULL,
     /* updateDepsgraph */ updateDepsgraph,
@@ -334,6 +334,7 @@ ModifierTypeInfo modifierType_VolumeDisplace = {
 
     /* initData */ initData,
     /* requiredDataMask */ nullptr,
+    /* writtenDataMask */ nullptr,
     /* freeData */ nullptr,
     /* isDisabled */ nullptr,
     /* updateDepsgraph */ updateDepsgraph,
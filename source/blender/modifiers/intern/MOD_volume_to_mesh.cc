@@ -340,6 +340,7 @@ ModifierTypeInfo modifierType_VolumeToMesh = {
 
     /* initData */ initData,
     /* requiredDataMask */ nullptr,
+    /* writtenDataMask */ nullptr,
     /* freeData */ nullptr,
     /* isDisabled */ nullptr,
     /* updateDepsgraph */ updateDepsgraph,
@@ -154,6 +154,13 @@ static void requiredDataMask(Object *UNUSED(ob),
   /* No need to ask for CD_PREVIEW_MLOOPCOL... */
 }
 
+static void writtenDataMask(Object *UNUSED(ob),
+                            ModifierData *UNUSED(md),
+                            CustomData_MeshMasks *r_cddata_masks)
+{
+  r_cddata_masks->vmask |= CD_MASK_MDEFORMVERT;
+}
+
 static bool dependsOnTime(ModifierData *md)
 {
   WeightVGMixModifierData *wmd = (WeightVGMixModifierData *)md;
@@ -518,6 +525,7 @@ ModifierTypeInfo modifierType_WeightVGMix = {
 
     /* initData */ initData,
     /* requiredDataMask */ requiredDataMask,
+    /* writtenDataMask */ writtenDataMask,
     /* freeData */ NULL,
     /* isDisabled */ isDisabled,
     /* updateDepsgraph */ updateDepsgraph,
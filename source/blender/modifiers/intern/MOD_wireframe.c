@@ -200,6 +200,7 @@ ModifierTypeInfo modifierType_Wireframe = {
 
     /* initData */ initData,
     /* requiredDataMask */ requiredDataMask,
+    /* writtenDataMask */ NULL,
     /* freeData */ NULL,
     /* isDisabled */ NULL,
     /* updateDepgraph */ NULL,
@@ -16,9 +16,12 @@
 
 #pragma once
 
+#include <memory>
 #include <string.h>
 
+#include "BLI_array.hh"
 #include "BLI_float3.hh"
+#include "BLI_task.hh"
 #include "BLI_utildefines.h"
 
 #include "MEM_guardedalloc.h"
@@ -53,4 +56,95 @@ void poisson_disk_point_elimination(Vector<float3> const *input_points,
 Array<uint32_t> get_geometry_element_ids_as_uints(const GeometryComponent &component,
                                                   const AttributeDomain domain);
 
+/* Number of elements processed at once by #attribute_foreach_chunk. Temporary buffers for the
+ * inputs of a chunk are small enough to stay in the CPU cache. */
+constexpr int64_t attribute_chunk_size = 4096;
+
+/**
+ * Call the function for consecutive chunks of at most #attribute_chunk_size elements covering
+ * the range `[0, size)`. Chunks are processed in parallel, so the function must only write to the
+ * elements of the chunk it is called with.
+ */
+template<typename Func> void attribute_foreach_chunk(const int64_t size, const Func &func)
+{
+  parallel_for(IndexRange(size), attribute_chunk_size, [&](const IndexRange range) {
+    for (int64_t start = range.start(); start < range.one_after_last();
+         start += attribute_chunk_size) {
+      func(IndexRange(start, std::min(attribute_chunk_size, range.one_after_last() - start)));
+    }
+  });
+}
+
+/**
+ * Read the values of the attribute in the chunk. When the attribute is stored in a contiguous
+ * array, this is a slice of it, otherwise the values are copied into a buffer owned by the calling
+ * thread, which is reused for all the chunks it processes. \a Slot distinguishes the buffers of
+ * inputs of the same type used for the same chunk.
+ */
+template<int Slot, typename T>
+Span<T> attribute_read_chunk(const bke::TypedReadAttribute<T> &attribute, const IndexRange range)
+{
+  BLI_assert(range.size() <= attribute_chunk_size);
+  const Span<T> array = attribute.get_array();
+  if (!array.is_empty()) {
+    return array.slice(range.start(), range.size());
+  }
+  thread_local std::unique_ptr<T[]> buffer = std::make_unique<T[]>(attribute_chunk_size);
+  return attribute.get_chunk(range, MutableSpan<T>(buffer.get(), attribute_chunk_size));
+}
+
+/**
+ * Compute `result[i] = func(input_a[i], input_b[i])` for all elements, chunk by chunk.
+ * Inputs that are not stored in contiguous arrays are only read into chunk-sized buffers,
+ * instead of copying the entire attribute into a temporary array first.
+ * When all inputs are constant, the function is only evaluated once.
+ */
+template<typename InA, typename InB, typename Out, typename Func>
+void attribute_compute_elementwise(const bke::TypedReadAttribute<InA> &input_a,
+                                   const bke::TypedReadAttribute<InB> &input_b,
+                                   MutableSpan<Out> result,
+                                   const Func &func)
+{
+  if (input_a.is_single() && input_b.is_single()) {
+    /* Constant folding: the result is the same for every element. */
+    if (result.size() > 0) {
+      result.fill(func(input_a[0], input_b[0]));
+    }
+    return;
+  }
+  attribute_foreach_chunk(result.size(), [&](const IndexRange range) {
+    const Span<InA> chunk_a = attribute_read_chunk<0>(input_a, range);
+    const Span<InB> chunk_b = attribute_read_chunk<1>(input_b, range);
+    MutableSpan<Out> chunk_result = result.slice(range.start(), range.size());
+    for (const int64_t i : IndexRange(range.size())) {
+      chunk_result[i] = func(chunk_a[i], chunk_b[i]);
+    }
+  });
+}
+
+/** Same as above, with a third input. */
+template<typename InA, typename InB, typename InC, typename Out, typename Func>
+void attribute_compute_elementwise(const bke::TypedReadAttribute<InA> &input_a,
+                                   const bke::TypedReadAttribute<InB> &input_b,
+                                   const bke::TypedReadAttribute<InC> &input_c,
+                                   MutableSpan<Out> result,
+                                   const Func &func)
+{
+  if (input_a.is_single() && input_b.is_single() && input_c.is_single()) {
+    if (result.size() > 0) {
+      result.fill(func(input_a[0], input_b[0], input_c[0]));
+    }
+    return;
+  }
+  attribute_foreach_chunk(result.size(), [&](const IndexRange range) {
+    const Span<InA> chunk_a = attribute_read_chunk<0>(input_a, range);
+    const Span<InB> chunk_b = attribute_read_chunk<1>(input_b, range);
+    const Span<InC> chunk_c = attribute_read_chunk<2>(input_c, range);
+    MutableSpan<Out> chunk_result = result.slice(range.start(), range.size());
+    for (const int64_t i : IndexRange(range.size())) {
+      chunk_result[i] = func(chunk_a[i], chunk_b[i], chunk_c[i]);
+    }
+  });
+}
+
 }  // namespace blender::nodes
@@ -82,19 +82,9 @@ static void do_math_operation(const FloatReadAttribute &input_a,
                               const FloatCompareOperation operation,
                               MutableSpan<bool> span_result)
 {
-  const int size = input_a.size();
-
-  Span<float> span_a = input_a.get_span();
-  Span<float> span_b = input_b.get_span();
-
   if (try_dispatch_float_math_fl_fl_to_bool(
           operation, [&](auto math_function, const FloatMathOperationInfo &UNUSED(info)) {
-            for (const int i : IndexRange(size)) {
-              const float a = span_a[i];
-              const float b = span_b[i];
-              const bool out = math_function(a, b);
-              span_result[i] = out;
-            }
+            attribute_compute_elementwise(input_a, input_b, span_result, math_function);
           })) {
     return;
   }
@@ -108,12 +98,9 @@ static void do_equal_operation(const FloatReadAttribute &input_a,
                                const float threshold,
                                MutableSpan<bool> span_result)
 {
-  const int size = input_a.size();
-  for (const int i : IndexRange(size)) {
-    const float a = input_a[i];
-    const float b = input_b[i];
-    span_result[i] = compare_ff(a, b, threshold);
-  }
+  attribute_compute_elementwise(input_a, input_b, span_result, [&](const float a, const float b) {
+    return compare_ff(a, b, threshold);
+  });
 }
 
 static void do_equal_operation(const Float3ReadAttribute &input_a,
@@ -122,12 +109,10 @@ static void do_equal_operation(const Float3ReadAttribute &input_a,
                                MutableSpan<bool> span_result)
 {
   const float threshold_squared = pow2f(threshold);
-  const int size = input_a.size();
-  for (const int i : IndexRange(size)) {
-    const float3 a = input_a[i];
-    const float3 b = input_b[i];
-    span_result[i] = len_squared_v3v3(a, b) < threshold_squared;
-  }
+  attribute_compute_elementwise(
+      input_a, input_b, span_result, [&](const float3 a, const float3 b) {
+        return len_squared_v3v3(a, b) < threshold_squared;
+      });
 }
 
 static void do_equal_operation(const Color4fReadAttribute &input_a,
@@ -136,12 +121,10 @@ static void do_equal_operation(const Color4fReadAttribute &input_a,
                                MutableSpan<bool> span_result)
 {
   const float threshold_squared = pow2f(threshold);
-  const int size = input_a.size();
-  for (const int i : IndexRange(size)) {
-    const Color4f a = input_a[i];
-    const Color4f b = input_b[i];
-    span_result[i] = len_squared_v4v4(a, b) < threshold_squared;
-  }
+  attribute_compute_elementwise(
+      input_a, input_b, span_result, [&](const Color4f a, const Color4f b) {
+        return len_squared_v4v4(a, b) < threshold_squared;
+      });
 }
 
 static void do_equal_operation(const BooleanReadAttribute &input_a,
@@ -149,12 +132,9 @@ static void do_equal_operation(const BooleanReadAttribute &input_a,
                                const float UNUSED(threshold),
                                MutableSpan<bool> span_result)
 {
-  const int size = input_a.size();
-  for (const int i : IndexRange(size)) {
-    const bool a = input_a[i];
-    const bool b = input_b[i];
-    span_result[i] = a == b;
-  }
+  attribute_compute_elementwise(input_a, input_b, span_result, [&](const bool a, const bool b) {
+    return a == b;
+  });
 }
 
 static void do_not_equal_operation(const FloatReadAttribute &input_a,
@@ -162,12 +142,9 @@ static void do_not_equal_operation(const FloatReadAttribute &input_a,
                                    const float threshold,
                                    MutableSpan<bool> span_result)
 {
-  const int size = input_a.size();
-  for (const int i : IndexRange(size)) {
-    const float a = input_a[i];
-    const float b = input_b[i];
-    span_result[i] = !compare_ff(a, b, threshold);
-  }
+  attribute_compute_elementwise(input_a, input_b, span_result, [&](const float a, const float b) {
+    return !compare_ff(a, b, threshold);
+  });
 }
 
 static void do_not_equal_operation(const Float3ReadAttribute &input_a,
@@ -176,12 +153,10 @@ static void do_not_equal_operation(const Float3ReadAttribute &input_a,
                                    MutableSpan<bool> span_result)
 {
   const float threshold_squared = pow2f(threshold);
-  const int size = input_a.size();
-  for (const int i : IndexRange(size)) {
-    const float3 a = input_a[i];
-    const float3 b = input_b[i];
-    span_result[i] = len_squared_v3v3(a, b) >= threshold_squared;
-  }
+  attribute_compute_elementwise(
+      input_a, input_b, span_result, [&](const float3 a, const float3 b) {
+        return len_squared_v3v3(a, b) >= threshold_squared;
+      });
 }
 
 static void do_not_equal_operation(const Color4fReadAttribute &input_a,
@@ -190,12 +165,10 @@ static void do_not_equal_operation(const Color4fReadAttribute &input_a,
                                    MutableSpan<bool> span_result)
 {
   const float threshold_squared = pow2f(threshold);
-  const int size = input_a.size();
-  for (const int i : IndexRange(size)) {
-    const Color4f a = input_a[i];
-    const Color4f b = input_b[i];
-    span_result[i] = len_squared_v4v4(a, b) >= threshold_squared;
-  }
+  attribute_compute_elementwise(
+      input_a, input_b, span_result, [&](const Color4f a, const Color4f b) {
+        return len_squared_v4v4(a, b) >= threshold_squared;
+      });
 }
 
 static void do_not_equal_operation(const BooleanReadAttribute &input_a,
@@ -203,12 +176,9 @@ static void do_not_equal_operation(const BooleanReadAttribute &input_a,
                                    const float UNUSED(threshold),
                                    MutableSpan<bool> span_result)
 {
-  const int size = input_a.size();
-  for (const int i : IndexRange(size)) {
-    const bool a = input_a[i];
-    const bool b = input_b[i];
-    span_result[i] = a != b;
-  }
+  attribute_compute_elementwise(input_a, input_b, span_result, [&](const bool a, const bool b) {
+    return a != b;
+  });
 }
 
 static CustomDataType get_data_type(GeometryComponent &component,
@@ -71,20 +71,11 @@ static void do_math_operation(const FloatReadAttribute &input_a,
                               FloatWriteAttribute result,
                               const int operation)
 {
-  const int size = input_a.size();
-
-  Span<float> span_a = input_a.get_span();
-  Span<float> span_b = input_b.get_span();
   MutableSpan<float> span_result = result.get_span();
 
   bool success = try_dispatch_float_math_fl_fl_to_fl(
       operation, [&](auto math_function, const FloatMathOperationInfo &UNUSED(info)) {
-        for (const int i : IndexRange(size)) {
-          const float in1 = span_a[i];
-          const float in2 = span_b[i];
-          const float out = math_function(in1, in2);
-          span_result[i] = out;
-        }
+        attribute_compute_elementwise(input_a, input_b, span_result, math_function);
       });
 
   result.apply_span();
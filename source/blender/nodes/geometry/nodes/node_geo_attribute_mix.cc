@@ -49,15 +49,18 @@ static void do_mix_operation_float(const int blend_mode,
                                    const FloatReadAttribute &inputs_b,
                                    FloatWriteAttribute &results)
 {
-  const int size = results.size();
-  for (const int i : IndexRange(size)) {
-    const float factor = factors[i];
-    float3 a{inputs_a[i]};
-    const float3 b{inputs_b[i]};
-    ramp_blend(blend_mode, a, factor, b);
-    const float result = a.length();
-    results.set(i, result);
-  }
+  attribute_compute_elementwise(
+      factors,
+      inputs_a,
+      inputs_b,
+      results.get_span(),
+      [&](const float factor, const float input_a, const float input_b) {
+        float3 a{input_a};
+        const float3 b{input_b};
+        ramp_blend(blend_mode, a, factor, b);
+        return a.length();
+      });
+  results.apply_span();
 }
 
 static void do_mix_operation_float3(const int blend_mode,
@@ -66,14 +69,17 @@ static void do_mix_operation_float3(const int blend_mode,
                                     const Float3ReadAttribute &inputs_b,
                                     Float3WriteAttribute &results)
 {
-  const int size = results.size();
-  for (const int i : IndexRange(size)) {
-    const float factor = factors[i];
-    float3 a = inputs_a[i];
-    const float3 b = inputs_b[i];
-    ramp_blend(blend_mode, a, factor, b);
-    results.set(i, a);
-  }
+  attribute_compute_elementwise(
+      factors,
+      inputs_a,
+      inputs_b,
+      results.get_span(),
+      [&](const float factor, const float3 input_a, const float3 b) {
+        float3 a = input_a;
+        ramp_blend(blend_mode, a, factor, b);
+        return a;
+      });
+  results.apply_span();
 }
 
 static void do_mix_operation_color4f(const int blend_mode,
@@ -82,14 +88,17 @@ static void do_mix_operation_color4f(const int blend_mode,
                                      const Color4fReadAttribute &inputs_b,
                                      Color4fWriteAttribute &results)
 {
-  const int size = results.size();
-  for (const int i : IndexRange(size)) {
-    const float factor = factors[i];
-    Color4f a = inputs_a[i];
-    const Color4f b = inputs_b[i];
-    ramp_blend(blend_mode, a, factor, b);
-    results.set(i, a);
-  }
+  attribute_compute_elementwise(
+      factors,
+      inputs_a,
+      inputs_b,
+      results.get_span(),
+      [&](const float factor, const Color4f input_a, const Color4f b) {
+        Color4f a = input_a;
+        ramp_blend(blend_mode, a, factor, b);
+        return a;
+      });
+  results.apply_span();
 }
 
 static void do_mix_operation(const CustomDataType result_type,
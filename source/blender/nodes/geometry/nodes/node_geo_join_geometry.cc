@@ -216,15 +216,13 @@ static void join_components(Span<const PointCloudComponent *> src_components, Ge
 static void join_components(Span<const InstancesComponent *> src_components, GeometrySet &result)
 {
   InstancesComponent &dst_component = result.get_component_for_write<InstancesComponent>();
+  int tot_instances = 0;
   for (const InstancesComponent *component : src_components) {
-    const int size = component->instances_amount();
-    Span<InstancedData> instanced_data = component->instanced_data();
-    Span<float3> positions = component->positions();
-    Span<float3> rotations = component->rotations();
-    Span<float3> scales = component->scales();
-    for (const int i : IndexRange(size)) {
-      dst_component.add_instance(instanced_data[i], positions[i], rotations[i], scales[i]);
-    }
+    tot_instances += component->instances_amount();
+  }
+  dst_component.reserve(tot_instances);
+  for (const InstancesComponent *component : src_components) {
+    dst_component.add_instances(component->instanced_data(), component->transforms());
   }
 }
 
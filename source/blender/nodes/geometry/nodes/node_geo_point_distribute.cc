@@ -55,6 +55,36 @@ static void node_point_distribute_update(bNodeTree *UNUSED(ntree), bNode *node)
 
 namespace blender::nodes {
 
+/**
+ * Get the number of points to scatter on a triangle. This consumes the first random number of the
+ * triangle's random number generator.
+ */
+static int looptri_points_amount(const Mesh *mesh,
+                                 const MLoopTri &looptri,
+                                 const float density,
+                                 const FloatReadAttribute &density_factors,
+                                 RandomNumberGenerator &looptri_rng)
+{
+  const int v0_index = mesh->mloop[looptri.tri[0]].v;
+  const int v1_index = mesh->mloop[looptri.tri[1]].v;
+  const int v2_index = mesh->mloop[looptri.tri[2]].v;
+  const float3 v0_pos = mesh->mvert[v0_index].co;
+  const float3 v1_pos = mesh->mvert[v1_index].co;
+  const float3 v2_pos = mesh->mvert[v2_index].co;
+  const float v0_density_factor = std::max(0.0f, density_factors[v0_index]);
+  const float v1_density_factor = std::max(0.0f, density_factors[v1_index]);
+  const float v2_density_factor = std::max(0.0f, density_factors[v2_index]);
+  const float looptri_density_factor = (v0_density_factor + v1_density_factor +
+                                        v2_density_factor) /
+                                       3.0f;
+  const float area = area_tri_v3(v0_pos, v1_pos, v2_pos);
+
+  const float points_amount_fl = area * density * looptri_density_factor;
+  const float add_point_probability = fractf(points_amount_fl);
+  const bool add_point = add_point_probability > looptri_rng.get_float();
+  return (int)points_amount_fl + (int)add_point;
+}
+
 static Vector<float3> random_scatter_points_from_mesh(const Mesh *mesh,
                                                       const float density,
                                                       const FloatReadAttribute &density_factors,
@@ -65,42 +95,44 @@ static Vector<float3> random_scatter_points_from_mesh(const Mesh *mesh,
   const MLoopTri *looptris = BKE_mesh_runtime_looptri_ensure(const_cast<Mesh *>(mesh));
   const int looptris_len = BKE_mesh_runtime_looptri_len(mesh);
 
-  Vector<float3> points;
-
+  /* Count the points of every triangle first, so that the points can be created in parallel and
+   * still end up in the same order, independent of the number of threads. */
+  Array<int> point_offsets(looptris_len + 1);
+  point_offsets[0] = 0;
+  parallel_for(IndexRange(looptris_len), 512, [&](const IndexRange range) {
+    for (const int looptri_index : range) {
+      RandomNumberGenerator looptri_rng(BLI_hash_int(looptri_index + seed));
+      point_offsets[looptri_index + 1] = looptri_points_amount(
+          mesh, looptris[looptri_index], density, density_factors, looptri_rng);
+    }
+  });
   for (const int looptri_index : IndexRange(looptris_len)) {
-    const MLoopTri &looptri = looptris[looptri_index];
-    const int v0_index = mesh->mloop[looptri.tri[0]].v;
-    const int v1_index = mesh->mloop[looptri.tri[1]].v;
-    const int v2_index = mesh->mloop[looptri.tri[2]].v;
-    const float3 v0_pos = mesh->mvert[v0_index].co;
-    const float3 v1_pos = mesh->mvert[v1_index].co;
-    const float3 v2_pos = mesh->mvert[v2_index].co;
-    const float v0_density_factor = std::max(0.0f, density_factors[v0_index]);
-    const float v1_density_factor = std::max(0.0f, density_factors[v1_index]);
-    const float v2_density_factor = std::max(0.0f, density_factors[v2_index]);
-    const float looptri_density_factor = (v0_density_factor + v1_density_factor +
-                                          v2_density_factor) /
-                                         3.0f;
-    const float area = area_tri_v3(v0_pos, v1_pos, v2_pos);
+    point_offsets[looptri_index + 1] += point_offsets[looptri_index];
+  }
 
-    const int looptri_seed = BLI_hash_int(looptri_index + seed);
-    RandomNumberGenerator looptri_rng(looptri_seed);
+  Vector<float3> points(point_offsets.last());
+  r_ids.resize(point_offsets.last());
 
-    const float points_amount_fl = area * density * looptri_density_factor;
-    const float add_point_probability = fractf(points_amount_fl);
-    const bool add_point = add_point_probability > looptri_rng.get_float();
-    const int point_amount = (int)points_amount_fl + (int)add_point;
+  parallel_for(IndexRange(looptris_len), 512, [&](const IndexRange range) {
+    for (const int looptri_index : range) {
+      const MLoopTri &looptri = looptris[looptri_index];
+      const float3 v0_pos = mesh->mvert[mesh->mloop[looptri.tri[0]].v].co;
+      const float3 v1_pos = mesh->mvert[mesh->mloop[looptri.tri[1]].v].co;
+      const float3 v2_pos = mesh->mvert[mesh->mloop[looptri.tri[2]].v].co;
 
-    for (int i = 0; i < point_amount; i++) {
-      const float3 bary_coords = looptri_rng.get_barycentric_coordinates();
-      float3 point_pos;
-      interp_v3_v3v3v3(point_pos, v0_pos, v1_pos, v2_pos, bary_coords);
-      points.append(point_pos);
+      RandomNumberGenerator looptri_rng(BLI_hash_int(looptri_index + seed));
+      /* Skip the random number used to compute the amount of points. */
+      looptri_rng.get_float();
 
-      /* Build a hash stable even when the mesh is deformed. */
-      r_ids.append(((int)(bary_coords.hash()) + looptri_index));
+      for (int i = point_offsets[looptri_index]; i < point_offsets[looptri_index + 1]; i++) {
+        const float3 bary_coords = looptri_rng.get_barycentric_coordinates();
+        interp_v3_v3v3v3(points[i], v0_pos, v1_pos, v2_pos, bary_coords);
+
+        /* Build a hash stable even when the mesh is deformed. */
+        r_ids[i] = ((int)(bary_coords.hash()) + looptri_index);
+      }
     }
-  }
+  });
 
   return points;
 }
@@ -114,6 +146,7 @@ struct RayCastAll_Data {
   float2 raystart;
 
   const Mesh *mesh;
+  const MLoopTri *looptris;
   float base_weight;
   FloatReadAttribute *density_factors;
   Vector<float3> *projected_points;
@@ -129,11 +162,9 @@ static void project_2d_bvh_callback(void *userdata,
   struct RayCastAll_Data *data = (RayCastAll_Data *)userdata;
   data->raycast_callback(data->bvhdata, index, ray, hit);
   if (hit->index != -1) {
-    /* This only updates a cache and can be considered to be logically const. */
-    const MLoopTri *looptris = BKE_mesh_runtime_looptri_ensure(const_cast<Mesh *>(data->mesh));
     const MVert *mvert = data->mesh->mvert;
 
-    const MLoopTri &looptri = looptris[index];
+    const MLoopTri &looptri = data->looptris[index];
     const FloatReadAttribute &density_factors = data->density_factors[0];
 
     const int v0_index = data->mesh->mloop[looptri.tri[0]].v;
@@ -209,24 +240,18 @@ static Vector<float3> poisson_scatter_points_from_mesh(const Mesh *mesh,
   /* Check if we have any points we should remove from the final possion distribition. */
   BVHTreeFromMesh treedata;
   BKE_bvhtree_from_mesh_get(&treedata, const_cast<Mesh *>(mesh), BVHTREE_FROM_LOOPTRI, 2);
+  /* Get the triangles once, ensuring them for every hit would lock the mesh in all threads.
+   * This only updates a cache and can be considered to be logically const. */
+  const MLoopTri *looptris = BKE_mesh_runtime_looptri_ensure(const_cast<Mesh *>(mesh));
 
   float3 bb_min, bb_max;
   BLI_bvhtree_get_bounding_box(treedata.tree, bb_min, bb_max);
 
-  struct RayCastAll_Data data;
-  data.bvhdata = &treedata;
-  data.raycast_callback = treedata.raycast_callback;
-  data.mesh = mesh;
-  data.projected_points = &final_points;
-  data.stable_ids = &r_ids;
-  data.density_factors = const_cast<FloatReadAttribute *>(&density_factors);
-  data.base_weight = std::min(
+  const float base_weight = std::min(
       1.0f, density / (output_points.size() / (point_scale_multiplier * point_scale_multiplier)));
 
   const float max_dist = bb_max[2] - bb_min[2] + 2.0f;
   const float3 dir = float3(0, 0, -1);
-  float3 raystart;
-  raystart.z = bb_max[2] + 1.0f;
 
   float tile_start_x_coord = bb_min[0];
   int tile_repeat_x = ceilf((bb_max[0] - bb_min[0]) / point_scale_multiplier);
@@ -234,10 +259,30 @@ static Vector<float3> poisson_scatter_points_from_mesh(const Mesh *mesh,
   float tile_start_y_coord = bb_min[1];
   int tile_repeat_y = ceilf((bb_max[1] - bb_min[1]) / point_scale_multiplier);
 
-  for (int x = 0; x < tile_repeat_x; x++) {
-    float tile_curr_x_coord = x * point_scale_multiplier + tile_start_x_coord;
-    for (int y = 0; y < tile_repeat_y; y++) {
-      float tile_curr_y_coord = y * point_scale_multiplier + tile_start_y_coord;
+  /* Project the tiles in parallel. The points of every tile are gathered separately and joined
+   * in tile order afterwards, so the result does not depend on the number of threads. */
+  const int tiles_len = tile_repeat_x * tile_repeat_y;
+  Array<Vector<float3>> tile_points(tiles_len);
+  Array<Vector<int>> tile_ids(tiles_len);
+  parallel_for(IndexRange(tiles_len), 1, [&](const IndexRange range) {
+    for (const int tile_index : range) {
+      const int x = tile_index / tile_repeat_y;
+      const int y = tile_index % tile_repeat_y;
+      const float tile_curr_x_coord = x * point_scale_multiplier + tile_start_x_coord;
+      const float tile_curr_y_coord = y * point_scale_multiplier + tile_start_y_coord;
+
+      struct RayCastAll_Data data;
+      data.bvhdata = &treedata;
+      data.raycast_callback = treedata.raycast_callback;
+      data.mesh = mesh;
+      data.looptris = looptris;
+      data.projected_points = &tile_points[tile_index];
+      data.stable_ids = &tile_ids[tile_index];
+      data.density_factors = const_cast<FloatReadAttribute *>(&density_factors);
+      data.base_weight = base_weight;
+
+      float3 raystart;
+      raystart.z = bb_max[2] + 1.0f;
       for (int idx = 0; idx < output_points.size(); idx++) {
         raystart.x = output_points[idx].x + tile_curr_x_coord;
         raystart.y = output_points[idx].y + tile_curr_y_coord;
@@ -249,6 +294,11 @@ static Vector<float3> poisson_scatter_points_from_mesh(const Mesh *mesh,
             treedata.tree, raystart, dir, 0.0f, max_dist, project_2d_bvh_callback, &data);
       }
     }
+  });
+
+  for (const int tile_index : IndexRange(tiles_len)) {
+    final_points.extend(tile_points[tile_index]);
+    r_ids.extend(tile_ids[tile_index]);
   }
 
   return final_points;
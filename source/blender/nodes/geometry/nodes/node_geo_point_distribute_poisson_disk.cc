@@ -23,7 +23,6 @@
  */
 
 #include "BLI_inplace_priority_queue.hh"
-#include "BLI_kdtree.h"
 
 #include "node_geometry_util.hh"
 
@@ -32,48 +31,121 @@
 
 namespace blender::nodes {
 
-static void tile_point(Vector<float3> *tiled_points,
-                       Vector<size_t> *indices,
-                       const float maximum_distance,
-                       const float3 boundbox,
-                       float3 const &point,
-                       size_t index,
-                       int dimension = 0)
-{
-  for (int dimension_iter = dimension; dimension_iter < 3; dimension_iter++) {
-    if (boundbox[dimension_iter] - point[dimension_iter] < maximum_distance) {
-      float3 point_tiled = point;
-      point_tiled[dimension_iter] -= boundbox[dimension_iter];
-
-      tiled_points->append(point_tiled);
-      indices->append(index);
-
-      tile_point(tiled_points,
-                 indices,
-                 maximum_distance,
-                 boundbox,
-                 point_tiled,
-                 index,
-                 dimension_iter + 1);
+/**
+ * Uniform grid over the tiled 2D domain of the samples. The domain repeats in x and y, so that
+ * the distribution can be tiled seamlessly. Since the cells are at least as large as the search
+ * radius, all neighbors of a point are in the 3x3 cells around it.
+ */
+class PeriodicPointGrid {
+ private:
+  const float3 *points_;
+  float3 boundbox_;
+  int cells_x_;
+  int cells_y_;
+  float cell_size_x_;
+  float cell_size_y_;
+  /** Start of the points of every cell in #cell_points_. */
+  Array<int> cell_offsets_;
+  /** Point indices sorted by cell and index, so that iteration order is deterministic. */
+  Array<int> cell_points_;
+
+ public:
+  PeriodicPointGrid(const float3 *points,
+                    const int points_size,
+                    const float3 boundbox,
+                    const float maximum_distance)
+      : points_(points), boundbox_(boundbox)
+  {
+    cells_x_ = std::max(1, (int)(boundbox.x / maximum_distance));
+    cells_y_ = std::max(1, (int)(boundbox.y / maximum_distance));
+    cell_size_x_ = boundbox.x / cells_x_;
+    cell_size_y_ = boundbox.y / cells_y_;
+
+    /* Counting sort of the points by cell. */
+    Array<int> point_cells(points_size);
+    cell_offsets_.reinitialize(cells_x_ * cells_y_ + 1);
+    cell_offsets_.fill(0);
+    for (const int i : IndexRange(points_size)) {
+      point_cells[i] = this->cell_index(this->cell_x(points[i].x), this->cell_y(points[i].y));
+      cell_offsets_[point_cells[i] + 1]++;
+    }
+    for (const int i : IndexRange(cells_x_ * cells_y_)) {
+      cell_offsets_[i + 1] += cell_offsets_[i];
     }
+    cell_points_.reinitialize(points_size);
+    Array<int> cell_fill(cell_offsets_.as_span().drop_back(1));
+    for (const int i : IndexRange(points_size)) {
+      cell_points_[cell_fill[point_cells[i]]++] = i;
+    }
+  }
 
-    if (point[dimension_iter] < maximum_distance) {
-      float3 point_tiled = point;
-      point_tiled[dimension_iter] += boundbox[dimension_iter];
+  /**
+   * Call the function with the index of and the distance to every other point closer than
+   * \a maximum_distance to the given point. The shortest distance across tile borders is used.
+   */
+  template<typename Func>
+  void foreach_neighbor(const int point_id, const float maximum_distance, const Func &func) const
+  {
+    const float3 &point = points_[point_id];
+    const int center_x = this->cell_x(point.x);
+    const int center_y = this->cell_y(point.y);
+
+    /* With less than three cells in a dimension, the same cell would be visited twice. */
+    const int range_x = std::min(cells_x_, 3);
+    const int range_y = std::min(cells_y_, 3);
+    for (const int offset_y : IndexRange(range_y)) {
+      const int y = this->wrap(center_y + offset_y - (range_y == 3), cells_y_);
+      for (const int offset_x : IndexRange(range_x)) {
+        const int x = this->wrap(center_x + offset_x - (range_x == 3), cells_x_);
+        const int cell = this->cell_index(x, y);
+        for (int i = cell_offsets_[cell]; i < cell_offsets_[cell + 1]; i++) {
+          const int neighbor_id = cell_points_[i];
+          if (neighbor_id == point_id) {
+            continue;
+          }
+          const float distance = this->periodic_distance(point, points_[neighbor_id]);
+          if (distance <= maximum_distance) {
+            func(neighbor_id, distance);
+          }
+        }
+      }
+    }
+  }
 
-      tiled_points->append(point_tiled);
-      indices->append(index);
+ private:
+  int cell_x(const float x) const
+  {
+    return std::clamp((int)(x / cell_size_x_), 0, cells_x_ - 1);
+  }
 
-      tile_point(tiled_points,
-                 indices,
-                 maximum_distance,
-                 boundbox,
-                 point_tiled,
-                 index,
-                 dimension_iter + 1);
-    }
+  int cell_y(const float y) const
+  {
+    return std::clamp((int)(y / cell_size_y_), 0, cells_y_ - 1);
+  }
+
+  int cell_index(const int x, const int y) const
+  {
+    return y * cells_x_ + x;
   }
-}
+
+  static int wrap(const int value, const int size)
+  {
+    return (value + size) % size;
+  }
+
+  static float periodic_delta(const float a, const float b, const float size)
+  {
+    const float delta = std::abs(a - b);
+    return std::min(delta, size - delta);
+  }
+
+  float periodic_distance(const float3 &a, const float3 &b) const
+  {
+    const float dx = periodic_delta(a.x, b.x, boundbox_.x);
+    const float dy = periodic_delta(a.y, b.y, boundbox_.y);
+    return std::sqrt(dx * dx + dy * dy);
+  }
+};
 
 /**
  * Returns the weight the point gets based on the distance to another point.
@@ -91,55 +163,6 @@ static float point_weight_influence_get(const float maximum_distance,
   return std::pow(1.0f - distance / maximum_distance, alpha);
 }
 
-/**
- * Weight each point based on their proximity to its neighbors
- *
- * For each index in the weight array add a weight based on the proximity the
- * corresponding point has with its neighboors.
- **/
-static void points_distance_weight_calculate(Vector<float> *weights,
-                                             const size_t point_id,
-                                             const float3 *input_points,
-                                             const void *kd_tree,
-                                             const float minimum_distance,
-                                             const float maximum_distance,
-                                             InplacePriorityQueue<float> *heap)
-{
-  KDTreeNearest_3d *nearest_point = nullptr;
-  int neighbors = BLI_kdtree_3d_range_search(
-      (KDTree_3d *)kd_tree, input_points[point_id], &nearest_point, maximum_distance);
-
-  for (int i = 0; i < neighbors; i++) {
-    size_t neighbor_point_id = nearest_point[i].index;
-
-    if (neighbor_point_id >= weights->size()) {
-      continue;
-    }
-
-    /* The point should not influence itself. */
-    if (neighbor_point_id == point_id) {
-      continue;
-    }
-
-    const float weight_influence = point_weight_influence_get(
-        maximum_distance, minimum_distance, nearest_point[i].dist);
-
-    /* In the first pass we just the weights. */
-    if (heap == nullptr) {
-      (*weights)[point_id] += weight_influence;
-    }
-    /* When we run again we need to update the weights and the heap. */
-    else {
-      (*weights)[neighbor_point_id] -= weight_influence;
-      heap->priority_decreased(neighbor_point_id);
-    }
-  }
-
-  if (nearest_point) {
-    MEM_freeN(nearest_point);
-  }
-}
-
 /**
  * Returns the minimum radius fraction used by the default weight function.
  */
@@ -151,36 +174,6 @@ static float weight_limit_fraction_get(const size_t input_size, const size_t out
   return (1.0f - std::pow(ratio, gamma)) * beta;
 }
 
-/**
- * Tile the input points.
- */
-static void points_tiling(const float3 *input_points,
-                          const size_t input_size,
-                          void **kd_tree,
-                          const float maximum_distance,
-                          const float3 boundbox)
-
-{
-  Vector<float3> tiled_points(input_points, input_points + input_size);
-  Vector<size_t> indices(input_size);
-
-  for (size_t i = 0; i < input_size; i++) {
-    indices[i] = i;
-  }
-
-  /* Tile the tree based on the boundbox. */
-  for (size_t i = 0; i < input_size; i++) {
-    tile_point(&tiled_points, &indices, maximum_distance, boundbox, input_points[i], i);
-  }
-
-  /* Build a new tree with the new indices and tiled points. */
-  *kd_tree = BLI_kdtree_3d_new(tiled_points.size());
-  for (size_t i = 0; i < tiled_points.size(); i++) {
-    BLI_kdtree_3d_insert(*(KDTree_3d **)kd_tree, indices[i], tiled_points[i]);
-  }
-  BLI_kdtree_3d_balance(*(KDTree_3d **)kd_tree);
-}
-
 static void weighted_sample_elimination(const float3 *input_points,
                                         const size_t input_size,
                                         float3 *output_points,
@@ -192,15 +185,20 @@ static void weighted_sample_elimination(const float3 *input_points,
   const float minimum_distance = maximum_distance *
                                  weight_limit_fraction_get(input_size, output_size);
 
-  void *kd_tree = nullptr;
-  points_tiling(input_points, input_size, &kd_tree, maximum_distance, boundbox);
+  const PeriodicPointGrid grid{input_points, (int)input_size, boundbox, maximum_distance};
 
-  /* Assign weights to each sample. */
+  /* Assign weights to each sample based on the proximity to its neighbors. Every weight only
+   * depends on the point itself, so they can be computed in parallel. */
   Vector<float> weights(input_size, 0.0f);
-  for (size_t point_id = 0; point_id < weights.size(); point_id++) {
-    points_distance_weight_calculate(
-        &weights, point_id, input_points, kd_tree, minimum_distance, maximum_distance, nullptr);
-  }
+  parallel_for(IndexRange(input_size), 256, [&](const IndexRange range) {
+    for (const int point_id : range) {
+      float weight = 0.0f;
+      grid.foreach_neighbor(point_id, maximum_distance, [&](const int, const float distance) {
+        weight += point_weight_influence_get(maximum_distance, minimum_distance, distance);
+      });
+      weights[point_id] = weight;
+    }
+  });
 
   /* Remove the points based on their weight. */
   InplacePriorityQueue<float> heap(weights);
@@ -208,9 +206,13 @@ static void weighted_sample_elimination(const float3 *input_points,
   size_t sample_size = input_size;
   while (sample_size > output_size) {
     /* For each sample around it, remove its weight contribution and update the heap. */
-    size_t point_id = heap.pop_index();
-    points_distance_weight_calculate(
-        &weights, point_id, input_points, kd_tree, minimum_distance, maximum_distance, &heap);
+    const int point_id = heap.pop_index();
+    grid.foreach_neighbor(
+        point_id, maximum_distance, [&](const int neighbor_id, const float distance) {
+          weights[neighbor_id] -= point_weight_influence_get(
+              maximum_distance, minimum_distance, distance);
+          heap.priority_decreased(neighbor_id);
+        });
     sample_size--;
   }
 
@@ -220,9 +222,6 @@ static void weighted_sample_elimination(const float3 *input_points,
     size_t index = heap.all_indices()[i];
     output_points[i] = input_points[index];
   }
-
-  /* Cleanup. */
-  BLI_kdtree_3d_free((KDTree_3d *)kd_tree);
 }
 
 static void progressive_sampling_reorder(Vector<float3> *output_points,
@@ -153,16 +153,37 @@ static void add_instances_from_geometry_component(InstancesComponent &instances,
   Array<std::optional<InstancedData>> instances_data = get_instanced_data(
       params, src_geometry, domain_size);
 
-  Float3ReadAttribute positions = src_geometry.attribute_get_for_read<float3>(
-      "position", domain, {0, 0, 0});
-  Float3ReadAttribute rotations = src_geometry.attribute_get_for_read<float3>(
-      "rotation", domain, {0, 0, 0});
-  Float3ReadAttribute scales = src_geometry.attribute_get_for_read<float3>(
-      "scale", domain, {1, 1, 1});
+  /* Arrays stored on the points are used directly, accessors are only created for attributes
+   * that are stored differently or don't exist. Then there is no virtual call per point. */
+  Vector<Float3ReadAttribute> fallback_attributes;
+  auto get_span = [&](const StringRef name, const float3 default_value) {
+    Span<float3> span = src_geometry.attribute_try_get_span<float3>(name, domain);
+    if (span.is_empty()) {
+      fallback_attributes.append(
+          src_geometry.attribute_get_for_read<float3>(name, domain, default_value));
+      span = fallback_attributes.last().get_span();
+    }
+    return span;
+  };
+  const Span<float3> positions = get_span("position", {0, 0, 0});
+  const Span<float3> rotations = get_span("rotation", {0, 0, 0});
+  const Span<float3> scales = get_span("scale", {1, 1, 1});
+
+  Array<float4x4> transforms(domain_size);
+  parallel_for(IndexRange(domain_size), 4096, [&](const IndexRange range) {
+    for (const int i : range) {
+      loc_eul_size_to_mat4(transforms[i].values, positions[i], rotations[i], scales[i]);
+    }
+  });
 
+  int instances_amount = 0;
+  for (const int i : IndexRange(domain_size)) {
+    instances_amount += instances_data[i].has_value();
+  }
+  instances.reserve(instances.instances_amount() + instances_amount);
   for (const int i : IndexRange(domain_size)) {
     if (instances_data[i].has_value()) {
-      instances.add_instance(*instances_data[i], positions[i], rotations[i], scales[i]);
+      instances.add_instance(*instances_data[i], transforms[i]);
     }
   }
 }
@@ -91,20 +91,24 @@ static void transform_instances(InstancesComponent &instances,
                                 const float3 rotation,
                                 const float3 scale)
 {
-  MutableSpan<float3> positions = instances.positions();
+  MutableSpan<float4x4> transforms = instances.transforms();
 
   /* Use only translation if rotation and scale don't apply. */
   if (use_translate(rotation, scale)) {
-    for (float3 &position : positions) {
-      add_v3_v3(position, translation);
-    }
+    parallel_for(transforms.index_range(), 4096, [&](const IndexRange range) {
+      for (const int i : range) {
+        add_v3_v3(transforms[i].values[3], translation);
+      }
+    });
   }
   else {
-    float mat[4][4];
-    loc_eul_size_to_mat4(mat, translation, rotation, scale);
-    for (float3 &position : positions) {
-      mul_m4_v3(mat, position);
-    }
+    float4x4 matrix;
+    loc_eul_size_to_mat4(matrix.values, translation, rotation, scale);
+    parallel_for(transforms.index_range(), 4096, [&](const IndexRange range) {
+      for (const int i : range) {
+        transforms[i] = matrix * transforms[i];
+      }
+    });
   }
 }
 
@@ -419,6 +419,11 @@ static PyGetSetDef bpy_app_getsets[] = {
      bpy_app_debug_set,
      bpy_app_debug_doc,
      (void *)G_DEBUG_DEPSGRAPH_PRETTY},
+    {"debug_geometry_nodes_profile",
+     bpy_app_debug_get,
+     bpy_app_debug_set,
+     bpy_app_debug_doc,
+     (void *)G_DEBUG_GEOMETRY_NODES_PROFILE},
     {"debug_simdata",
      bpy_app_debug_get,
      bpy_app_debug_set,
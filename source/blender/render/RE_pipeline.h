@@ -291,6 +291,8 @@ void RE_RenderAnim(struct Render *re,
                    int sfra,
                    int efra,
                    int tfra);
+void RE_SetCompositorPipelineFrames(int frames);
+bool RE_WriteInBackground(bool (*write_fn)(void *data), void *data);
 #ifdef WITH_FREESTYLE
 void RE_RenderFreestyleStrokes(struct Render *re,
                                struct Main *bmain,
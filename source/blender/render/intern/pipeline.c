@@ -47,6 +47,7 @@
 #include "BLI_path_util.h"
 #include "BLI_rect.h"
 #include "BLI_string.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 #include "BLI_timecode.h"
 
@@ -2300,6 +2301,181 @@ bool RE_WriteRenderViewsMovie(ReportList *reports,
   return ok;
 }
 
+/* ************ Pipelined Compositing of Animations ************ */
+
+/* Number of frames whose files may be written in the background while the next frames are
+ * composited, 0 writes them before compositing the next frame. */
+static int g_compositor_pipeline_frames = 0;
+
+typedef struct CompositePipelineFrame {
+  struct CompositePipelineFrame *next, *prev;
+  /** Write jobs of the frame that haven't finished yet. */
+  int pending_jobs;
+  /** The frame is done compositing, no more jobs are added to it. */
+  bool closed;
+} CompositePipelineFrame;
+
+typedef struct CompositePipeline {
+  TaskPool *pool;
+  ThreadMutex mutex;
+  ThreadCondition condition;
+  int max_frames;
+  /** Frames that are being composited or written, oldest first. */
+  ListBase frames;
+  /** Writing a file failed, the animation is stopped. */
+  bool failed;
+} CompositePipeline;
+
+typedef struct CompositePipelineJob {
+  CompositePipelineFrame *frame;
+  bool (*write_fn)(void *data);
+  void *data;
+} CompositePipelineJob;
+
+/* Pipeline of the animation being composited, only accessed from the render thread. */
+static CompositePipeline *g_composite_pipeline = NULL;
+
+/**
+ * Write the output files of compositor-only animations in the background, overlapping the
+ * encoding of frames with compositing the next ones. Used by command line rendering.
+ * \param frames: Number of frames that can be in flight, 0 disables the pipeline.
+ */
+void RE_SetCompositorPipelineFrames(int frames)
+{
+  g_compositor_pipeline_frames = max_ii(frames, 0);
+}
+
+static void composite_pipeline_frame_free(CompositePipeline *pipeline,
+                                          CompositePipelineFrame *frame)
+{
+  BLI_remlink(&pipeline->frames, frame);
+  MEM_freeN(frame);
+  BLI_condition_notify_all(&pipeline->condition);
+}
+
+static void composite_pipeline_job_run(TaskPool *__restrict pool, void *taskdata)
+{
+  CompositePipeline *pipeline = BLI_task_pool_user_data(pool);
+  CompositePipelineJob *job = taskdata;
+  const bool ok = job->write_fn(job->data);
+
+  BLI_mutex_lock(&pipeline->mutex);
+  if (!ok) {
+    pipeline->failed = true;
+  }
+  job->frame->pending_jobs--;
+  if (job->frame->pending_jobs == 0 && job->frame->closed) {
+    composite_pipeline_frame_free(pipeline, job->frame);
+  }
+  BLI_mutex_unlock(&pipeline->mutex);
+}
+
+static CompositePipeline *composite_pipeline_create(int max_frames)
+{
+  CompositePipeline *pipeline = MEM_callocN(sizeof(CompositePipeline), "CompositePipeline");
+  pipeline->pool = BLI_task_pool_create_background(pipeline, TASK_PRIORITY_HIGH);
+  BLI_mutex_init(&pipeline->mutex);
+  BLI_condition_init(&pipeline->condition);
+  pipeline->max_frames = max_frames;
+  return pipeline;
+}
+
+/* Wait until less than the maximum number of frames are in flight and start the next one. */
+static void composite_pipeline_frame_begin(CompositePipeline *pipeline)
+{
+  BLI_mutex_lock(&pipeline->mutex);
+  while (BLI_listbase_count(&pipeline->frames) >= pipeline->max_frames) {
+    BLI_condition_wait(&pipeline->condition, &pipeline->mutex);
+  }
+  BLI_addtail(&pipeline->frames, MEM_callocN(sizeof(CompositePipelineFrame), __func__));
+  BLI_mutex_unlock(&pipeline->mutex);
+}
+
+/* Done compositing the current frame, returns false when writing a file has failed. */
+static bool composite_pipeline_frame_end(CompositePipeline *pipeline)
+{
+  BLI_mutex_lock(&pipeline->mutex);
+  CompositePipelineFrame *frame = pipeline->frames.last;
+  frame->closed = true;
+  if (frame->pending_jobs == 0) {
+    composite_pipeline_frame_free(pipeline, frame);
+  }
+  const bool ok = !pipeline->failed;
+  BLI_mutex_unlock(&pipeline->mutex);
+  return ok;
+}
+
+/* Wait for all files to be written, returns false when writing a file has failed. */
+static bool composite_pipeline_free(CompositePipeline *pipeline)
+{
+  BLI_task_pool_work_and_wait(pipeline->pool);
+  BLI_task_pool_free(pipeline->pool);
+  BLI_assert(BLI_listbase_is_empty(&pipeline->frames));
+  BLI_condition_end(&pipeline->condition);
+  BLI_mutex_end(&pipeline->mutex);
+  const bool ok = !pipeline->failed;
+  MEM_freeN(pipeline);
+  return ok;
+}
+
+/* Load the files of image sequences of the compositor at a frame in the background. */
+static void composite_pipeline_prefetch(bNodeTree *ntree, int cfra)
+{
+  LISTBASE_FOREACH (bNode *, node, &ntree->nodes) {
+    if (node->flag & NODE_MUTED || node->id == NULL) {
+      continue;
+    }
+    if (node->type == CMP_NODE_IMAGE) {
+      BKE_image_prefetch_frame((Image *)node->id, node->storage, cfra);
+    }
+    else if (node->type == NODE_GROUP) {
+      composite_pipeline_prefetch((bNodeTree *)node->id, cfra);
+    }
+  }
+}
+
+/**
+ * Write a file of the frame being composited in the background when pipelined compositing of an
+ * animation is active, the write_fn is called from another thread and owns the data.
+ * \return false when the pipeline isn't active, the caller writes the file itself.
+ */
+bool RE_WriteInBackground(bool (*write_fn)(void *data), void *data)
+{
+  CompositePipeline *pipeline = g_composite_pipeline;
+  if (pipeline == NULL) {
+    return false;
+  }
+
+  CompositePipelineJob *job = MEM_mallocN(sizeof(CompositePipelineJob), __func__);
+  job->write_fn = write_fn;
+  job->data = data;
+
+  BLI_mutex_lock(&pipeline->mutex);
+  job->frame = pipeline->frames.last;
+  BLI_assert(job->frame && !job->frame->closed);
+  job->frame->pending_jobs++;
+  BLI_mutex_unlock(&pipeline->mutex);
+
+  BLI_task_pool_push(pipeline->pool, composite_pipeline_job_run, job, true, NULL);
+  return true;
+}
+
+typedef struct RenderViewsWrite {
+  RenderResult *rr;
+  /* Shallow copy, the settings used for writing can be animated. */
+  Scene scene;
+  char name[FILE_MAX];
+} RenderViewsWrite;
+
+static bool render_views_write_job(void *data)
+{
+  RenderViewsWrite *write = data;
+  const bool ok = RE_WriteRenderViewsImage(NULL, write->rr, &write->scene, true, write->name);
+  RE_FreeRenderResult(write->rr);
+  MEM_freeN(write);
+  return ok;
+}
+
 static int do_write_image_or_movie(Render *re,
                                    Main *bmain,
                                    Scene *scene,
@@ -2334,8 +2510,17 @@ static int do_write_image_or_movie(Render *re,
                                    NULL);
     }
 
-    /* write images as individual images or stereo */
-    ok = RE_WriteRenderViewsImage(re->reports, &rres, scene, true, name);
+    if (g_composite_pipeline) {
+      RenderViewsWrite *write = MEM_mallocN(sizeof(RenderViewsWrite), __func__);
+      write->rr = RE_DuplicateRenderResult(&rres);
+      write->scene = *scene;
+      BLI_strncpy(write->name, name, sizeof(write->name));
+      RE_WriteInBackground(render_views_write_job, write);
+    }
+    else {
+      /* write images as individual images or stereo */
+      ok = RE_WriteRenderViewsImage(re->reports, &rres, scene, true, name);
+    }
   }
 
   RE_ReleaseResultImageViews(re, &rres);
@@ -2420,6 +2605,9 @@ void RE_RenderAnim(Render *re,
   const bool is_movie = BKE_imtype_is_movie(rd.im_format.imtype);
   const bool is_multiview_name = ((rd.scemode & R_MULTIVIEW) != 0 &&
                                   (rd.im_format.views_format == R_IMF_VIEWS_INDIVIDUAL));
+  /* Overlap loading and writing files with compositing, when only compositing is done. */
+  const bool use_composite_pipeline = (g_compositor_pipeline_frames > 0 && !is_movie &&
+                                       !composite_needs_render(scene, 0));
 
   /* do not fully call for each frame, it initializes & pops output window */
   if (!render_init_from_main(re, &rd, bmain, scene, single_layer, camera_override, 0, 1)) {
@@ -2475,6 +2663,11 @@ void RE_RenderAnim(Render *re,
 
   re->flag |= R_ANIMATION;
 
+  if (use_composite_pipeline) {
+    g_composite_pipeline = composite_pipeline_create(g_compositor_pipeline_frames);
+    composite_pipeline_prefetch(scene->nodetree, sfra);
+  }
+
   {
     for (nfra = sfra, scene->r.cfra = sfra; scene->r.cfra <= efra; scene->r.cfra++) {
       char name[FILE_MAX];
@@ -2588,6 +2781,14 @@ void RE_RenderAnim(Render *re,
       /* run callbacks before rendering, before the scene is updated */
       render_callback_exec_id(re, re->main, &scene->id, BKE_CB_EVT_RENDER_PRE);
 
+      if (g_composite_pipeline) {
+        composite_pipeline_frame_begin(g_composite_pipeline);
+        /* Load the next frame while this one is composited. */
+        if (nfra <= efra) {
+          composite_pipeline_prefetch(scene->nodetree, nfra);
+        }
+      }
+
       do_render_all_options(re);
       totrendered++;
 
@@ -2602,6 +2803,14 @@ void RE_RenderAnim(Render *re,
         G.is_break = true;
       }
 
+      if (g_composite_pipeline) {
+        if (!composite_pipeline_frame_end(g_composite_pipeline)) {
+          G.is_break = true;
+        }
+        /* Free prefetched files this frame didn't use. */
+        BKE_image_prefetch_discard(nfra);
+      }
+
       if (G.is_break == true) {
         /* remove touched file */
         if (is_movie == false) {
@@ -2648,6 +2857,14 @@ void RE_RenderAnim(Render *re,
     re_movie_free_all(re, mh, totvideos);
   }
 
+  if (g_composite_pipeline) {
+    if (!composite_pipeline_free(g_composite_pipeline)) {
+      G.is_break = true;
+    }
+    g_composite_pipeline = NULL;
+    BKE_image_prefetch_discard(INT_MAX);
+  }
+
   if (totskipped && totrendered == 0) {
     BKE_report(re->reports, RPT_INFO, "No frames rendered, skipped to not overwrite");
   }
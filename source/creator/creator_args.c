@@ -47,6 +47,7 @@
 
 #  include "BKE_blender_version.h"
 #  include "BKE_context.h"
+#  include "BKE_geometry_nodes_profile.h"
 
 #  include "BKE_global.h"
 #  include "BKE_image.h"
@@ -515,6 +516,7 @@ static int arg_handle_print_help(int UNUSED(argc), const char **UNUSED(argv), vo
   BLI_args_print_arg_doc(ba, "--render-output");
   BLI_args_print_arg_doc(ba, "--engine");
   BLI_args_print_arg_doc(ba, "--threads");
+  BLI_args_print_arg_doc(ba, "--compositor-pipeline");
 
   printf("\n");
   printf("Format Options:\n");
@@ -586,6 +588,7 @@ static int arg_handle_print_help(int UNUSED(argc), const char **UNUSED(argv), vo
   BLI_args_print_arg_doc(ba, "--debug-depsgraph-no-threads");
   BLI_args_print_arg_doc(ba, "--debug-depsgraph-time");
   BLI_args_print_arg_doc(ba, "--debug-depsgraph-pretty");
+  BLI_args_print_arg_doc(ba, "--debug-geometry-nodes-profile");
   BLI_args_print_arg_doc(ba, "--debug-gpu");
   BLI_args_print_arg_doc(ba, "--debug-gpumem");
   BLI_args_print_arg_doc(ba, "--debug-gpu-shaders");
@@ -1000,6 +1003,23 @@ static int arg_handle_debug_mode_io(int UNUSED(argc),
   return 0;
 }
 
+static const char arg_handle_debug_mode_geometry_nodes_profile_doc[] =
+    "<filename>\n"
+    "\tRecord the execution time of every geometry node and write it to a Chrome trace file\n"
+    "\ton exit, which can be opened in 'chrome://tracing'.";
+static int arg_handle_debug_mode_geometry_nodes_profile(int argc,
+                                                        const char **argv,
+                                                        void *UNUSED(data))
+{
+  const char *arg_id = "--debug-geometry-nodes-profile";
+  if (argc > 1) {
+    BKE_geometry_nodes_profile_write_on_exit(argv[1]);
+    return 1;
+  }
+  printf("\nError: '%s' no args given.\n", arg_id);
+  return 0;
+}
+
 static const char arg_handle_debug_mode_all_doc[] =
     "\n\t"
     "Enable all debug messages.";
@@ -1468,6 +1488,36 @@ static int arg_handle_threads_set(int argc, const char **argv, void *UNUSED(data
   return 0;
 }
 
+static const char arg_handle_compositor_pipeline_set_doc[] =
+    "<frames>\n"
+    "\tWhen rendering an animation that only uses the compositor, load the input image sequences\n"
+    "\tof the next frame and write the output files of up to <frames> previous frames in the\n"
+    "\tbackground while compositing a frame [1-16].\n"
+    "\tThe render write handlers run before the files of a frame are written.";
+static int arg_handle_compositor_pipeline_set(int argc, const char **argv, void *UNUSED(data))
+{
+  const char *arg_id = "--compositor-pipeline";
+  const int min = 1, max = 16;
+  if (argc > 1) {
+    const char *err_msg = NULL;
+    int frames;
+    if (!parse_int_strict_range(argv[1], NULL, min, max, &frames, &err_msg)) {
+      printf("\nError: %s '%s %s', expected number in [%d..%d].\n",
+             err_msg,
+             arg_id,
+             argv[1],
+             min,
+             max);
+      return 1;
+    }
+
+    RE_SetCompositorPipelineFrames(frames);
+    return 1;
+  }
+  printf("\nError: you must specify a number of frames in [%d..%d] '%s'.\n", min, max, arg_id);
+  return 0;
+}
+
 static const char arg_handle_verbosity_set_doc[] =
     "<verbose>\n"
     "\tSet the logging verbosity level for debug messages that support it.";
@@ -2011,6 +2061,7 @@ void main_args_setup(bContext *C, bArgs *ba)
   BLI_args_add(ba, NULL, "--env-system-python", CB_EX(arg_handle_env_system_set, python), NULL);
 
   BLI_args_add(ba, "-t", "--threads", CB(arg_handle_threads_set), NULL);
+  BLI_args_add(ba, NULL, "--compositor-pipeline", CB(arg_handle_compositor_pipeline_set), NULL);
 
   /* Pass: Background Mode & Settings
    *
@@ -2157,6 +2208,11 @@ void main_args_setup(bContext *C, bArgs *ba)
                "--debug-depsgraph-uuid",
                CB_EX(arg_handle_debug_mode_generic_set, depsgraph_build),
                (void *)G_DEBUG_DEPSGRAPH_UUID);
+  BLI_args_add(ba,
+               NULL,
+               "--debug-geometry-nodes-profile",
+               CB(arg_handle_debug_mode_geometry_nodes_profile),
+               NULL);
   BLI_args_add(ba,
                NULL,
                "--debug-gpumem",